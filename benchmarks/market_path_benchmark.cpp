@@ -10,6 +10,31 @@
 #include <sentum/market/IncrementalIndicators.hpp>
 #include <sentum/market/MarketDataStore.hpp>
 #include <sentum/market/MarketEventBus.hpp>
+#include <sentum/market/SymbolInterner.hpp>
+
+namespace {
+
+void count_event(void* context, const MarketEvent&) { ++*static_cast<std::uint64_t*>(context); }
+
+// Publish cost on an isolated bus with `subscribers` function-pointer handlers.
+double dispatch_nanoseconds(std::size_t subscribers, std::size_t events, std::uint64_t& delivered) {
+    sentum::market::MarketEventBus bus;
+    std::vector<sentum::market::MarketEventBus::SubscriptionId> ids;
+    for (std::size_t i = 0; i < subscribers; ++i) ids.push_back(bus.subscribe(&count_event, &delivered));
+    MarketEvent event;
+    event.type = MarketEvent::Type::Candle;
+    event.symbol_id = 1;
+    const auto begin = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < events; ++i) {
+        event.price = static_cast<double>(i);
+        bus.publish(event);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - begin;
+    for (const auto id : ids) bus.unsubscribe(id);
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(events);
+}
+
+} // namespace
 
 int main(int argc, char** argv) {
     const std::size_t symbols = argc > 1 ? static_cast<std::size_t>(std::stoull(argv[1])) : 500;
@@ -20,10 +45,9 @@ int main(int argc, char** argv) {
     MarketDataStore store(600);
     std::vector<std::string> names;
     names.reserve(symbols);
-    for (std::size_t i = 0; i < symbols; ++i) {
-        names.push_back("sym" + std::to_string(i));
-        store.register_symbol(static_cast<sentum::market::SymbolId>(i + 1), names.back());
-    }
+    for (std::size_t i = 0; i < symbols; ++i) names.push_back("SYM" + std::to_string(i) + "USDT");
+    const auto ids = sentum::market::SymbolInterner::global().intern_all(names);
+    for (std::size_t i = 0; i < symbols; ++i) store.register_symbol(ids[i], names[i]);
 
     std::uint64_t delivered = 0;
     const auto subscription = sentum::market::MarketEventBus::global().subscribe(
@@ -36,7 +60,7 @@ int main(int argc, char** argv) {
     const auto begin = std::chrono::steady_clock::now();
     for (std::size_t i = 0; i < total_events; ++i) {
         const auto index = i % symbols;
-        const auto id = static_cast<sentum::market::SymbolId>(index + 1);
+        const auto id = ids[index];
         const double price = 100.0 + static_cast<double>(i % 1000) * 0.001;
         Kline kline;
         kline.timestamp = static_cast<std::int64_t>(i) * 1000;
@@ -54,7 +78,6 @@ int main(int argc, char** argv) {
         MarketEvent event;
         event.type = MarketEvent::Type::Candle;
         event.symbol_id = id;
-        event.symbol = names[index];
         event.price = price;
         event.close = price;
         event.closed = true;
@@ -66,7 +89,12 @@ int main(int argc, char** argv) {
     const double seconds = std::chrono::duration<double>(elapsed).count();
     const double eps = static_cast<double>(total_events) / seconds;
     double return_60 = 0.0;
-    store.cumulative_return(static_cast<sentum::market::SymbolId>(1), 60, return_60);
+    store.cumulative_return(ids.front(), 60, return_60);
+
+    std::uint64_t dispatched = 0;
+    double dispatch_ns[3];
+    const std::size_t fan_out[3] = {1, 4, 16};
+    for (std::size_t i = 0; i < 3; ++i) dispatch_ns[i] = dispatch_nanoseconds(fan_out[i], total_events, dispatched);
 
     std::cout << std::fixed << std::setprecision(2)
               << "symbols=" << symbols << '\n'
@@ -78,5 +106,7 @@ int main(int argc, char** argv) {
               << "rolling_return_60=" << return_60 << '\n'
               << "sma20=" << sma.current() << '\n'
               << "rsi14_ready=" << (rsi.ready() ? "true" : "false") << '\n';
-    return delivered == total_events ? 0 : 1;
+    for (std::size_t i = 0; i < 3; ++i)
+        std::cout << "dispatch_ns_per_event_" << fan_out[i] << "_subscribers=" << dispatch_ns[i] << '\n';
+    return delivered == total_events && dispatched == total_events * (1 + 4 + 16) ? 0 : 1;
 }
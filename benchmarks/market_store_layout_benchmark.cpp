@@ -0,0 +1,210 @@
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sentum/api/model/Kline.hpp>
+#include <sentum/market/MarketDataStore.hpp>
+
+namespace {
+
+// The previous store layout: one shared_ptr ring of 48-byte Klines per symbol (AoS).
+class LegacyMarketDataStore {
+public:
+    explicit LegacyMarketDataStore(std::size_t capacity) : capacity_(capacity) {}
+
+    void register_symbol(sentum::market::SymbolId id) {
+        if (buffers_.size() <= id) buffers_.resize(static_cast<std::size_t>(id) + 1);
+        buffers_[id] = std::make_shared<RingBuffer>(capacity_);
+    }
+
+    void upsert(sentum::market::SymbolId id, const Kline& kline) {
+        auto buffer = id < buffers_.size() ? buffers_[id] : nullptr;
+        if (!buffer) return;
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        if (buffer->size > 0) {
+            const auto last = (buffer->head + buffer->capacity - 1) % buffer->capacity;
+            if (buffer->data[last].timestamp == kline.timestamp) { buffer->data[last] = kline; return; }
+        }
+        buffer->data[buffer->head] = kline;
+        buffer->head = (buffer->head + 1) % buffer->capacity;
+        if (buffer->size < buffer->capacity) ++buffer->size;
+    }
+
+    bool cumulative_return(sentum::market::SymbolId id, std::size_t lookback, double& result) const {
+        auto buffer = id < buffers_.size() ? buffers_[id] : nullptr;
+        if (!buffer || lookback < 2) return false;
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        const std::size_t count = std::min(lookback, buffer->size);
+        if (count < 2) return false;
+        const std::size_t first_index = (buffer->head + buffer->capacity - count) % buffer->capacity;
+        const std::size_t last = (buffer->head + buffer->capacity - 1) % buffer->capacity;
+        const double first = buffer->data[first_index].close;
+        if (first <= 0.0) return false;
+        result = (buffer->data[last].close - first) / first;
+        return true;
+    }
+
+    std::vector<Kline> latest(sentum::market::SymbolId id, std::size_t limit) const {
+        auto buffer = id < buffers_.size() ? buffers_[id] : nullptr;
+        if (!buffer) return {};
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        const std::size_t count = std::min(limit, buffer->size);
+        std::vector<Kline> result; result.reserve(count);
+        const std::size_t start = (buffer->head + buffer->capacity - count) % buffer->capacity;
+        for (std::size_t i = 0; i < count; ++i) result.push_back(buffer->data[(start + i) % buffer->capacity]);
+        return result;
+    }
+
+private:
+    struct RingBuffer {
+        explicit RingBuffer(std::size_t c) : data(c), capacity(c) {}
+        std::vector<Kline> data;
+        const std::size_t capacity;
+        std::size_t head = 0;
+        std::size_t size = 0;
+        mutable std::mutex mutex;
+    };
+    std::size_t capacity_;
+    std::vector<std::shared_ptr<RingBuffer>> buffers_;
+};
+
+Kline make_kline(std::size_t symbol, std::size_t bar) {
+    const double price = 10.0 + static_cast<double>(symbol % 97) + static_cast<double>((bar * 31 + symbol) % 500) * 0.01;
+    return {static_cast<std::int64_t>(bar) * 60000, price - 0.01, price + 0.02, price - 0.02, price, 1.0 + static_cast<double>(bar % 7)};
+}
+
+// Upsert cost on one writer thread while `readers` threads keep reading full windows of
+// the same symbols, as the scanner, strategies and dashboard do.
+template <typename Store, typename Read>
+double contended_upsert_ns(Store& store, std::size_t symbols, std::size_t bars, std::size_t readers, Read read) {
+    std::atomic<bool> done{false};
+    std::atomic<std::uint64_t> reads{0};
+    std::vector<std::thread> threads;
+    for (std::size_t r = 0; r < readers; ++r)
+        threads.emplace_back([&, r] {
+            std::uint64_t local = 0;
+            for (std::size_t i = r; !done.load(std::memory_order_relaxed); i = i % symbols + 1, ++local)
+                read(store, static_cast<sentum::market::SymbolId>(i % symbols + 1));
+            reads.fetch_add(local, std::memory_order_relaxed);
+        });
+    const auto begin = std::chrono::steady_clock::now();
+    for (std::size_t bar = 2 * bars; bar < 3 * bars; ++bar)
+        for (std::size_t i = 1; i <= symbols; ++i) store.upsert(static_cast<sentum::market::SymbolId>(i), make_kline(i, bar));
+    const double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+    done.store(true);
+    for (auto& thread : threads) thread.join();
+    return elapsed / static_cast<double>(symbols * bars);
+}
+
+double seconds_since(std::chrono::steady_clock::time_point begin) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t symbols = argc > 1 ? static_cast<std::size_t>(std::stoull(argv[1])) : 2000;
+    const std::size_t bars = argc > 2 ? static_cast<std::size_t>(std::stoull(argv[2])) : 600;
+    const std::size_t rounds = argc > 3 ? static_cast<std::size_t>(std::stoull(argv[3])) : 500;
+    const bool huge_pages = argc > 4 && std::string(argv[4]) == "huge";
+    constexpr std::size_t lookback = 60;
+    if (symbols == 0 || bars == 0 || rounds == 0 || symbols > MarketDataStore::default_max_symbols) return 2;
+
+    // The layout comparison runs without rollups; `rolled` measures what they add.
+    LegacyMarketDataStore legacy(bars);
+    MarketDataStore slab(bars, symbols, huge_pages, 0);
+    MarketDataStore rolled(bars, symbols, huge_pages);
+    for (std::size_t i = 1; i <= symbols; ++i) {
+        const auto id = static_cast<sentum::market::SymbolId>(i);
+        legacy.register_symbol(id);
+        slab.register_symbol(id, "SYM" + std::to_string(i));
+        rolled.register_symbol(id, "SYM" + std::to_string(i));
+    }
+
+    // The first window faults the pages in; the timed pass overwrites a warm window.
+    const auto ingest = [&](auto& store, std::size_t first_bar) {
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t bar = first_bar; bar < first_bar + bars; ++bar)
+            for (std::size_t i = 1; i <= symbols; ++i) store.upsert(static_cast<sentum::market::SymbolId>(i), make_kline(i, bar));
+        return seconds_since(start);
+    };
+    ingest(legacy, 0);
+    ingest(slab, 0);
+    ingest(rolled, 0);
+    const double legacy_ingest = ingest(legacy, bars);
+    const double slab_ingest = ingest(slab, bars);
+    const double rolled_ingest = ingest(rolled, bars);
+
+    std::chrono::steady_clock::time_point begin;
+
+    double legacy_sum = 0.0, slab_sum = 0.0, scan_sum = 0.0;
+    begin = std::chrono::steady_clock::now();
+    for (std::size_t round = 0; round < rounds; ++round)
+        for (std::size_t i = 1; i <= symbols; ++i) {
+            double value;
+            if (legacy.cumulative_return(static_cast<sentum::market::SymbolId>(i), lookback, value)) legacy_sum += value;
+        }
+    const double legacy_scan = seconds_since(begin);
+
+    begin = std::chrono::steady_clock::now();
+    for (std::size_t round = 0; round < rounds; ++round)
+        for (std::size_t i = 1; i <= symbols; ++i) {
+            double value;
+            if (slab.cumulative_return(static_cast<sentum::market::SymbolId>(i), lookback, value)) slab_sum += value;
+        }
+    const double slab_scan = seconds_since(begin);
+
+    std::vector<double> returns;
+    begin = std::chrono::steady_clock::now();
+    for (std::size_t round = 0; round < rounds; ++round) {
+        slab.cumulative_returns(lookback, returns);
+        for (const double value : returns) if (!std::isnan(value)) scan_sum += value;
+    }
+    const double cross_section = seconds_since(begin);
+
+    const double per_scan = static_cast<double>(symbols * rounds);
+    const double per_upsert = static_cast<double>(symbols * bars);
+    std::cout << std::fixed << std::setprecision(2)
+              << "symbols=" << symbols << " bars=" << bars << " rounds=" << rounds
+              << " huge_pages=" << (slab.huge_pages() ? "true" : "false") << '\n'
+              << "aos_upsert_ns=" << legacy_ingest * 1e9 / per_upsert << '\n'
+              << "soa_upsert_ns=" << slab_ingest * 1e9 / per_upsert << '\n'
+              << "soa_upsert_ns_with_rollups=" << rolled_ingest * 1e9 / per_upsert << '\n'
+              << "aos_return_ns_per_symbol=" << legacy_scan * 1e9 / per_scan << '\n'
+              << "soa_return_ns_per_symbol=" << slab_scan * 1e9 / per_scan << '\n'
+              << "soa_cross_section_ns_per_symbol=" << cross_section * 1e9 / per_scan << '\n';
+
+    // Readers copy full windows from the AoS store under its mutex; the slab is read in
+    // place through with_window.
+    const std::size_t readers = argc > 5 ? static_cast<std::size_t>(std::stoull(argv[5])) : 4;
+    const double aos_contended = contended_upsert_ns(legacy, symbols, bars, readers, [bars](const LegacyMarketDataStore& store, sentum::market::SymbolId id) {
+        volatile std::size_t sink = store.latest(id, bars).size();
+        (void)sink;
+    });
+    const double soa_contended = contended_upsert_ns(slab, symbols, bars, readers, [bars](const MarketDataStore& store, sentum::market::SymbolId id) {
+        double sum = 0.0;
+        store.with_window(id, bars, [&](const MarketDataStore::Window& window) {
+            sum = 0.0;
+            const auto close = window.close();
+            for (std::size_t i = 0; i < close.first_size; ++i) sum += close.first[i];
+            for (std::size_t i = 0; i < close.second_size; ++i) sum += close.second[i];
+        });
+        volatile double sink = sum;
+        (void)sink;
+    });
+    std::cout << "readers=" << readers << '\n'
+              << "aos_upsert_ns_with_readers=" << aos_contended << '\n'
+              << "soa_upsert_ns_with_readers=" << soa_contended << '\n';
+
+    const auto close = [](double a, double b) { return std::fabs(a - b) <= 1e-9 * std::max(1.0, std::fabs(a)); };
+    return close(legacy_sum, slab_sum) && close(legacy_sum, scan_sum) ? 0 : 1;
+}
@@ -0,0 +1,274 @@
+#include <chrono>
+#include <cinttypes>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <sentum/collector/DepthBook.hpp>
+#include <sentum/collector/DepthReplayFeed.hpp>
+#include <sentum/collector/FastBinanceDepthParser.hpp>
+#include <sentum/market/OrderBook.hpp>
+
+namespace {
+
+using sentum::market::BookSide;
+
+// BTCUSDT-like grid: 0.01 tick, 0.00001 step.
+constexpr std::int64_t price_units = 100;
+constexpr std::int64_t quantity_units = 100000;
+
+struct Change {
+    BookSide side;
+    std::int64_t price;
+    std::int64_t quantity;
+};
+
+// Produces a snapshot plus a stream of diffs around a drifting mid, keeping the true book
+// in std::maps so replayed books can be checked level by level.
+class DepthGenerator {
+public:
+    explicit DepthGenerator(std::size_t levels) {
+        for (std::size_t i = 0; i < levels; ++i) {
+            bids_[mid_ - 1 - static_cast<std::int64_t>(i)] = quantity();
+            asks_[mid_ + 1 + static_cast<std::int64_t>(i)] = quantity();
+        }
+    }
+
+    std::string snapshot() const {
+        std::string out = "{\"lastUpdateId\":" + std::to_string(last_id_) + ",\"bids\":";
+        append_levels(out, bids_.rbegin(), bids_.rend());
+        out += ",\"asks\":";
+        append_levels(out, asks_.begin(), asks_.end());
+        out += '}';
+        return out;
+    }
+
+    // Next diff event; `changes` receives the level updates it carries.
+    std::string diff(std::vector<Change>& changes) {
+        changes.clear();
+        const auto shift = static_cast<int>(rng_() % 9) - 4;
+        if (shift > 0) {
+            for (auto it = asks_.begin(); it != asks_.end() && it->first <= mid_ + shift;) { changes.push_back({BookSide::Ask, it->first, 0}); it = asks_.erase(it); }
+        } else if (shift < 0) {
+            for (auto it = bids_.lower_bound(mid_ + shift); it != bids_.end();) { changes.push_back({BookSide::Bid, it->first, 0}); it = bids_.erase(it); }
+        }
+        mid_ += shift;
+        const std::size_t count = 5 + rng_() % 30;
+        for (std::size_t i = 0; i < count; ++i) {
+            const bool bid = rng_() & 1U;
+            const std::int64_t distance = rng_() % 20 == 0 ? static_cast<std::int64_t>(rng_() % 1000) : static_cast<std::int64_t>(rng_() % 50);
+            const std::int64_t price = bid ? mid_ - 1 - distance : mid_ + 1 + distance;
+            const std::int64_t size = rng_() % 5 == 0 ? 0 : quantity();
+            auto& side = bid ? bids_ : asks_;
+            if (size == 0) side.erase(price);
+            else side[price] = size;
+            changes.push_back({bid ? BookSide::Bid : BookSide::Ask, price, size});
+        }
+        const auto first = last_id_ + 1;
+        last_id_ += static_cast<std::int64_t>(changes.size());
+        std::string out = "{\"e\":\"depthUpdate\",\"E\":" + std::to_string(1700000000000 + last_id_) +
+                          ",\"s\":\"BTCUSDT\",\"U\":" + std::to_string(first) + ",\"u\":" + std::to_string(last_id_) + ",\"b\":";
+        append_changes(out, changes, BookSide::Bid);
+        out += ",\"a\":";
+        append_changes(out, changes, BookSide::Ask);
+        out += '}';
+        return out;
+    }
+
+    // Drops the next diff, as a lost websocket frame would.
+    void skip() {
+        std::vector<Change> lost;
+        diff(lost);
+    }
+
+    bool matches(const sentum::market::OrderBook& book) const {
+        return matches(book, BookSide::Bid, bids_.rbegin(), bids_.rend()) && matches(book, BookSide::Ask, asks_.begin(), asks_.end());
+    }
+
+private:
+    std::int64_t quantity() { return 1 + static_cast<std::int64_t>(rng_() % 200000); }
+
+    static void append_level(std::string& out, std::int64_t price, std::int64_t quantity) {
+        char text[96];
+        std::snprintf(text, sizeof(text), "[\"%" PRId64 ".%02" PRId64 "000000\",\"%" PRId64 ".%05" PRId64 "000\"]",
+                      price / price_units, price % price_units, quantity / quantity_units, quantity % quantity_units);
+        out += text;
+    }
+
+    template <typename It>
+    static void append_levels(std::string& out, It begin, It end) {
+        out += '[';
+        for (auto it = begin; it != end; ++it) {
+            if (it != begin) out += ',';
+            append_level(out, it->first, it->second);
+        }
+        out += ']';
+    }
+
+    static void append_changes(std::string& out, const std::vector<Change>& changes, BookSide side) {
+        out += '[';
+        bool first = true;
+        for (const auto& change : changes) {
+            if (change.side != side) continue;
+            if (!first) out += ',';
+            append_level(out, change.price, change.quantity);
+            first = false;
+        }
+        out += ']';
+    }
+
+    template <typename It>
+    static bool matches(const sentum::market::OrderBook& book, BookSide side, It begin, It end) {
+        std::size_t n = 0;
+        for (auto it = begin; it != end; ++it, ++n) {
+            if (n >= book.depth(side)) return false;
+            const auto& level = book.level(side, n);
+            // The book's grid carries 8 decimals like the wire strings.
+            if (level.price.raw != it->first * 1000000 || level.quantity.raw != it->second * 1000) return false;
+        }
+        return n == book.depth(side);
+    }
+
+    std::mt19937_64 rng_{42};
+    std::int64_t mid_ = 6000000;
+    std::int64_t last_id_ = 1000;
+    std::map<std::int64_t, std::int64_t> bids_;
+    std::map<std::int64_t, std::int64_t> asks_;
+};
+
+// The same book on node-based ordered maps, the structure the flat vectors replace.
+class MapOrderBook {
+public:
+    void set_level(BookSide side, std::int64_t price, std::int64_t quantity) {
+        if (side == BookSide::Bid) set(bids_, price, quantity);
+        else set(asks_, price, quantity);
+    }
+    std::int64_t best_bid() const { return bids_.empty() ? 0 : bids_.begin()->first; }
+    std::int64_t best_ask() const { return asks_.empty() ? 0 : asks_.begin()->first; }
+
+private:
+    template <typename Map>
+    static void set(Map& side, std::int64_t price, std::int64_t quantity) {
+        if (quantity == 0) side.erase(price);
+        else side[price] = quantity;
+    }
+    std::map<std::int64_t, std::int64_t, std::greater<std::int64_t>> bids_;
+    std::map<std::int64_t, std::int64_t> asks_;
+};
+
+double seconds_since(std::chrono::steady_clock::time_point begin) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t diffs = argc > 1 ? static_cast<std::size_t>(std::stoull(argv[1])) : 200000;
+    const std::size_t levels = argc > 2 ? static_cast<std::size_t>(std::stoull(argv[2])) : 1000;
+    const std::string recording = argc > 3 ? argv[3] : "order_book_benchmark.depth.jsonl";
+    if (diffs < 4 || levels == 0) return 2;
+
+    // A recording as the collector writes it: diffs already flowing before the first
+    // snapshot, and a lost frame halfway that forces a resync from a later snapshot.
+    DepthGenerator generator(levels);
+    std::vector<std::string> lines;
+    std::vector<std::vector<Change>> parsed;
+    std::vector<Change> changes;
+    lines.push_back(generator.diff(changes));
+    const auto first_snapshot = generator.snapshot();
+    lines.push_back(generator.diff(changes));
+    lines.push_back(first_snapshot);
+    for (std::size_t i = 0; i < diffs; ++i) {
+        if (i == diffs / 2) {
+            generator.skip();
+            lines.push_back(generator.diff(changes));
+            lines.push_back(generator.diff(changes));
+            lines.push_back(generator.snapshot());
+        }
+        lines.push_back(generator.diff(changes));
+        parsed.push_back(changes);
+    }
+    {
+        std::FILE* file = std::fopen(recording.c_str(), "wb");
+        if (!file) return 2;
+        for (const auto& line : lines) { std::fwrite(line.data(), 1, line.size(), file); std::fputc('\n', file); }
+        std::fclose(file);
+    }
+
+    sentum::collector::DepthBook replayed;
+    sentum::collector::DepthReplayFeed feed(replayed);
+    if (!feed.replay_file(recording)) return 2;
+    bool valid = false;
+    replayed.with_book([&](const sentum::market::OrderBook& book) { valid = generator.matches(book) && !book.crossed(); });
+    const auto& stats = feed.stats();
+    std::remove(recording.c_str());
+
+    // Throughput per book: full diff path (parse, lock, sequence check, apply), then the
+    // level updates alone on the flat book and on std::map.
+    std::size_t level_updates = 0;
+    for (const auto& diff : parsed) level_updates += diff.size();
+
+    DepthGenerator timed_generator(levels);
+    std::vector<std::string> timed_lines;
+    timed_lines.reserve(diffs);
+    for (std::size_t i = 0; i < diffs; ++i) timed_lines.push_back(timed_generator.diff(changes));
+    sentum::collector::DepthBook timed;
+    timed.on_snapshot(DepthGenerator(levels).snapshot());
+    auto begin = std::chrono::steady_clock::now();
+    for (const auto& line : timed_lines) timed.on_diff(line);
+    const double diff_path = seconds_since(begin);
+    timed.with_book([&](const sentum::market::OrderBook& book) { valid = valid && timed_generator.matches(book); });
+
+    sentum::market::OrderBook flat(sentum::market::SymbolScales{{2, 1}, {5, 1}});
+    MapOrderBook tree;
+    // Both books start from the same full depth.
+    for (std::int64_t i = 0; i < static_cast<std::int64_t>(levels); ++i) {
+        flat.set_level(BookSide::Bid, sentum::market::Price{6000000 - 1 - i}, sentum::market::Qty{1});
+        flat.set_level(BookSide::Ask, sentum::market::Price{6000000 + 1 + i}, sentum::market::Qty{1});
+        tree.set_level(BookSide::Bid, 6000000 - 1 - i, 1);
+        tree.set_level(BookSide::Ask, 6000000 + 1 + i, 1);
+    }
+    begin = std::chrono::steady_clock::now();
+    for (const auto& diff : parsed)
+        for (const auto& change : diff) flat.set_level(change.side, sentum::market::Price{change.price}, sentum::market::Qty{change.quantity});
+    const double flat_apply = seconds_since(begin);
+    begin = std::chrono::steady_clock::now();
+    for (const auto& diff : parsed)
+        for (const auto& change : diff) tree.set_level(change.side, change.price, change.quantity);
+    const double tree_apply = seconds_since(begin);
+
+    constexpr std::size_t queries = 1000000;
+    double sink = 0.0;
+    begin = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < queries; ++i) sink += static_cast<double>(flat.level(BookSide::Ask, i % 10).price.raw);
+    const double level_query = seconds_since(begin);
+    begin = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < queries; ++i) sink += flat.cumulative_quantity(BookSide::Bid, 20);
+    const double depth_query = seconds_since(begin);
+    begin = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < queries; ++i) sink += flat.walk(BookSide::Ask, 25.0 + static_cast<double>(i % 8)).average_price;
+    const double walk_query = seconds_since(begin);
+    sink += static_cast<double>(tree.best_bid() + tree.best_ask());
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "diffs=" << diffs << " levels_per_side=" << levels << " level_updates=" << level_updates << '\n'
+              << "replay_applied=" << stats.applied << " replay_buffered=" << stats.buffered << " replay_stale=" << stats.stale
+              << " replay_resyncs=" << stats.resyncs << " snapshots_served=" << stats.snapshots_served
+              << " snapshots_skipped=" << stats.snapshots_skipped << " book_matches=" << (valid ? "true" : "false") << '\n'
+              << "diff_path_ns=" << diff_path * 1e9 / static_cast<double>(diffs) << '\n'
+              << "diffs_per_second=" << static_cast<double>(diffs) / diff_path << '\n'
+              << "flat_level_update_ns=" << flat_apply * 1e9 / static_cast<double>(level_updates) << '\n'
+              << "map_level_update_ns=" << tree_apply * 1e9 / static_cast<double>(level_updates) << '\n'
+              << "level_query_ns=" << level_query * 1e9 / queries << '\n'
+              << "depth20_query_ns=" << depth_query * 1e9 / queries << '\n'
+              << "walk_query_ns=" << walk_query * 1e9 / queries << '\n'
+              << "checksum=" << sink << '\n';
+    return valid && stats.invalid == 0 && stats.resyncs == 1 ? 0 : 1;
+}
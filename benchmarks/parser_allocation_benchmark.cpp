@@ -1,15 +1,51 @@
 #include <atomic>
+#include <chrono>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <iomanip>
 #include <iostream>
 #include <new>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include <sentum/collector/FastBinanceKlineParser.hpp>
 
 namespace {
 std::atomic<std::uint64_t> allocations{0};
+
+using sentum::collector::FastBinanceKlineParser;
+using sentum::collector::ParsedKline;
+
+std::string make_payload(std::size_t index) {
+    const auto symbol = "SYM" + std::to_string(index) + "USDT";
+    std::string lower = symbol;
+    for (auto& c : lower) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    const auto ts = std::to_string(1720000000000ULL + index * 1000ULL);
+    const auto price = std::to_string(100 + index % 90000) + "." + std::to_string(10000000 + index % 89999999);
+    return R"({"stream":")" + lower + R"(@kline_1s","data":{"e":"kline","E":)" + ts + R"(,"s":")" + symbol +
+           R"(","k":{"t":)" + ts + R"(,"T":)" + ts + R"(,"s":")" + symbol + R"(","i":"1s","f":1,"L":2,"o":")" + price +
+           R"(","c":")" + price + R"(","h":")" + price + R"(","l":")" + price +
+           R"(","v":"12.34560000","n":2,"x":true,"q":"741.00000000","V":"6.00000000","Q":"370.00000000","B":"0"}}})";
+}
+
+bool same(const ParsedKline& a, const ParsedKline& b) {
+    const auto close = [](double x, double y) { return std::fabs(x - y) <= 1e-9 * std::fabs(x); };
+    return a.symbol == b.symbol && a.timestamp == b.timestamp && a.closed == b.closed && close(a.open, b.open) &&
+           close(a.high, b.high) && close(a.low, b.low) && close(a.close, b.close) && close(a.volume, b.volume);
+}
+
+template <typename Fn>
+double ns_per_message(std::size_t iterations, std::size_t messages, Fn&& fn) {
+    const auto begin = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        if (!fn()) std::exit(3);
+    }
+    const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+    return elapsed / static_cast<double>(iterations * messages);
+}
 }
 
 void* operator new(std::size_t size) {
@@ -29,20 +65,56 @@ void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
 void operator delete[](void* ptr) noexcept { std::free(ptr); }
 void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
 
-int main() {
-    const std::string payload = R"({"stream":"btcusdt@kline_1s","data":{"e":"kline","E":1720000000000,"s":"BTCUSDT","k":{"t":1720000000000,"T":1720000000999,"s":"BTCUSDT","i":"1s","f":1,"L":2,"o":"60123.12000000","c":"60125.34000000","h":"60130.00000000","l":"60120.00000000","v":"12.34560000","x":true}}})";
+int main(int argc, char** argv) {
+    const std::size_t rounds = argc > 1 ? static_cast<std::size_t>(std::stoull(argv[1])) : 2000;
+    constexpr std::size_t messages = 512;
+    if (rounds == 0) return 2;
 
-    sentum::collector::ParsedKline parsed;
-    if (!sentum::collector::FastBinanceKlineParser::parse(payload, parsed)) return 2;
+    std::vector<std::string> payloads;
+    std::vector<std::string_view> views;
+    payloads.reserve(messages);
+    views.reserve(messages);
+    for (std::size_t i = 0; i < messages; ++i) {
+        payloads.push_back(make_payload(i * 7919));
+        views.push_back(payloads.back());
+    }
+    std::vector<ParsedKline> batch(messages);
 
-    allocations.store(0, std::memory_order_relaxed);
-    constexpr std::size_t iterations = 1000000;
-    for (std::size_t i = 0; i < iterations; ++i) {
-        if (!sentum::collector::FastBinanceKlineParser::parse(payload, parsed)) return 3;
+    for (std::size_t i = 0; i < messages; ++i) {
+        ParsedKline reference, fast;
+        if (!FastBinanceKlineParser::parse_scalar(views[i], reference) || !FastBinanceKlineParser::parse(views[i], fast)) return 2;
+        if (!same(reference, fast)) {
+            std::cerr << "parser mismatch: " << views[i] << '\n';
+            return 4;
+        }
     }
+
+    allocations.store(0, std::memory_order_relaxed);
+    ParsedKline parsed;
+    std::size_t cursor = 0;
+    const auto scalar_ns = ns_per_message(rounds * messages, 1, [&] {
+        cursor = cursor + 1 == messages ? 0 : cursor + 1;
+        return FastBinanceKlineParser::parse_scalar(views[cursor], parsed);
+    });
+    const auto single_pass_ns = ns_per_message(rounds * messages, 1, [&] {
+        cursor = cursor + 1 == messages ? 0 : cursor + 1;
+        return FastBinanceKlineParser::parse(views[cursor], parsed);
+    });
+    const auto batch_ns = ns_per_message(rounds, messages, [&] {
+        return FastBinanceKlineParser::parse_batch(views.data(), messages, batch.data()) == messages;
+    });
     const auto count = allocations.load(std::memory_order_relaxed);
-    std::cout << "iterations=" << iterations << '\n'
+    const auto iterations = rounds * messages * 3;
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "backend=" << FastBinanceKlineParser::backend() << '\n'
+              << "messages=" << rounds * messages << '\n'
+              << "scalar_ns_per_message=" << scalar_ns << '\n'
+              << "single_pass_ns_per_message=" << single_pass_ns << '\n'
+              << "batch_ns_per_message=" << batch_ns << '\n'
+              << "speedup=" << scalar_ns / single_pass_ns << "x\n"
+              << std::setprecision(6)
               << "allocations=" << count << '\n'
-              << "allocations_per_parse=" << static_cast<double>(count) / iterations << '\n';
+              << "allocations_per_parse=" << static_cast<double>(count) / static_cast<double>(iterations) << '\n';
     return count == 0 ? 0 : 1;
 }
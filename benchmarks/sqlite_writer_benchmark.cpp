@@ -0,0 +1,373 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <sqlite3.h>
+
+#include <sentum/market/SymbolInterner.hpp>
+#include <sentum/utils/Database.hpp>
+
+namespace {
+
+// The writer before kline schema 2: a text-keyed rowid table, a secondary index over its
+// own primary key and the symbol bound as SQLITE_TRANSIENT text on every row.
+class LegacyKlineWriter {
+public:
+    explicit LegacyKlineWriter(const std::string& path) {
+        if (sqlite3_open_v2(path.c_str(), &db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX, nullptr) != SQLITE_OK)
+            throw std::runtime_error("Failed to open " + path);
+        exec("PRAGMA journal_mode=WAL; PRAGMA synchronous=NORMAL; PRAGMA temp_store=MEMORY; PRAGMA wal_autocheckpoint=1000;");
+        exec("CREATE TABLE IF NOT EXISTS klines(symbol TEXT NOT NULL,timestamp INTEGER NOT NULL,open REAL,high REAL,low REAL,close REAL,volume REAL,PRIMARY KEY(symbol,timestamp));");
+        exec("CREATE INDEX IF NOT EXISTS idx_klines_symbol_ts ON klines(symbol,timestamp DESC);");
+        const char* sql =
+            "INSERT INTO klines(symbol,timestamp,open,high,low,close,volume) VALUES(?,?,?,?,?,?,?) "
+            "ON CONFLICT(symbol,timestamp) DO UPDATE SET open=excluded.open,high=excluded.high,"
+            "low=excluded.low,close=excluded.close,volume=excluded.volume;";
+        if (sqlite3_prepare_v2(db, sql, -1, &upsert, nullptr) != SQLITE_OK) throw std::runtime_error(sqlite3_errmsg(db));
+    }
+    ~LegacyKlineWriter() {
+        sqlite3_finalize(upsert);
+        sqlite3_close(db);
+    }
+
+    bool save_kline_batch(const std::vector<std::pair<const std::string*, Kline>>& batch) {
+        if (sqlite3_exec(db, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) != SQLITE_OK) return false;
+        for (const auto& [symbol, kline] : batch) {
+            sqlite3_reset(upsert);
+            sqlite3_clear_bindings(upsert);
+            sqlite3_bind_text(upsert, 1, symbol->c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_bind_int64(upsert, 2, kline.timestamp);
+            sqlite3_bind_double(upsert, 3, kline.open);
+            sqlite3_bind_double(upsert, 4, kline.high);
+            sqlite3_bind_double(upsert, 5, kline.low);
+            sqlite3_bind_double(upsert, 6, kline.close);
+            sqlite3_bind_double(upsert, 7, kline.volume);
+            if (sqlite3_step(upsert) != SQLITE_DONE) {
+                sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+                return false;
+            }
+        }
+        return sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr) == SQLITE_OK;
+    }
+
+private:
+    void exec(const char* sql) {
+        if (sqlite3_exec(db, sql, nullptr, nullptr, nullptr) != SQLITE_OK) throw std::runtime_error(sqlite3_errmsg(db));
+    }
+
+    sqlite3* db = nullptr;
+    sqlite3_stmt* upsert = nullptr;
+};
+
+// Folds the WAL into the database so the file size is the table's.
+std::uintmax_t checkpointed_bytes(const std::string& path) {
+    sqlite3* db = nullptr;
+    sqlite3_open(path.c_str(), &db);
+    sqlite3_exec(db, "PRAGMA wal_checkpoint(TRUNCATE);", nullptr, nullptr, nullptr);
+    sqlite3_close(db);
+    std::uintmax_t total = 0;
+    for (const auto* suffix : {"", "-wal"}) {
+        std::error_code ec;
+        const auto size = std::filesystem::file_size(path + suffix, ec);
+        if (!ec) total += size;
+    }
+    return total;
+}
+
+void remove_database(const std::string& path) {
+    for (const auto* suffix : {"", "-wal", "-shm"}) std::filesystem::remove(path + suffix);
+}
+
+std::string symbol_name(std::size_t index) {
+    std::string base;
+    do { base.push_back(static_cast<char>('a' + index % 26)); index /= 26; } while (index > 0);
+    while (base.size() < 3) base.push_back('x');
+    return base + "usdt";
+}
+
+struct Row {
+    std::size_t symbol = 0;
+    Kline kline;
+};
+
+// One closed 1s kline per symbol per second, in the order the collector's writer sees
+// them: every symbol of a second before the next second.
+std::vector<Row> make_rows(std::size_t symbols, std::size_t seconds) {
+    std::mt19937_64 rng(7);
+    std::normal_distribution<double> step(0.0, 0.0005);
+    std::uniform_real_distribution<double> volume(0.0, 50.0);
+    std::vector<double> price(symbols);
+    for (std::size_t s = 0; s < symbols; ++s) price[s] = 1.0 + static_cast<double>(s % 97);
+    std::vector<Row> rows;
+    rows.reserve(symbols * seconds);
+    const std::int64_t start_ms = 1767225600000;
+    for (std::size_t t = 0; t < seconds; ++t) {
+        for (std::size_t s = 0; s < symbols; ++s) {
+            const double open = price[s];
+            const double close = open * std::exp(step(rng));
+            price[s] = close;
+            rows.push_back({s, {start_ms + static_cast<std::int64_t>(t) * 1000, open, std::max(open, close) * 1.0001,
+                                std::min(open, close) * 0.9999, close, volume(rng)}});
+        }
+    }
+    return rows;
+}
+
+template <typename Fn>
+double seconds_for(Fn&& fn) {
+    const auto begin = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+// Warm-start shaped read: the newest `bars` klines of every symbol.
+double warm_load_ms(const std::string& path, const std::vector<std::string>& names, int bars) {
+    KlineReader reader(path);
+    std::vector<Kline> out;
+    std::size_t loaded = 0;
+    const double seconds = seconds_for([&] {
+        for (const auto& name : names) if (reader.load_latest(name, 0, bars, out)) loaded += out.size();
+    });
+    if (loaded != names.size() * static_cast<std::size_t>(bars)) throw std::runtime_error("warm load returned " + std::to_string(loaded) + " rows");
+    return seconds * 1e3;
+}
+
+struct BurstResult {
+    double p99_ms = 0.0;
+    double max_ms = 0.0;
+    double max_commit_ms = 0.0;
+    std::uint64_t checkpoints = 0;
+};
+
+double percentile(std::vector<double> values, double q) {
+    std::sort(values.begin(), values.end());
+    return values[std::min(values.size() - 1, static_cast<std::size_t>(q * static_cast<double>(values.size())))];
+}
+
+// Top-of-second bursts: every symbol's kline closes at once and the writer drains them.
+// `adaptive` runs the collector's writer as it is now (AIMD batch cap, WAL checkpointed
+// by a separate connection every second); otherwise fixed 256-row batches
+// with SQLite's autocheckpoint running inside whichever commit crosses 1000 pages.
+// Reports how long each burst took to reach disk.
+BurstResult burst_drain(const std::string& path, std::size_t symbols, std::size_t bursts, std::chrono::milliseconds tick, bool adaptive) {
+    remove_database(path);
+    std::vector<std::string> names;
+    std::vector<std::string> upper;
+    for (std::size_t s = 0; s < symbols; ++s) {
+        names.push_back(symbol_name(s));
+        upper.push_back(names.back());
+        for (auto& c : upper.back()) c = static_cast<char>(c - 'a' + 'A');
+    }
+    Database db(path);
+    const auto ids = sentum::market::SymbolInterner::global().intern_all(upper);
+    for (std::size_t s = 0; s < symbols; ++s) if (!db.register_symbol(ids[s], names[s])) throw std::runtime_error("register failed");
+    std::unique_ptr<WalCheckpointer> checkpointer;
+    std::thread checkpoint_thread;
+    std::atomic<bool> running{true};
+    std::atomic<std::uint64_t> checkpoints{0};
+    if (adaptive) {
+        checkpointer = std::make_unique<WalCheckpointer>(path);
+        db.set_wal_autocheckpoint(0);
+        checkpoint_thread = std::thread([&] {
+            while (running.load()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+                if (checkpointer->checkpoint().ok) checkpoints.fetch_add(1);
+            }
+        });
+    }
+
+    std::vector<double> drain_ms;
+    BurstResult result;
+    std::vector<KlineBatchItem> burst(symbols);
+    std::vector<KlineBatchItem> batch;
+    std::size_t batch_limit = 256;
+    const std::int64_t start_ms = 1767225600000;
+    auto next = std::chrono::steady_clock::now();
+    for (std::size_t b = 0; b < bursts; ++b) {
+        std::this_thread::sleep_until(next);
+        next += tick;
+        for (std::size_t s = 0; s < symbols; ++s) {
+            const double price = 1.0 + static_cast<double>((s + b) % 97);
+            burst[s] = {ids[s], {start_ms + static_cast<std::int64_t>(b) * 1000, price, price * 1.001, price * 0.999, price, 1.0}};
+        }
+        const auto begin = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < burst.size();) {
+            const std::size_t end = std::min(burst.size(), i + batch_limit);
+            batch.assign(burst.begin() + static_cast<std::ptrdiff_t>(i), burst.begin() + static_cast<std::ptrdiff_t>(end));
+            i = end;
+            const auto commit_begin = std::chrono::steady_clock::now();
+            if (!db.save_kline_batch(batch)) throw std::runtime_error("burst batch failed");
+            const auto commit = std::chrono::steady_clock::now() - commit_begin;
+            result.max_commit_ms = std::max(result.max_commit_ms, std::chrono::duration<double, std::milli>(commit).count());
+            if (!adaptive) continue;
+            if (commit > std::chrono::milliseconds(10)) batch_limit = std::max<std::size_t>(64, batch_limit / 2);
+            else if (burst.size() - i > batch_limit) batch_limit = std::min<std::size_t>(4096, batch_limit + 64);
+        }
+        drain_ms.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count());
+    }
+    running = false;
+    if (checkpoint_thread.joinable()) checkpoint_thread.join();
+    result.p99_ms = percentile(drain_ms, 0.99);
+    result.max_ms = *std::max_element(drain_ms.begin(), drain_ms.end());
+    result.checkpoints = checkpoints.load();
+    return result;
+}
+
+}
+
+int main(int argc, char** argv) {
+    const std::size_t symbols = argc > 1 ? static_cast<std::size_t>(std::stoull(argv[1])) : 300;
+    const std::size_t seconds = argc > 2 ? static_cast<std::size_t>(std::stoull(argv[2])) : 2000;
+    const std::string dir = argc > 3 ? argv[3] : std::filesystem::temp_directory_path().string();
+    if (symbols == 0 || seconds < 600) return 2;
+    // The collector's writer batch.
+    constexpr std::size_t batch_size = 256;
+    constexpr int warm_bars = 600;
+
+    std::vector<std::string> names;
+    std::vector<std::string> upper;
+    for (std::size_t s = 0; s < symbols; ++s) {
+        names.push_back(symbol_name(s));
+        upper.push_back(names.back());
+        for (auto& c : upper.back()) c = static_cast<char>(c - 'a' + 'A');
+    }
+    const auto rows = make_rows(symbols, seconds);
+    const std::string legacy_path = dir + "/sentum_writer_bench_v1.sqlite3";
+    const std::string current_path = dir + "/sentum_writer_bench_v2.sqlite3";
+    remove_database(legacy_path);
+    remove_database(current_path);
+
+    double legacy_s = 0.0;
+    {
+        LegacyKlineWriter writer(legacy_path);
+        std::vector<std::pair<const std::string*, Kline>> batch;
+        batch.reserve(batch_size);
+        legacy_s = seconds_for([&] {
+            for (std::size_t i = 0; i < rows.size(); i += batch_size) {
+                batch.clear();
+                for (std::size_t j = i; j < std::min(rows.size(), i + batch_size); ++j) batch.emplace_back(&names[rows[j].symbol], rows[j].kline);
+                if (!writer.save_kline_batch(batch)) throw std::runtime_error("legacy batch failed");
+            }
+        });
+    }
+
+    double current_s = 0.0;
+    {
+        Database db(current_path);
+        const auto ids = sentum::market::SymbolInterner::global().intern_all(upper);
+        for (std::size_t s = 0; s < symbols; ++s) if (!db.register_symbol(ids[s], names[s])) return 3;
+        std::vector<KlineBatchItem> batch;
+        batch.reserve(batch_size);
+        current_s = seconds_for([&] {
+            for (std::size_t i = 0; i < rows.size(); i += batch_size) {
+                batch.clear();
+                for (std::size_t j = i; j < std::min(rows.size(), i + batch_size); ++j) batch.push_back({ids[rows[j].symbol], rows[j].kline});
+                if (!db.save_kline_batch(batch)) throw std::runtime_error("batch failed");
+            }
+        });
+    }
+
+    const auto legacy_bytes = checkpointed_bytes(legacy_path);
+    const auto current_bytes = checkpointed_bytes(current_path);
+    const double legacy_warm_ms = warm_load_ms(legacy_path, names, warm_bars);
+    const double current_warm_ms = warm_load_ms(current_path, names, warm_bars);
+    const double n = static_cast<double>(rows.size());
+
+    // Converts the legacy file in place, as sentum_migrate does, then reclaims its space.
+    KlineSchemaMigration migration;
+    const double migrate_s = seconds_for([&] { migration = Database::migrate(legacy_path); });
+    if (migration.rows != rows.size()) return 4;
+    {
+        sqlite3* db = nullptr;
+        sqlite3_open(legacy_path.c_str(), &db);
+        sqlite3_exec(db, "VACUUM;", nullptr, nullptr, nullptr);
+        sqlite3_close(db);
+    }
+    const auto migrated_bytes = checkpointed_bytes(legacy_path);
+
+    // Backfill: every symbol's history in 1000-row REST pages, fetched round-robin across
+    // symbols, through the schema 1 writer, Database::save_klines and KlineBulkImport.
+    enum class Backfill { Schema1, SaveKlines, Bulk };
+    const auto backfill = [&](Backfill mode) {
+        const auto& path = mode == Backfill::Schema1 ? legacy_path : current_path;
+        remove_database(path);
+        std::vector<Kline> page;
+        page.reserve(1000);
+        const auto each_page = [&](auto&& sink) {
+            for (std::size_t t = 0; t < seconds; t += 1000) {
+                for (std::size_t s = 0; s < symbols; ++s) {
+                    page.clear();
+                    for (std::size_t u = t; u < std::min(seconds, t + 1000); ++u) page.push_back(rows[u * symbols + s].kline);
+                    if (!sink(names[s], page)) throw std::runtime_error("backfill page failed");
+                }
+            }
+        };
+        if (mode == Backfill::Schema1) {
+            LegacyKlineWriter writer(path);
+            std::vector<std::pair<const std::string*, Kline>> batch;
+            return seconds_for([&] {
+                each_page([&](const std::string& name, const std::vector<Kline>& klines) {
+                    batch.clear();
+                    for (const auto& kline : klines) batch.emplace_back(&name, kline);
+                    return writer.save_kline_batch(batch);
+                });
+            });
+        }
+        Database db(path);
+        return seconds_for([&] {
+            if (mode == Backfill::SaveKlines) {
+                each_page([&](const std::string& name, const std::vector<Kline>& klines) { return db.save_klines(name, klines); });
+                return;
+            }
+            KlineBulkImport import(db);
+            each_page([&](const std::string& name, const std::vector<Kline>& klines) { return import.append(name, klines); });
+            if (!import.finish()) throw std::runtime_error("bulk merge failed");
+        });
+    };
+    const double schema1_backfill_s = backfill(Backfill::Schema1);
+    const double save_klines_s = backfill(Backfill::SaveKlines);
+    const double bulk_s = backfill(Backfill::Bulk);
+    if (warm_load_ms(current_path, names, warm_bars) <= 0.0) return 5;
+
+    // 2,000 symbols closing together every 250 ms: four times the live rate, so a
+    // checkpoint lands inside a burst often enough to show in the tail.
+    constexpr std::size_t burst_symbols = 2000;
+    constexpr std::size_t bursts = 240;
+    const auto fixed = burst_drain(current_path, burst_symbols, bursts, std::chrono::milliseconds(250), false);
+    const auto adaptive = burst_drain(current_path, burst_symbols, bursts, std::chrono::milliseconds(250), true);
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "symbols=" << symbols << " rows=" << rows.size() << " batch=" << batch_size << '\n'
+              << "schema1 upserts_per_s=" << n / legacy_s << " bytes=" << legacy_bytes
+              << " bytes_per_row=" << static_cast<double>(legacy_bytes) / n << " warm_load_ms=" << legacy_warm_ms << '\n'
+              << "schema2 upserts_per_s=" << n / current_s << " bytes=" << current_bytes
+              << " bytes_per_row=" << static_cast<double>(current_bytes) / n << " warm_load_ms=" << current_warm_ms << '\n'
+              << std::setprecision(2) << "speedup=" << legacy_s / current_s << "x size_ratio="
+              << static_cast<double>(legacy_bytes) / static_cast<double>(current_bytes) << "x\n"
+              << std::setprecision(1) << "migrate rows_per_s=" << n / migrate_s << " chunks=" << migration.chunks
+              << " bytes_after_vacuum=" << migrated_bytes << '\n'
+              << "backfill schema1_rows_per_s=" << n / schema1_backfill_s << " save_klines_rows_per_s=" << n / save_klines_s
+              << " bulk_import_rows_per_s=" << n / bulk_s << std::setprecision(2) << " speedup_vs_schema1="
+              << schema1_backfill_s / bulk_s << "x speedup_vs_save_klines=" << save_klines_s / bulk_s << "x\n"
+              << "burst symbols=" << burst_symbols << " bursts=" << bursts << '\n'
+              << "burst autocheckpoint drain_p99_ms=" << fixed.p99_ms << " drain_max_ms=" << fixed.max_ms
+              << " commit_max_ms=" << fixed.max_commit_ms << '\n'
+              << "burst checkpointer drain_p99_ms=" << adaptive.p99_ms << " drain_max_ms=" << adaptive.max_ms
+              << " commit_max_ms=" << adaptive.max_commit_ms << " checkpoints=" << adaptive.checkpoints << '\n';
+    remove_database(legacy_path);
+    remove_database(current_path);
+    return 0;
+}
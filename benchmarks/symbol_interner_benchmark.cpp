@@ -0,0 +1,121 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <sentum/market/SymbolId.hpp>
+#include <sentum/market/SymbolInterner.hpp>
+
+namespace {
+
+// The collector's previous resolver: FNV-1a over a case-folded symbol, a hash-map probe
+// and a case-insensitive character compare against the canonical lowercase name.
+class LegacyResolver {
+public:
+    explicit LegacyResolver(const std::vector<std::string>& symbols) {
+        canonical_.reserve(symbols.size());
+        for (std::size_t i = 0; i < symbols.size(); ++i) {
+            std::string lower = symbols[i];
+            for (auto& c : lower) if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+            canonical_.push_back(std::move(lower));
+            by_hash_.emplace(sentum::market::symbol_hash(symbols[i]), i);
+        }
+    }
+
+    sentum::market::SymbolId find(std::string_view symbol) const noexcept {
+        const auto it = by_hash_.find(sentum::market::symbol_hash(symbol));
+        if (it == by_hash_.end()) return sentum::market::kInvalidSymbolId;
+        const auto& canonical = canonical_[it->second];
+        if (canonical.size() != symbol.size()) return sentum::market::kInvalidSymbolId;
+        for (std::size_t i = 0; i < symbol.size(); ++i) {
+            char c = symbol[i]; if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+            if (canonical[i] != c) return sentum::market::kInvalidSymbolId;
+        }
+        return static_cast<sentum::market::SymbolId>(it->second + 1);
+    }
+
+private:
+    std::vector<std::string> canonical_;
+    std::unordered_map<std::uint64_t, std::size_t> by_hash_;
+};
+
+std::vector<std::string> make_universe(std::size_t count, std::mt19937_64& rng) {
+    static const char* quotes[] = {"USDT", "USDC", "BTC", "FDUSD"};
+    std::uniform_int_distribution<int> letter('A', 'Z'), length(2, 8), quote(0, 3);
+    std::unordered_set<std::string> seen;
+    std::vector<std::string> symbols;
+    while (symbols.size() < count) {
+        std::string base;
+        for (int i = length(rng); i > 0; --i) base.push_back(static_cast<char>(letter(rng)));
+        auto symbol = base + quotes[quote(rng)];
+        if (seen.insert(symbol).second) symbols.push_back(std::move(symbol));
+    }
+    return symbols;
+}
+
+template <typename Fn>
+double ns_per_lookup(const std::vector<std::string_view>& lookups, std::size_t rounds, std::uint64_t& checksum, Fn&& find) {
+    const auto begin = std::chrono::steady_clock::now();
+    for (std::size_t r = 0; r < rounds; ++r)
+        for (const auto& symbol : lookups) checksum += find(symbol);
+    const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+    return elapsed / static_cast<double>(lookups.size() * rounds);
+}
+
+}
+
+int main(int argc, char** argv) {
+    const std::size_t rounds = argc > 1 ? static_cast<std::size_t>(std::stoull(argv[1])) : 200;
+    if (rounds == 0) return 2;
+    std::mt19937_64 rng(42);
+
+    std::cout << std::fixed << std::setprecision(1);
+    for (const std::size_t count : {500, 2000, 10000}) {
+        const auto universe = make_universe(count, rng);
+        LegacyResolver legacy(universe);
+        sentum::market::SymbolInterner interner;
+        const auto build_begin = std::chrono::steady_clock::now();
+        const auto ids = interner.intern_all(universe);
+        const auto build_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - build_begin).count();
+
+        for (std::size_t i = 0; i < universe.size(); ++i) {
+            if (interner.find(universe[i]) != ids[i] || legacy.find(universe[i]) == sentum::market::kInvalidSymbolId) return 3;
+        }
+        if (interner.find("NOTASYMBOL") != sentum::market::kInvalidSymbolId) return 4;
+
+        // One symbol at a time, as listings and recovered spill rows arrive.
+        sentum::market::SymbolInterner incremental;
+        const auto incremental_begin = std::chrono::steady_clock::now();
+        for (const auto& symbol : universe) incremental.intern(symbol);
+        const auto incremental_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - incremental_begin).count();
+        for (std::size_t i = 0; i < universe.size(); ++i) {
+            if (incremental.find(universe[i]) != ids[i] || incremental.name(ids[i]) != universe[i]) return 6;
+        }
+
+        // Uniformly random message order, as seen by the collector under a busy universe.
+        std::vector<std::string_view> lookups;
+        lookups.reserve(50000);
+        std::uniform_int_distribution<std::size_t> pick(0, universe.size() - 1);
+        for (std::size_t i = 0; i < 50000; ++i) lookups.emplace_back(universe[pick(rng)]);
+
+        std::uint64_t legacy_sum = 0, interner_sum = 0;
+        const auto legacy_ns = ns_per_lookup(lookups, rounds, legacy_sum, [&](std::string_view s) { return legacy.find(s); });
+        const auto interner_ns = ns_per_lookup(lookups, rounds, interner_sum, [&](std::string_view s) { return interner.find(s); });
+        if (legacy_sum == 0 || interner_sum == 0) return 5;
+
+        std::cout << "symbols=" << count
+                  << " build_ms=" << build_ms
+                  << " incremental_ms=" << incremental_ms
+                  << " legacy_ns_per_lookup=" << legacy_ns
+                  << " interner_ns_per_lookup=" << interner_ns
+                  << " speedup=" << legacy_ns / interner_ns << "x\n";
+    }
+    return 0;
+}
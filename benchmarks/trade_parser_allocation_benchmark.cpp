@@ -0,0 +1,177 @@
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+#include <sentum/collector/FastBinanceAggTradeParser.hpp>
+#include <sentum/collector/FastBinanceBookTickerParser.hpp>
+#include <sentum/collector/FastBinanceTradeParser.hpp>
+
+namespace {
+std::atomic<std::uint64_t> allocations{0};
+
+using sentum::collector::FastBinanceAggTradeParser;
+using sentum::collector::FastBinanceBookTickerParser;
+using sentum::collector::FastBinanceTradeParser;
+using sentum::collector::ParsedAggTrade;
+using sentum::collector::ParsedBookTicker;
+using sentum::collector::ParsedTrade;
+
+std::string make_payload(std::size_t index) {
+    const auto time = std::to_string(1720000000000ULL + index);
+    const auto price = std::to_string(100 + index % 90000) + "." + std::to_string(10000000 + index % 89999999);
+    return R"({"e":"trade","E":)" + time + R"(,"s":"BTCUSDT","t":)" + std::to_string(3000000000ULL + index) +
+           R"(,"p":")" + price + R"(","q":"0.00)" + std::to_string(100 + index % 900) + R"(00","T":)" + time +
+           R"(,"m":)" + (index % 2 ? "true" : "false") + R"(,"M":true})";
+}
+
+// Combined-stream envelopes, as the collector receives them.
+std::string make_agg_trade_payload(std::size_t index) {
+    const auto time = std::to_string(1720000000000ULL + index);
+    const auto price = std::to_string(100 + index % 90000) + "." + std::to_string(10000000 + index % 89999999);
+    return R"({"stream":"btcusdt@aggTrade","data":{"e":"aggTrade","E":)" + time + R"(,"s":"BTCUSDT","a":)" +
+           std::to_string(2000000000ULL + index) + R"(,"p":")" + price + R"(","q":"0.00)" + std::to_string(100 + index % 900) +
+           R"(00","f":100,"l":105,"T":)" + time + R"(,"m":)" + (index % 2 ? "true" : "false") + R"(,"M":true}})";
+}
+
+std::string make_book_ticker_payload(std::size_t index) {
+    const auto bid = std::to_string(100 + index % 90000) + "." + std::to_string(10000000 + index % 89999999);
+    const auto ask = std::to_string(100 + index % 90000) + "." + std::to_string(10000001 + index % 89999999);
+    return R"({"stream":"btcusdt@bookTicker","data":{"u":)" + std::to_string(400900217ULL + index) + R"(,"s":"BTCUSDT","b":")" +
+           bid + R"(","B":"31.)" + std::to_string(100 + index % 900) + R"(","a":")" + ask + R"(","A":"40.66000000"}})";
+}
+
+template <typename Fn>
+double ns_per_message(std::size_t iterations, Fn&& fn) {
+    const auto begin = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        if (!fn()) std::exit(3);
+    }
+    const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+    return elapsed / static_cast<double>(iterations);
+}
+}
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+int main(int argc, char** argv) {
+    const std::size_t iterations = argc > 1 ? static_cast<std::size_t>(std::stoull(argv[1])) : 1000000;
+    constexpr std::size_t messages = 512;
+    if (iterations == 0) return 2;
+
+    std::vector<std::string> payloads;
+    payloads.reserve(messages);
+    for (std::size_t i = 0; i < messages; ++i) payloads.push_back(make_payload(i * 7919));
+
+    for (const auto& payload : payloads) {
+        ParsedTrade trade;
+        if (!FastBinanceTradeParser::parse(payload, trade)) return 2;
+        const auto j = nlohmann::json::parse(payload);
+        if (trade.price != std::stod(j["p"].get<std::string>()) || trade.quantity != std::stod(j["q"].get<std::string>()) ||
+            trade.trade_id != j["t"].get<std::int64_t>() || trade.event_time != j["E"].get<std::int64_t>() ||
+            trade.buyer_maker != j["m"].get<bool>() || trade.symbol != j["s"].get<std::string>()) {
+            std::cerr << "parser mismatch: " << payload << '\n';
+            return 4;
+        }
+    }
+
+    std::size_t cursor = 0;
+    double sink = 0.0;
+    const std::size_t dom_iterations = std::max<std::size_t>(1, iterations / 20);
+    allocations.store(0, std::memory_order_relaxed);
+    const auto dom_ns = ns_per_message(dom_iterations, [&] {
+        cursor = cursor + 1 == messages ? 0 : cursor + 1;
+        const auto j = nlohmann::json::parse(payloads[cursor]);
+        sink += std::stod(j["p"].get<std::string>());
+        return true;
+    });
+    const auto dom_allocations = allocations.load(std::memory_order_relaxed);
+
+    ParsedTrade trade;
+    allocations.store(0, std::memory_order_relaxed);
+    const auto fast_ns = ns_per_message(iterations, [&] {
+        cursor = cursor + 1 == messages ? 0 : cursor + 1;
+        if (!FastBinanceTradeParser::parse(payloads[cursor], trade)) return false;
+        sink += trade.price;
+        return true;
+    });
+    const auto count = allocations.load(std::memory_order_relaxed);
+
+    std::vector<std::string> agg_payloads, book_payloads;
+    for (std::size_t i = 0; i < messages; ++i) {
+        agg_payloads.push_back(make_agg_trade_payload(i * 7919));
+        book_payloads.push_back(make_book_ticker_payload(i * 7919));
+    }
+    for (std::size_t i = 0; i < messages; ++i) {
+        ParsedAggTrade agg;
+        ParsedBookTicker book;
+        if (!FastBinanceAggTradeParser::parse(agg_payloads[i], agg) || !FastBinanceBookTickerParser::parse(book_payloads[i], book)) return 2;
+        const auto a = nlohmann::json::parse(agg_payloads[i])["data"];
+        const auto b = nlohmann::json::parse(book_payloads[i])["data"];
+        if (agg.price != std::stod(a["p"].get<std::string>()) || agg.quantity != std::stod(a["q"].get<std::string>()) ||
+            agg.aggregate_id != a["a"].get<std::int64_t>() || agg.trade_time != a["T"].get<std::int64_t>() ||
+            agg.buyer_maker != a["m"].get<bool>() || agg.symbol != a["s"].get<std::string>() ||
+            book.bid_price != std::stod(b["b"].get<std::string>()) || book.bid_quantity != std::stod(b["B"].get<std::string>()) ||
+            book.ask_price != std::stod(b["a"].get<std::string>()) || book.ask_quantity != std::stod(b["A"].get<std::string>()) ||
+            book.update_id != b["u"].get<std::int64_t>() || book.symbol != b["s"].get<std::string>()) {
+            std::cerr << "parser mismatch: " << agg_payloads[i] << ' ' << book_payloads[i] << '\n';
+            return 4;
+        }
+    }
+
+    ParsedAggTrade agg;
+    ParsedBookTicker book;
+    allocations.store(0, std::memory_order_relaxed);
+    const auto agg_ns = ns_per_message(iterations, [&] {
+        cursor = cursor + 1 == messages ? 0 : cursor + 1;
+        if (!FastBinanceAggTradeParser::parse(agg_payloads[cursor], agg)) return false;
+        sink += agg.price;
+        return true;
+    });
+    const auto book_ns = ns_per_message(iterations, [&] {
+        cursor = cursor + 1 == messages ? 0 : cursor + 1;
+        if (!FastBinanceBookTickerParser::parse(book_payloads[cursor], book)) return false;
+        sink += book.bid_price;
+        return true;
+    });
+    const auto feed_count = allocations.load(std::memory_order_relaxed);
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "backend=" << FastBinanceTradeParser::backend() << '\n'
+              << "iterations=" << iterations << '\n'
+              << "json_dom_ns_per_message=" << dom_ns << '\n'
+              << "json_dom_allocations_per_message=" << static_cast<double>(dom_allocations) / static_cast<double>(dom_iterations) << '\n'
+              << "fast_ns_per_message=" << fast_ns << '\n'
+              << "agg_trade_ns_per_message=" << agg_ns << '\n'
+              << "book_ticker_ns_per_message=" << book_ns << '\n'
+              << std::setprecision(6)
+              << "allocations=" << count << '\n'
+              << "allocations_per_parse=" << static_cast<double>(count) / static_cast<double>(iterations) << '\n'
+              << "agg_trade_and_book_ticker_allocations=" << feed_count << '\n'
+              << "checksum=" << (sink > 0.0 ? "ok" : "zero") << '\n';
+    return count == 0 && feed_count == 0 ? 0 : 1;
+}
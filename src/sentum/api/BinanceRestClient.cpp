@@ -134,7 +134,15 @@ double BinanceRestClient::get_coin_balance(const std::string& asset_symbol) {
 }
 
 std::vector<Kline> BinanceRestClient::get_historical_klines(const std::string& symbol, const std::string& interval, int limit) {
-	std::string url = "https://api.binance.com/api/v3/klines?symbol=" + symbol + "&interval=" + interval + "&limit=" + std::to_string(limit);
+	return fetch_klines("https://api.binance.com/api/v3/klines?symbol=" + symbol + "&interval=" + interval + "&limit=" + std::to_string(limit));
+}
+
+std::vector<Kline> BinanceRestClient::get_klines(const std::string& symbol, const std::string& interval, std::int64_t start_ms, std::int64_t end_ms, int limit) {
+	return fetch_klines("https://api.binance.com/api/v3/klines?symbol=" + symbol + "&interval=" + interval +
+	                    "&startTime=" + std::to_string(start_ms) + "&endTime=" + std::to_string(end_ms) + "&limit=" + std::to_string(limit));
+}
+
+std::vector<Kline> BinanceRestClient::fetch_klines(const std::string& url) {
 	std::string response;
 	CURL* curl = curl_easy_init();
 	if (curl) {
@@ -201,9 +209,36 @@ std::vector<MarketInfo> BinanceRestClient::get_markets_by_quote(const std::strin
 			market.base_asset_precision = symbol["baseAssetPrecision"].get<int>();
 			market.quote_asset          = symbol["quoteAsset"].get<std::string>();
 			market.quote_asset_precision= symbol["quoteAssetPrecision"].get<int>();
+			if (symbol.contains("filters")) {
+				for (const auto& filter : symbol["filters"]) {
+					const auto type = filter.value("filterType", std::string{});
+					if (type == "PRICE_FILTER") market.tick_size = filter.value("tickSize", std::string{});
+					else if (type == "LOT_SIZE") market.step_size = filter.value("stepSize", std::string{});
+				}
+			}
 
 			markets.push_back(market);
 		}
 	}
 	return markets;
-}
\ No newline at end of file
+}
+
+std::string BinanceRestClient::get_depth_snapshot(const std::string& symbol, int limit) {
+	std::string url = "https://api.binance.com/api/v3/depth?symbol=" + symbol + "&limit=" + std::to_string(limit);
+	std::string response;
+	long status = 0;
+	CURL* curl = curl_easy_init();
+	if (curl) {
+		curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+		curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
+		curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
+		curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10L);
+		if (curl_easy_perform(curl) == CURLE_OK) curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+		curl_easy_cleanup(curl);
+	}
+	if (status != 200) {
+		std::cerr << "Depth snapshot request failed for " << symbol << " (HTTP " << status << ")\n";
+		return {};
+	}
+	return response;
+}
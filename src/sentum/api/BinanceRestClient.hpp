@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -38,12 +39,18 @@ class BinanceRestClient {
 		std::string send_signed_order(const std::string& symbol, const std::string& quantity);
 		double get_coin_balance(const std::string& asset_symbol);
 		std::vector<Kline> get_historical_klines(const std::string& symbol, const std::string& interval, int limit);
+		// Up to `limit` (at most 1000) klines opened in [start_ms, end_ms], oldest first; empty on
+		// failure. Backfills page through a range with it.
+		static std::vector<Kline> get_klines(const std::string& symbol, const std::string& interval, std::int64_t start_ms, std::int64_t end_ms, int limit = 1000);
 		static nlohmann::json get_exchange_info();
 		static std::vector<MarketInfo> get_markets_by_quote(const std::string& quote_asset);
+		// Raw /api/v3/depth response (empty on transport failure), for FastBinanceDepthParser.
+		static std::string get_depth_snapshot(const std::string& symbol, int limit);
 
 	private:
 		std::string api_key_;
 		std::string api_secret_;
 		std::string get_timestamp() const;
 		std::string hmac_sha256(const std::string& data, const std::string& key) const;
+		static std::vector<Kline> fetch_klines(const std::string& url);
 };
\ No newline at end of file
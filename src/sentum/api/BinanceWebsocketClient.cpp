@@ -8,26 +8,34 @@
 #include <iostream>
 #include <mutex>
 #include <stdexcept>
+#include <type_traits>
 
 #include <boost/asio/ssl/context.hpp>
-#include <nlohmann/json.hpp>
 #include <websocketpp/client.hpp>
 #include <websocketpp/config/asio_client.hpp>
+#include <websocketpp/config/asio_no_tls_client.hpp>
 
 #include <sentum/api/BinanceWebsocketClient.hpp>
+#include <sentum/collector/FastBinanceTradeParser.hpp>
 
-using json = nlohmann::json;
 using tls_client = websocketpp::client<websocketpp::config::asio_tls_client>;
+using plain_client = websocketpp::client<websocketpp::config::asio_client>;
 
 struct BinanceWebsocketClient::Impl {
 	tls_client client;
+	plain_client plain;
+	bool use_plain = false;
 	websocketpp::connection_hdl connection;
 	std::mutex mutex;
 	bool connection_valid = false;
 };
 
-BinanceWebsocketClient::BinanceWebsocketClient(const std::string& sym)
-	: impl(std::make_unique<Impl>()), symbol(sym), running(false) {}
+BinanceWebsocketClient::BinanceWebsocketClient(const std::string& sym, const std::string& base)
+	: impl(std::make_unique<Impl>()), symbol(sym), base_url(base), running(false) {
+	while (!base_url.empty() && base_url.back() == '/') base_url.pop_back();
+	impl->use_plain = base_url.compare(0, 5, "ws://") == 0;
+	if (!impl->use_plain && base_url.compare(0, 6, "wss://") != 0) throw std::invalid_argument("Websocket base URL must start with ws:// or wss://: " + base);
+}
 
 BinanceWebsocketClient::~BinanceWebsocketClient() {
 	stop();
@@ -44,68 +52,82 @@ void BinanceWebsocketClient::start() {
 
 void BinanceWebsocketClient::stop() {
 	running.store(false);
-	{
-		std::lock_guard<std::mutex> lock(impl->mutex);
-		if (impl->connection_valid) {
-			websocketpp::lib::error_code ec;
-			impl->client.close(impl->connection, websocketpp::close::status::going_away, "shutdown", ec);
+	const auto stop_endpoint = [this](auto& endpoint) {
+		{
+			std::lock_guard<std::mutex> lock(impl->mutex);
+			if (impl->connection_valid) {
+				websocketpp::lib::error_code ec;
+				endpoint.close(impl->connection, websocketpp::close::status::going_away, "shutdown", ec);
+			}
 		}
-	}
-	impl->client.stop_perpetual();
-	impl->client.stop();
+		endpoint.stop_perpetual();
+		endpoint.stop();
+	};
+	if (impl->use_plain) stop_endpoint(impl->plain);
+	else stop_endpoint(impl->client);
 	if (ws_thread.joinable() && ws_thread.get_id() != std::this_thread::get_id()) ws_thread.join();
 }
 
 void BinanceWebsocketClient::run() {
-	try {
-		impl->client.init_asio();
-		impl->client.start_perpetual();
-		impl->client.set_tls_init_handler([](websocketpp::connection_hdl) {
-			auto ctx = websocketpp::lib::make_shared<boost::asio::ssl::context>(boost::asio::ssl::context::tls_client);
-			ctx->set_options(boost::asio::ssl::context::default_workarounds |
-				boost::asio::ssl::context::no_sslv2 |
-				boost::asio::ssl::context::no_sslv3);
-			return ctx;
-		});
-		impl->client.clear_access_channels(websocketpp::log::alevel::all);
-		impl->client.clear_error_channels(websocketpp::log::elevel::all);
+	std::string lower = symbol;
+	std::transform(lower.begin(), lower.end(), lower.begin(),
+		[](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+	const std::string url = base_url + "/ws/" + lower + "@trade";
+	if (thread_tuning.active() && !sentum::runtime::apply_thread_tuning("sentum-trade-ws", thread_tuning))
+		std::cerr << "[WS] CPU affinity or SCHED_FIFO was refused\n";
+	if (impl->use_plain) run_endpoint(impl->plain, url);
+	else run_endpoint(impl->client, url);
+	running.store(false);
+}
 
-		std::string lower = symbol;
-		std::transform(lower.begin(), lower.end(), lower.begin(),
-			[](unsigned char c) { return static_cast<char>(std::tolower(c)); });
-		const std::string url = "wss://stream.binance.com:9443/ws/" + lower + "@trade";
+template <typename Endpoint>
+void BinanceWebsocketClient::run_endpoint(Endpoint& endpoint, const std::string& url) {
+	try {
+		endpoint.init_asio();
+		endpoint.start_perpetual();
+		if constexpr (std::is_same_v<Endpoint, tls_client>) {
+			endpoint.set_tls_init_handler([](websocketpp::connection_hdl) {
+				auto ctx = websocketpp::lib::make_shared<boost::asio::ssl::context>(boost::asio::ssl::context::tls_client);
+				ctx->set_options(boost::asio::ssl::context::default_workarounds |
+					boost::asio::ssl::context::no_sslv2 |
+					boost::asio::ssl::context::no_sslv3);
+				return ctx;
+			});
+		}
+		endpoint.clear_access_channels(websocketpp::log::alevel::all);
+		endpoint.clear_error_channels(websocketpp::log::elevel::all);
 
-		impl->client.set_open_handler([this](websocketpp::connection_hdl hdl) {
+		endpoint.set_open_handler([this](websocketpp::connection_hdl hdl) {
 			std::lock_guard<std::mutex> lock(impl->mutex);
 			impl->connection = hdl;
 			impl->connection_valid = true;
 		});
-		impl->client.set_close_handler([this](websocketpp::connection_hdl) {
+		endpoint.set_close_handler([this](websocketpp::connection_hdl) {
 			std::lock_guard<std::mutex> lock(impl->mutex);
 			impl->connection_valid = false;
 		});
-		impl->client.set_fail_handler([this](websocketpp::connection_hdl) {
+		endpoint.set_fail_handler([this](websocketpp::connection_hdl) {
 			std::lock_guard<std::mutex> lock(impl->mutex);
 			impl->connection_valid = false;
 		});
-		impl->client.set_message_handler([this](websocketpp::connection_hdl, tls_client::message_ptr msg) {
+		endpoint.set_message_handler([this](websocketpp::connection_hdl, typename Endpoint::message_ptr msg) {
+			if (!running.load() || !on_price) return;
+			sentum::collector::ParsedTrade trade;
+			// Non-trade frames (subscription acks, errors) simply fail to parse and are skipped.
+			if (!sentum::collector::FastBinanceTradeParser::parse(msg->get_payload(), trade)) return;
 			try {
-				const auto j = json::parse(msg->get_payload());
-				if (running.load() && j.contains("p") && on_price) {
-					on_price(std::stod(j["p"].get<std::string>()));
-				}
+				on_price(trade.price);
 			} catch (const std::exception& e) {
-				std::cerr << "[WS] Error parsing message: " << e.what() << '\n';
+				std::cerr << "[WS] Error handling trade: " << e.what() << '\n';
 			}
 		});
 
 		websocketpp::lib::error_code ec;
-		auto con = impl->client.get_connection(url, ec);
+		auto con = endpoint.get_connection(url, ec);
 		if (ec) throw std::runtime_error("Connection failed: " + ec.message());
-		impl->client.connect(con);
-		impl->client.run();
+		endpoint.connect(con);
+		sentum::runtime::run_io_loop(endpoint, thread_tuning.busy_poll);
 	} catch (const std::exception& e) {
 		if (running.load()) std::cerr << "[WS] Connection error: " << e.what() << '\n';
 	}
-	running.store(false);
 }
@@ -10,22 +10,32 @@
 #include <string>
 #include <thread>
 
+#include <sentum/core/ThreadTuning.hpp>
+
 class BinanceWebsocketClient {
 public:
-	explicit BinanceWebsocketClient(const std::string& symbol);
+	static constexpr const char* default_base_url = "wss://stream.binance.com:9443";
+
+	// Streams <base_url>/ws/<symbol>@trade. A ws:// base URL connects without TLS.
+	explicit BinanceWebsocketClient(const std::string& symbol, const std::string& base_url = default_base_url);
 	~BinanceWebsocketClient();
 
 	void start();
 	void stop();
 	void set_on_price(const std::function<void(double)>& callback);
+	// Placement and polling of the stream thread; call before start().
+	void set_thread_tuning(const sentum::runtime::ThreadTuning& tuning) { thread_tuning = tuning; }
 
 private:
 	struct Impl;
 	std::unique_ptr<Impl> impl;
 	std::string symbol;
+	std::string base_url;
 	std::atomic<bool> running;
 	std::thread ws_thread;
 	std::function<void(double)> on_price;
+	sentum::runtime::ThreadTuning thread_tuning;
 
 	void run();
+	template <typename Endpoint> void run_endpoint(Endpoint& endpoint, const std::string& url);
 };
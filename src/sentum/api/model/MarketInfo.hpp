@@ -35,6 +35,9 @@ struct MarketInfo {
 	int base_asset_precision;
 	std::string quote_asset;
 	int quote_asset_precision;
+	// Exchange filter increments as sent by Binance (e.g. "0.01000000"); empty when unknown.
+	std::string tick_size;
+	std::string step_size;
 
 	static std::optional<MarketInfo> find_by_symbol(const std::vector<MarketInfo>& markets, const std::string& target_symbol) {
 		auto it = std::find_if(markets.begin(), markets.end(), [&target_symbol](const MarketInfo& m) {
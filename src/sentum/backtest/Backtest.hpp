@@ -32,6 +32,7 @@ public:
         std::ifstream file(path);
         if (!file) throw std::runtime_error("Cannot open replay file: " + path);
         std::vector<MarketEvent> events;
+        const auto symbol_id = sentum::market::SymbolInterner::global().intern(symbol);
         std::string line;
         bool first = true;
         while (std::getline(file, line)) {
@@ -45,7 +46,7 @@ public:
             if (cols.size() < 2) throw std::runtime_error("Replay CSV requires timestamp_ms,price[,volume]");
             MarketEvent e;
             e.type = MarketEvent::Type::Trade;
-            e.symbol = symbol;
+            e.symbol_id = symbol_id;
             e.timestamp = std::chrono::system_clock::time_point(std::chrono::milliseconds(std::stoll(cols[0])));
             e.price = std::stod(cols[1]);
             e.close = e.price;
@@ -1,59 +1,259 @@
+#include <algorithm>
+#include <cctype>
 #include <chrono>
+#include <exception>
+#include <functional>
 #include <mutex>
 #include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
+#include <boost/asio/post.hpp>
 #include <boost/asio/ssl/context.hpp>
 #include <websocketpp/client.hpp>
 #include <websocketpp/config/asio_client.hpp>
+#include <websocketpp/config/asio_no_tls_client.hpp>
 
+#include <sentum/api/BinanceRestClient.hpp>
 #include <sentum/collector/Collector.hpp>
+#include <sentum/collector/FastBinanceAggTradeParser.hpp>
+#include <sentum/collector/FastBinanceBookTickerParser.hpp>
+#include <sentum/collector/FastBinanceDepthParser.hpp>
 #include <sentum/collector/FastBinanceKlineParser.hpp>
 #include <sentum/market/MarketEventBus.hpp>
 #include <sentum/market/RuntimePerformanceMetrics.hpp>
 #include <sentum/utils/helper.hpp>
 
 using client = websocketpp::client<websocketpp::config::asio_tls_client>;
+using plain_client = websocketpp::client<websocketpp::config::asio_client>;
 
-struct Collector::Impl {
+static_assert(Collector::max_shards <= sentum::market::RuntimePerformanceMetrics::max_collector_shards,
+              "every collector shard needs a metrics slot");
+
+namespace {
+constexpr std::chrono::milliseconds min_reconnect_delay{1000};
+constexpr std::chrono::milliseconds max_reconnect_delay{30000};
+
+enum class StreamKind { Kline, BookTicker, AggTrade, Depth, Unknown };
+
+// Reads the stream type from the combined-stream envelope, e.g. "btcusdt@bookTicker".
+// Payloads without an envelope are klines.
+StreamKind stream_kind(std::string_view payload) noexcept {
+    constexpr std::string_view envelope = "{\"stream\":\"";
+    if (payload.compare(0, envelope.size(), envelope) != 0) return StreamKind::Kline;
+    const auto at = payload.find('@', envelope.size());
+    if (at == std::string_view::npos) return StreamKind::Unknown;
+    const auto name = payload.substr(at + 1);
+    if (name.compare(0, 5, "kline") == 0) return StreamKind::Kline;
+    if (name.compare(0, 10, "bookTicker") == 0) return StreamKind::BookTicker;
+    if (name.compare(0, 8, "aggTrade") == 0) return StreamKind::AggTrade;
+    if (name.compare(0, 5, "depth") == 0) return StreamKind::Depth;
+    return StreamKind::Unknown;
+}
+
+std::int64_t now_milliseconds() noexcept {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::int64_t now_nanoseconds() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::uint64_t elapsed_microseconds(std::chrono::steady_clock::time_point since) noexcept {
+    const auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - since).count();
+    return static_cast<std::uint64_t>(us < 0 ? 0 : us);
+}
+
+MarketEvent candle_event(sentum::market::SymbolId id, const Kline& entry) noexcept {
+    MarketEvent event;
+    event.type = MarketEvent::Type::Candle;
+    event.symbol_id = id;
+    event.timestamp = std::chrono::system_clock::time_point(std::chrono::milliseconds(entry.timestamp));
+    event.price = entry.close;
+    event.open = entry.open; event.high = entry.high; event.low = entry.low; event.close = entry.close; event.volume = entry.volume; event.closed = true;
+    return event;
+}
+
+MarketDataStore::TopOfBook top_of_book(const sentum::collector::ParsedBookTicker& parsed, std::int64_t received_ms) noexcept {
+    MarketDataStore::TopOfBook book;
+    book.update_id = parsed.update_id;
+    book.timestamp = received_ms;
+    book.bid_price = parsed.bid_price; book.bid_quantity = parsed.bid_quantity;
+    book.ask_price = parsed.ask_price; book.ask_quantity = parsed.ask_quantity;
+    return book;
+}
+
+MarketEvent quote_event(sentum::market::SymbolId id, const MarketDataStore::TopOfBook& book) noexcept {
+    return MarketEvent::quote(id, std::chrono::system_clock::time_point(std::chrono::milliseconds(book.timestamp)),
+                              book.bid_price, book.bid_quantity, book.ask_price, book.ask_quantity);
+}
+
+MarketEvent agg_trade_event(sentum::market::SymbolId id, const sentum::collector::ParsedAggTrade& parsed) noexcept {
+    MarketEvent event;
+    event.type = MarketEvent::Type::AggTrade;
+    event.symbol_id = id;
+    event.timestamp = std::chrono::system_clock::time_point(std::chrono::milliseconds(parsed.trade_time));
+    event.price = parsed.price; event.close = parsed.price; event.volume = parsed.quantity;
+    event.buyer_maker = parsed.buyer_maker;
+    event.closed = false;
+    return event;
+}
+}
+
+// One frame after the parse pass of on_frames, before it touches the store.
+struct Collector::ParsedFrame {
+    StreamKind kind = StreamKind::Unknown;
+    SymbolRef symbol;
+    std::int64_t received_ms = 0;
+    std::string_view payload; // depth diffs are parsed and applied by on_depth
+    Kline kline{};
+    sentum::market::FixedKline fixed;
+    bool closed = false;
+    sentum::collector::ParsedBookTicker quote;
+    sentum::collector::ParsedAggTrade trade;
+};
+
+struct Collector::Shard {
+    std::size_t index = 0;
+    std::string url;
+    std::vector<std::size_t> symbols;
+    // wss:// URLs use the TLS endpoint, ws:// (local test feeds) the plain one.
+    bool plain = false;
     client websocket;
+    plain_client plain_websocket;
     websocketpp::connection_hdl connection;
     std::mutex mutex;
     bool connection_valid = false;
+    std::chrono::milliseconds reconnect_delay = min_reconnect_delay;
+    std::thread io_thread;
+    sentum::market::SpscRingQueue<KlineBatchItem, queue_capacity + 1> queue;
+    sentum::market::CollectorShardMetrics* metrics = nullptr;
+    // Batched ingest: the frames of the current socket read, kept alive by their message
+    // buffers until the posted drain runs, plus scratch reused by every batch.
+    std::vector<Frame> pending;
+    std::vector<std::shared_ptr<const void>> pending_owners;
+    bool drain_posted = false;
+    std::vector<ParsedFrame> parsed;
+    std::vector<MarketEvent> events;
+    std::vector<KlineBatchItem> closed;
 };
 
 Collector::Collector(Database& db, const std::vector<MarketInfo>& markets_)
     : Collector(db, MarketDataStore::global(), markets_) {}
 
-Collector::Collector(Database& db, MarketDataStore& store, const std::vector<MarketInfo>& markets_)
-    : db_ref(db), store_ref(store), markets(markets_), logger("log/collector.log"), impl(std::make_unique<Impl>()) {
+Collector::Collector(Database& db, MarketDataStore& store, const std::vector<MarketInfo>& markets_, CollectorOptions options)
+    : db_ref(db), store_ref(store), markets(markets_), fixed_point(options.fixed_point),
+      book_ticker(options.book_ticker), agg_trades(options.agg_trades), batch_frames(options.batch_frames),
+      sqlite_sink(options.sqlite_sink), wal_checkpoint_interval(options.wal_checkpoint_interval),
+      wal_restart_bytes(options.wal_restart_bytes), low_latency(options.low_latency), logger("log/collector.log") {
+    if (!sqlite_sink && options.archive_path.empty()) throw std::invalid_argument("Collector needs the SQLite sink or an archive path");
     initialize_symbols();
+    initialize_depth(options);
+    initialize_shards(options.shards, options.stream_url);
+    if (!options.frame_journal_path.empty())
+        frame_journal = std::make_unique<sentum::collector::FrameJournalWriter>(options.frame_journal_path);
+    if (!options.archive_path.empty())
+        archive = std::make_unique<sentum::market::KlineArchiveWriter>(options.archive_path, options.archive_block_rows);
+    if (!options.spill_path.empty()) spill = std::make_unique<sentum::collector::KlineSpill>(options.spill_path, options.spill_max_bytes);
 }
 
 Collector::~Collector() { stop(); }
 
 void Collector::initialize_symbols() {
     canonical_symbols.reserve(markets.size());
-    symbol_by_hash.reserve(markets.size() * 2);
+    const auto ids = sentum::market::SymbolInterner::global().intern_all(MarketInfo::get_symbol_list(markets));
     for (std::size_t i = 0; i < markets.size(); ++i) {
         canonical_symbols.push_back(helper::to_lowercase(markets[i].symbol));
-        const auto id = static_cast<sentum::market::SymbolId>(i + 1);
-        symbol_by_hash.emplace(sentum::market::symbol_hash(markets[i].symbol), i);
-        store_ref.register_symbol(id, canonical_symbols.back());
+        const auto id = ids[i];
+        if (index_by_id.size() <= id) index_by_id.resize(static_cast<std::size_t>(id) + 1, static_cast<std::size_t>(-1));
+        index_by_id[id] = i;
+        // Resolves the symbols dictionary row now rather than in the writer's first batch.
+        if (sqlite_sink && !db_ref.register_symbol(id, canonical_symbols.back()))
+            throw std::runtime_error("Failed to register " + canonical_symbols.back() + " in " + db_ref.path());
+        if (!fixed_point) { store_ref.register_symbol(id, canonical_symbols.back()); continue; }
+        sentum::market::SymbolScales scales;
+        if (!markets[i].tick_size.empty()) scales.price = sentum::market::FixedScale::from_increment(markets[i].tick_size);
+        if (!markets[i].step_size.empty()) scales.quantity = sentum::market::FixedScale::from_increment(markets[i].step_size);
+        symbol_scales.push_back(scales);
+        store_ref.register_symbol(id, canonical_symbols.back(), scales);
+    }
+}
+
+void Collector::initialize_depth(const CollectorOptions& options) {
+    depth_snapshot_limit = options.depth_snapshot_limit;
+    depth_books.assign(markets.size(), nullptr);
+    for (auto name : options.depth_symbols) {
+        std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+        const auto symbol = resolve_symbol(name);
+        if (!symbol.canonical || depth_books[symbol.index]) continue;
+        sentum::market::SymbolScales scales;
+        const auto& market = markets[symbol.index];
+        if (!market.tick_size.empty()) scales.price = sentum::market::FixedScale::from_increment(market.tick_size);
+        if (!market.step_size.empty()) scales.quantity = sentum::market::FixedScale::from_increment(market.step_size);
+        depth_books[symbol.index] = &sentum::collector::DepthBooks::global().add(symbol.id, scales);
+        ++depth_symbol_count;
+    }
+    if (depth_symbol_count > 0 && !options.depth_record_path.empty()) {
+        depth_record.open(options.depth_record_path, std::ios::app);
+        if (!depth_record) throw std::runtime_error("Cannot open depth record file " + options.depth_record_path);
     }
 }
 
+void Collector::initialize_shards(std::size_t requested, const std::string& stream_url) {
+    std::string base_url = stream_url;
+    while (!base_url.empty() && base_url.back() == '/') base_url.pop_back();
+    const bool plain = base_url.compare(0, 5, "ws://") == 0;
+    if (!plain && base_url.compare(0, 6, "wss://") != 0) throw std::runtime_error("Collector stream URL must start with ws:// or wss://: " + stream_url);
+    const std::size_t symbol_count = canonical_symbols.size();
+    const std::size_t streams_per_symbol = 1 + (book_ticker ? 1 : 0) + (agg_trades ? 1 : 0);
+    const std::size_t streams = symbol_count * streams_per_symbol + depth_symbol_count;
+    const std::size_t required = (streams + max_streams_per_connection - 1) / max_streams_per_connection;
+    if (required > max_shards) throw std::runtime_error("Collector universe exceeds " + std::to_string(max_shards * max_streams_per_connection) + " streams");
+    std::size_t count = std::max<std::size_t>({1, requested, required});
+    count = std::min({count, max_shards, std::max<std::size_t>(1, symbol_count)});
+
+    auto& perf = sentum::market::RuntimePerformanceMetrics::global();
+    shards.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        auto shard = std::make_unique<Shard>();
+        shard->index = i;
+        shard->metrics = &perf.collector_shards[i];
+        shards.push_back(std::move(shard));
+    }
+    // Round-robin keeps alphabetically clustered high-volume symbols spread across connections.
+    for (std::size_t i = 0; i < symbol_count; ++i) shards[i % count]->symbols.push_back(i);
+    for (auto& shard : shards) {
+        shard->plain = plain;
+        shard->url = base_url + "/stream?streams=";
+        for (std::size_t i = 0; i < shard->symbols.size(); ++i) {
+            const auto& symbol = canonical_symbols[shard->symbols[i]];
+            shard->url += symbol + "@kline_1s";
+            if (book_ticker) shard->url += "/" + symbol + "@bookTicker";
+            if (agg_trades) shard->url += "/" + symbol + "@aggTrade";
+            if (depth_books[shard->symbols[i]]) shard->url += "/" + symbol + "@depth@100ms";
+            if (i + 1 < shard->symbols.size()) shard->url += "/";
+        }
+        shard->metrics->symbols.store(shard->symbols.size(), std::memory_order_relaxed);
+    }
+    perf.collector_shard_count.store(count, std::memory_order_relaxed);
+}
+
 Collector::SymbolRef Collector::resolve_symbol(std::string_view symbol) const noexcept {
-    const auto it = symbol_by_hash.find(sentum::market::symbol_hash(symbol));
-    if (it == symbol_by_hash.end()) return {};
-    const auto index = it->second;
+    // Binance sends upper-case symbols, which is the interner's canonical form.
+    const auto id = sentum::market::SymbolInterner::global().find(symbol);
+    if (id == sentum::market::kInvalidSymbolId || id >= index_by_id.size()) return {};
+    const auto index = index_by_id[id];
     if (index >= canonical_symbols.size()) return {};
-    const auto& canonical = canonical_symbols[index];
-    if (canonical.size() != symbol.size()) return {};
-    for (std::size_t i = 0; i < symbol.size(); ++i) {
-        char c = symbol[i]; if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
-        if (canonical[i] != c) return {};
-    }
-    return {static_cast<sentum::market::SymbolId>(index + 1), &canonical};
+    return {id, index, &canonical_symbols[index]};
+}
+
+std::optional<sentum::market::FixedScale> Collector::price_scale(std::string symbol) const {
+    std::transform(symbol.begin(), symbol.end(), symbol.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    const auto ref = resolve_symbol(symbol);
+    if (!ref.canonical || markets[ref.index].tick_size.empty()) return std::nullopt;
+    if (fixed_point) return symbol_scales[ref.index].price;
+    return sentum::market::FixedScale::from_increment(markets[ref.index].tick_size);
 }
 
 double Collector::drop_rate() const {
@@ -63,69 +263,314 @@ double Collector::drop_rate() const {
     return total == 0 ? 0.0 : static_cast<double>(rejected) / static_cast<double>(total);
 }
 
+std::size_t Collector::queue_depth() const {
+    std::size_t depth = 0;
+    for (const auto& shard : shards) depth += shard->queue.size_approx();
+    return depth;
+}
+
+WarmStartReport Collector::warm_start(std::size_t bars, std::chrono::seconds max_age, std::size_t threads) {
+    WarmStartReport report;
+    if (bars == 0 || canonical_symbols.empty()) return report;
+    const auto begin = std::chrono::steady_clock::now();
+    const auto since = now_milliseconds() - std::chrono::duration_cast<std::chrono::milliseconds>(max_age).count();
+    const int limit = static_cast<int>(std::min<std::size_t>(bars, store_ref.capacity_per_symbol()));
+    std::atomic<std::size_t> next{0}, symbols{0}, klines{0};
+    // The archive reader maps the sealed partitions once and is shared by the workers.
+    std::unique_ptr<sentum::market::KlineArchiveReader> archive_reader;
+    if (!sqlite_sink) archive_reader = std::make_unique<sentum::market::KlineArchiveReader>(archive->directory());
+    const auto work = [&] {
+        try {
+            std::unique_ptr<KlineReader> reader;
+            if (!archive_reader) reader = std::make_unique<KlineReader>(db_ref.path());
+            std::vector<Kline> rows;
+            rows.reserve(static_cast<std::size_t>(limit));
+            for (auto i = next.fetch_add(1); i < canonical_symbols.size(); i = next.fetch_add(1)) {
+                const auto id = sentum::market::SymbolInterner::global().find(markets[i].symbol);
+                if (id == sentum::market::kInvalidSymbolId) continue;
+                // After a snapshot restore only the gap is loaded. The newest restored
+                // candle is read again in case it was saved before it closed.
+                auto from = since;
+                store_ref.with_window(id, 1, [&](const MarketDataStore::Window& window) {
+                    from = window.size() ? std::max(since, window.timestamp().back()) : since;
+                });
+                const bool loaded = reader ? reader->load_latest(canonical_symbols[i], from, limit, rows)
+                                           : archive_reader->load_latest(canonical_symbols[i], from, static_cast<std::size_t>(limit), rows);
+                if (!loaded || rows.empty()) continue;
+                for (const auto& kline : rows) store_ref.upsert(id, kline);
+                symbols.fetch_add(1, std::memory_order_relaxed);
+                klines.fetch_add(rows.size(), std::memory_order_relaxed);
+            }
+        } catch (const std::exception& e) {
+            logger.log(std::string("Warm start worker failed: ") + e.what());
+        }
+    };
+    const std::size_t workers = std::clamp<std::size_t>(threads, 1, canonical_symbols.size());
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    for (std::size_t i = 1; i < workers; ++i) pool.emplace_back(work);
+    work();
+    for (auto& worker : pool) worker.join();
+
+    report.symbols = symbols.load();
+    report.klines = klines.load();
+    report.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin);
+    auto& startup = sentum::market::RuntimePerformanceMetrics::global().startup;
+    startup.warm_start_ms.store(static_cast<std::uint64_t>(report.elapsed.count()), std::memory_order_relaxed);
+    startup.warm_start_symbols.store(report.symbols, std::memory_order_relaxed);
+    startup.warm_start_klines.store(report.klines, std::memory_order_relaxed);
+    return report;
+}
+
 void Collector::start() {
     if (running.exchange(true)) return;
     logger.start();
-    writer_thread = std::thread(&Collector::writer_loop, this);
-    ws_thread = std::thread(&Collector::run, this);
+    logger.log("Collector starting: symbols=" + std::to_string(canonical_symbols.size()) + " shards=" + std::to_string(shards.size()));
+    start_persistence();
+    if (depth_symbol_count > 0) depth_thread = std::thread(&Collector::depth_loop, this);
+    for (auto& shard : shards) shard->io_thread = std::thread(&Collector::run, this, std::ref(*shard));
 }
 
-void Collector::stop() {
-    running.store(false);
+template <typename Endpoint>
+void Collector::stop_endpoint(Shard& shard, Endpoint& websocket) {
     {
-        std::lock_guard<std::mutex> lock(impl->mutex);
-        if (impl->connection_valid) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (shard.connection_valid) {
             websocketpp::lib::error_code ec;
-            impl->websocket.close(impl->connection, websocketpp::close::status::going_away, "shutdown", ec);
+            websocket.close(shard.connection, websocketpp::close::status::going_away, "shutdown", ec);
         }
     }
-    impl->websocket.stop_perpetual();
-    impl->websocket.stop();
+    websocket.stop_perpetual();
+    websocket.stop();
+}
+
+void Collector::stop() {
+    running.store(false);
+    for (auto& shard : shards) {
+        // Shards of a collector that replayed or never started have no websocket loop.
+        if (!shard->io_thread.joinable()) continue;
+        if (shard->plain) stop_endpoint(*shard, shard->plain_websocket);
+        else stop_endpoint(*shard, shard->websocket);
+    }
     queue_cv.notify_all();
-    if (ws_thread.joinable() && ws_thread.get_id() != std::this_thread::get_id()) ws_thread.join();
+    { std::lock_guard<std::mutex> lock(depth_mutex); }
+    depth_cv.notify_all();
+    { std::lock_guard<std::mutex> lock(checkpoint_mutex); }
+    checkpoint_cv.notify_all();
+    for (auto& shard : shards) {
+        if (shard->io_thread.joinable() && shard->io_thread.get_id() != std::this_thread::get_id()) shard->io_thread.join();
+    }
     if (writer_thread.joinable() && writer_thread.get_id() != std::this_thread::get_id()) writer_thread.join();
+    if (depth_thread.joinable() && depth_thread.get_id() != std::this_thread::get_id()) depth_thread.join();
+    if (checkpoint_thread.joinable() && checkpoint_thread.get_id() != std::this_thread::get_id()) checkpoint_thread.join();
+    if (checkpointer && !checkpoint_thread.joinable()) {
+        checkpointer.reset();
+        // The writer has stopped; its connection checkpoints inline again.
+        try { db_ref.set_wal_autocheckpoint(1000); } catch (const std::exception& e) { logger.log(std::string("Restoring wal_autocheckpoint failed: ") + e.what()); }
+    }
+    if (frame_journal) frame_journal->flush();
     logger.log("Collector stopped: enqueued=" + std::to_string(enqueued.load()) +
                " dropped=" + std::to_string(dropped.load()) +
                " drop_rate=" + std::to_string(drop_rate()));
     logger.stop();
 }
 
-bool Collector::try_enqueue(const std::string* symbol, Kline kline) {
-    if (!queue.try_push(KlineBatchItem{symbol, std::move(kline)})) {
+FrameReplayReport Collector::replay(const std::string& journal_path, double speed) {
+    sentum::collector::FrameJournalReader journal(journal_path);
+    if (!journal) throw std::runtime_error("Cannot read frame journal " + journal_path);
+    running.store(true);
+    logger.start();
+    logger.log("Collector replaying " + journal_path + ": symbols=" + std::to_string(canonical_symbols.size()) + " shards=" + std::to_string(shards.size()));
+    start_persistence();
+
+    FrameReplayReport report;
+    sentum::collector::JournalFrame frame;
+    std::int64_t first_ns = 0, last_ns = 0;
+    // Unpaced batched replays hand runs of one connection's frames to on_frames, as
+    // back-to-back frames of a socket read would arrive. The reader reuses its buffer,
+    // so batched payloads are copied.
+    const bool batched = batch_frames && speed <= 0.0;
+    std::vector<std::string> storage(batched ? max_frame_batch : 0);
+    std::vector<Frame> run;
+    Shard* run_shard = nullptr;
+    const auto flush_run = [&] {
+        if (run_shard) on_frames(*run_shard, run.data(), run.size());
+        run.clear();
+        run_shard = nullptr;
+    };
+    const auto begin = std::chrono::steady_clock::now();
+    while (running.load(std::memory_order_relaxed) && journal.next(frame)) {
+        if (report.frames == 0) first_ns = frame.received_ns;
+        last_ns = frame.received_ns;
+        ++report.frames;
+        report.bytes += frame.payload.size();
+        auto& shard = *shards[frame.connection % shards.size()];
+        if (batched) {
+            if (run_shard != &shard || run.size() == max_frame_batch) flush_run();
+            run_shard = &shard;
+            storage[run.size()].assign(frame.payload);
+            run.push_back({storage[run.size()], frame.received_ns / 1000000});
+            continue;
+        }
+        if (speed > 0.0 && frame.received_ns > first_ns) {
+            const auto offset = std::chrono::nanoseconds(static_cast<std::int64_t>(static_cast<double>(frame.received_ns - first_ns) / speed));
+            std::this_thread::sleep_until(begin + offset);
+        }
+        on_message(shard, frame.payload, frame.received_ns / 1000000);
+    }
+    flush_run();
+    report.elapsed = std::chrono::steady_clock::now() - begin;
+    report.recorded = std::chrono::nanoseconds(last_ns - first_ns);
+    report.truncated = journal.truncated();
+    stop();
+    return report;
+}
+
+bool Collector::try_enqueue(Shard& shard, sentum::market::SymbolId symbol_id, Kline kline) {
+    // While the spill holds rows, newer ones queue behind them there.
+    const bool spilling = spill && spill->pending() > 0;
+    if ((spilling || !shard.queue.try_push(KlineBatchItem{symbol_id, kline})) && !spill_kline(symbol_id, kline)) {
         dropped.fetch_add(1, std::memory_order_relaxed);
         return false;
     }
     enqueued.fetch_add(1, std::memory_order_relaxed);
-    const auto depth = queue.size_approx();
+    const auto depth = shard.queue.size_approx();
     sentum::market::RuntimePerformanceMetrics::global().observe_queue_depth(depth);
-    queue_cv.notify_one();
+    notify_writer();
     return true;
 }
 
+bool Collector::spill_kline(sentum::market::SymbolId symbol_id, const Kline& kline) {
+    return spill && spill->append(canonical_symbols[index_by_id[symbol_id]], kline);
+}
+
+void Collector::enqueue_batch(Shard& shard, std::vector<KlineBatchItem>& items) {
+    std::uint64_t accepted = 0;
+    for (auto& item : items) {
+        const bool spilling = spill && spill->pending() > 0;
+        if ((!spilling && shard.queue.try_push(item)) || spill_kline(item.symbol_id, item.kline)) ++accepted;
+    }
+    if (accepted < items.size()) dropped.fetch_add(items.size() - accepted, std::memory_order_relaxed);
+    if (accepted == 0) return;
+    enqueued.fetch_add(accepted, std::memory_order_relaxed);
+    sentum::market::RuntimePerformanceMetrics::global().observe_queue_depth(shard.queue.size_approx());
+    notify_writer();
+}
+
+void Collector::notify_writer() {
+    // A busy-polling io thread must not pay for a futex wake; the writer polls instead.
+    if (!low_latency.enabled) queue_cv.notify_one();
+}
+
+void Collector::start_persistence() {
+    // An in-memory database has no WAL to checkpoint.
+    if (sqlite_sink && wal_checkpoint_interval.count() > 0 && !db_ref.path().empty() && db_ref.path() != ":memory:") {
+        try {
+            checkpointer = std::make_unique<WalCheckpointer>(db_ref.path(), wal_restart_bytes);
+            db_ref.set_wal_autocheckpoint(0);
+        } catch (const std::exception& e) {
+            checkpointer.reset();
+            logger.log(std::string("WAL checkpoint thread disabled, SQLite checkpoints inline: ") + e.what());
+        }
+    }
+    if (spill && spill->recovered() > 0)
+        logger.log("Kline spill " + spill->path() + " holds " + std::to_string(spill->recovered()) + " rows from the last run; writing them first");
+    writer_thread = std::thread(&Collector::writer_loop, this);
+    if (checkpointer) checkpoint_thread = std::thread(&Collector::checkpoint_loop, this);
+}
+
 void Collector::writer_loop() {
     using namespace std::chrono_literals;
+    if (low_latency.enabled) sentum::runtime::apply_thread_tuning("sentum-writer", low_latency.persistence());
+    const auto idle_wait = low_latency.enabled ? 1ms : 100ms;
+    auto& writer_metrics = sentum::market::RuntimePerformanceMetrics::global().sqlite_writer;
+    std::size_t batch_limit = initial_batch_size;
+    writer_metrics.batch_limit.store(batch_limit, std::memory_order_relaxed);
     std::vector<KlineBatchItem> batch;
-    batch.reserve(batch_size);
+    batch.reserve(max_batch_size);
     auto last_metrics = std::chrono::steady_clock::now();
+    const auto queues_empty = [this] {
+        return std::all_of(shards.begin(), shards.end(), [](const auto& shard) { return shard->queue.empty(); }) &&
+               (!spill || spill->pending() == 0);
+    };
+    // Rows recovered from a spill file may name symbols outside this run's universe.
+    std::string archive_symbol;
+    const auto archive_name = [this, &archive_symbol](sentum::market::SymbolId id) -> const std::string& {
+        if (id < index_by_id.size() && index_by_id[id] < canonical_symbols.size()) return canonical_symbols[index_by_id[id]];
+        archive_symbol = helper::to_lowercase(std::string(sentum::market::SymbolInterner::global().name(id)));
+        return archive_symbol;
+    };
+    auto last_spill_sync = std::chrono::steady_clock::now();
+    std::size_t first_shard = 0;
 
-    while (running.load(std::memory_order_acquire) || !queue.empty()) {
+    while (running.load(std::memory_order_acquire) || !queues_empty()) {
         KlineBatchItem item;
-        while (batch.size() < batch_size && queue.try_pop(item)) batch.push_back(std::move(item));
+        // Rotate the starting shard so one busy connection cannot starve the others of batch slots.
+        for (std::size_t n = 0; n < shards.size() && batch.size() < batch_limit; ++n) {
+            auto& queue = shards[(first_shard + n) % shards.size()]->queue;
+            while (batch.size() < batch_limit && queue.try_pop(item)) batch.push_back(std::move(item));
+        }
+        first_shard = shards.empty() ? 0 : (first_shard + 1) % shards.size();
+        // Spilled rows are newer than anything still in the rings, so they go in after.
+        // They leave the spill only once the batch is stored.
+        const auto from_rings = batch.size();
+        const auto from_spill = spill && batch.size() < batch_limit ? spill->peek(batch, batch_limit - batch.size()) : 0;
+        if (spill && std::chrono::steady_clock::now() - last_spill_sync >= spill_sync_interval) {
+            spill->sync();
+            last_spill_sync = std::chrono::steady_clock::now();
+        }
         if (batch.empty()) {
             std::unique_lock<std::mutex> lock(wait_mutex);
-            queue_cv.wait_for(lock, 100ms, [this] { return !queue.empty() || !running.load(); });
+            queue_cv.wait_for(lock, idle_wait, [this, &queues_empty] { return !queues_empty() || !running.load(); });
             continue;
         }
-        {
-            sentum::market::ScopedLatency latency(sentum::market::RuntimePerformanceMetrics::global().sqlite_batch_latency);
-            if (!db_ref.save_kline_batch(batch)) logger.log("SQLite batch UPSERT failed, size=" + std::to_string(batch.size()));
+        bool saved = true;
+        if (sqlite_sink) {
+            const auto begin = std::chrono::steady_clock::now();
+            {
+                sentum::market::ScopedLatency latency(sentum::market::RuntimePerformanceMetrics::global().sqlite_batch_latency);
+                saved = db_ref.save_kline_batch(batch);
+            }
+            const auto elapsed = std::chrono::steady_clock::now() - begin;
+            if (saved) {
+                writer_metrics.batches.fetch_add(1, std::memory_order_relaxed);
+                writer_metrics.rows.fetch_add(batch.size(), std::memory_order_relaxed);
+            } else {
+                writer_metrics.failed_batches.fetch_add(1, std::memory_order_relaxed);
+                logger.log("SQLite batch UPSERT failed, size=" + std::to_string(batch.size()));
+            }
+            // AIMD on commit latency: a commit over target halves the cap, so the queues
+            // never wait behind one long transaction; a backlog deeper than the cap grows
+            // it a step, so a top-of-second burst drains in fewer commits.
+            if (elapsed > target_commit_latency) batch_limit = std::max(min_batch_size, batch_limit / 2);
+            else if (queue_depth() + (spill ? spill->pending() : 0) > batch_limit) batch_limit = std::min(max_batch_size, batch_limit + batch_size_step);
+            writer_metrics.batch_limit.store(batch_limit, std::memory_order_relaxed);
+        }
+        // A failed batch's spilled rows are retried on the next pass, and archived then.
+        if (!saved) batch.resize(from_rings);
+        else if (from_spill > 0) spill->commit(from_spill);
+        if (archive) {
+            sentum::market::ScopedLatency latency(sentum::market::RuntimePerformanceMetrics::global().archive_batch_latency);
+            std::size_t rejected = 0;
+            for (const auto& item : batch) if (!archive->append(archive_name(item.symbol_id), item.kline)) ++rejected;
+            if (rejected > 0) logger.log("Kline archive rejected " + std::to_string(rejected) + " of " + std::to_string(batch.size()) + " rows");
         }
         batch.clear();
+        if (!saved && from_spill > 0) {
+            // They stay in the spill file and are written first at the next start.
+            if (!running.load()) {
+                logger.log("Kline spill keeps " + std::to_string(spill->pending()) + " rows after a failed batch at shutdown");
+                break;
+            }
+            std::unique_lock<std::mutex> lock(wait_mutex);
+            queue_cv.wait_for(lock, idle_wait, [this] { return !running.load(); });
+        }
         if (std::chrono::steady_clock::now() - last_metrics >= 10s) {
             const double rate = drop_rate();
-            logger.log("Queue metrics: depth=" + std::to_string(queue.size_approx()) +
+            logger.log("Queue metrics: depth=" + std::to_string(queue_depth()) +
                        " high_water=" + std::to_string(sentum::market::RuntimePerformanceMetrics::global().queue_high_water.load()) +
                        " enqueued=" + std::to_string(enqueued.load()) +
+                       " spilled=" + std::to_string(spill ? spill->pending() : 0) +
                        " dropped=" + std::to_string(dropped.load()) +
                        " drop_rate=" + std::to_string(rate) +
                        " limit=" + std::to_string(max_drop_rate));
@@ -133,73 +578,372 @@ void Collector::writer_loop() {
             last_metrics = std::chrono::steady_clock::now();
         }
     }
+    // Open archive blocks hold up to archive_block_rows rows per symbol.
+    if (archive && !archive->seal()) logger.log("Kline archive seal failed in " + archive->directory());
+}
+
+void Collector::checkpoint_loop() {
+    if (low_latency.enabled) sentum::runtime::apply_thread_tuning("sentum-checkpoint", low_latency.persistence());
+    auto& metrics = sentum::market::RuntimePerformanceMetrics::global().sqlite_writer;
+    std::unique_lock<std::mutex> lock(checkpoint_mutex);
+    while (!checkpoint_cv.wait_for(lock, wal_checkpoint_interval, [this] { return !running.load(); })) {
+        lock.unlock();
+        const auto result = checkpointer->checkpoint();
+        metrics.checkpoint_latency.observe(static_cast<std::uint64_t>(result.elapsed.count()));
+        if (result.ok) {
+            metrics.checkpoints.fetch_add(1, std::memory_order_relaxed);
+            if (result.restart) metrics.restarts.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            metrics.busy_checkpoints.fetch_add(1, std::memory_order_relaxed);
+        }
+        metrics.wal_frames.store(static_cast<std::uint64_t>(std::max(result.wal_frames, 0)), std::memory_order_relaxed);
+        metrics.wal_checkpointed_frames.store(static_cast<std::uint64_t>(std::max(result.checkpointed_frames, 0)), std::memory_order_relaxed);
+        metrics.observe_wal_bytes(result.wal_bytes);
+        lock.lock();
+    }
+}
+
+void Collector::on_message(Shard& shard, std::string_view payload, std::int64_t received_ms) {
+    if (!running.load(std::memory_order_relaxed)) return;
+    switch (stream_kind(payload)) {
+        case StreamKind::Kline: on_kline(shard, payload); break;
+        case StreamKind::BookTicker: on_book_ticker(shard, payload, received_ms); break;
+        case StreamKind::AggTrade: on_agg_trade(shard, payload, received_ms); break;
+        case StreamKind::Depth: on_depth(shard, payload); break;
+        case StreamKind::Unknown: break;
+    }
+}
+
+void Collector::drain_frames(Shard& shard) {
+    if (!shard.pending.empty()) on_frames(shard, shard.pending.data(), shard.pending.size());
+    shard.pending.clear();
+    shard.pending_owners.clear();
+}
+
+void Collector::on_frames(Shard& shard, const Frame* frames, std::size_t count) {
+    if (!running.load(std::memory_order_relaxed) || count == 0) return;
+    auto& perf = sentum::market::RuntimePerformanceMetrics::global();
+    auto& parsed = shard.parsed;
+    parsed.clear();
+
+    // Parse pass: one clock pair for the whole batch; each frame is charged the average.
+    std::size_t timed = 0;
+    const auto parse_begin = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < count; ++i) {
+        auto& out = parsed.emplace_back();
+        out.kind = stream_kind(frames[i].payload);
+        out.received_ms = frames[i].received_ms;
+        bool ok = false;
+        switch (out.kind) {
+            case StreamKind::Kline:
+                ok = parse_message(frames[i].payload, out.symbol, out.kline, fixed_point ? &out.fixed : nullptr, out.closed);
+                break;
+            case StreamKind::BookTicker:
+                ok = sentum::collector::FastBinanceBookTickerParser::parse(frames[i].payload, out.quote) &&
+                     (out.symbol = resolve_symbol(out.quote.symbol)).canonical;
+                break;
+            case StreamKind::AggTrade:
+                ok = sentum::collector::FastBinanceAggTradeParser::parse(frames[i].payload, out.trade) &&
+                     (out.symbol = resolve_symbol(out.trade.symbol)).canonical;
+                break;
+            case StreamKind::Depth: out.payload = frames[i].payload; ok = true; break;
+            case StreamKind::Unknown: break;
+        }
+        if (out.kind != StreamKind::Depth) ++timed;
+        if (!ok) parsed.pop_back();
+    }
+    if (timed > 0) {
+        const auto per_frame = elapsed_microseconds(parse_begin) / timed;
+        perf.parse_latency.observe(per_frame, timed);
+        shard.metrics->parse_latency.observe(per_frame, timed);
+    }
+
+    // Apply pass: store writes in arrival order, events and closed candles collected.
+    auto& events = shard.events;
+    auto& closed = shard.closed;
+    events.clear();
+    closed.clear();
+    std::uint64_t applied = 0;
+    for (auto& frame : parsed) {
+        switch (frame.kind) {
+            case StreamKind::Kline:
+                if (fixed_point) store_ref.upsert(frame.symbol.id, frame.fixed);
+                else store_ref.upsert(frame.symbol.id, frame.kline);
+                ++applied;
+                if (!frame.closed) break;
+                events.push_back(candle_event(frame.symbol.id, frame.kline));
+                closed.push_back({frame.symbol.id, frame.kline});
+                break;
+            case StreamKind::BookTicker: {
+                const auto book = top_of_book(frame.quote, frame.received_ms);
+                store_ref.update_book(frame.symbol.id, book);
+                ++applied;
+                events.push_back(quote_event(frame.symbol.id, book));
+                break;
+            }
+            case StreamKind::AggTrade:
+                store_ref.record_trade(frame.symbol.id, {frame.trade.trade_time, frame.trade.price, frame.trade.quantity, frame.trade.buyer_maker});
+                perf.feed_lag.observe(static_cast<std::uint64_t>(std::max<std::int64_t>(0, frame.received_ms - frame.trade.event_time)) * 1000);
+                ++applied;
+                events.push_back(agg_trade_event(frame.symbol.id, frame.trade));
+                break;
+            case StreamKind::Depth: on_depth(shard, frame.payload); break;
+            case StreamKind::Unknown: break;
+        }
+    }
+    if (applied > 0) {
+        perf.market_events.fetch_add(applied, std::memory_order_relaxed);
+        shard.metrics->events.fetch_add(applied, std::memory_order_relaxed);
+    }
+    if (!events.empty()) {
+        const auto dispatch_begin = std::chrono::steady_clock::now();
+        sentum::market::MarketEventBus::global().publish(MarketEventBatch{events.data(), events.size()});
+        perf.event_dispatch_latency.observe(elapsed_microseconds(dispatch_begin) / events.size(), events.size());
+    }
+    if (!closed.empty()) enqueue_batch(shard, closed);
+}
+
+void Collector::on_book_ticker(Shard& shard, std::string_view payload, std::int64_t received_ms) {
+    auto& perf = sentum::market::RuntimePerformanceMetrics::global();
+    sentum::collector::ParsedBookTicker parsed;
+    SymbolRef symbol;
+    {
+        sentum::market::ScopedLatency latency(perf.parse_latency, &shard.metrics->parse_latency);
+        if (!sentum::collector::FastBinanceBookTickerParser::parse(payload, parsed)) return;
+        symbol = resolve_symbol(parsed.symbol);
+        if (!symbol.canonical) return;
+    }
+    const auto book = top_of_book(parsed, received_ms);
+    store_ref.update_book(symbol.id, book);
+    perf.market_events.fetch_add(1, std::memory_order_relaxed);
+    shard.metrics->events.fetch_add(1, std::memory_order_relaxed);
+
+    const auto event = quote_event(symbol.id, book);
+    sentum::market::ScopedLatency latency(perf.event_dispatch_latency);
+    sentum::market::MarketEventBus::global().publish(event);
+}
+
+void Collector::on_agg_trade(Shard& shard, std::string_view payload, std::int64_t received_ms) {
+    auto& perf = sentum::market::RuntimePerformanceMetrics::global();
+    sentum::collector::ParsedAggTrade parsed;
+    SymbolRef symbol;
+    {
+        sentum::market::ScopedLatency latency(perf.parse_latency, &shard.metrics->parse_latency);
+        if (!sentum::collector::FastBinanceAggTradeParser::parse(payload, parsed)) return;
+        symbol = resolve_symbol(parsed.symbol);
+        if (!symbol.canonical) return;
+    }
+    store_ref.record_trade(symbol.id, {parsed.trade_time, parsed.price, parsed.quantity, parsed.buyer_maker});
+    perf.feed_lag.observe(static_cast<std::uint64_t>(std::max<std::int64_t>(0, received_ms - parsed.event_time)) * 1000);
+    perf.market_events.fetch_add(1, std::memory_order_relaxed);
+    shard.metrics->events.fetch_add(1, std::memory_order_relaxed);
+
+    const auto event = agg_trade_event(symbol.id, parsed);
+    sentum::market::ScopedLatency latency(perf.event_dispatch_latency);
+    sentum::market::MarketEventBus::global().publish(event);
+}
+
+void Collector::on_depth(Shard& shard, std::string_view payload) {
+    auto& perf = sentum::market::RuntimePerformanceMetrics::global();
+    sentum::collector::ParsedDepthUpdate parsed;
+    SymbolRef symbol;
+    {
+        sentum::market::ScopedLatency latency(perf.parse_latency, &shard.metrics->parse_latency);
+        if (!sentum::collector::FastBinanceDepthParser::parse(payload, parsed)) return;
+        symbol = resolve_symbol(parsed.symbol);
+        if (!symbol.canonical || !depth_books[symbol.index]) return;
+    }
+    auto& book = *depth_books[symbol.index];
+    record_depth(payload);
+    const auto result = book.on_diff(parsed, payload);
+    if (result == sentum::collector::DepthBook::Result::Invalid) return;
+    perf.market_events.fetch_add(1, std::memory_order_relaxed);
+    shard.metrics->events.fetch_add(1, std::memory_order_relaxed);
+    if (result == sentum::collector::DepthBook::Result::NeedsSnapshot)
+        logger.log("Depth book " + *symbol.canonical + " lost sequence at U=" + std::to_string(parsed.first_update_id) + ", resyncing");
+    if ((result == sentum::collector::DepthBook::Result::Buffered || result == sentum::collector::DepthBook::Result::NeedsSnapshot) &&
+        book.claim_snapshot()) request_depth_snapshot(symbol.index);
+}
+
+void Collector::request_depth_snapshot(std::size_t index) {
+    { std::lock_guard<std::mutex> lock(depth_mutex); depth_requests.push_back(index); }
+    depth_cv.notify_one();
+}
+
+void Collector::record_depth(std::string_view payload) {
+    if (!depth_record.is_open()) return;
+    std::lock_guard<std::mutex> lock(record_mutex);
+    depth_record.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+    depth_record.put('\n');
+}
+
+// Fetches REST snapshots for books that lost or never had their sequence, one at a time
+// so a burst of resyncs cannot exceed the REST request weight.
+void Collector::depth_loop() {
+    using namespace std::chrono_literals;
+    if (low_latency.enabled) sentum::runtime::apply_thread_tuning("sentum-depth", low_latency.persistence());
+    while (running.load(std::memory_order_acquire)) {
+        std::size_t index = 0;
+        {
+            std::unique_lock<std::mutex> lock(depth_mutex);
+            depth_cv.wait(lock, [this] { return !depth_requests.empty() || !running.load(); });
+            if (!running.load()) return;
+            index = depth_requests.front();
+            depth_requests.pop_front();
+        }
+        auto& book = *depth_books[index];
+        const auto snapshot = BinanceRestClient::get_depth_snapshot(markets[index].symbol, depth_snapshot_limit);
+        if (!snapshot.empty()) record_depth(snapshot);
+        const auto result = snapshot.empty() ? sentum::collector::DepthBook::Result::Invalid : book.on_snapshot(snapshot);
+        if (result == sentum::collector::DepthBook::Result::Invalid) {
+            book.snapshot_failed();
+            logger.log("Depth snapshot for " + canonical_symbols[index] + " failed");
+            std::unique_lock<std::mutex> lock(depth_mutex);
+            depth_cv.wait_for(lock, 1s, [this] { return !running.load(); });
+        } else if (result == sentum::collector::DepthBook::Result::NeedsSnapshot) {
+            logger.log("Depth snapshot for " + canonical_symbols[index] + " predates the buffered stream, refetching");
+        }
+    }
+}
+
+void Collector::on_kline(Shard& shard, std::string_view payload) {
+    auto& perf = sentum::market::RuntimePerformanceMetrics::global();
+    SymbolRef symbol;
+    Kline entry;
+    sentum::market::FixedKline fixed;
+    bool closed = false;
+    {
+        sentum::market::ScopedLatency latency(perf.parse_latency, &shard.metrics->parse_latency);
+        if (!parse_message(payload, symbol, entry, fixed_point ? &fixed : nullptr, closed)) return;
+    }
+    if (fixed_point) store_ref.upsert(symbol.id, fixed);
+    else store_ref.upsert(symbol.id, entry);
+    perf.market_events.fetch_add(1, std::memory_order_relaxed);
+    shard.metrics->events.fetch_add(1, std::memory_order_relaxed);
+
+    if (closed) {
+        const auto event = candle_event(symbol.id, entry);
+        {
+            sentum::market::ScopedLatency latency(perf.event_dispatch_latency);
+            sentum::market::MarketEventBus::global().publish(event);
+        }
+        try_enqueue(shard, symbol.id, std::move(entry));
+    }
 }
 
-void Collector::run() {
+bool Collector::parse_message(std::string_view payload, SymbolRef& symbol, Kline& entry,
+                              sentum::market::FixedKline* fixed, bool& closed) const noexcept {
+    if (!fixed) {
+        sentum::collector::ParsedKline parsed;
+        if (!sentum::collector::FastBinanceKlineParser::parse(payload, parsed)) return false;
+        symbol = resolve_symbol(parsed.symbol);
+        if (!symbol.canonical) return false;
+        entry = {parsed.timestamp, parsed.open, parsed.high, parsed.low, parsed.close, parsed.volume};
+        closed = parsed.closed;
+        return true;
+    }
+    sentum::collector::ParsedFixedKline parsed;
+    if (!sentum::collector::FastBinanceKlineParser::parse_fixed(payload, parsed)) return false;
+    symbol = resolve_symbol(parsed.symbol);
+    if (!symbol.canonical) return false;
+    const auto& scales = symbol_scales[symbol.index];
+    fixed->timestamp = parsed.timestamp;
+    if (!scales.price.from_decimal(parsed.open, fixed->open) || !scales.price.from_decimal(parsed.high, fixed->high) ||
+        !scales.price.from_decimal(parsed.low, fixed->low) || !scales.price.from_decimal(parsed.close, fixed->close) ||
+        !scales.quantity.from_decimal(parsed.volume, fixed->volume)) return false;
+    // Doubles derived from the grid value round-trip the exchange's decimal string exactly.
+    entry = {fixed->timestamp, scales.price.to_double(fixed->open), scales.price.to_double(fixed->high),
+             scales.price.to_double(fixed->low), scales.price.to_double(fixed->close), scales.quantity.to_double(fixed->volume)};
+    closed = parsed.closed;
+    return true;
+}
+
+template <typename Endpoint>
+void Collector::connect(Shard& shard, Endpoint& websocket) {
+    websocketpp::lib::error_code ec;
+    auto con = websocket.get_connection(shard.url, ec);
+    if (ec) throw std::runtime_error("Connection error: " + ec.message());
+    websocket.connect(con);
+}
+
+template <typename Endpoint>
+void Collector::schedule_reconnect(Shard& shard, Endpoint& websocket) {
+    if (!running.load(std::memory_order_acquire)) return;
+    const auto delay = shard.reconnect_delay;
+    shard.reconnect_delay = std::min(delay * 2, max_reconnect_delay);
+    shard.metrics->reconnects.fetch_add(1, std::memory_order_relaxed);
+    logger.log("Collector shard " + std::to_string(shard.index) + " disconnected, reconnecting in " + std::to_string(delay.count()) + "ms");
+    websocket.set_timer(static_cast<long>(delay.count()), [this, &shard, &websocket](const websocketpp::lib::error_code& ec) {
+        if (ec || !running.load(std::memory_order_acquire)) return;
+        try { connect(shard, websocket); }
+        catch (const std::exception& e) {
+            logger.log("Collector shard " + std::to_string(shard.index) + " reconnect error: " + e.what());
+            schedule_reconnect(shard, websocket);
+        }
+    });
+}
+
+void Collector::run(Shard& shard) {
+    if (low_latency.enabled) {
+        const auto name = "sentum-io-" + std::to_string(shard.index);
+        if (!sentum::runtime::apply_thread_tuning(name, low_latency.io(shard.index)))
+            logger.log("Collector shard " + std::to_string(shard.index) + ": CPU affinity or SCHED_FIFO was refused");
+    }
+    if (shard.plain) run_endpoint(shard, shard.plain_websocket);
+    else run_endpoint(shard, shard.websocket);
+    shard.metrics->connected.store(false, std::memory_order_relaxed);
+}
+
+template <typename Endpoint>
+void Collector::run_endpoint(Shard& shard, Endpoint& websocket) {
     try {
-        impl->websocket.init_asio();
-        impl->websocket.start_perpetual();
-        impl->websocket.clear_access_channels(websocketpp::log::alevel::all);
-        impl->websocket.clear_error_channels(websocketpp::log::elevel::all);
-        impl->websocket.set_tls_init_handler([](websocketpp::connection_hdl) {
-            auto ctx = websocketpp::lib::make_shared<boost::asio::ssl::context>(boost::asio::ssl::context::tls_client);
-            ctx->set_options(boost::asio::ssl::context::default_workarounds | boost::asio::ssl::context::no_sslv2 | boost::asio::ssl::context::no_sslv3);
-            return ctx;
+        websocket.init_asio();
+        websocket.start_perpetual();
+        websocket.clear_access_channels(websocketpp::log::alevel::all);
+        websocket.clear_error_channels(websocketpp::log::elevel::all);
+        if constexpr (std::is_same_v<Endpoint, client>) {
+            websocket.set_tls_init_handler([](websocketpp::connection_hdl) {
+                auto ctx = websocketpp::lib::make_shared<boost::asio::ssl::context>(boost::asio::ssl::context::tls_client);
+                ctx->set_options(boost::asio::ssl::context::default_workarounds | boost::asio::ssl::context::no_sslv2 | boost::asio::ssl::context::no_sslv3);
+                return ctx;
+            });
+        }
+        websocket.set_open_handler([&shard](websocketpp::connection_hdl hdl) {
+            std::lock_guard<std::mutex> lock(shard.mutex); shard.connection = hdl; shard.connection_valid = true;
+            shard.reconnect_delay = min_reconnect_delay;
+            shard.metrics->connected.store(true, std::memory_order_relaxed);
         });
-        impl->websocket.set_open_handler([this](websocketpp::connection_hdl hdl) {
-            std::lock_guard<std::mutex> lock(impl->mutex); impl->connection = hdl; impl->connection_valid = true;
+        websocket.set_close_handler([this, &shard, &websocket](websocketpp::connection_hdl) {
+            { std::lock_guard<std::mutex> lock(shard.mutex); shard.connection_valid = false; }
+            shard.metrics->connected.store(false, std::memory_order_relaxed);
+            schedule_reconnect(shard, websocket);
         });
-        impl->websocket.set_close_handler([this](websocketpp::connection_hdl) {
-            std::lock_guard<std::mutex> lock(impl->mutex); impl->connection_valid = false;
+        websocket.set_fail_handler([this, &shard, &websocket](websocketpp::connection_hdl) {
+            { std::lock_guard<std::mutex> lock(shard.mutex); shard.connection_valid = false; }
+            shard.metrics->connected.store(false, std::memory_order_relaxed);
+            schedule_reconnect(shard, websocket);
         });
-        impl->websocket.set_fail_handler([this](websocketpp::connection_hdl) {
-            std::lock_guard<std::mutex> lock(impl->mutex); impl->connection_valid = false;
-        });
-        impl->websocket.set_message_handler([this](websocketpp::connection_hdl, client::message_ptr msg) {
-            if (!running.load(std::memory_order_relaxed)) return;
-            sentum::collector::ParsedKline parsed;
-            {
-                sentum::market::ScopedLatency latency(sentum::market::RuntimePerformanceMetrics::global().parse_latency);
-                if (!sentum::collector::FastBinanceKlineParser::parse(msg->get_payload(), parsed)) return;
-            }
-            const auto symbol = resolve_symbol(parsed.symbol);
-            if (!symbol.canonical) return;
-            Kline entry;
-            entry.timestamp = parsed.timestamp;
-            entry.open = parsed.open; entry.high = parsed.high; entry.low = parsed.low; entry.close = parsed.close; entry.volume = parsed.volume;
-            store_ref.upsert(symbol.id, entry);
-            auto& perf = sentum::market::RuntimePerformanceMetrics::global();
-            perf.market_events.fetch_add(1, std::memory_order_relaxed);
-
-            if (parsed.closed) {
-                MarketEvent event;
-                event.type = MarketEvent::Type::Candle;
-                event.symbol_id = symbol.id;
-                event.symbol = *symbol.canonical;
-                event.timestamp = std::chrono::system_clock::time_point(std::chrono::milliseconds(entry.timestamp));
-                event.price = entry.close;
-                event.open = entry.open; event.high = entry.high; event.low = entry.low; event.close = entry.close; event.volume = entry.volume; event.closed = true;
-                {
-                    sentum::market::ScopedLatency latency(perf.event_dispatch_latency);
-                    sentum::market::MarketEventBus::global().publish(event);
-                }
-                try_enqueue(symbol.canonical, std::move(entry));
-            }
+        websocket.set_message_handler([this, &shard, &websocket](websocketpp::connection_hdl, typename Endpoint::message_ptr msg) {
+            const auto received_ns = now_nanoseconds();
+            const auto& payload = msg->get_payload();
+            if (frame_journal) frame_journal->append(static_cast<std::uint32_t>(shard.index), received_ns, payload);
+            if (!batch_frames) { on_message(shard, payload, received_ns / 1000000); return; }
+            shard.pending.push_back({payload, received_ns / 1000000});
+            shard.pending_owners.push_back(msg);
+            if (shard.pending.size() >= max_frame_batch) { drain_frames(shard); return; }
+            // websocketpp hands over every frame of a socket read before it reads again,
+            // so a handler posted behind the first one runs once the read is exhausted.
+            if (shard.drain_posted) return;
+            shard.drain_posted = true;
+            boost::asio::post(websocket.get_io_service(), [this, &shard] {
+                shard.drain_posted = false;
+                drain_frames(shard);
+            });
         });
 
-        std::string url = "wss://stream.binance.com:443/stream?streams=";
-        for (std::size_t i = 0; i < canonical_symbols.size(); ++i) {
-            url += canonical_symbols[i] + "@kline_1s";
-            if (i + 1 < canonical_symbols.size()) url += "/";
-        }
-        websocketpp::lib::error_code ec;
-        auto con = impl->websocket.get_connection(url, ec);
-        if (ec) throw std::runtime_error("Connection error: " + ec.message());
-        impl->websocket.connect(con);
-        impl->websocket.run();
+        connect(shard, websocket);
+        sentum::runtime::run_io_loop(websocket, low_latency.enabled);
     } catch (const std::exception& e) {
-        if (running.load()) logger.log(std::string("Collector run() error: ") + e.what());
+        if (running.load()) logger.log("Collector shard " + std::to_string(shard.index) + " run() error: " + e.what());
     }
-    running.store(false);
-    queue_cv.notify_all();
 }
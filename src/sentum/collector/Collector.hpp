@@ -1,67 +1,220 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstdint>
+#include <deque>
+#include <fstream>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <thread>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include <sentum/utils/Database.hpp>
 #include <sentum/utils/AsyncLogger.hpp>
 #include <sentum/api/model/MarketInfo.hpp>
+#include <sentum/collector/DepthBook.hpp>
+#include <sentum/collector/FrameJournal.hpp>
+#include <sentum/collector/KlineSpill.hpp>
+#include <sentum/core/ThreadTuning.hpp>
+#include <sentum/market/FixedPoint.hpp>
+#include <sentum/market/KlineArchive.hpp>
 #include <sentum/market/MarketDataStore.hpp>
 #include <sentum/market/SpscRingQueue.hpp>
 #include <sentum/market/SymbolId.hpp>
+#include <sentum/market/SymbolInterner.hpp>
+
+struct CollectorOptions {
+    // Requested connection count. The collector raises it when the universe
+    // would exceed Binance's per-connection stream limit.
+    std::size_t shards = 1;
+    // Combined-stream endpoint. ws:// connects without TLS, e.g. to sentum_feed_server.
+    std::string stream_url = "wss://stream.binance.com:443";
+    // Process the frames of each socket read as one batch: one parse timing, one bus
+    // publish (MarketEventBatch) and one writer wake-up instead of one per frame.
+    bool batch_frames = true;
+    // Keep candles on each symbol's tick grid (exact decimals, packed store series).
+    bool fixed_point = false;
+    // Also subscribe to @bookTicker (best bid/ask) and @aggTrade (trade tape) per symbol.
+    // Both go to the store and onto the bus as Quote and AggTrade events.
+    bool book_ticker = false;
+    bool agg_trades = false;
+    // Maintain local L2 books (sentum::collector::DepthBooks) for these symbols from
+    // @depth@100ms diffs plus REST snapshots of `depth_snapshot_limit` levels.
+    std::vector<std::string> depth_symbols;
+    int depth_snapshot_limit = 1000;
+    // Appends every depth diff and snapshot as one line, replayable with DepthReplayFeed.
+    std::string depth_record_path;
+    // Appends every websocket frame to a binary journal (sentum::collector::FrameJournal),
+    // replayable with Collector::replay.
+    std::string frame_journal_path;
+    // Closed klines go to the SQLite klines table and, with `archive_path` set, to the
+    // columnar archive in that directory (sentum::market::KlineArchiveWriter). Without
+    // the SQLite sink, warm_start reads the archive.
+    bool sqlite_sink = true;
+    std::string archive_path;
+    std::size_t archive_block_rows = sentum::market::KlineArchiveWriter::default_block_rows;
+    // WAL checkpoints run on a thread of their own every `wal_checkpoint_interval`
+    // instead of inside the writer's commits; zero keeps SQLite's wal_autocheckpoint.
+    // RESTART replaces PASSIVE once the WAL file exceeds `wal_restart_bytes`.
+    std::chrono::milliseconds wal_checkpoint_interval{1000};
+    std::uint64_t wal_restart_bytes = WalCheckpointer::default_restart_bytes;
+    // Closed klines that find their shard's queue full go to this file
+    // (sentum::collector::KlineSpill) instead of being dropped, up to `spill_max_bytes`.
+    // Empty drops them, as before.
+    std::string spill_path;
+    std::uint64_t spill_max_bytes = sentum::collector::KlineSpill::default_max_bytes;
+    // Pins io threads and spin-polls their sockets; the writer and depth threads move to
+    // the persistence cores and are polled instead of signalled.
+    sentum::runtime::LowLatencyOptions low_latency;
+};
+
+struct FrameReplayReport {
+    std::uint64_t frames = 0;
+    std::uint64_t bytes = 0;
+    bool truncated = false; // the journal ended inside a frame
+    std::chrono::nanoseconds elapsed{0};
+    std::chrono::nanoseconds recorded{0}; // span between the first and last frame
+};
+
+struct WarmStartReport {
+    std::size_t symbols = 0; // symbols that received at least one kline
+    std::size_t klines = 0;
+    std::chrono::milliseconds elapsed{0};
+};
 
 class Collector {
 public:
+    static constexpr std::size_t max_shards = 32;
+    static constexpr std::size_t max_streams_per_connection = 1024;
+
     Collector(Database& db, const std::vector<MarketInfo>& markets);
-    Collector(Database& db, MarketDataStore& store, const std::vector<MarketInfo>& markets);
+    Collector(Database& db, MarketDataStore& store, const std::vector<MarketInfo>& markets,
+              CollectorOptions options = {});
     ~Collector();
+    // Loads up to `bars` recent klines per symbol from the database (or the archive when
+    // it is the only sink) into the store, on `threads` workers that each read through
+    // their own connection. Klines opened more
+    // than `max_age` ago, or before the newest candle already in the store, are skipped.
+    // Call before start().
+    WarmStartReport warm_start(std::size_t bars, std::chrono::seconds max_age, std::size_t threads);
     void start();
     void stop();
+    // Feeds a frame journal through the live message path instead of connecting: each
+    // frame goes to the shard that received it, and closed candles reach the database
+    // writer. `speed` 1 keeps the recorded pacing, N plays N times faster and 0 plays
+    // as fast as possible, batched like socket reads when batch_frames is set. Runs on
+    // the calling thread; use it instead of start().
+    FrameReplayReport replay(const std::string& journal_path, double speed);
 
     std::uint64_t enqueued_count() const { return enqueued.load(std::memory_order_relaxed); }
     std::uint64_t dropped_count() const { return dropped.load(std::memory_order_relaxed); }
     double drop_rate() const;
-    std::size_t queue_depth() const { return queue.size_approx(); }
+    std::size_t queue_depth() const;
+    std::size_t shard_count() const noexcept { return shards.size(); }
+    // `symbol`'s PRICE_FILTER tick from the markets it was built with, in either case;
+    // empty for symbols it does not collect or that have no tick.
+    std::optional<sentum::market::FixedScale> price_scale(std::string symbol) const;
 
 private:
-    struct Impl;
+    struct Shard;
+    struct ParsedFrame;
+    struct Frame {
+        std::string_view payload;
+        std::int64_t received_ms = 0;
+    };
     struct SymbolRef {
         sentum::market::SymbolId id = sentum::market::kInvalidSymbolId;
+        std::size_t index = 0;
         const std::string* canonical = nullptr;
     };
 
-    void run();
+    void run(Shard& shard);
+    // Shards hold a TLS and a plain endpoint; these run on whichever the URL selected.
+    template <typename Endpoint> void run_endpoint(Shard& shard, Endpoint& websocket);
+    template <typename Endpoint> void connect(Shard& shard, Endpoint& websocket);
+    template <typename Endpoint> void schedule_reconnect(Shard& shard, Endpoint& websocket);
+    template <typename Endpoint> void stop_endpoint(Shard& shard, Endpoint& websocket);
+    void on_message(Shard& shard, std::string_view payload, std::int64_t received_ms);
+    void on_frames(Shard& shard, const Frame* frames, std::size_t count);
+    void drain_frames(Shard& shard);
+    void on_kline(Shard& shard, std::string_view payload);
+    void on_book_ticker(Shard& shard, std::string_view payload, std::int64_t received_ms);
+    void on_agg_trade(Shard& shard, std::string_view payload, std::int64_t received_ms);
+    void on_depth(Shard& shard, std::string_view payload);
+    void depth_loop();
+    void request_depth_snapshot(std::size_t index);
+    void record_depth(std::string_view payload);
+    bool parse_message(std::string_view payload, SymbolRef& symbol, Kline& entry, sentum::market::FixedKline* fixed, bool& closed) const noexcept;
+    void start_persistence();
     void writer_loop();
-    bool try_enqueue(const std::string* symbol, Kline kline);
+    void checkpoint_loop();
+    bool try_enqueue(Shard& shard, sentum::market::SymbolId symbol_id, Kline kline);
+    bool spill_kline(sentum::market::SymbolId symbol_id, const Kline& kline);
+    void enqueue_batch(Shard& shard, std::vector<KlineBatchItem>& items);
+    void notify_writer();
     SymbolRef resolve_symbol(std::string_view symbol) const noexcept;
     void initialize_symbols();
+    void initialize_depth(const CollectorOptions& options);
+    void initialize_shards(std::size_t requested, const std::string& stream_url);
 
     static constexpr std::size_t queue_capacity = 8192;
-    static constexpr std::size_t batch_size = 256;
+    // The writer's batch cap adapts between these (see writer_loop).
+    static constexpr std::size_t initial_batch_size = 256;
+    static constexpr std::size_t min_batch_size = 64;
+    static constexpr std::size_t max_batch_size = 4096;
+    static constexpr std::size_t batch_size_step = 64;
+    static constexpr std::chrono::milliseconds target_commit_latency{10};
+    // Spilled rows are fdatasynced by the writer at most this often.
+    static constexpr std::chrono::milliseconds spill_sync_interval{100};
+    // Frames per ingest batch; a longer socket read is processed in several.
+    static constexpr std::size_t max_frame_batch = 256;
     static constexpr double max_drop_rate = 0.001;
 
     Database& db_ref;
     MarketDataStore& store_ref;
     std::vector<MarketInfo> markets;
     std::vector<std::string> canonical_symbols;
-    std::unordered_map<std::uint64_t, std::size_t> symbol_by_hash;
-    std::thread ws_thread;
+    std::vector<sentum::market::SymbolScales> symbol_scales;
+    bool fixed_point = false;
+    bool book_ticker = false;
+    bool agg_trades = false;
+    bool batch_frames = true;
+    bool sqlite_sink = true;
+    std::unique_ptr<sentum::market::KlineArchiveWriter> archive;
+    std::chrono::milliseconds wal_checkpoint_interval{0};
+    std::uint64_t wal_restart_bytes = 0;
+    // Set while checkpoint_thread owns the checkpoints.
+    std::unique_ptr<WalCheckpointer> checkpointer;
+    std::thread checkpoint_thread;
+    std::mutex checkpoint_mutex;
+    std::condition_variable checkpoint_cv;
+    std::unique_ptr<sentum::collector::KlineSpill> spill;
+    sentum::runtime::LowLatencyOptions low_latency;
+    // Depth book per market index; null for symbols without depth.
+    std::vector<sentum::collector::DepthBook*> depth_books;
+    std::size_t depth_symbol_count = 0;
+    int depth_snapshot_limit = 1000;
+    std::thread depth_thread;
+    std::mutex depth_mutex;
+    std::condition_variable depth_cv;
+    std::deque<std::size_t> depth_requests;
+    std::mutex record_mutex;
+    std::ofstream depth_record;
+    std::unique_ptr<sentum::collector::FrameJournalWriter> frame_journal;
+    // Market index per interned SymbolId; npos for ids interned by other components.
+    std::vector<std::size_t> index_by_id;
+    std::vector<std::unique_ptr<Shard>> shards;
     std::thread writer_thread;
     std::atomic<bool> running{false};
     std::atomic<std::uint64_t> enqueued{0};
     std::atomic<std::uint64_t> dropped{0};
-    sentum::market::SpscRingQueue<KlineBatchItem, queue_capacity + 1> queue;
     std::mutex wait_mutex;
     std::condition_variable queue_cv;
     AsyncLogger logger;
-    std::unique_ptr<Impl> impl;
 };
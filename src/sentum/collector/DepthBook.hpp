@@ -0,0 +1,215 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <sentum/collector/FastBinanceDepthParser.hpp>
+#include <sentum/market/FixedPoint.hpp>
+#include <sentum/market/OrderBook.hpp>
+#include <sentum/market/SymbolId.hpp>
+
+namespace sentum::collector {
+
+// A local order book kept in step with Binance's diff-depth stream:
+//
+//  1. Diffs are buffered until a REST snapshot arrives.
+//  2. The snapshot replaces the book; buffered diffs with u <= lastUpdateId are dropped
+//     and the first one applied must straddle it (U <= lastUpdateId + 1 <= u).
+//  3. Every later diff must continue the sequence (U == previous u + 1). A gap clears
+//     the book and starts over at 1 with the diff that revealed it.
+//
+// The stream thread calls on_diff, a fetcher thread on_snapshot; readers go through
+// with_book. All of them take the book's mutex, which the stream thread holds for one
+// diff at a time.
+class DepthBook {
+public:
+    enum class Result : std::uint8_t {
+        Applied,       // the book moved forward
+        Buffered,      // held until a snapshot arrives
+        Stale,         // already covered by the snapshot
+        NeedsSnapshot, // out of sync; fetch a snapshot
+        Invalid        // malformed payload or a price off the grid
+    };
+
+    static constexpr std::size_t default_max_buffered = 2048;
+
+    explicit DepthBook(sentum::market::SymbolScales scales = {},
+                       std::size_t max_levels = sentum::market::OrderBook::default_max_levels,
+                       std::size_t max_buffered = default_max_buffered)
+        : book_(scales, max_levels), max_buffered_(std::max<std::size_t>(1, max_buffered)) {}
+
+    DepthBook(const DepthBook&) = delete;
+    DepthBook& operator=(const DepthBook&) = delete;
+
+    Result on_diff(std::string_view payload) {
+        ParsedDepthUpdate update;
+        if (!FastBinanceDepthParser::parse(payload, update)) return Result::Invalid;
+        return on_diff(update, payload);
+    }
+
+    // For callers that already parsed the payload, e.g. to route it by symbol.
+    Result on_diff(const ParsedDepthUpdate& update, std::string_view payload) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!live_) {
+            buffer_locked(payload);
+            return Result::Buffered;
+        }
+        return apply_locked(update, payload);
+    }
+
+    Result on_snapshot(std::string_view payload) {
+        ParsedDepthSnapshot snapshot;
+        if (!FastBinanceDepthParser::parse_snapshot(payload, snapshot)) {
+            snapshot_pending_.store(false, std::memory_order_release);
+            return Result::Invalid;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        snapshot_pending_.store(false, std::memory_order_release);
+        book_.clear();
+        if (!apply_levels_locked(sentum::market::BookSide::Bid, snapshot.bids) ||
+            !apply_levels_locked(sentum::market::BookSide::Ask, snapshot.asks)) {
+            book_.clear();
+            return Result::Invalid;
+        }
+        last_update_id_ = snapshot.last_update_id;
+        live_ = true;
+        ++snapshots_;
+
+        auto buffered = std::move(buffered_);
+        buffered_.clear();
+        for (std::size_t i = 0; i < buffered.size(); ++i) {
+            ParsedDepthUpdate update;
+            if (!FastBinanceDepthParser::parse(buffered[i], update)) continue;
+            if (apply_locked(update, buffered[i]) != Result::NeedsSnapshot) continue;
+            // The snapshot predates the buffered stream: keep the rest for the next one.
+            for (++i; i < buffered.size(); ++i) buffer_locked(buffered[i]);
+            return Result::NeedsSnapshot;
+        }
+        return Result::Applied;
+    }
+
+    // True once per desync for the caller that should fetch the snapshot. A failed
+    // fetch calls snapshot_failed so the next diff asks again.
+    bool claim_snapshot() noexcept {
+        if (live()) return false;
+        return !snapshot_pending_.exchange(true, std::memory_order_acq_rel);
+    }
+    void snapshot_failed() noexcept { snapshot_pending_.store(false, std::memory_order_release); }
+
+    bool live() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return live_;
+    }
+
+    // Runs visit(const OrderBook&) under the book's lock while it is in sync.
+    template <typename Visitor>
+    bool with_book(Visitor&& visit) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!live_) return false;
+        visit(book_);
+        return true;
+    }
+
+    bool estimate_fill(sentum::market::BookSide side, double quantity, sentum::market::FillEstimate& out) const {
+        return with_book([&](const sentum::market::OrderBook& book) { out = book.walk(side, quantity); });
+    }
+
+    std::int64_t last_update_id() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return last_update_id_;
+    }
+    std::uint64_t snapshots() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return snapshots_;
+    }
+    std::uint64_t resyncs() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return resyncs_;
+    }
+
+private:
+    Result apply_locked(const ParsedDepthUpdate& update, std::string_view payload) {
+        if (update.final_update_id <= last_update_id_) return Result::Stale;
+        if (update.first_update_id > last_update_id_ + 1 ||
+            !apply_levels_locked(sentum::market::BookSide::Bid, update.bids) ||
+            !apply_levels_locked(sentum::market::BookSide::Ask, update.asks)) {
+            desync_locked(payload);
+            return Result::NeedsSnapshot;
+        }
+        last_update_id_ = update.final_update_id;
+        return Result::Applied;
+    }
+
+    bool apply_levels_locked(sentum::market::BookSide side, std::string_view levels) {
+        const auto& scales = book_.scales();
+        return FastBinanceDepthParser::for_each_level(levels, [&](const sentum::market::Decimal& price, const sentum::market::Decimal& quantity) {
+            sentum::market::Price fixed_price;
+            sentum::market::Qty fixed_quantity;
+            if (!scales.price.from_decimal(price, fixed_price) || !scales.quantity.from_decimal(quantity, fixed_quantity)) return false;
+            book_.set_level(side, fixed_price, fixed_quantity);
+            return true;
+        });
+    }
+
+    void desync_locked(std::string_view payload) {
+        live_ = false;
+        book_.clear();
+        last_update_id_ = 0;
+        ++resyncs_;
+        buffered_.clear();
+        buffer_locked(payload);
+    }
+
+    void buffer_locked(std::string_view payload) {
+        if (buffered_.size() >= max_buffered_) buffered_.erase(buffered_.begin());
+        buffered_.emplace_back(payload);
+    }
+
+    mutable std::mutex mutex_;
+    sentum::market::OrderBook book_;
+    std::vector<std::string> buffered_;
+    std::size_t max_buffered_;
+    std::int64_t last_update_id_ = 0;
+    bool live_ = false;
+    std::uint64_t snapshots_ = 0;
+    std::uint64_t resyncs_ = 0;
+    std::atomic<bool> snapshot_pending_{false};
+};
+
+// Depth books by SymbolId, for the symbols the collector maintains them for.
+class DepthBooks {
+public:
+    static DepthBooks& global() {
+        static DepthBooks instance;
+        return instance;
+    }
+
+    DepthBook& add(sentum::market::SymbolId id, const sentum::market::SymbolScales& scales,
+                   std::size_t max_levels = sentum::market::OrderBook::default_max_levels) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        if (books_.size() <= id) books_.resize(static_cast<std::size_t>(id) + 1);
+        if (!books_[id]) books_[id] = std::make_unique<DepthBook>(scales, max_levels);
+        return *books_[id];
+    }
+
+    // Books stay registered for the process lifetime, so the pointer remains valid.
+    const DepthBook* find(sentum::market::SymbolId id) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return id < books_.size() ? books_[id].get() : nullptr;
+    }
+
+private:
+    mutable std::shared_mutex mutex_;
+    std::vector<std::unique_ptr<DepthBook>> books_;
+};
+
+} // namespace sentum::collector
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+#include <sentum/collector/DepthBook.hpp>
+
+namespace sentum::collector {
+
+struct DepthReplayStats {
+    std::uint64_t diffs = 0;
+    std::uint64_t applied = 0;
+    std::uint64_t buffered = 0;
+    std::uint64_t stale = 0;
+    std::uint64_t invalid = 0;
+    std::uint64_t resyncs = 0;
+    std::uint64_t snapshots_served = 0;
+    std::uint64_t snapshots_skipped = 0;
+};
+
+// Offline stand-in for the depth stream and the REST snapshot endpoint, fed from a
+// recording with one payload per line (as written by the collector's depthRecordPath):
+// diff events in stream order with snapshot responses interleaved where they were
+// fetched. A recorded snapshot is handed to the book only while the book is out of
+// sync, as the collector's fetcher would; otherwise it is skipped.
+class DepthReplayFeed {
+public:
+    explicit DepthReplayFeed(DepthBook& book) : book_(book) {}
+
+    DepthBook::Result feed(std::string_view line) {
+        while (!line.empty() && (line.back() == '\r' || line.back() == '\n')) line.remove_suffix(1);
+        if (line.empty()) return DepthBook::Result::Stale;
+        if (line.find("\"lastUpdateId\"") != std::string_view::npos) return serve_snapshot(line);
+
+        ++stats_.diffs;
+        const auto result = book_.on_diff(line);
+        switch (result) {
+            case DepthBook::Result::Applied: ++stats_.applied; break;
+            case DepthBook::Result::Buffered: ++stats_.buffered; break;
+            case DepthBook::Result::Stale: ++stats_.stale; break;
+            case DepthBook::Result::Invalid: ++stats_.invalid; break;
+            case DepthBook::Result::NeedsSnapshot: ++stats_.resyncs; break;
+        }
+        return result;
+    }
+
+    // Replays a whole recording; false when it cannot be opened.
+    bool replay_file(const std::string& path) {
+        std::ifstream input(path);
+        if (!input) return false;
+        std::string line;
+        while (std::getline(input, line)) feed(line);
+        return true;
+    }
+
+    const DepthReplayStats& stats() const noexcept { return stats_; }
+
+private:
+    DepthBook::Result serve_snapshot(std::string_view line) {
+        // A book out of sync is always waiting for a snapshot.
+        if (!book_.claim_snapshot()) {
+            ++stats_.snapshots_skipped;
+            return DepthBook::Result::Stale;
+        }
+        ++stats_.snapshots_served;
+        const auto result = book_.on_snapshot(line);
+        if (result == DepthBook::Result::Invalid) ++stats_.invalid;
+        if (result == DepthBook::Result::NeedsSnapshot) ++stats_.resyncs;
+        return result;
+    }
+
+    DepthBook& book_;
+    DepthReplayStats stats_;
+};
+
+} // namespace sentum::collector
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include <sentum/collector/QuoteScanner.hpp>
+#include <sentum/market/FixedPoint.hpp>
+
+namespace sentum::collector {
+
+struct ParsedBookTicker {
+    std::string_view symbol;
+    std::int64_t update_id = 0;
+    double bid_price = 0.0;
+    double bid_quantity = 0.0;
+    double ask_price = 0.0;
+    double ask_quantity = 0.0;
+};
+
+struct ParsedFixedBookTicker {
+    std::string_view symbol;
+    std::int64_t update_id = 0;
+    sentum::market::Decimal bid_price, bid_quantity, ask_price, ask_quantity;
+};
+
+// Extracts the fields of a Binance @bookTicker event (raw or combined-stream envelope)
+// without building a JSON DOM or allocating. The spot payload carries no event time.
+class FastBinanceBookTickerParser {
+public:
+    static constexpr const char* backend() noexcept { return QuoteScanner::backend(); }
+
+    static bool parse(std::string_view payload, ParsedBookTicker& out) noexcept {
+        ParsedFixedBookTicker fixed;
+        if (!parse_fixed(payload, fixed)) return false;
+        out.symbol = fixed.symbol;
+        out.update_id = fixed.update_id;
+        out.bid_price = sentum::market::to_double(fixed.bid_price);
+        out.bid_quantity = sentum::market::to_double(fixed.bid_quantity);
+        out.ask_price = sentum::market::to_double(fixed.ask_price);
+        out.ask_quantity = sentum::market::to_double(fixed.ask_quantity);
+        return true;
+    }
+
+    static bool parse_fixed(std::string_view payload, ParsedFixedBookTicker& out) noexcept {
+        const char* const begin = payload.data();
+        const char* const end = begin + payload.size();
+        Offsets offsets;
+        const bool complete = QuoteScanner::scan(begin, payload.size(), [&](std::size_t q) {
+            const int slot = slot_for(QuoteScanner::single_char_key(begin, payload.size(), q));
+            if (slot < 0 || (offsets.found & (1u << slot))) return false;
+            offsets.at[slot] = q + 4;
+            offsets.found |= 1u << slot;
+            return offsets.found == all_slots;
+        });
+        if (!complete) return false;
+
+        return string_at(begin + offsets.at[slot_s], end, out.symbol) &&
+               integer_at(begin + offsets.at[slot_u], end, out.update_id) &&
+               decimal_at(begin + offsets.at[slot_b], end, out.bid_price) &&
+               decimal_at(begin + offsets.at[slot_B], end, out.bid_quantity) &&
+               decimal_at(begin + offsets.at[slot_a], end, out.ask_price) &&
+               decimal_at(begin + offsets.at[slot_A], end, out.ask_quantity);
+    }
+
+private:
+    enum Slot : std::uint8_t { slot_u, slot_s, slot_b, slot_B, slot_a, slot_A, slot_count };
+    static constexpr std::uint32_t all_slots = (1u << slot_count) - 1;
+
+    struct Offsets {
+        std::size_t at[slot_count];
+        std::uint32_t found = 0;
+    };
+
+    static int slot_for(char key) noexcept {
+        switch (key) {
+            case 'u': return slot_u; case 's': return slot_s; case 'b': return slot_b;
+            case 'B': return slot_B; case 'a': return slot_a; case 'A': return slot_A;
+            default: return -1;
+        }
+    }
+};
+
+} // namespace sentum::collector
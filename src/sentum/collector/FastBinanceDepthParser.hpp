@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include <sentum/collector/QuoteScanner.hpp>
+#include <sentum/market/FixedPoint.hpp>
+
+namespace sentum::collector {
+
+// Header of a Binance @depth / @depth@100ms diff event. `bids` and `asks` are the raw
+// level arrays, read with FastBinanceDepthParser::for_each_level.
+struct ParsedDepthUpdate {
+    std::string_view symbol;
+    std::int64_t event_time = 0;
+    std::int64_t first_update_id = 0; // U
+    std::int64_t final_update_id = 0; // u
+    std::string_view bids, asks;
+};
+
+// REST /api/v3/depth response.
+struct ParsedDepthSnapshot {
+    std::int64_t last_update_id = 0;
+    std::string_view bids, asks;
+};
+
+// Extracts depth diffs (raw or combined-stream envelope) and depth snapshots without
+// building a JSON DOM or allocating. Levels are visited as exact wire decimals.
+class FastBinanceDepthParser {
+public:
+    static constexpr const char* backend() noexcept { return QuoteScanner::backend(); }
+
+    static bool parse(std::string_view payload, ParsedDepthUpdate& out) noexcept {
+        const char* const begin = payload.data();
+        const char* const end = begin + payload.size();
+        Offsets offsets;
+        const bool complete = QuoteScanner::scan(begin, payload.size(), [&](std::size_t q) {
+            const int slot = slot_for(QuoteScanner::single_char_key(begin, payload.size(), q));
+            if (slot < 0 || (offsets.found & (1u << slot))) return false;
+            offsets.at[slot] = q + 4;
+            offsets.found |= 1u << slot;
+            return offsets.found == all_slots;
+        });
+        if (!complete) return false;
+
+        return string_at(begin + offsets.at[slot_s], end, out.symbol) &&
+               integer_at(begin + offsets.at[slot_E], end, out.event_time) &&
+               integer_at(begin + offsets.at[slot_U], end, out.first_update_id) &&
+               integer_at(begin + offsets.at[slot_u], end, out.final_update_id) &&
+               array_at(begin + offsets.at[slot_b], end, out.bids) &&
+               array_at(begin + offsets.at[slot_a], end, out.asks);
+    }
+
+    static bool parse_snapshot(std::string_view payload, ParsedDepthSnapshot& out) noexcept {
+        const char* const end = payload.data() + payload.size();
+        const char* id = value_of(payload, "\"lastUpdateId\":");
+        const char* bids = value_of(payload, "\"bids\":");
+        const char* asks = value_of(payload, "\"asks\":");
+        return id && bids && asks && integer_at(id, end, out.last_update_id) &&
+               array_at(bids, end, out.bids) && array_at(asks, end, out.asks);
+    }
+
+    // Calls visit(price, quantity) for each ["price","quantity"] pair; a false return
+    // from the visitor stops the walk and fails it.
+    template <typename Visitor>
+    static bool for_each_level(std::string_view levels, Visitor&& visit) {
+        const char* p = levels.data();
+        const char* const end = p + levels.size();
+        if (p == end || *p != '[') return false;
+        ++p;
+        if (p < end && *p == ']') return true;
+        while (p < end) {
+            sentum::market::Decimal price, quantity;
+            if (*p != '[' || !(p = quoted_decimal(p + 1, end, price)) || p >= end || *p != ',' ||
+                !(p = quoted_decimal(p + 1, end, quantity)) || p >= end || *p != ']') return false;
+            if (!visit(price, quantity)) return false;
+            ++p;
+            if (p < end && *p == ',') { ++p; continue; }
+            return p < end && *p == ']';
+        }
+        return false;
+    }
+
+private:
+    enum Slot : std::uint8_t { slot_s, slot_E, slot_U, slot_u, slot_b, slot_a, slot_count };
+    static constexpr std::uint32_t all_slots = (1u << slot_count) - 1;
+
+    struct Offsets {
+        std::size_t at[slot_count];
+        std::uint32_t found = 0;
+    };
+
+    static int slot_for(char key) noexcept {
+        switch (key) {
+            case 's': return slot_s; case 'E': return slot_E; case 'U': return slot_U;
+            case 'u': return slot_u; case 'b': return slot_b; case 'a': return slot_a;
+            default: return -1;
+        }
+    }
+
+    static const char* value_of(std::string_view payload, std::string_view key) noexcept {
+        const auto at = payload.find(key);
+        return at == std::string_view::npos ? nullptr : payload.data() + at + key.size();
+    }
+
+    // Level values never contain brackets, so the array ends at the first "]]" (or is "[]").
+    static bool array_at(const char* p, const char* end, std::string_view& out) noexcept {
+        if (p >= end || *p != '[') return false;
+        if (end - p >= 2 && p[1] == ']') { out = std::string_view(p, 2); return true; }
+        for (const char* q = p + 1; q < end;) {
+            q = static_cast<const char*>(std::memchr(q, ']', static_cast<std::size_t>(end - q)));
+            if (!q || q + 1 >= end) return false;
+            if (q[1] == ']') { out = std::string_view(p, static_cast<std::size_t>(q + 2 - p)); return true; }
+            ++q;
+        }
+        return false;
+    }
+
+    static const char* quoted_decimal(const char* p, const char* end, sentum::market::Decimal& value) noexcept {
+        if (p >= end || *p != '\"') return nullptr;
+        p = sentum::market::scan_decimal(p + 1, end, value);
+        if (!p || p >= end || *p != '\"') return nullptr;
+        return p + 1;
+    }
+};
+
+} // namespace sentum::collector
@@ -1,9 +1,14 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <stdexcept>
 #include <string_view>
 
+#include <sentum/collector/QuoteScanner.hpp>
+#include <sentum/market/FixedPoint.hpp>
+
 namespace sentum::collector {
 
 struct ParsedKline {
@@ -17,9 +22,35 @@ struct ParsedKline {
     bool closed = false;
 };
 
+// Same fields with prices and volume kept as exact wire decimals, for callers that
+// rescale onto a symbol's fixed-point grid instead of rounding through double.
+struct ParsedFixedKline {
+    std::string_view symbol;
+    std::int64_t timestamp = 0;
+    sentum::market::Decimal open, high, low, close, volume;
+    bool closed = false;
+};
+
 class FastBinanceKlineParser {
 public:
-    static bool parse(std::string_view payload, ParsedKline& out) noexcept {
+    static constexpr const char* backend() noexcept { return QuoteScanner::backend(); }
+
+    static bool parse(std::string_view payload, ParsedKline& out) noexcept { return parse_single_pass(payload, out); }
+
+    // Parses `count` payloads into `out[0..count)`. Entries that fail to parse are reset
+    // and keep an empty symbol; the return value is the number of successful parses.
+    static std::size_t parse_batch(const std::string_view* payloads, std::size_t count, ParsedKline* out) noexcept {
+        std::size_t parsed = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            if (i + 1 < count) __builtin_prefetch(payloads[i + 1].data());
+            if (parse_single_pass(payloads[i], out[i])) ++parsed;
+            else out[i] = ParsedKline{};
+        }
+        return parsed;
+    }
+
+    // Reference path: one substring search per key and digit-by-digit decimals.
+    static bool parse_scalar(std::string_view payload, ParsedKline& out) noexcept {
         const auto kline = payload.find("\"k\":{");
         if (kline == std::string_view::npos) return false;
         const auto body = payload.substr(kline + 5);
@@ -33,7 +64,80 @@ public:
                bool_field(body, "x", out.closed);
     }
 
+    // Locates every required key in one pass over the payload, using vector quote
+    // detection when the target supports it, then converts values with SWAR digits.
+    static bool parse_single_pass(std::string_view payload, ParsedKline& out) noexcept {
+        ParsedFixedKline fixed;
+        if (!parse_fixed(payload, fixed)) return false;
+        out.symbol = fixed.symbol;
+        out.timestamp = fixed.timestamp;
+        out.open = sentum::market::to_double(fixed.open);
+        out.high = sentum::market::to_double(fixed.high);
+        out.low = sentum::market::to_double(fixed.low);
+        out.close = sentum::market::to_double(fixed.close);
+        out.volume = sentum::market::to_double(fixed.volume);
+        out.closed = fixed.closed;
+        return true;
+    }
+
+    static bool parse_fixed(std::string_view payload, ParsedFixedKline& out) noexcept {
+        const char* const begin = payload.data();
+        const char* const end = begin + payload.size();
+        Offsets offsets;
+        if (!locate_fields(begin, payload.size(), offsets)) return false;
+
+        if (!string_at(begin + offsets.at[slot_s], end, out.symbol) ||
+            !integer_at(begin + offsets.at[slot_t], end, out.timestamp) ||
+            !decimal_at(begin + offsets.at[slot_o], end, out.open) ||
+            !decimal_at(begin + offsets.at[slot_h], end, out.high) ||
+            !decimal_at(begin + offsets.at[slot_l], end, out.low) ||
+            !decimal_at(begin + offsets.at[slot_c], end, out.close) ||
+            !decimal_at(begin + offsets.at[slot_v], end, out.volume)) return false;
+
+        const char* p = begin + offsets.at[slot_x];
+        if (end - p >= 4 && std::memcmp(p, "true", 4) == 0) { out.closed = true; return true; }
+        if (end - p >= 5 && std::memcmp(p, "false", 5) == 0) { out.closed = false; return true; }
+        return false;
+    }
+
 private:
+    enum Slot : std::uint8_t { slot_s, slot_t, slot_o, slot_h, slot_l, slot_c, slot_v, slot_x, slot_count };
+    static constexpr std::uint32_t all_slots = (1u << slot_count) - 1;
+
+    struct Offsets {
+        std::size_t at[slot_count];
+        std::uint32_t found = 0;
+        bool in_kline = false;
+    };
+
+    static int slot_for(char key) noexcept {
+        switch (key) {
+            case 's': return slot_s; case 't': return slot_t; case 'o': return slot_o; case 'h': return slot_h;
+            case 'l': return slot_l; case 'c': return slot_c; case 'v': return slot_v; case 'x': return slot_x;
+            default: return -1;
+        }
+    }
+
+    // Single-character keys are recorded once the "k":{ object has been entered, so the
+    // outer event's "s" and "E" are ignored. Stops the scan when every slot is filled.
+    static bool on_quote(const char* data, std::size_t size, std::size_t q, Offsets& offsets) noexcept {
+        const char key = QuoteScanner::single_char_key(data, size, q);
+        if (!key) return false;
+        if (!offsets.in_kline) {
+            if (key == 'k' && data[q + 4] == '{') offsets.in_kline = true;
+            return false;
+        }
+        const int slot = slot_for(key);
+        if (slot < 0 || (offsets.found & (1u << slot))) return false;
+        offsets.at[slot] = q + 4;
+        offsets.found |= 1u << slot;
+        return offsets.found == all_slots;
+    }
+
+    static bool locate_fields(const char* data, std::size_t size, Offsets& offsets) noexcept {
+        return QuoteScanner::scan(data, size, [&](std::size_t q) { return on_quote(data, size, q, offsets); });
+    }
+
     static std::size_t value_pos(std::string_view body, std::string_view key) noexcept {
         char pattern[8] = {'\"', 0, '\"', ':', 0, 0, 0, 0};
         if (key.size() != 1) return std::string_view::npos;
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include <sentum/collector/QuoteScanner.hpp>
+#include <sentum/market/FixedPoint.hpp>
+
+namespace sentum::collector {
+
+struct ParsedTrade {
+    std::string_view symbol;
+    std::int64_t trade_id = 0;
+    std::int64_t event_time = 0;
+    double price = 0.0;
+    double quantity = 0.0;
+    bool buyer_maker = false;
+};
+
+struct ParsedFixedTrade {
+    std::string_view symbol;
+    std::int64_t trade_id = 0;
+    std::int64_t event_time = 0;
+    sentum::market::Decimal price, quantity;
+    bool buyer_maker = false;
+};
+
+// Extracts the fields of a Binance @trade event (raw or combined-stream envelope)
+// without building a JSON DOM or allocating.
+class FastBinanceTradeParser {
+public:
+    static constexpr const char* backend() noexcept { return QuoteScanner::backend(); }
+
+    static bool parse(std::string_view payload, ParsedTrade& out) noexcept {
+        ParsedFixedTrade fixed;
+        if (!parse_fixed(payload, fixed)) return false;
+        out.symbol = fixed.symbol;
+        out.trade_id = fixed.trade_id;
+        out.event_time = fixed.event_time;
+        out.price = sentum::market::to_double(fixed.price);
+        out.quantity = sentum::market::to_double(fixed.quantity);
+        out.buyer_maker = fixed.buyer_maker;
+        return true;
+    }
+
+    static bool parse_fixed(std::string_view payload, ParsedFixedTrade& out) noexcept {
+        const char* const begin = payload.data();
+        const char* const end = begin + payload.size();
+        Offsets offsets;
+        const bool complete = QuoteScanner::scan(begin, payload.size(), [&](std::size_t q) {
+            const int slot = slot_for(QuoteScanner::single_char_key(begin, payload.size(), q));
+            if (slot < 0 || (offsets.found & (1u << slot))) return false;
+            offsets.at[slot] = q + 4;
+            offsets.found |= 1u << slot;
+            return offsets.found == all_slots;
+        });
+        if (!complete) return false;
+
+        if (!string_at(begin + offsets.at[slot_s], end, out.symbol) ||
+            !integer_at(begin + offsets.at[slot_t], end, out.trade_id) ||
+            !integer_at(begin + offsets.at[slot_E], end, out.event_time) ||
+            !decimal_at(begin + offsets.at[slot_p], end, out.price) ||
+            !decimal_at(begin + offsets.at[slot_q], end, out.quantity)) return false;
+
+        const char* p = begin + offsets.at[slot_m];
+        if (end - p >= 4 && std::memcmp(p, "true", 4) == 0) { out.buyer_maker = true; return true; }
+        if (end - p >= 5 && std::memcmp(p, "false", 5) == 0) { out.buyer_maker = false; return true; }
+        return false;
+    }
+
+private:
+    enum Slot : std::uint8_t { slot_s, slot_t, slot_E, slot_p, slot_q, slot_m, slot_count };
+    static constexpr std::uint32_t all_slots = (1u << slot_count) - 1;
+
+    struct Offsets {
+        std::size_t at[slot_count];
+        std::uint32_t found = 0;
+    };
+
+    static int slot_for(char key) noexcept {
+        switch (key) {
+            case 's': return slot_s; case 't': return slot_t; case 'E': return slot_E;
+            case 'p': return slot_p; case 'q': return slot_q; case 'm': return slot_m;
+            default: return -1;
+        }
+    }
+};
+
+} // namespace sentum::collector
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sentum::collector {
+
+// Binary journal of raw websocket frames. After an 8-byte magic, each frame is a
+// 16-byte header followed by the payload bytes:
+//
+//   int64  received_ns  receive time, nanoseconds since the Unix epoch
+//   uint32 connection   collector shard that received the frame
+//   uint32 length       payload bytes
+//
+// Fields are little-endian, as on every machine the collector runs on.
+struct FrameJournalFormat {
+    static constexpr char magic[8] = {'S', 'N', 'T', 'M', 'F', 'R', 'J', '1'};
+    static constexpr std::size_t frame_header_bytes = 16;
+    // Larger frames are treated as corruption by the reader.
+    static constexpr std::uint32_t max_frame_bytes = 64u << 20;
+};
+
+struct JournalFrame {
+    std::int64_t received_ns = 0;
+    std::uint32_t connection = 0;
+    std::string_view payload;
+};
+
+// Appends frames from any number of shard threads. Frames are staged in a buffer and
+// written in large blocks, so capture adds one short critical section per frame.
+class FrameJournalWriter {
+public:
+    explicit FrameJournalWriter(const std::string& path) : out_(path, std::ios::binary | std::ios::app) {
+        if (!out_) throw std::runtime_error("Cannot open frame journal " + path);
+        out_.seekp(0, std::ios::end);
+        if (out_.tellp() == 0) out_.write(FrameJournalFormat::magic, sizeof(FrameJournalFormat::magic));
+        buffer_.reserve(flush_bytes + 4096);
+    }
+
+    ~FrameJournalWriter() { flush(); }
+
+    FrameJournalWriter(const FrameJournalWriter&) = delete;
+    FrameJournalWriter& operator=(const FrameJournalWriter&) = delete;
+
+    void append(std::uint32_t connection, std::int64_t received_ns, std::string_view payload) {
+        char header[FrameJournalFormat::frame_header_bytes];
+        const auto length = static_cast<std::uint32_t>(payload.size());
+        std::memcpy(header, &received_ns, 8);
+        std::memcpy(header + 8, &connection, 4);
+        std::memcpy(header + 12, &length, 4);
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffer_.insert(buffer_.end(), header, header + sizeof(header));
+        buffer_.insert(buffer_.end(), payload.begin(), payload.end());
+        ++frames_;
+        if (buffer_.size() >= flush_bytes) write_buffer();
+    }
+
+    void flush() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        write_buffer();
+        out_.flush();
+    }
+
+    std::uint64_t frames() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return frames_;
+    }
+
+private:
+    static constexpr std::size_t flush_bytes = 1u << 20;
+
+    void write_buffer() {
+        if (buffer_.empty()) return;
+        out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        buffer_.clear();
+    }
+
+    std::ofstream out_;
+    mutable std::mutex mutex_;
+    std::vector<char> buffer_;
+    std::uint64_t frames_ = 0;
+};
+
+// Reads a journal front to back. The payload view stays valid until the next call to
+// next(). A truncated final frame (from a capture that was killed) ends the journal.
+class FrameJournalReader {
+public:
+    explicit FrameJournalReader(const std::string& path) : in_(path, std::ios::binary) {
+        char magic[sizeof(FrameJournalFormat::magic)];
+        valid_ = in_.read(magic, sizeof(magic)) && std::memcmp(magic, FrameJournalFormat::magic, sizeof(magic)) == 0;
+    }
+
+    // False when the file is missing or is not a frame journal.
+    explicit operator bool() const noexcept { return valid_; }
+
+    bool next(JournalFrame& frame) {
+        if (!valid_) return false;
+        char header[FrameJournalFormat::frame_header_bytes];
+        if (!in_.read(header, sizeof(header))) { truncated_ = in_.gcount() > 0; return false; }
+        std::uint32_t length = 0;
+        std::memcpy(&frame.received_ns, header, 8);
+        std::memcpy(&frame.connection, header + 8, 4);
+        std::memcpy(&length, header + 12, 4);
+        if (length > FrameJournalFormat::max_frame_bytes) { truncated_ = true; return false; }
+        payload_.resize(length);
+        if (!in_.read(payload_.data(), length)) { truncated_ = true; return false; }
+        frame.payload = std::string_view(payload_.data(), length);
+        return true;
+    }
+
+    // The journal ended inside a frame.
+    bool truncated() const noexcept { return truncated_; }
+
+private:
+    std::ifstream in_;
+    std::string payload_;
+    bool valid_ = false;
+    bool truncated_ = false;
+};
+
+} // namespace sentum::collector
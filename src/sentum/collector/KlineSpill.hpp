@@ -0,0 +1,412 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <sentum/market/RuntimePerformanceMetrics.hpp>
+#include <sentum/market/SymbolInterner.hpp>
+#include <sentum/utils/Database.hpp>
+
+namespace sentum::collector {
+
+// Overflow file of the collector's persistence queues. After an 8-byte magic, each
+// closed kline is one fixed 80-byte record:
+//
+//   char[24] symbol      as the collector writes it, NUL-padded
+//   int64    spilled_ms  wall-clock time the record was spilled
+//   int64    timestamp   kline open time, then open, high, low, close and volume as doubles
+//
+// Fields are little-endian, as on every machine the collector runs on. The symbol is
+// stored by name because SymbolIds do not survive a restart.
+struct KlineSpillFormat {
+    static constexpr char magic[8] = {'S', 'N', 'T', 'M', 'S', 'P', 'L', '1'};
+    static constexpr std::size_t header_bytes = sizeof(magic);
+    static constexpr std::size_t symbol_bytes = 24;
+    static constexpr std::size_t record_bytes = symbol_bytes + 8 + 48;
+};
+
+// Appended by any number of shard threads when their ring is full, drained by the
+// writer thread once it catches up: peek() a batch, commit() it once it is stored.
+// Records are staged in memory and written in 64 KiB runs, or after `flush_interval`
+// so a crash loses little. The mutex only guards the staging buffers and offsets: the
+// thread that writes swaps the full buffer for the empty spare and writes it unlocked,
+// while the others keep staging. sync() makes the file durable and runs on the writer
+// thread, so shard threads never wait for fdatasync. Records left over from a previous
+// run are recovered on open and drained first. Once everything is drained the file is
+// truncated back to its header, so it only takes space during a backlog, and never
+// more than `max_bytes`.
+class KlineSpill {
+public:
+    static constexpr std::uint64_t default_max_bytes = 1ull << 30;
+
+    explicit KlineSpill(std::string path, std::uint64_t max_bytes = default_max_bytes) : path_(std::move(path)), max_bytes_(max_bytes) {
+#if !defined(_WIN32)
+        fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+#endif
+        if (fd_ < 0) throw std::runtime_error("Cannot open kline spill file " + path_);
+        recover();
+        buffer_.reserve(flush_bytes + KlineSpillFormat::record_bytes);
+        writing_buffer_.reserve(flush_bytes + KlineSpillFormat::record_bytes);
+    }
+
+    ~KlineSpill() {
+        sync();
+#if !defined(_WIN32)
+        if (fd_ >= 0) ::close(fd_);
+#endif
+    }
+
+    KlineSpill(const KlineSpill&) = delete;
+    KlineSpill& operator=(const KlineSpill&) = delete;
+
+    // False when the file would grow past max_bytes, the symbol does not fit a record or
+    // the write failed; the caller counts the row as dropped.
+    bool append(std::string_view symbol, const Kline& kline) {
+        if (symbol.empty() || symbol.size() >= KlineSpillFormat::symbol_bytes) return reject();
+        const auto now_ms = wall_ms();
+        char record[KlineSpillFormat::record_bytes] = {};
+        std::memcpy(record, symbol.data(), symbol.size());
+        encode(record + KlineSpillFormat::symbol_bytes, now_ms, kline);
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (end_offset() + sizeof(record) > max_bytes_) return reject();
+        if (buffer_.empty()) staged_since_ms_ = now_ms;
+        buffer_.insert(buffer_.end(), record, record + sizeof(record));
+        if (pending_ == 0) oldest_ms_ = now_ms;
+        ++pending_;
+        auto& metrics = metrics_();
+        metrics.spilled.fetch_add(1, std::memory_order_relaxed);
+        publish_depth();
+        if ((buffer_.size() >= flush_bytes || now_ms - staged_since_ms_ >= flush_interval.count()) && !write_buffer(lock)) {
+            // Keep the staged records; the next append or sync() retries the write.
+            metrics.write_errors.fetch_add(1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    // Copies up to `max` of the oldest records into `out`, oldest first, and leaves them
+    // in the spill: the next peek() returns them again until commit() removes them, so
+    // rows whose write failed are not lost. Writer thread only; the file is read and the
+    // records decoded after the lock is released.
+    std::size_t peek(std::vector<KlineBatchItem>& out, std::size_t max) {
+        std::uint64_t offset = 0;
+        std::uint64_t written = 0;
+        std::size_t count = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            count = static_cast<std::size_t>(std::min<std::uint64_t>(max, pending_));
+            if (count == 0) return 0;
+            // One record more when there is one: its age becomes the backlog age on commit().
+            peeked_ = static_cast<std::size_t>(std::min<std::uint64_t>(count + 1, pending_));
+            offset = read_offset_;
+            written = write_offset_;
+            scratch_.resize(peeked_ * KlineSpillFormat::record_bytes);
+            copy_staged(offset, scratch_.data(), scratch_.size());
+        }
+        // Records below `written` are on disk and stay put until commit() drains them.
+        if (offset < written && !read_at(offset, scratch_.data(), static_cast<std::size_t>(std::min<std::uint64_t>(scratch_.size(), written - offset)))) {
+            peeked_ = 0;
+            metrics_().write_errors.fetch_add(1, std::memory_order_relaxed);
+            return 0;
+        }
+        std::string_view last_symbol;
+        sentum::market::SymbolId last_id = sentum::market::kInvalidSymbolId;
+        for (std::size_t i = 0; i < count; ++i) {
+            const char* record = scratch_.data() + i * KlineSpillFormat::record_bytes;
+            const std::string_view symbol(record, ::strnlen(record, KlineSpillFormat::symbol_bytes));
+            if (symbol != last_symbol) {
+                last_symbol = symbol;
+                last_id = resolve(symbol);
+            }
+            out.push_back(decode(record, last_id));
+        }
+        return count;
+    }
+
+    // Removes the `count` oldest records, returned by the last peek() and now stored.
+    void commit(std::size_t count) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        const auto taken = std::min<std::uint64_t>(count, pending_);
+        if (taken == 0) return;
+        read_offset_ += taken * KlineSpillFormat::record_bytes;
+        pending_ -= taken;
+        metrics_().drained.fetch_add(taken, std::memory_order_relaxed);
+        if (pending_ == 0) {
+            // A write in flight may still cover drained records; it resets when done.
+            if (writing_) reset_due_ = true;
+            else reset(lock);
+        } else if (taken < peeked_) {
+            oldest_ms_ = spilled_ms(scratch_.data() + taken * KlineSpillFormat::record_bytes);
+        } else if (read_offset_ >= write_offset_) {
+            // Appended after the peek and still staged; one on disk keeps the older age.
+            char record[KlineSpillFormat::record_bytes];
+            copy_staged(read_offset_, record, sizeof(record));
+            oldest_ms_ = spilled_ms(record);
+        }
+        peeked_ = 0;
+        publish_depth();
+    }
+
+    // Writes the staged records and makes everything written so far durable. Cheap when
+    // nothing changed since the last call.
+    bool sync() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        const bool written = write_buffer(lock);
+        if (!dirty_) return written;
+        dirty_ = false;
+        lock.unlock();
+        const auto begin = std::chrono::steady_clock::now();
+#if !defined(_WIN32)
+        const bool synced = ::fdatasync(fd_) == 0;
+#else
+        const bool synced = false;
+#endif
+        auto& metrics = metrics_();
+        metrics.sync_latency.observe(static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count()));
+        if (!synced) {
+            lock.lock();
+            dirty_ = true;
+            metrics.write_errors.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        metrics.syncs.fetch_add(1, std::memory_order_relaxed);
+        return written;
+    }
+
+    // Records not yet drained. While any are, new rows must be spilled too, so a
+    // symbol's rows reach the writer in order.
+    std::uint64_t pending() const noexcept { return pending_.load(std::memory_order_acquire); }
+    std::uint64_t recovered() const noexcept { return recovered_; }
+    const std::string& path() const noexcept { return path_; }
+
+private:
+    static constexpr std::size_t flush_bytes = 64u << 10;
+    static constexpr std::chrono::milliseconds flush_interval{50};
+
+    static sentum::market::KlineSpillMetrics& metrics_() noexcept { return sentum::market::RuntimePerformanceMetrics::global().kline_spill; }
+
+    static bool reject() noexcept {
+        metrics_().rejected.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    static std::int64_t wall_ms() noexcept {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    // Spilled names are lowercase stream names, already interned by this run's collector
+    // unless they were recovered from an older universe.
+    static sentum::market::SymbolId resolve(std::string_view symbol) {
+        auto& interner = sentum::market::SymbolInterner::global();
+        const auto id = interner.find_folded(symbol);
+        return id != sentum::market::kInvalidSymbolId ? id : interner.intern(symbol);
+    }
+
+    static std::int64_t spilled_ms(const char* record) noexcept {
+        std::int64_t value = 0;
+        std::memcpy(&value, record + KlineSpillFormat::symbol_bytes, 8);
+        return value;
+    }
+
+    static void encode(char* out, std::int64_t spilled_ms, const Kline& kline) noexcept {
+        std::memcpy(out, &spilled_ms, 8);
+        std::memcpy(out + 8, &kline.timestamp, 8);
+        std::memcpy(out + 16, &kline.open, 8);
+        std::memcpy(out + 24, &kline.high, 8);
+        std::memcpy(out + 32, &kline.low, 8);
+        std::memcpy(out + 40, &kline.close, 8);
+        std::memcpy(out + 48, &kline.volume, 8);
+    }
+
+    static KlineBatchItem decode(const char* record, sentum::market::SymbolId id) {
+        KlineBatchItem item;
+        item.symbol_id = id;
+        const auto* fields = record + KlineSpillFormat::symbol_bytes;
+        std::memcpy(&item.kline.timestamp, fields + 8, 8);
+        std::memcpy(&item.kline.open, fields + 16, 8);
+        std::memcpy(&item.kline.high, fields + 24, 8);
+        std::memcpy(&item.kline.low, fields + 32, 8);
+        std::memcpy(&item.kline.close, fields + 40, 8);
+        std::memcpy(&item.kline.volume, fields + 48, 8);
+        return item;
+    }
+
+    // Opens what a previous run left: whole records are kept, a torn final record is cut.
+    void recover() {
+        std::uint64_t size = 0;
+#if !defined(_WIN32)
+        struct stat status {};
+        if (::fstat(fd_, &status) == 0 && status.st_size > 0) size = static_cast<std::uint64_t>(status.st_size);
+#endif
+        char magic[KlineSpillFormat::header_bytes] = {};
+        const bool valid = size >= KlineSpillFormat::header_bytes && read_at(0, magic, sizeof(magic)) &&
+                           std::memcmp(magic, KlineSpillFormat::magic, sizeof(magic)) == 0;
+        const auto records = valid ? (size - KlineSpillFormat::header_bytes) / KlineSpillFormat::record_bytes : 0;
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (records == 0) {
+            reset(lock);
+            if (!write_at(0, KlineSpillFormat::magic, sizeof(KlineSpillFormat::magic))) throw std::runtime_error("Cannot write kline spill file " + path_);
+            return;
+        }
+        write_offset_ = KlineSpillFormat::header_bytes + records * KlineSpillFormat::record_bytes;
+        if (write_offset_ != size) truncate(write_offset_);
+        pending_ = records;
+        recovered_ = records;
+        char first[KlineSpillFormat::record_bytes];
+        if (read_at(read_offset_, first, sizeof(first))) oldest_ms_ = spilled_ms(first);
+        metrics_().recovered.fetch_add(records, std::memory_order_relaxed);
+        publish_depth();
+    }
+
+    // Back to an empty file, the magic kept; everything staged has been drained too.
+    // Called with the lock held and no write in flight. Truncates unlocked, holding the
+    // write turn so nothing is written at the reused offsets until it is done.
+    void reset(std::unique_lock<std::mutex>& lock) {
+        reset_due_ = false;
+        read_offset_ = write_offset_ = KlineSpillFormat::header_bytes;
+        buffer_.clear();
+        oldest_ms_ = 0;
+        writing_ = true;
+        lock.unlock();
+        const bool truncated = truncate(KlineSpillFormat::header_bytes);
+        lock.lock();
+        writing_ = false;
+        if (truncated) dirty_ = true;
+    }
+
+    // Position just past the last appended record, as if everything staged were written.
+    std::uint64_t end_offset() const noexcept { return write_offset_ + writing_buffer_.size() + buffer_.size(); }
+
+    // Offsets are positions in the file as it will be once the staged records are
+    // written: below write_offset_ they are on disk, then come writing_buffer_ and
+    // buffer_. Copies the staged part of [offset, offset + bytes); called with the lock.
+    void copy_staged(std::uint64_t offset, char* data, std::size_t bytes) const noexcept {
+        auto position = write_offset_;
+        for (const auto* staged : {&writing_buffer_, &buffer_}) {
+            const auto end = position + staged->size();
+            const auto from = std::max(offset, position);
+            const auto to = std::min<std::uint64_t>(offset + bytes, end);
+            if (from < to) std::memcpy(data + (from - offset), staged->data() + (from - position), static_cast<std::size_t>(to - from));
+            position = end;
+        }
+    }
+
+    void publish_depth() noexcept {
+        auto& metrics = metrics_();
+        const auto depth = pending_.load(std::memory_order_relaxed);
+        metrics.depth.store(depth, std::memory_order_relaxed);
+        metrics.oldest_spilled_ms.store(oldest_ms_, std::memory_order_relaxed);
+        metrics.file_bytes.store(end_offset(), std::memory_order_relaxed);
+        auto current = metrics.depth_high_water.load(std::memory_order_relaxed);
+        while (depth > current && !metrics.depth_high_water.compare_exchange_weak(current, depth, std::memory_order_relaxed)) {}
+    }
+
+    // Called with the lock held. Swaps the staged records into the spare buffer and
+    // writes them with the lock released; appends meanwhile stage into the other one.
+    // One thread writes at a time: while another does, this returns true and the
+    // records wait for the next call.
+    bool write_buffer(std::unique_lock<std::mutex>& lock) {
+        if (writing_ || buffer_.empty()) return true;
+        writing_ = true;
+        writing_buffer_.swap(buffer_);
+        const auto offset = write_offset_;
+        lock.unlock();
+        const bool written = write_at(offset, writing_buffer_.data(), writing_buffer_.size());
+        lock.lock();
+        if (written) {
+            write_offset_ += writing_buffer_.size();
+            dirty_ = true;
+        } else {
+            // Still staged, ahead of anything appended meanwhile.
+            writing_buffer_.insert(writing_buffer_.end(), buffer_.begin(), buffer_.end());
+            buffer_.swap(writing_buffer_);
+        }
+        writing_buffer_.clear();
+        writing_ = false;
+        if (reset_due_) {
+            if (pending_ == 0) reset(lock);
+            else reset_due_ = false; // appended to again; the file shrinks after the next backlog
+        }
+        return written;
+    }
+
+    bool write_at(std::uint64_t offset, const char* data, std::size_t bytes) noexcept {
+#if !defined(_WIN32)
+        while (bytes > 0) {
+            const auto written = ::pwrite(fd_, data, bytes, static_cast<off_t>(offset));
+            if (written < 0 && errno == EINTR) continue;
+            if (written <= 0) return false;
+            data += written;
+            offset += static_cast<std::uint64_t>(written);
+            bytes -= static_cast<std::size_t>(written);
+        }
+        return true;
+#else
+        (void)offset; (void)data; (void)bytes;
+        return false;
+#endif
+    }
+
+    bool read_at(std::uint64_t offset, char* data, std::size_t bytes) noexcept {
+#if !defined(_WIN32)
+        while (bytes > 0) {
+            const auto read = ::pread(fd_, data, bytes, static_cast<off_t>(offset));
+            if (read < 0 && errno == EINTR) continue;
+            if (read <= 0) return false;
+            data += read;
+            offset += static_cast<std::uint64_t>(read);
+            bytes -= static_cast<std::size_t>(read);
+        }
+        return true;
+#else
+        (void)offset; (void)data; (void)bytes;
+        return false;
+#endif
+    }
+
+    bool truncate(std::uint64_t size) noexcept {
+#if !defined(_WIN32)
+        return ::ftruncate(fd_, static_cast<off_t>(size)) == 0;
+#else
+        (void)size;
+        return false;
+#endif
+    }
+
+    std::string path_;
+    std::uint64_t max_bytes_;
+    int fd_ = -1;
+    std::mutex mutex_;
+    std::vector<char> buffer_;         // appended, not yet written
+    std::vector<char> writing_buffer_; // being written by the thread holding the write turn
+    std::vector<char> scratch_;        // writer thread only
+    std::size_t peeked_ = 0;           // records in scratch_, writer thread only
+    std::uint64_t write_offset_ = KlineSpillFormat::header_bytes;
+    std::uint64_t read_offset_ = KlineSpillFormat::header_bytes;
+    std::atomic<std::uint64_t> pending_{0};
+    std::uint64_t recovered_ = 0;
+    std::int64_t oldest_ms_ = 0;
+    std::int64_t staged_since_ms_ = 0;
+    bool writing_ = false;   // a thread holds the write turn
+    bool reset_due_ = false; // drained while a write was in flight
+    bool dirty_ = false;     // written since the last fdatasync
+};
+
+} // namespace sentum::collector
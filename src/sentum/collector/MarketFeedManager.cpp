@@ -0,0 +1,401 @@
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/ssl/context.hpp>
+#include <nlohmann/json.hpp>
+#include <websocketpp/client.hpp>
+#include <websocketpp/config/asio_client.hpp>
+#include <websocketpp/config/asio_no_tls_client.hpp>
+
+#include <sentum/collector/FastBinanceTradeParser.hpp>
+#include <sentum/collector/MarketFeedManager.hpp>
+#include <sentum/market/RuntimePerformanceMetrics.hpp>
+#include <sentum/market/SymbolInterner.hpp>
+#include <sentum/utils/AsyncLogger.hpp>
+
+namespace sentum::collector {
+
+namespace {
+
+using tls_client = websocketpp::client<websocketpp::config::asio_tls_client>;
+using plain_client = websocketpp::client<websocketpp::config::asio_client>;
+
+constexpr std::chrono::milliseconds min_reconnect_delay{1000};
+constexpr std::chrono::milliseconds max_reconnect_delay{30000};
+// Streams named in the handshake URL on (re)connect; the rest follow as SUBSCRIBE
+// requests so the request line stays short.
+constexpr std::size_t max_url_streams = 200;
+
+std::string trade_stream(std::string symbol) {
+    std::transform(symbol.begin(), symbol.end(), symbol.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return symbol + "@trade";
+}
+
+} // namespace
+
+struct MarketFeedManager::Impl {
+    struct Stream {
+        std::size_t references = 0;
+        sentum::market::SymbolId id = sentum::market::kInvalidSymbolId;
+    };
+
+    explicit Impl(sentum::market::MarketEventBus& bus_) : bus(bus_), logger("log/market_feed.log") {}
+
+    sentum::market::MarketEventBus& bus;
+    AsyncLogger logger;
+    std::atomic<bool> running{false};
+
+    // Guards the configuration, the stream sets and the connection state.
+    mutable std::mutex mutex;
+    std::string base_url = default_base_url;
+    sentum::runtime::ThreadTuning tuning;
+    std::map<std::string, Stream> streams; // wanted, by stream name
+    std::set<std::string> subscribed;      // confirmed sent on the current connection
+    // The io thread's current endpoint, owned by the thread; null between endpoints.
+    tls_client* tls = nullptr;
+    plain_client* plain = nullptr;
+    std::thread io_thread;
+    // Bumped by start_locked(); an io thread from before a stop() exits on a mismatch.
+    std::uint64_t generation = 0;
+    std::condition_variable restart_cv;
+    websocketpp::connection_hdl connection;
+    bool connection_valid = false;
+    bool flush_scheduled = false;
+    std::chrono::milliseconds reconnect_delay = min_reconnect_delay;
+    std::chrono::steady_clock::time_point last_request{};
+    std::uint64_t next_request_id = 1;
+
+    // Symbols subscribed but without a trade yet; checked on the message path only while
+    // `awaiting_count` is non-zero.
+    std::mutex awaiting_mutex;
+    std::unordered_map<sentum::market::SymbolId, std::chrono::steady_clock::time_point> awaiting_first;
+    std::atomic<std::size_t> awaiting_count{0};
+
+    template <typename F>
+    void with_endpoint(F&& f) {
+        if (plain) f(*plain);
+        else if (tls) f(*tls);
+    }
+
+    void start_locked() {
+        running.store(true);
+        logger.start();
+        const auto started = ++generation;
+        if (base_url.compare(0, 5, "ws://") == 0) io_thread = std::thread([this, started] { supervise<plain_client>(started); });
+        else io_thread = std::thread([this, started] { supervise<tls_client>(started); });
+    }
+
+    template <typename Endpoint>
+    Endpoint*& current_endpoint() {
+        if constexpr (std::is_same_v<Endpoint, tls_client>) return tls;
+        else return plain;
+    }
+
+    void request_flush_locked() {
+        if (!connection_valid || flush_scheduled) return;
+        flush_scheduled = true;
+        with_endpoint([this](auto& endpoint) {
+            boost::asio::post(endpoint.get_io_service(), [this, &endpoint] {
+                std::lock_guard<std::mutex> lock(mutex);
+                flush_locked(endpoint);
+            });
+        });
+    }
+
+    template <typename Endpoint>
+    void schedule_flush_locked(Endpoint& endpoint, std::chrono::milliseconds delay) {
+        flush_scheduled = true;
+        endpoint.set_timer(static_cast<long>(std::max<std::int64_t>(delay.count(), 1)), [this, &endpoint](const websocketpp::lib::error_code& ec) {
+            if (ec) return;
+            std::lock_guard<std::mutex> lock(mutex);
+            flush_locked(endpoint);
+        });
+    }
+
+    // Sends one SUBSCRIBE or UNSUBSCRIBE for the difference between the wanted and the
+    // subscribed streams, at most one request per min_request_interval. Additions go
+    // first: consumers drop trades of released symbols anyway.
+    template <typename Endpoint>
+    void flush_locked(Endpoint& endpoint) {
+        flush_scheduled = false;
+        if (!connection_valid) return;
+        std::vector<std::string> add, remove;
+        for (const auto& [name, stream] : streams) if (!subscribed.count(name)) add.push_back(name);
+        for (const auto& name : subscribed) if (!streams.count(name)) remove.push_back(name);
+        if (add.empty() && remove.empty()) return;
+        const auto now = std::chrono::steady_clock::now();
+        const auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(last_request + min_request_interval - now);
+        if (wait.count() > 0) { schedule_flush_locked(endpoint, wait); return; }
+        const bool subscribing = !add.empty();
+        const auto& names = subscribing ? add : remove;
+        const nlohmann::json request = {{"method", subscribing ? "SUBSCRIBE" : "UNSUBSCRIBE"}, {"params", names}, {"id", next_request_id++}};
+        websocketpp::lib::error_code ec;
+        endpoint.send(connection, request.dump(), websocketpp::frame::opcode::text, ec);
+        if (ec) { logger.log("Trade feed request failed: " + ec.message()); return; } // the close handler reconnects
+        for (const auto& name : names) {
+            if (subscribing) subscribed.insert(name);
+            else subscribed.erase(name);
+        }
+        last_request = now;
+        sentum::market::RuntimePerformanceMetrics::global().market_feed.requests.fetch_add(1, std::memory_order_relaxed);
+        if (subscribing && !remove.empty()) schedule_flush_locked(endpoint, min_request_interval);
+    }
+
+    template <typename Endpoint>
+    void connect(Endpoint& endpoint) {
+        std::string url;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            url = base_url + "/stream";
+            subscribed.clear();
+            for (const auto& [name, stream] : streams) {
+                if (subscribed.size() == max_url_streams) break;
+                url += subscribed.empty() ? "?streams=" : "/";
+                url += name;
+                subscribed.insert(name);
+            }
+        }
+        websocketpp::lib::error_code ec;
+        auto con = endpoint.get_connection(url, ec);
+        if (ec) throw std::runtime_error("Trade feed connection failed: " + ec.message());
+        endpoint.connect(con);
+    }
+
+    template <typename Endpoint>
+    void schedule_reconnect(Endpoint& endpoint) {
+        if (!running.load()) return;
+        std::chrono::milliseconds delay;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            delay = reconnect_delay;
+            reconnect_delay = std::min(reconnect_delay * 2, max_reconnect_delay);
+        }
+        endpoint.set_timer(static_cast<long>(delay.count()), [this, &endpoint](const websocketpp::lib::error_code& ec) {
+            if (ec || !running.load()) return;
+            try { connect(endpoint); }
+            catch (const std::exception& e) {
+                logger.log(std::string("Trade feed reconnect error: ") + e.what());
+                schedule_reconnect(endpoint);
+            }
+        });
+    }
+
+    // Body of the io thread. When the loop of an endpoint ends with an error (a throwing
+    // handler, or a failed initial connect) while the feed is still running, the endpoint
+    // is replaced by a fresh one after the reconnect backoff.
+    template <typename Endpoint>
+    void supervise(std::uint64_t started) {
+        auto& metrics = sentum::market::RuntimePerformanceMetrics::global().market_feed;
+        if (tuning.active() && !sentum::runtime::apply_thread_tuning("sentum-feed", tuning))
+            logger.log("Trade feed: CPU affinity or SCHED_FIFO was refused");
+        const auto live = [&] { return running.load() && generation == started; };
+        while (true) {
+            auto endpoint = std::make_unique<Endpoint>();
+            bool ready = false;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!live()) break;
+                // Under the lock, so stop() never sees an endpoint without an io_service.
+                try {
+                    init(*endpoint);
+                    current_endpoint<Endpoint>() = endpoint.get();
+                    ready = true;
+                } catch (const std::exception& e) {
+                    logger.log(std::string("Trade feed init error: ") + e.what());
+                }
+            }
+            if (ready) {
+                try {
+                    connect(*endpoint);
+                    sentum::runtime::run_io_loop(*endpoint, tuning.busy_poll);
+                } catch (const std::exception& e) {
+                    if (running.load()) logger.log(std::string("Trade feed run() error: ") + e.what());
+                }
+            }
+            metrics.connected.store(false, std::memory_order_relaxed);
+            std::unique_lock<std::mutex> lock(mutex);
+            if (current_endpoint<Endpoint>() == endpoint.get()) {
+                current_endpoint<Endpoint>() = nullptr;
+                connection_valid = false;
+                flush_scheduled = false;
+                subscribed.clear();
+            }
+            if (!live()) break;
+            const auto delay = reconnect_delay;
+            reconnect_delay = std::min(reconnect_delay * 2, max_reconnect_delay);
+            if (restart_cv.wait_for(lock, delay, [&] { return !live(); })) break;
+        }
+        metrics.connected.store(false, std::memory_order_relaxed);
+    }
+
+    template <typename Endpoint>
+    void init(Endpoint& endpoint) {
+        auto& metrics = sentum::market::RuntimePerformanceMetrics::global().market_feed;
+        endpoint.init_asio();
+        endpoint.start_perpetual();
+        endpoint.clear_access_channels(websocketpp::log::alevel::all);
+        endpoint.clear_error_channels(websocketpp::log::elevel::all);
+        if constexpr (std::is_same_v<Endpoint, tls_client>) {
+            endpoint.set_tls_init_handler([](websocketpp::connection_hdl) {
+                auto ctx = websocketpp::lib::make_shared<boost::asio::ssl::context>(boost::asio::ssl::context::tls_client);
+                ctx->set_options(boost::asio::ssl::context::default_workarounds | boost::asio::ssl::context::no_sslv2 | boost::asio::ssl::context::no_sslv3);
+                return ctx;
+            });
+        }
+        endpoint.set_open_handler([this, &endpoint, &metrics](websocketpp::connection_hdl hdl) {
+            std::lock_guard<std::mutex> lock(mutex);
+            connection = hdl;
+            connection_valid = true;
+            reconnect_delay = min_reconnect_delay;
+            metrics.connected.store(true, std::memory_order_relaxed);
+            metrics.connects.fetch_add(1, std::memory_order_relaxed);
+            // Streams beyond the handshake URL, and changes made while connecting.
+            flush_locked(endpoint);
+        });
+        const auto on_lost = [this, &endpoint, &metrics](websocketpp::connection_hdl) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                connection_valid = false;
+                subscribed.clear();
+            }
+            metrics.connected.store(false, std::memory_order_relaxed);
+            schedule_reconnect(endpoint);
+        };
+        endpoint.set_close_handler(on_lost);
+        endpoint.set_fail_handler(on_lost);
+        endpoint.set_message_handler([this](websocketpp::connection_hdl, typename Endpoint::message_ptr msg) {
+            on_frame(msg->get_payload());
+        });
+    }
+
+    void on_frame(const std::string& payload) {
+        ParsedTrade trade;
+        // Request acknowledgements ({"result":null,"id":n}) are not trades.
+        if (!FastBinanceTradeParser::parse(payload, trade)) {
+            if (payload.find("\"error\"") != std::string::npos) logger.log("Trade feed request rejected: " + payload);
+            return;
+        }
+        const auto id = sentum::market::SymbolInterner::global().find(trade.symbol);
+        if (id == sentum::market::kInvalidSymbolId) return;
+        MarketEvent event;
+        event.type = MarketEvent::Type::Trade;
+        event.symbol_id = id;
+        event.timestamp = std::chrono::system_clock::now();
+        event.price = trade.price;
+        event.close = trade.price;
+        event.volume = trade.quantity;
+        event.buyer_maker = trade.buyer_maker;
+        event.closed = false;
+        auto& metrics = sentum::market::RuntimePerformanceMetrics::global().market_feed;
+        metrics.trades.fetch_add(1, std::memory_order_relaxed);
+        if (awaiting_count.load(std::memory_order_relaxed) != 0) {
+            std::lock_guard<std::mutex> lock(awaiting_mutex);
+            const auto it = awaiting_first.find(id);
+            if (it != awaiting_first.end()) {
+                const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - it->second).count();
+                metrics.observe_first_trade(static_cast<std::uint64_t>(ms < 0 ? 0 : ms));
+                awaiting_first.erase(it);
+                awaiting_count.store(awaiting_first.size(), std::memory_order_relaxed);
+            }
+        }
+        bus.publish(event);
+    }
+
+    void await_first_trade(sentum::market::SymbolId id, bool waiting) {
+        std::lock_guard<std::mutex> lock(awaiting_mutex);
+        if (waiting) awaiting_first[id] = std::chrono::steady_clock::now();
+        else awaiting_first.erase(id);
+        awaiting_count.store(awaiting_first.size(), std::memory_order_relaxed);
+    }
+};
+
+MarketFeedManager::MarketFeedManager(sentum::market::MarketEventBus& bus) : impl_(std::make_unique<Impl>(bus)) {}
+
+MarketFeedManager::~MarketFeedManager() { stop(); }
+
+void MarketFeedManager::configure(std::string base_url, sentum::runtime::ThreadTuning tuning) {
+    while (!base_url.empty() && base_url.back() == '/') base_url.pop_back();
+    if (base_url.compare(0, 5, "ws://") != 0 && base_url.compare(0, 6, "wss://") != 0)
+        throw std::invalid_argument("Trade feed URL must start with ws:// or wss://: " + base_url);
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->base_url = std::move(base_url);
+    impl_->tuning = std::move(tuning);
+}
+
+TradeSubscription MarketFeedManager::subscribe_trades(const std::string& symbol) {
+    auto stream = trade_stream(symbol);
+    const auto id = sentum::market::SymbolInterner::global().intern(symbol);
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    const auto it = impl_->streams.find(stream);
+    if (it == impl_->streams.end()) {
+        if (impl_->streams.size() >= max_streams) throw std::runtime_error("Trade feed is limited to " + std::to_string(max_streams) + " streams");
+        impl_->streams.emplace(stream, Impl::Stream{1, id});
+        impl_->await_first_trade(id, true);
+        sentum::market::RuntimePerformanceMetrics::global().market_feed.streams.store(impl_->streams.size(), std::memory_order_relaxed);
+        if (impl_->running.load()) impl_->request_flush_locked();
+    } else {
+        ++it->second.references;
+    }
+    // Also restarts a feed stopped while its streams were still held.
+    if (!impl_->running.load()) impl_->start_locked();
+    return TradeSubscription(this, std::move(stream));
+}
+
+void MarketFeedManager::release(const std::string& stream) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    const auto it = impl_->streams.find(stream);
+    if (it == impl_->streams.end() || --it->second.references > 0) return;
+    impl_->await_first_trade(it->second.id, false);
+    impl_->streams.erase(it);
+    sentum::market::RuntimePerformanceMetrics::global().market_feed.streams.store(impl_->streams.size(), std::memory_order_relaxed);
+    impl_->request_flush_locked();
+}
+
+void MarketFeedManager::stop() {
+    std::thread io_thread;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        if (!impl_->running.exchange(false)) return;
+        impl_->with_endpoint([this](auto& endpoint) {
+            if (impl_->connection_valid) {
+                websocketpp::lib::error_code ec;
+                endpoint.close(impl_->connection, websocketpp::close::status::going_away, "shutdown", ec);
+            }
+            endpoint.stop_perpetual();
+            endpoint.stop();
+        });
+        impl_->connection_valid = false;
+        impl_->flush_scheduled = false;
+        impl_->subscribed.clear();
+        io_thread = std::move(impl_->io_thread);
+    }
+    impl_->restart_cv.notify_all();
+    if (io_thread.joinable() && io_thread.get_id() != std::this_thread::get_id()) io_thread.join();
+    else if (io_thread.joinable()) io_thread.detach();
+    impl_->logger.stop();
+}
+
+bool MarketFeedManager::connected() const noexcept {
+    return sentum::market::RuntimePerformanceMetrics::global().market_feed.connected.load(std::memory_order_relaxed);
+}
+
+std::size_t MarketFeedManager::stream_count() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->streams.size();
+}
+
+} // namespace sentum::collector
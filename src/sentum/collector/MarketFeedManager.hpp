@@ -0,0 +1,97 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <sentum/core/ThreadTuning.hpp>
+#include <sentum/market/MarketEventBus.hpp>
+
+namespace sentum::collector {
+
+class TradeSubscription;
+
+// Owns the trade-stream connection shared by TradeEngine, ShadowTradingSession and
+// TestnetStrategyRuntime. Symbols are added and removed with SUBSCRIBE/UNSUBSCRIBE
+// requests on the open combined-stream connection, so a symbol switch costs one request
+// instead of a new TLS session. Trades are published on the bus as MarketEvent::Type::Trade
+// stamped with the receive time; consumers filter by SymbolId. The connection opens with
+// the first subscription and stays open, with no streams, when the last one is released.
+// Kline, book-ticker and depth streams remain with the Collector's shards.
+class MarketFeedManager {
+public:
+    static constexpr const char* default_base_url = "wss://stream.binance.com:9443";
+    // Binance's limit per connection.
+    static constexpr std::size_t max_streams = 1024;
+    // Binance accepts five incoming messages per second; one request per interval stays
+    // under it with room for pongs.
+    static constexpr std::chrono::milliseconds min_request_interval{250};
+
+    static MarketFeedManager& global() { static MarketFeedManager instance; return instance; }
+
+    explicit MarketFeedManager(sentum::market::MarketEventBus& bus = sentum::market::MarketEventBus::global());
+    ~MarketFeedManager();
+
+    MarketFeedManager(const MarketFeedManager&) = delete;
+    MarketFeedManager& operator=(const MarketFeedManager&) = delete;
+
+    // Endpoint (ws:// or wss://) and io-thread placement. Applies from the next connect,
+    // so call it before the first subscription or after stop().
+    void configure(std::string base_url, sentum::runtime::ThreadTuning tuning = {});
+    // Reference-counted per symbol: the first reference subscribes <symbol>@trade, the
+    // last one (the handle's destruction) unsubscribes it.
+    TradeSubscription subscribe_trades(const std::string& symbol);
+    // Closes the connection. Subscriptions stay registered and reconnect with the next
+    // subscribe_trades().
+    void stop();
+
+    bool connected() const noexcept;
+    std::size_t stream_count() const;
+
+private:
+    friend class TradeSubscription;
+    struct Impl;
+
+    void release(const std::string& stream);
+
+    std::unique_ptr<Impl> impl_;
+};
+
+// Keeps one symbol's trade stream subscribed for as long as it lives.
+class TradeSubscription {
+public:
+    TradeSubscription() = default;
+    TradeSubscription(TradeSubscription&& other) noexcept
+        : manager_(std::exchange(other.manager_, nullptr)), stream_(std::move(other.stream_)) {}
+    TradeSubscription& operator=(TradeSubscription&& other) noexcept {
+        if (this != &other) {
+            reset();
+            manager_ = std::exchange(other.manager_, nullptr);
+            stream_ = std::move(other.stream_);
+        }
+        return *this;
+    }
+    ~TradeSubscription() { reset(); }
+
+    TradeSubscription(const TradeSubscription&) = delete;
+    TradeSubscription& operator=(const TradeSubscription&) = delete;
+
+    void reset() noexcept {
+        if (!manager_) return;
+        try { manager_->release(stream_); } catch (...) {}
+        manager_ = nullptr;
+    }
+    explicit operator bool() const noexcept { return manager_ != nullptr; }
+    const std::string& stream() const noexcept { return stream_; }
+
+private:
+    friend class MarketFeedManager;
+    TradeSubscription(MarketFeedManager* manager, std::string stream) : manager_(manager), stream_(std::move(stream)) {}
+
+    MarketFeedManager* manager_ = nullptr;
+    std::string stream_;
+};
+
+} // namespace sentum::collector
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SENTUM_PARSER_AVX2 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define SENTUM_PARSER_SSE2 1
+#endif
+
+#include <sentum/market/FixedPoint.hpp>
+
+namespace sentum::collector {
+
+// Shared front end of the fast Binance parsers: visits every '"' in a payload, 32 bytes
+// at a time with AVX2, 16 with SSE2 and via memchr otherwise. The visitor returns true
+// to stop the scan early.
+class QuoteScanner {
+public:
+    static constexpr const char* backend() noexcept {
+#if defined(SENTUM_PARSER_AVX2)
+        return "avx2";
+#elif defined(SENTUM_PARSER_SSE2)
+        return "sse2";
+#else
+        return "scalar";
+#endif
+    }
+
+    template <typename Visitor>
+    static bool scan(const char* data, std::size_t size, Visitor&& visit) noexcept {
+        std::size_t i = 0;
+#if defined(SENTUM_PARSER_AVX2)
+        const __m256i quote = _mm256_set1_epi8('\"');
+        for (; i + 32 <= size; i += 32) {
+            const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, quote)));
+            while (mask) {
+                if (visit(i + static_cast<std::size_t>(__builtin_ctz(mask)))) return true;
+                mask &= mask - 1;
+            }
+        }
+#elif defined(SENTUM_PARSER_SSE2)
+        const __m128i quote = _mm_set1_epi8('\"');
+        for (; i + 16 <= size; i += 16) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, quote)));
+            while (mask) {
+                if (visit(i + static_cast<std::size_t>(__builtin_ctz(mask)))) return true;
+                mask &= mask - 1;
+            }
+        }
+#endif
+        while (i < size) {
+            const auto* next = static_cast<const char*>(std::memchr(data + i, '\"', size - i));
+            if (!next) break;
+            i = static_cast<std::size_t>(next - data);
+            if (visit(i)) return true;
+            ++i;
+        }
+        return false;
+    }
+
+    // Returns the key byte when the quote at `q` opens a single-character key ("k":), else 0.
+    static char single_char_key(const char* data, std::size_t size, std::size_t q) noexcept {
+        if (q + 4 >= size || data[q + 2] != '\"' || data[q + 3] != ':') return 0;
+        return data[q + 1];
+    }
+};
+
+// Value readers for the parsers; `p` is a value start as recorded from single_char_key.
+inline bool string_at(const char* p, const char* end, std::string_view& value) noexcept {
+    if (p >= end || *p != '\"') return false;
+    ++p;
+    const auto* quote = static_cast<const char*>(std::memchr(p, '\"', static_cast<std::size_t>(end - p)));
+    if (!quote) return false;
+    value = std::string_view(p, static_cast<std::size_t>(quote - p));
+    return true;
+}
+
+inline bool integer_at(const char* p, const char* end, std::int64_t& value) noexcept {
+    sentum::market::Decimal decimal;
+    if (!sentum::market::scan_decimal(p, end, decimal) || decimal.exponent != 0) return false;
+    value = decimal.negative ? -static_cast<std::int64_t>(decimal.mantissa) : static_cast<std::int64_t>(decimal.mantissa);
+    return true;
+}
+
+// Binance quotes decimals; the quote is optional here.
+inline bool decimal_at(const char* p, const char* end, sentum::market::Decimal& value) noexcept {
+    if (p < end && *p == '\"') ++p;
+    return sentum::market::scan_decimal(p, end, value) != nullptr;
+}
+
+} // namespace sentum::collector
@@ -0,0 +1,254 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sentum::collector {
+
+enum class SyntheticStreamKind { Kline, Trade, AggTrade, BookTicker };
+
+struct SyntheticStream {
+    std::string name;   // stream name as subscribed, e.g. "btcusdt@kline_1s"
+    std::string symbol; // upper case, as Binance sends it in payloads
+    SyntheticStreamKind kind = SyntheticStreamKind::Kline;
+    std::int64_t interval_ms = 1000; // klines only
+};
+
+// Generates Binance-format market data for a set of subscribed streams: kline, trade,
+// aggTrade and bookTicker payloads, raw or wrapped in the combined-stream envelope.
+// All streams of a symbol share one random walk. Klines close when the wall clock
+// crosses an interval boundary, so closed candles reach the collector's SQLite writer
+// at the same cadence as on the live feed. Stand-in for stream.binance.com in
+// benchmarks (see tools/feed_server_main.cpp); not thread-safe.
+class SyntheticFeed {
+public:
+    explicit SyntheticFeed(std::uint64_t seed = 1) : rng_(seed ? seed : 1) {}
+
+    // Parses a stream name ("btcusdt@kline_1s", "btcusdt@trade", ...). Depth and other
+    // streams are not generated and return false.
+    static bool parse_stream(std::string_view name, SyntheticStream& out) {
+        const auto at = name.find('@');
+        if (at == std::string_view::npos || at == 0) return false;
+        const auto type = name.substr(at + 1);
+        out.name = std::string(name);
+        out.symbol = std::string(name.substr(0, at));
+        std::transform(out.symbol.begin(), out.symbol.end(), out.symbol.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+        if (type == "trade") { out.kind = SyntheticStreamKind::Trade; return true; }
+        if (type == "aggTrade") { out.kind = SyntheticStreamKind::AggTrade; return true; }
+        if (type == "bookTicker") { out.kind = SyntheticStreamKind::BookTicker; return true; }
+        if (type.compare(0, 6, "kline_") != 0 || type.size() < 8) return false;
+        out.kind = SyntheticStreamKind::Kline;
+        std::int64_t count = 0;
+        std::size_t i = 6;
+        for (; i < type.size() && std::isdigit(static_cast<unsigned char>(type[i])); ++i) count = count * 10 + (type[i] - '0');
+        if (count <= 0 || i + 1 != type.size()) return false;
+        switch (type[i]) {
+            case 's': out.interval_ms = count * 1000; return true;
+            case 'm': out.interval_ms = count * 60000; return true;
+            case 'h': out.interval_ms = count * 3600000; return true;
+            case 'd': out.interval_ms = count * 86400000; return true;
+            default: return false;
+        }
+    }
+
+    // Subscribes the streams of a handshake resource: "/stream?streams=a@x/b@y"
+    // (combined envelope) or "/ws/a@x" (raw payloads). Returns the number added.
+    std::size_t subscribe_resource(std::string_view resource) {
+        constexpr std::string_view combined_prefix = "/stream?streams=";
+        constexpr std::string_view raw_prefix = "/ws/";
+        if (resource.compare(0, combined_prefix.size(), combined_prefix) == 0) {
+            combined_ = true;
+            resource.remove_prefix(combined_prefix.size());
+            const auto query_end = resource.find('&');
+            if (query_end != std::string_view::npos) resource = resource.substr(0, query_end);
+            std::size_t added = 0;
+            while (!resource.empty()) {
+                const auto slash = resource.find('/');
+                added += subscribe(resource.substr(0, slash)) ? 1 : 0;
+                if (slash == std::string_view::npos) break;
+                resource.remove_prefix(slash + 1);
+            }
+            return added;
+        }
+        if (resource == "/stream") { combined_ = true; return 0; }
+        if (resource.compare(0, raw_prefix.size(), raw_prefix) == 0) return subscribe(resource.substr(raw_prefix.size())) ? 1 : 0;
+        return 0;
+    }
+
+    bool subscribe(std::string_view name) {
+        SyntheticStream stream;
+        if (!parse_stream(name, stream)) return false;
+        for (const auto& existing : streams_) if (existing.stream.name == stream.name) return false;
+        State state;
+        state.walk = std::find(symbols_.begin(), symbols_.end(), stream.symbol) - symbols_.begin();
+        if (state.walk == symbols_.size()) {
+            symbols_.push_back(stream.symbol);
+            // Spread starting prices over several orders of magnitude, as on a real universe.
+            prices_.push_back(0.01 * static_cast<double>(1 + next_random() % 1000000));
+        }
+        state.stream = std::move(stream);
+        streams_.push_back(std::move(state));
+        return true;
+    }
+
+    // The symbol's random walk is kept, so a later resubscription continues it.
+    bool unsubscribe(std::string_view name) {
+        const auto it = std::find_if(streams_.begin(), streams_.end(), [&](const State& state) { return state.stream.name == name; });
+        if (it == streams_.end()) return false;
+        streams_.erase(it);
+        if (cursor_ >= streams_.size()) cursor_ = 0;
+        return true;
+    }
+
+    // Combined streams are wrapped in {"stream":...,"data":...}; /ws/ streams are not.
+    bool combined() const noexcept { return combined_; }
+    std::size_t stream_count() const noexcept { return streams_.size(); }
+
+    // Replaces `out` with the next message, taking the streams round-robin. False when
+    // nothing is subscribed.
+    bool next(std::int64_t now_ms, std::string& out) {
+        if (streams_.empty()) return false;
+        auto& state = streams_[cursor_];
+        cursor_ = cursor_ + 1 == streams_.size() ? 0 : cursor_ + 1;
+        out.clear();
+        if (combined_) { out += "{\"stream\":\""; out += state.stream.name; out += "\",\"data\":"; }
+        switch (state.stream.kind) {
+            case SyntheticStreamKind::Kline: append_kline(state, now_ms, out); break;
+            case SyntheticStreamKind::Trade: append_trade(state, now_ms, out, false); break;
+            case SyntheticStreamKind::AggTrade: append_trade(state, now_ms, out, true); break;
+            case SyntheticStreamKind::BookTicker: append_book_ticker(state, out); break;
+        }
+        if (combined_) out += '}';
+        return true;
+    }
+
+    // Symbols of a synthetic universe: SYN0000USDT, SYN0001USDT, ...
+    static std::vector<std::string> universe(std::size_t count) {
+        std::vector<std::string> symbols;
+        symbols.reserve(count);
+        char name[32];
+        for (std::size_t i = 0; i < count; ++i) {
+            std::snprintf(name, sizeof(name), "SYN%04zuUSDT", i);
+            symbols.emplace_back(name);
+        }
+        return symbols;
+    }
+
+private:
+    struct State {
+        SyntheticStream stream;
+        std::size_t walk = 0; // index into symbols_ and prices_
+        std::int64_t sequence = 0;
+        // Current kline; open_time 0 until the first message.
+        std::int64_t open_time = 0;
+        double open = 0.0, high = 0.0, low = 0.0, close = 0.0, volume = 0.0, quote_volume = 0.0;
+        std::int64_t first_trade = 0, trades = 0;
+    };
+
+    std::uint64_t next_random() noexcept {
+        rng_ ^= rng_ >> 12; rng_ ^= rng_ << 25; rng_ ^= rng_ >> 27;
+        return rng_ * 0x2545F4914F6CDD1DULL;
+    }
+    // Uniform in [0, 1).
+    double uniform() noexcept { return static_cast<double>(next_random() >> 11) * 0x1.0p-53; }
+
+    double step(const State& state) noexcept {
+        auto& price = prices_[state.walk];
+        price *= 1.0 + (uniform() - 0.5) * 2e-4;
+        return price;
+    }
+
+    void append_kline(State& state, std::int64_t now_ms, std::string& out) {
+        const auto interval = state.stream.interval_ms;
+        const auto open_time = now_ms - now_ms % interval;
+        if (state.open_time != 0 && state.open_time != open_time) {
+            // Close the previous candle first, as Binance does on the boundary.
+            format_kline(state, now_ms, true, out);
+            state.open_time = 0;
+            return;
+        }
+        const auto price = step(state);
+        const auto quantity = 0.001 + uniform() * 10.0;
+        if (state.open_time == 0) {
+            state.open_time = open_time;
+            state.open = state.high = state.low = price;
+            state.volume = state.quote_volume = 0.0;
+            state.first_trade = state.sequence + 1;
+            state.trades = 0;
+        }
+        state.high = std::max(state.high, price);
+        state.low = std::min(state.low, price);
+        state.close = price;
+        state.volume += quantity;
+        state.quote_volume += quantity * price;
+        state.sequence += 1;
+        state.trades += 1;
+        format_kline(state, now_ms, false, out);
+    }
+
+    void format_kline(const State& state, std::int64_t now_ms, bool closed, std::string& out) {
+        const auto& symbol = state.stream.symbol;
+        char buffer[640];
+        const int length = std::snprintf(buffer, sizeof(buffer),
+            "{\"e\":\"kline\",\"E\":%lld,\"s\":\"%s\",\"k\":{\"t\":%lld,\"T\":%lld,\"s\":\"%s\",\"i\":\"%s\",\"f\":%lld,\"L\":%lld,"
+            "\"o\":\"%.8f\",\"c\":\"%.8f\",\"h\":\"%.8f\",\"l\":\"%.8f\",\"v\":\"%.8f\",\"n\":%lld,\"x\":%s,"
+            "\"q\":\"%.8f\",\"V\":\"%.8f\",\"Q\":\"%.8f\",\"B\":\"0\"}}",
+            static_cast<long long>(now_ms), symbol.c_str(), static_cast<long long>(state.open_time),
+            static_cast<long long>(state.open_time + state.stream.interval_ms - 1), symbol.c_str(), interval_name(state).c_str(),
+            static_cast<long long>(state.first_trade), static_cast<long long>(state.sequence),
+            state.open, state.close, state.high, state.low, state.volume, static_cast<long long>(state.trades),
+            closed ? "true" : "false", state.quote_volume, state.volume / 2.0, state.quote_volume / 2.0);
+        out.append(buffer, static_cast<std::size_t>(std::clamp(length, 0, static_cast<int>(sizeof(buffer)) - 1)));
+    }
+
+    void append_trade(State& state, std::int64_t now_ms, std::string& out, bool aggregate) {
+        const auto price = step(state);
+        const auto quantity = 0.001 + uniform() * 10.0;
+        const bool buyer_maker = (next_random() & 1) != 0;
+        state.sequence += 1;
+        const auto& symbol = state.stream.symbol;
+        char buffer[320];
+        const int length = aggregate
+            ? std::snprintf(buffer, sizeof(buffer),
+                "{\"e\":\"aggTrade\",\"E\":%lld,\"s\":\"%s\",\"a\":%lld,\"p\":\"%.8f\",\"q\":\"%.8f\",\"f\":%lld,\"l\":%lld,\"T\":%lld,\"m\":%s,\"M\":true}",
+                static_cast<long long>(now_ms), symbol.c_str(), static_cast<long long>(state.sequence), price, quantity,
+                static_cast<long long>(state.sequence), static_cast<long long>(state.sequence), static_cast<long long>(now_ms),
+                buyer_maker ? "true" : "false")
+            : std::snprintf(buffer, sizeof(buffer),
+                "{\"e\":\"trade\",\"E\":%lld,\"s\":\"%s\",\"t\":%lld,\"p\":\"%.8f\",\"q\":\"%.8f\",\"T\":%lld,\"m\":%s,\"M\":true}",
+                static_cast<long long>(now_ms), symbol.c_str(), static_cast<long long>(state.sequence), price, quantity,
+                static_cast<long long>(now_ms), buyer_maker ? "true" : "false");
+        out.append(buffer, static_cast<std::size_t>(std::clamp(length, 0, static_cast<int>(sizeof(buffer)) - 1)));
+    }
+
+    void append_book_ticker(State& state, std::string& out) {
+        const auto mid = step(state);
+        const auto half_spread = mid * 5e-5;
+        state.sequence += 1;
+        char buffer[320];
+        const int length = std::snprintf(buffer, sizeof(buffer),
+            "{\"u\":%lld,\"s\":\"%s\",\"b\":\"%.8f\",\"B\":\"%.8f\",\"a\":\"%.8f\",\"A\":\"%.8f\"}",
+            static_cast<long long>(state.sequence), state.stream.symbol.c_str(), mid - half_spread, 0.001 + uniform() * 50.0,
+            mid + half_spread, 0.001 + uniform() * 50.0);
+        out.append(buffer, static_cast<std::size_t>(std::clamp(length, 0, static_cast<int>(sizeof(buffer)) - 1)));
+    }
+
+    static std::string interval_name(const State& state) {
+        const auto at = state.stream.name.find("@kline_");
+        return at == std::string::npos ? "1s" : state.stream.name.substr(at + 7);
+    }
+
+    std::vector<State> streams_;
+    std::vector<std::string> symbols_;
+    std::vector<double> prices_;
+    std::size_t cursor_ = 0;
+    bool combined_ = false;
+    std::uint64_t rng_;
+};
+
+} // namespace sentum::collector
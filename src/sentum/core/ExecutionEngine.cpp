@@ -3,14 +3,19 @@
  * MIT License - https://opensource.org/license/mit/
  */
 
+#include <algorithm>
 #include <chrono>
 #include <filesystem>
 #include <iostream>
 #include <stdexcept>
+#include <string>
+#include <thread>
 
 #include <nlohmann/json.hpp>
+#include <sentum/collector/MarketFeedManager.hpp>
 #include <sentum/core/ExecutionEngine.hpp>
 #include <sentum/core/RuntimeControl.hpp>
+#include <sentum/core/ThreadTuning.hpp>
 #include <sentum/dashboard/DashboardState.hpp>
 #include <sentum/market/RuntimePerformanceMetrics.hpp>
 #include <sentum/trader/strategy/StrategyFramework.hpp>
@@ -52,6 +57,7 @@ void ExecutionEngine::stop(ShutdownProgressCallback progress) {
     stop_trader();
 
     report(2, "Disconnecting market stream and flushing database writer");
+    sentum::collector::MarketFeedManager::global().stop();
     if (collector) { collector->stop(); collector_active.store(false); }
 
     report(3, "Joining runtime coordinator");
@@ -62,6 +68,7 @@ void ExecutionEngine::stop(ShutdownProgressCallback progress) {
     scanner_active.store(false);
 
     report(5, "Finalizing runtime state");
+    save_market_snapshot();
     sentum::dashboard::DashboardState::global().merge({
         {"collector_active", false}, {"scanner_active", false}, {"trader_active", false},
         {"market_data_connected", false}
@@ -86,20 +93,77 @@ void ExecutionEngine::init_config() {
 }
 
 void ExecutionEngine::init_components() {
+    low_latency.enabled = config.lowLatencyEnabled;
+    low_latency.io_cores = config.lowLatencyIoCores;
+    low_latency.decision_cores = config.lowLatencyDecisionCores;
+    low_latency.persistence_cores = config.lowLatencyPersistenceCores;
+    low_latency.fifo_priority = config.lowLatencyFifoPriority;
+    if (low_latency.enabled) {
+        // Threads inherit this placement, so the dashboard, scanner lane and loggers stay
+        // on the housekeeping cores; io and decision threads re-pin themselves.
+        if (!sentum::runtime::apply_thread_tuning("sentum", low_latency.persistence()))
+            logger.log("[WARN] Low-latency mode: could not restrict the process to the persistence cores");
+        logger.log("[INFO] Low-latency mode enabled: collector io and decision threads busy-poll");
+    }
     db_path = config.databasePath.empty() ? "log/klines.sqlite3" : config.databasePath;
     binance = std::make_unique<BinanceRestClient>(secrets.api_key, secrets.api_secret);
     markets = binance->get_markets_by_quote(config.quoteAsset);
     paper_account = std::make_unique<sentum::paper::PaperAccount>(config.paperStatePath, config.quoteAsset, config.paperInitialBalance);
     quote_balance = paper_account->equity();
     db = std::make_unique<Database>(db_path);
-    market_store = std::make_unique<MarketDataStore>(600);
-    collector = std::make_unique<Collector>(*db, *market_store, markets);
+    market_store = std::make_unique<MarketDataStore>(600, MarketDataStore::default_max_symbols, config.collectorHugePages);
+    CollectorOptions collector_options;
+    collector_options.shards = config.collectorShards;
+    collector_options.stream_url = config.collectorStreamUrl;
+    collector_options.batch_frames = config.collectorBatchFrames;
+    collector_options.fixed_point = config.collectorFixedPoint;
+    collector_options.book_ticker = config.collectorBookTicker;
+    collector_options.agg_trades = config.collectorAggTrades;
+    collector_options.depth_symbols = config.collectorDepthSymbols;
+    collector_options.depth_snapshot_limit = config.collectorDepthSnapshotLimit;
+    collector_options.depth_record_path = config.collectorDepthRecordPath;
+    collector_options.frame_journal_path = config.collectorFrameJournalPath;
+    collector_options.sqlite_sink = config.collectorKlineSink != "archive";
+    if (config.collectorKlineSink != "sqlite") collector_options.archive_path = config.collectorArchivePath;
+    collector_options.archive_block_rows = config.collectorArchiveBlockRows;
+    collector_options.wal_checkpoint_interval = std::chrono::milliseconds(config.collectorWalCheckpointIntervalMs);
+    collector_options.wal_restart_bytes = static_cast<std::uint64_t>(config.collectorWalRestartMb) << 20;
+    collector_options.spill_path = config.collectorSpillPath;
+    collector_options.spill_max_bytes = static_cast<std::uint64_t>(config.collectorSpillMaxMb) << 20;
+    collector_options.low_latency = low_latency;
+    collector = std::make_unique<Collector>(*db, *market_store, markets, collector_options);
+    // Trade streams for the engines share one connection; its io thread takes the io core
+    // after the collector shards'.
+    sentum::collector::MarketFeedManager::global().configure(config.collectorStreamUrl, low_latency.io(collector->shard_count()));
+    const auto max_age = std::chrono::seconds(config.collectorWarmStartMaxAgeSeconds);
+    if (!config.collectorSnapshotPath.empty() && std::filesystem::exists(config.collectorSnapshotPath)) {
+        const auto restored = market_store->load_snapshot(config.collectorSnapshotPath, max_age);
+        if (restored.ok) {
+            auto& startup = sentum::market::RuntimePerformanceMetrics::global().startup;
+            startup.snapshot_load_ms.store(static_cast<std::uint64_t>(restored.elapsed.count()), std::memory_order_relaxed);
+            startup.snapshot_symbols.store(restored.symbols, std::memory_order_relaxed);
+            logger.log("[INFO] Restored " + std::to_string(restored.symbols) + " symbols from " + config.collectorSnapshotPath + " in " +
+                       std::to_string(restored.elapsed.count()) + " ms (" + (restored.mapped ? "mapped" : "copied") + ", " +
+                       std::to_string(restored.skipped) + " skipped)");
+        } else {
+            logger.log("[WARN] Ignoring market store snapshot: " + restored.error);
+        }
+    }
+    if (config.collectorWarmStartBars > 0) {
+        const auto threads = config.collectorWarmStartThreads > 0
+            ? config.collectorWarmStartThreads
+            : std::clamp<std::size_t>(std::thread::hardware_concurrency(), 1, 8);
+        const auto warm = collector->warm_start(config.collectorWarmStartBars, max_age, threads);
+        logger.log("[INFO] Warm start loaded " + std::to_string(warm.klines) + " klines for " + std::to_string(warm.symbols) +
+                   " symbols in " + std::to_string(warm.elapsed.count()) + " ms");
+    }
     scanner = std::make_unique<SymbolScanner>(*market_store, config.minCumulativeReturn);
     scanner->set_top_changed_handler([this](const SymbolPerformance& top) {
         if (!sentum::runtime::RuntimeControl::global().auto_symbol() || trader_active.load()) return;
         { std::lock_guard<std::mutex> lock(scanner_signal_mutex); pending_scanner_symbol = top.symbol; }
         scanner_signal_cv.notify_one();
     });
+    scanner->seed();
     collector->start();
     collector_active.store(true);
     scanner_active.store(true);
@@ -111,6 +175,7 @@ void ExecutionEngine::init_components() {
 }
 
 void ExecutionEngine::init() {
+    sentum::market::RuntimePerformanceMetrics::global().startup.mark_started();
     std::filesystem::create_directories("log");
     init_config();
     init_components();
@@ -161,8 +226,10 @@ void ExecutionEngine::run_main_loop() {
     scanner_thread = std::thread(&ExecutionEngine::monitor_scanner, this);
     scanner_signal_cv.notify_all();
     auto last_db_probe = std::chrono::steady_clock::time_point{};
+    auto last_snapshot = std::chrono::steady_clock::now();
     auto last_event_sample = std::chrono::steady_clock::now();
     std::uint64_t previous_events = sentum::market::RuntimePerformanceMetrics::global().market_events.load(std::memory_order_relaxed);
+    std::vector<std::uint64_t> previous_shard_events;
     try {
         while (running.load()) {
             apply_runtime_control();
@@ -181,6 +248,10 @@ void ExecutionEngine::run_main_loop() {
                 if (ec) db_size = 0;
                 last_db_probe = now;
             }
+            if (config.collectorSnapshotIntervalSeconds > 0 && now - last_snapshot >= std::chrono::seconds(config.collectorSnapshotIntervalSeconds)) {
+                save_market_snapshot();
+                last_snapshot = now;
+            }
 
             std::string symbol_snapshot;
             { std::lock_guard<std::mutex> lock(symbol_mutex); symbol_snapshot = current_symbol; }
@@ -190,12 +261,21 @@ void ExecutionEngine::run_main_loop() {
             const double events_per_second = sample_seconds > 0.0 ? static_cast<double>(current_events - previous_events) / sample_seconds : 0.0;
             previous_events = current_events; last_event_sample = now;
 
+            auto performance = perf.snapshot();
+            auto& shards = performance["collector_shards"];
+            previous_shard_events.resize(shards.size(), 0);
+            for (std::size_t i = 0; i < shards.size(); ++i) {
+                const auto shard_events = shards[i].value("events_total", std::uint64_t{0});
+                shards[i]["events_per_second"] = sample_seconds > 0.0 ? static_cast<double>(shard_events - previous_shard_events[i]) / sample_seconds : 0.0;
+                previous_shard_events[i] = shard_events;
+            }
+
             nlohmann::json runtime = {
                 {"scanner", scanner_json}, {"top_asset", top_asset}, {"top_return_percent", top_ret}, {"current_symbol", symbol_snapshot},
                 {"db_size_bytes", db_size}, {"collector_active", collector_active.load()}, {"scanner_active", scanner_active.load()},
                 {"trader_active", trader_active.load()}, {"drop_rate", collector ? collector->drop_rate() : 0.0},
                 {"queue_depth", collector ? collector->queue_depth() : 0}, {"events_per_second", events_per_second},
-                {"entries_paused", sentum::runtime::RuntimeControl::global().entries_paused()}, {"performance", perf.snapshot()}
+                {"entries_paused", sentum::runtime::RuntimeControl::global().entries_paused()}, {"performance", performance}
             };
 
             if (trader) {
@@ -237,6 +317,12 @@ void ExecutionEngine::run_main_loop() {
     }
 }
 
+void ExecutionEngine::save_market_snapshot() {
+    if (!market_store || config.collectorSnapshotPath.empty()) return;
+    const auto saved = market_store->save_snapshot(config.collectorSnapshotPath);
+    if (!saved.ok) logger.log("[WARN] Market store snapshot failed: " + saved.error);
+}
+
 void ExecutionEngine::monitor_scanner() {
     try {
         while (running.load()) {
@@ -265,6 +351,13 @@ void ExecutionEngine::start_trader_for(const std::string& symbol) {
     if (paper_account) risk.max_total_capital = paper_account->equity();
     auto strategy = sentum::strategy::StrategyFactory::create(sentum::runtime::RuntimeControl::global().strategy());
     trader = std::make_unique<TradeEngine>(symbol, *binance, risk, std::move(strategy), db_path);
+    if (market_store) trader->attach_market_data(*market_store);
+    trader->set_thread_tuning(low_latency.decision());
+    if (risk.tick_grid_exits) {
+        const auto scale = collector ? collector->price_scale(symbol) : std::nullopt;
+        if (scale) trader->set_exit_price_scale(*scale);
+        else logger.log("[WARN] No PRICE_FILTER tick for " + symbol + ", exit levels stay unrounded");
+    }
     accounted_profit_ = 0.0;
     trader_active.store(true);
     sentum::dashboard::DashboardState::global().merge({
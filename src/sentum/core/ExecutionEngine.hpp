@@ -16,6 +16,7 @@
 
 #include <sentum/api/BinanceRestClient.hpp>
 #include <sentum/collector/Collector.hpp>
+#include <sentum/core/ThreadTuning.hpp>
 #include <sentum/market/MarketDataStore.hpp>
 #include <sentum/scanner/SymbolScanner.hpp>
 #include <sentum/trader/TradeEngine.hpp>
@@ -63,6 +64,7 @@ private:
 
     std::chrono::system_clock::time_point start_time;
     Config config;
+    sentum::runtime::LowLatencyOptions low_latency;
     Secrets secrets;
     AsyncLogger logger;
 
@@ -74,4 +76,5 @@ private:
     void start_trader_for(const std::string& symbol);
     void stop_trader();
     void apply_runtime_control();
+    void save_market_snapshot();
 };
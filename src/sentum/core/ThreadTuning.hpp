@@ -0,0 +1,164 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include <sentum/market/RuntimePerformanceMetrics.hpp>
+
+namespace sentum::runtime {
+
+// Where a latency-critical thread runs and how it waits for work.
+struct ThreadTuning {
+    std::vector<int> cores; // CPUs the thread may run on; empty leaves it to the scheduler
+    int fifo_priority = 0;  // 1-99 runs it SCHED_FIFO (needs CAP_SYS_NICE)
+    bool busy_poll = false; // spin on its io_service or queue instead of sleeping
+
+    bool active() const noexcept { return !cores.empty() || fifo_priority > 0 || busy_poll; }
+};
+
+// Low-latency mode. Collector io threads and the trade-decision thread spin on cores of
+// their own, optionally SCHED_FIFO; the SQLite writer, depth snapshots and every other
+// thread stay on the remaining (housekeeping) cores.
+struct LowLatencyOptions {
+    bool enabled = false;
+    std::vector<int> io_cores;          // io thread i takes io_cores[i % size]
+    std::vector<int> decision_cores;
+    std::vector<int> persistence_cores; // empty: every CPU not listed above
+    int fifo_priority = 0;              // io and decision threads only
+
+    ThreadTuning io(std::size_t index) const {
+        ThreadTuning tuning;
+        if (!enabled) return tuning;
+        if (!io_cores.empty()) tuning.cores = {io_cores[index % io_cores.size()]};
+        tuning.fifo_priority = fifo_priority;
+        tuning.busy_poll = true;
+        return tuning;
+    }
+
+    ThreadTuning decision() const {
+        ThreadTuning tuning;
+        if (!enabled) return tuning;
+        tuning.cores = decision_cores;
+        tuning.fifo_priority = fifo_priority;
+        tuning.busy_poll = true;
+        return tuning;
+    }
+
+    ThreadTuning persistence() const {
+        ThreadTuning tuning;
+        if (!enabled) return tuning;
+        tuning.cores = persistence_cores;
+        if (tuning.cores.empty() && (!io_cores.empty() || !decision_cores.empty())) {
+            const auto listed = [](const std::vector<int>& cores, int core) { return std::find(cores.begin(), cores.end(), core) != cores.end(); };
+            const int online = static_cast<int>(std::thread::hardware_concurrency());
+            for (int core = 0; core < online; ++core)
+                if (!listed(io_cores, core) && !listed(decision_cores, core)) tuning.cores.push_back(core);
+        }
+        return tuning;
+    }
+};
+
+// Parses a CPU list as in taskset and isolcpus: "3", "2,5", "4-7,10".
+inline std::vector<int> parse_core_list(std::string_view text) {
+    std::vector<int> cores;
+    while (!text.empty()) {
+        const auto comma = text.find(',');
+        const auto item = text.substr(0, comma);
+        const auto dash = item.find('-');
+        const int first = std::stoi(std::string(item.substr(0, dash)));
+        const int last = dash == std::string_view::npos ? first : std::stoi(std::string(item.substr(dash + 1)));
+        if (first < 0 || last < first) throw std::invalid_argument("Invalid CPU list: " + std::string(text));
+        for (int core = first; core <= last; ++core) cores.push_back(core);
+        if (comma == std::string_view::npos) break;
+        text.remove_prefix(comma + 1);
+    }
+    return cores;
+}
+
+// Applies `tuning` to the calling thread, names it (as shown by top -H and perf) and
+// records the outcome under performance.threads. Returns false when the kernel refused
+// the affinity or the scheduling policy; the thread keeps running either way.
+inline bool apply_thread_tuning(const std::string& name, const ThreadTuning& tuning) {
+    bool pinned = false, realtime = false;
+    std::uint64_t mask = 0;
+#if defined(__linux__)
+    char thread_name[16] = {};
+    name.copy(thread_name, sizeof(thread_name) - 1);
+    pthread_setname_np(pthread_self(), thread_name);
+    if (!tuning.cores.empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int core : tuning.cores) {
+            if (core < 0 || core >= CPU_SETSIZE) continue;
+            CPU_SET(core, &set);
+            if (core < 64) mask |= std::uint64_t{1} << core;
+        }
+        pinned = CPU_COUNT(&set) > 0 && pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+    }
+    if (tuning.fifo_priority > 0) {
+        sched_param param{};
+        param.sched_priority = std::clamp(tuning.fifo_priority, sched_get_priority_min(SCHED_FIFO), sched_get_priority_max(SCHED_FIFO));
+        realtime = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+    }
+#endif
+    if (auto* slot = sentum::market::RuntimePerformanceMetrics::global().thread_placement(name)) {
+        slot->core_mask.store(pinned ? mask : 0, std::memory_order_relaxed);
+        slot->pinned.store(pinned, std::memory_order_relaxed);
+        slot->realtime.store(realtime, std::memory_order_relaxed);
+        slot->busy_poll.store(tuning.busy_poll, std::memory_order_relaxed);
+    }
+    return (tuning.cores.empty() || pinned) && (tuning.fifo_priority <= 0 || realtime);
+}
+
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+// Backoff for spin loops: 1, 2, 4 ... 64 pause instructions between empty polls, then a
+// yield per poll. A SCHED_FIFO spinner only yields to threads of its own priority, so
+// it must own its core.
+class SpinBackoff {
+public:
+    void reset() noexcept { spins_ = 1; }
+    void idle() noexcept {
+        if (spins_ > max_spins) { std::this_thread::yield(); return; }
+        for (unsigned i = 0; i < spins_; ++i) cpu_relax();
+        spins_ <<= 1;
+    }
+
+private:
+    static constexpr unsigned max_spins = 64;
+    unsigned spins_ = 1;
+};
+
+// Runs an asio endpoint (websocketpp endpoint or io_service) until it is stopped: in
+// run(), sleeping in epoll between events, or spinning on poll() when busy-polling.
+template <typename Endpoint>
+void run_io_loop(Endpoint& endpoint, bool busy_poll) {
+    if (!busy_poll) { endpoint.run(); return; }
+    SpinBackoff backoff;
+    while (!endpoint.stopped()) {
+        if (endpoint.poll() > 0) backoff.reset();
+        else backoff.idle();
+    }
+}
+
+} // namespace sentum::runtime
@@ -48,6 +48,7 @@ inline constexpr const char* kDashboardHtml = R"HTML(<!doctype html>
 <section id="runtimeView" class="view">
 <div class="grid kpis"><div class="card"><div class="label">Balance</div><div id="balance" class="value">—</div></div><div class="card"><div class="label">Net P&amp;L</div><div id="pnl" class="value">—</div></div><div class="card"><div class="label">Trades</div><div id="trades" class="value">0</div></div><div class="card"><div class="label">Win Rate</div><div id="winrate" class="value">—</div></div><div class="card"><div class="label">Symbol</div><div id="symbol" class="value">—</div></div><div class="card"><div class="label">Queue Drop</div><div id="drop" class="value">—</div></div></div>
 <div class="grid two"><div class="card"><div class="section">Realized Trading Equity</div><canvas id="equity" width="900" height="240"></canvas></div><div class="card"><div class="section">System Health</div><div id="healthGrid" class="health"></div></div></div>
+<div class="card" style="margin-top:14px"><div class="section">Dispatch Lanes</div><div class="scroll"><table><thead><tr><th>Lane</th><th>Policy</th><th>Depth</th><th>High Water</th><th>Lag (µs)</th><th>Lag p99 (µs)</th><th>Dropped</th><th>Conflated</th></tr></thead><tbody id="laneRows"></tbody></table></div></div>
 <div class="grid two" style="margin-top:14px"><div class="card"><div class="section">Recent Trades</div><div class="scroll"><table><thead><tr><th>Symbol</th><th>Strategy</th><th>Entry</th><th>Exit</th><th>Net P&amp;L</th><th>Reason</th></tr></thead><tbody id="tradeRows"></tbody></table></div></div><div class="card"><div class="section">Order Events</div><div class="scroll"><table><thead><tr><th>Symbol</th><th>Side</th><th>State</th><th>Executed</th><th>Fill</th><th>Source</th></tr></thead><tbody id="orderRows"></tbody></table></div></div></div>
 </section>
 <div class="footer">Advanced research views are read-only. No order, credential, configuration-write or kill-switch endpoints are exposed to the browser.</div>
@@ -90,7 +91,7 @@ async function loadRuns(){runs=await get('/api/experiments?limit=200')||[];const
 $('runA').onchange=()=>selectRun($('runA').value);$('runB').onchange=()=>compareRun($('runB').value);
 
 function healthItem(name,val){const cls=val===true?'good':val===false?'bad':'warn';return `<div class="${cls}"><span class="dot"></span>${esc(name)}: ${val===true?'OK':val===false?'DOWN':esc(String(val??'n/a'))}</div>`}
-async function refreshRuntime(){const [s,t,o,e]=await Promise.all([get('/api/status'),get('/api/trades?limit=100'),get('/api/orders?limit=100'),get('/api/equity?limit=500')]);if(!s)return;$('mode').textContent=String(s.mode||'idle').toUpperCase();$('updated').textContent=new Date().toLocaleTimeString();$('balance').textContent=fmt(s.balance,2)+(s.quote_asset?' '+s.quote_asset:'');$('pnl').textContent=fmt(s.total_profit,2);$('pnl').className='value '+((+s.total_profit||0)>=0?'positive':'negative');$('trades').textContent=s.total_trades||0;$('winrate').textContent=fmt(s.win_rate,1)+'%';$('symbol').textContent=s.current_symbol||s.symbol||'—';$('drop').textContent=fmt((+s.drop_rate||0)*100,3)+'%';$('healthGrid').innerHTML=healthItem('Market data',s.market_data_connected)+healthItem('User stream',s.user_stream_connected)+healthItem('Reconciled',s.reconciliation_complete)+healthItem('Kill switch',s.kill_switch_active?false:true)+healthItem('Collector',s.collector_active)+healthItem('Scanner',s.scanner_active);$('tradeRows').innerHTML=(t||[]).map(v=>`<tr><td>${esc(v.symbol)}</td><td>${esc(v.strategy)}</td><td>${fmt(v.entry_price,4)}</td><td>${fmt(v.exit_price,4)}</td><td class="${(+v.net_profit||0)>=0?'positive':'negative'}">${fmt(v.net_profit,2)}</td><td>${esc(v.exit_reason)}</td></tr>`).join('');$('orderRows').innerHTML=(o||[]).map(v=>`<tr><td>${esc(v.symbol)}</td><td>${esc(v.side)}</td><td>${esc(v.state)}</td><td>${fmt(v.executed_quantity,6)}</td><td>${fmt(v.average_fill_price,4)}</td><td>${esc(v.source)}</td></tr>`).join('');lineChart('equity',[{points:(e||[]).map(p=>({y:+p.equity}))}])}
+async function refreshRuntime(){const [s,t,o,e]=await Promise.all([get('/api/status'),get('/api/trades?limit=100'),get('/api/orders?limit=100'),get('/api/equity?limit=500')]);if(!s)return;$('mode').textContent=String(s.mode||'idle').toUpperCase();$('updated').textContent=new Date().toLocaleTimeString();$('balance').textContent=fmt(s.balance,2)+(s.quote_asset?' '+s.quote_asset:'');$('pnl').textContent=fmt(s.total_profit,2);$('pnl').className='value '+((+s.total_profit||0)>=0?'positive':'negative');$('trades').textContent=s.total_trades||0;$('winrate').textContent=fmt(s.win_rate,1)+'%';$('symbol').textContent=s.current_symbol||s.symbol||'—';$('drop').textContent=fmt((+s.drop_rate||0)*100,3)+'%';$('healthGrid').innerHTML=healthItem('Market data',s.market_data_connected)+healthItem('User stream',s.user_stream_connected)+healthItem('Reconciled',s.reconciliation_complete)+healthItem('Kill switch',s.kill_switch_active?false:true)+healthItem('Collector',s.collector_active)+healthItem('Scanner',s.scanner_active);$('laneRows').innerHTML=(s.performance?.dispatch_lanes||[]).map(v=>`<tr><td>${esc(v.name)}</td><td>${esc(v.policy)}</td><td>${v.depth??0}</td><td>${v.depth_high_water??0}</td><td>${v.lag_us??0}</td><td>${v.lag?.p99_us??0}</td><td>${v.dropped_total??0}</td><td>${v.conflated_total??0}</td></tr>`).join('');$('tradeRows').innerHTML=(t||[]).map(v=>`<tr><td>${esc(v.symbol)}</td><td>${esc(v.strategy)}</td><td>${fmt(v.entry_price,4)}</td><td>${fmt(v.exit_price,4)}</td><td class="${(+v.net_profit||0)>=0?'positive':'negative'}">${fmt(v.net_profit,2)}</td><td>${esc(v.exit_reason)}</td></tr>`).join('');$('orderRows').innerHTML=(o||[]).map(v=>`<tr><td>${esc(v.symbol)}</td><td>${esc(v.side)}</td><td>${esc(v.state)}</td><td>${fmt(v.executed_quantity,6)}</td><td>${fmt(v.average_fill_price,4)}</td><td>${esc(v.source)}</td></tr>`).join('');lineChart('equity',[{points:(e||[]).map(p=>({y:+p.equity}))}])}
 
 loadRuns();refreshRuntime();setInterval(refreshRuntime,2500);setInterval(loadRuns,15000);
 </script></body></html>)HTML";
@@ -0,0 +1,308 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <sentum/market/MarketEvent.hpp>
+#include <sentum/market/RuntimePerformanceMetrics.hpp>
+#include <sentum/market/SpscRingQueue.hpp>
+
+namespace sentum::market {
+
+enum class OverflowPolicy : std::uint8_t {
+    Block,      // the publisher waits for the worker to make room
+    DropOldest, // the oldest queued event is overwritten
+    Conflate    // only the latest event per SymbolId is kept
+};
+
+struct LaneOptions {
+    std::string name = "lane";
+    OverflowPolicy policy = OverflowPolicy::Block;
+    // Ring capacity, rounded up to a power of two.
+    std::size_t capacity = 4096;
+    // Conflate only: number of SymbolId slots (at most 65535). Higher ids use the ring in
+    // drop-oldest mode.
+    std::size_t conflation_symbols = 16384;
+    // MarketEvent::type_mask bits of the events this lane accepts; others are skipped on
+    // the publishing thread. Conflating lanes that mix types keep only the latest event of
+    // any type per symbol, so they usually accept one type.
+    std::uint8_t event_types = MarketEvent::all_types;
+};
+
+// Single-producer/single-consumer hand-off from the publishing thread to a dedicated
+// worker that runs one subscriber. Events are copied into seqlock-protected cells, so a
+// drop-oldest producer can overwrite a cell the worker is reading and the worker
+// detects it and skips ahead. Conflation keeps one cell per SymbolId plus a queue of
+// dirty ids; a symbol is queued at most once however often it is updated.
+class DispatchLane {
+public:
+    using Callback = void (*)(void* context, const MarketEvent& event);
+
+    DispatchLane(LaneOptions options, Callback callback, void* context)
+        : options_(std::move(options)), callback_(callback), context_(context),
+          mask_(round_up(options_.capacity) - 1), ring_(mask_ + 1),
+          metrics_(RuntimePerformanceMetrics::global().acquire_dispatch_lane(options_.name,
+                                                                             static_cast<std::uint8_t>(options_.policy))) {
+        if (options_.policy == OverflowPolicy::Conflate) {
+            options_.conflation_symbols = std::min(options_.conflation_symbols, DirtyQueue::usable_capacity());
+            latest_ = std::vector<Cell>(options_.conflation_symbols);
+            pending_ = std::make_unique<std::atomic<bool>[]>(options_.conflation_symbols);
+            dirty_ = std::make_unique<DirtyQueue>();
+        }
+        worker_ = std::thread(&DispatchLane::run, this);
+    }
+
+    DispatchLane(const DispatchLane&) = delete;
+    DispatchLane& operator=(const DispatchLane&) = delete;
+
+    // Stops the worker; events still queued are discarded.
+    ~DispatchLane() {
+        {
+            std::lock_guard<std::mutex> lock(wait_mutex_);
+            stopping_.store(true, std::memory_order_seq_cst);
+        }
+        wait_cv_.notify_one();
+        if (worker_.joinable()) worker_.join();
+        RuntimePerformanceMetrics::global().release_dispatch_lane(metrics_);
+    }
+
+    // Publisher side. The lane is single-producer; concurrent publishers (several collector
+    // shards) are serialized by a spin lock that is uncontended with a single shard.
+    void push(const MarketEvent& event) {
+        if (!(options_.event_types & MarketEvent::type_mask(event.type))) return;
+        while (producer_lock_.test_and_set(std::memory_order_acquire)) std::this_thread::yield();
+        if (metrics_) metrics_->published.fetch_add(1, std::memory_order_relaxed);
+        if (enqueue_locked(event, steady_nanoseconds())) {
+            if (metrics_) metrics_->observe_depth(depth());
+            wake_worker();
+        }
+        producer_lock_.clear(std::memory_order_release);
+    }
+
+    // Queues a whole batch under one lock acquisition, one clock read and one wake-up.
+    void push(const MarketEventBatch& batch) {
+        while (producer_lock_.test_and_set(std::memory_order_acquire)) std::this_thread::yield();
+        const auto now = steady_nanoseconds();
+        std::uint64_t accepted = 0;
+        for (const auto& event : batch) {
+            if (!(options_.event_types & MarketEvent::type_mask(event.type))) continue;
+            ++accepted;
+            if (!enqueue_locked(event, now)) break;
+        }
+        if (accepted > 0) {
+            if (metrics_) {
+                metrics_->published.fetch_add(accepted, std::memory_order_relaxed);
+                metrics_->observe_depth(depth());
+            }
+            wake_worker();
+        }
+        producer_lock_.clear(std::memory_order_release);
+    }
+
+    std::size_t depth() const noexcept {
+        const auto queued = head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+        return static_cast<std::size_t>(std::min<std::uint64_t>(queued, mask_ + 1)) +
+               dirty_size_.load(std::memory_order_relaxed);
+    }
+
+    const std::string& name() const noexcept { return options_.name; }
+
+    static void push_thunk(void* lane, const MarketEvent& event) { static_cast<DispatchLane*>(lane)->push(event); }
+    static void push_batch_thunk(void* lane, const MarketEventBatch& batch) { static_cast<DispatchLane*>(lane)->push(batch); }
+
+private:
+    // False when a blocking lane is stopping and the event was discarded.
+    bool enqueue_locked(const MarketEvent& event, std::uint64_t now) {
+        const auto id = static_cast<std::size_t>(event.symbol_id);
+        if (options_.policy == OverflowPolicy::Conflate && id < latest_.size()) {
+            auto& cell = latest_[id];
+            cell.write(cell.sequence.load(std::memory_order_relaxed) + 2, event, now);
+            if (!pending_[id].exchange(true, std::memory_order_acq_rel)) {
+                // One entry per symbol at most, so the dirty queue cannot overflow.
+                dirty_->try_push(static_cast<SymbolId>(id));
+                dirty_size_.fetch_add(1, std::memory_order_seq_cst);
+            } else if (metrics_) {
+                metrics_->conflated.fetch_add(1, std::memory_order_relaxed);
+            }
+        } else {
+            const auto head = head_.load(std::memory_order_relaxed);
+            if (options_.policy == OverflowPolicy::Block) {
+                while (head - tail_.load(std::memory_order_acquire) > mask_) {
+                    if (stopping_.load(std::memory_order_relaxed)) return false;
+                    // Within a batch the worker has not been woken for earlier events yet.
+                    wake_worker();
+                    std::this_thread::yield();
+                }
+            }
+            ring_[head & mask_].write(2 * head + 2, event, now);
+            head_.store(head + 1, std::memory_order_seq_cst);
+        }
+        return true;
+    }
+
+    void wake_worker() {
+        if (waiting_.load(std::memory_order_seq_cst)) {
+            std::lock_guard<std::mutex> lock(wait_mutex_);
+            wait_cv_.notify_one();
+        }
+    }
+
+    // One event plus its enqueue time, copied word by word so a concurrent overwrite is a
+    // detectable torn read rather than a data race.
+    struct alignas(64) Cell {
+        static constexpr std::size_t words = sizeof(MarketEvent) / sizeof(std::uint64_t);
+        std::atomic<std::uint64_t> sequence{0};
+        std::atomic<std::uint64_t> enqueued_ns{0};
+        std::array<std::atomic<std::uint64_t>, words> payload{};
+
+        void write(std::uint64_t final_sequence, const MarketEvent& event, std::uint64_t now) noexcept {
+            std::uint64_t raw[words];
+            std::memcpy(raw, &event, sizeof(event));
+            sequence.store(final_sequence - 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            enqueued_ns.store(now, std::memory_order_relaxed);
+            for (std::size_t i = 0; i < words; ++i) payload[i].store(raw[i], std::memory_order_relaxed);
+            sequence.store(final_sequence, std::memory_order_release);
+        }
+
+        // Returns the sequence the copy belongs to, or an odd value if it was torn.
+        std::uint64_t read(MarketEvent& event, std::uint64_t& enqueued) const noexcept {
+            const auto before = sequence.load(std::memory_order_acquire);
+            if (before & 1U) return before;
+            std::uint64_t raw[words];
+            enqueued = enqueued_ns.load(std::memory_order_relaxed);
+            for (std::size_t i = 0; i < words; ++i) raw[i] = payload[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) != before) return 1;
+            std::memcpy(&event, raw, sizeof(event));
+            return before;
+        }
+    };
+    static_assert(sizeof(MarketEvent) % sizeof(std::uint64_t) == 0);
+    static_assert(std::is_trivially_copyable_v<MarketEvent>);
+
+    using DirtyQueue = SpscRingQueue<SymbolId, 65536>;
+
+    static std::size_t round_up(std::size_t value) noexcept {
+        std::size_t capacity = 2;
+        while (capacity < value) capacity <<= 1U;
+        return capacity;
+    }
+
+    static std::uint64_t steady_nanoseconds() noexcept {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    bool has_work() const noexcept {
+        return head_.load(std::memory_order_seq_cst) != tail_.load(std::memory_order_relaxed) ||
+               dirty_size_.load(std::memory_order_seq_cst) != 0;
+    }
+
+    void deliver(const MarketEvent& event, std::uint64_t enqueued) {
+        try {
+            callback_(context_, event);
+        } catch (...) {
+            if (metrics_) metrics_->handler_errors.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (!metrics_) return;
+        const auto now = steady_nanoseconds();
+        const auto lag_us = now > enqueued ? (now - enqueued) / 1000 : 0;
+        metrics_->delivered.fetch_add(1, std::memory_order_relaxed);
+        metrics_->last_lag_us.store(lag_us, std::memory_order_relaxed);
+        metrics_->lag.observe(lag_us);
+    }
+
+    bool drain_ring() {
+        bool progressed = false;
+        auto tail = tail_.load(std::memory_order_relaxed);
+        while (true) {
+            const auto head = head_.load(std::memory_order_acquire);
+            if (tail == head) break;
+            if (head - tail > mask_ + 1) {
+                // The producer lapped the worker: skip to the oldest cell still intact.
+                if (metrics_) metrics_->dropped.fetch_add(head - tail - (mask_ + 1), std::memory_order_relaxed);
+                tail = head - (mask_ + 1);
+            }
+            MarketEvent event;
+            std::uint64_t enqueued = 0;
+            const auto sequence = ring_[tail & mask_].read(event, enqueued);
+            if (sequence != 2 * tail + 2) {
+                // Overwritten while reading; the next pass re-measures the lap.
+                if (sequence > 2 * tail + 2 && (sequence & 1U) == 0) {
+                    if (metrics_) metrics_->dropped.fetch_add(1, std::memory_order_relaxed);
+                    ++tail;
+                }
+                tail_.store(tail, std::memory_order_release);
+                continue;
+            }
+            ++tail;
+            tail_.store(tail, std::memory_order_release);
+            deliver(event, enqueued);
+            progressed = true;
+        }
+        return progressed;
+    }
+
+    bool drain_conflated() {
+        bool progressed = false;
+        SymbolId id = kInvalidSymbolId;
+        while (dirty_ && dirty_->try_pop(id)) {
+            dirty_size_.fetch_sub(1, std::memory_order_relaxed);
+            // Clear first so an update racing with this read queues the symbol again.
+            pending_[id].store(false, std::memory_order_seq_cst);
+            MarketEvent event;
+            std::uint64_t enqueued = 0;
+            while (latest_[id].read(event, enqueued) & 1U) std::this_thread::yield();
+            deliver(event, enqueued);
+            progressed = true;
+        }
+        return progressed;
+    }
+
+    void run() {
+        while (!stopping_.load(std::memory_order_acquire)) {
+            const bool ring = drain_ring();
+            const bool conflated = drain_conflated();
+            if (metrics_) metrics_->depth.store(depth(), std::memory_order_relaxed);
+            if (ring || conflated) continue;
+            std::unique_lock<std::mutex> lock(wait_mutex_);
+            waiting_.store(true, std::memory_order_seq_cst);
+            wait_cv_.wait(lock, [this] { return stopping_.load(std::memory_order_seq_cst) || has_work(); });
+            waiting_.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    LaneOptions options_;
+    Callback callback_;
+    void* context_;
+    const std::uint64_t mask_;
+    std::vector<Cell> ring_;
+    std::vector<Cell> latest_;
+    std::unique_ptr<std::atomic<bool>[]> pending_;
+    std::unique_ptr<DirtyQueue> dirty_;
+    DispatchLaneMetrics* metrics_;
+    alignas(64) std::atomic<std::uint64_t> head_{0};
+    alignas(64) std::atomic<std::uint64_t> tail_{0};
+    alignas(64) std::atomic<std::size_t> dirty_size_{0};
+    std::atomic_flag producer_lock_ = ATOMIC_FLAG_INIT;
+    std::atomic<bool> waiting_{false};
+    std::atomic<bool> stopping_{false};
+    std::mutex wait_mutex_;
+    std::condition_variable wait_cv_;
+    std::thread worker_;
+};
+
+} // namespace sentum::market
@@ -0,0 +1,251 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string_view>
+
+namespace sentum::market {
+
+// Exact decimal as read from the wire: value = mantissa * 10^exponent.
+struct Decimal {
+    std::uint64_t mantissa = 0;
+    int exponent = 0;
+    bool negative = false;
+};
+
+namespace detail {
+
+inline constexpr double kPow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+inline constexpr std::uint64_t kPow10u[] = {1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+                                            100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL,
+                                            1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+                                            1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+                                            1000000000000000000ULL, 10000000000000000000ULL};
+inline constexpr int kMaxMantissaDigits = 19;
+
+inline bool is_digit(char c) noexcept { return c >= '0' && c <= '9'; }
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define SENTUM_DECIMAL_SWAR 1
+inline std::uint64_t load8(const char* p) noexcept { std::uint64_t v; std::memcpy(&v, p, sizeof(v)); return v; }
+
+inline bool is_eight_digits(std::uint64_t v) noexcept {
+    return ((v & 0xF0F0F0F0F0F0F0F0ULL) | (((v + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) == 0x3333333333333333ULL;
+}
+
+// Converts eight ASCII digits (little-endian load) with three multiplies instead of eight.
+inline std::uint32_t eight_digits_value(std::uint64_t v) noexcept {
+    constexpr std::uint64_t mask = 0x000000FF000000FFULL;
+    constexpr std::uint64_t mul1 = 100ULL + (1000000ULL << 32);
+    constexpr std::uint64_t mul2 = 1ULL + (10000ULL << 32);
+    v -= 0x3030303030303030ULL;
+    v = (v * 10) + (v >> 8);
+    v = (((v & mask) * mul1) + (((v >> 16) & mask) * mul2)) >> 32;
+    return static_cast<std::uint32_t>(v);
+}
+#endif
+
+// Accumulates a digit run into `mantissa`. Digits beyond the 19-digit mantissa budget are
+// counted in `dropped` so the caller can keep the decimal exponent correct.
+inline const char* scan_digits(const char* p, const char* end, std::uint64_t& mantissa, int& digits, int& dropped) noexcept {
+#if defined(SENTUM_DECIMAL_SWAR)
+    while (end - p >= 8 && digits + 8 <= kMaxMantissaDigits) {
+        const auto chunk = load8(p);
+        if (!is_eight_digits(chunk)) break;
+        mantissa = mantissa * 100000000ULL + eight_digits_value(chunk);
+        if (mantissa != 0) digits += 8;
+        p += 8;
+    }
+#endif
+    while (p < end && is_digit(*p)) {
+        if (digits < kMaxMantissaDigits) {
+            mantissa = mantissa * 10 + static_cast<std::uint64_t>(*p - '0');
+            if (mantissa != 0) ++digits;
+        } else ++dropped;
+        ++p;
+    }
+    return p;
+}
+
+} // namespace detail
+
+// Parses [-]digits[.digits] starting at `p`. Returns the first unconsumed byte or nullptr.
+inline const char* scan_decimal(const char* p, const char* end, Decimal& out) noexcept {
+    out = {};
+    if (p < end && *p == '-') { out.negative = true; ++p; }
+    int digits = 0, dropped = 0;
+    const char* start = p;
+    p = detail::scan_digits(p, end, out.mantissa, digits, dropped);
+    bool any = p != start;
+    out.exponent = dropped;
+    if (p < end && *p == '.') {
+        ++p;
+        const char* fraction = p;
+        int fraction_dropped = 0;
+        p = detail::scan_digits(p, end, out.mantissa, digits, fraction_dropped);
+        out.exponent -= static_cast<int>(p - fraction) - fraction_dropped;
+        any = any || p != fraction;
+    }
+    return any ? p : nullptr;
+}
+
+inline double to_double(const Decimal& d) noexcept {
+    double value = static_cast<double>(d.mantissa);
+    // Single multiply/divide by an exact power of ten is correctly rounded while the mantissa fits 53 bits.
+    if (d.exponent < 0) value = d.exponent >= -22 ? value / detail::kPow10[-d.exponent] : value / 1e22 / detail::kPow10[-d.exponent - 22];
+    else if (d.exponent > 0) value *= d.exponent <= 22 ? detail::kPow10[d.exponent] : 1e22;
+    return d.negative ? -value : value;
+}
+
+// Scaled integer in units of 10^-decimals of the owning FixedScale. Tags keep prices and
+// quantities from being mixed by accident.
+template <typename Tag>
+struct Fixed {
+    std::int64_t raw = 0;
+
+    constexpr Fixed() = default;
+    constexpr explicit Fixed(std::int64_t value) : raw(value) {}
+
+    friend constexpr bool operator==(Fixed a, Fixed b) noexcept { return a.raw == b.raw; }
+    friend constexpr bool operator!=(Fixed a, Fixed b) noexcept { return a.raw != b.raw; }
+    friend constexpr bool operator<(Fixed a, Fixed b) noexcept { return a.raw < b.raw; }
+    friend constexpr bool operator<=(Fixed a, Fixed b) noexcept { return a.raw <= b.raw; }
+    friend constexpr bool operator>(Fixed a, Fixed b) noexcept { return a.raw > b.raw; }
+    friend constexpr bool operator>=(Fixed a, Fixed b) noexcept { return a.raw >= b.raw; }
+    friend constexpr Fixed operator+(Fixed a, Fixed b) noexcept { return Fixed(a.raw + b.raw); }
+    friend constexpr Fixed operator-(Fixed a, Fixed b) noexcept { return Fixed(a.raw - b.raw); }
+};
+
+struct PriceTag {};
+struct QtyTag {};
+using Price = Fixed<PriceTag>;
+using Qty = Fixed<QtyTag>;
+
+// Decimal grid of one symbol's prices or quantities, derived from the exchange's
+// tickSize/stepSize. A tick of "0.05000000" gives two decimals and a tick of 5 units.
+class FixedScale {
+public:
+    static constexpr int max_decimals = 12;
+
+    constexpr FixedScale() = default;
+    constexpr FixedScale(int decimals, std::int64_t tick_units) : decimals_(decimals), tick_units_(tick_units) {}
+
+    static FixedScale from_increment(std::string_view text) noexcept {
+        Decimal d;
+        if (!scan_decimal(text.data(), text.data() + text.size(), d) || d.mantissa == 0 || d.negative) return {};
+        while (d.mantissa % 10 == 0) { d.mantissa /= 10; ++d.exponent; }
+        if (-d.exponent > max_decimals) return {};
+        if (d.exponent >= 0) {
+            if (d.exponent > 18) return {};
+            return {0, static_cast<std::int64_t>(d.mantissa * detail::kPow10u[d.exponent])};
+        }
+        return {-d.exponent, static_cast<std::int64_t>(d.mantissa)};
+    }
+
+    static FixedScale from_increment(double increment) noexcept {
+        if (!(increment > 0.0)) return {};
+        char text[48];
+        const int length = std::snprintf(text, sizeof(text), "%.*f", max_decimals, increment);
+        if (length <= 0 || static_cast<std::size_t>(length) >= sizeof(text)) return {};
+        return from_increment(std::string_view(text, static_cast<std::size_t>(length)));
+    }
+
+    constexpr int decimals() const noexcept { return decimals_; }
+    constexpr std::int64_t tick_units() const noexcept { return tick_units_; }
+
+    // Rescales an exact wire decimal onto this grid, rounding half away from zero when the
+    // value carries more digits than the grid. Fails instead of wrapping on overflow.
+    template <typename Tag>
+    bool from_decimal(const Decimal& d, Fixed<Tag>& out) const noexcept {
+        const int shift = d.exponent + decimals_;
+        std::uint64_t magnitude = d.mantissa;
+        if (shift >= 0) {
+            if (shift > 18 || magnitude > static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max()) / detail::kPow10u[shift]) return false;
+            magnitude *= detail::kPow10u[shift];
+        } else if (-shift > 19) {
+            magnitude = 0;
+        } else {
+            const auto divisor = detail::kPow10u[-shift];
+            const auto remainder = magnitude % divisor;
+            magnitude /= divisor;
+            if (remainder >= divisor - remainder) ++magnitude;
+        }
+        if (magnitude > static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max())) return false;
+        out.raw = d.negative ? -static_cast<std::int64_t>(magnitude) : static_cast<std::int64_t>(magnitude);
+        return true;
+    }
+
+    template <typename Tag = PriceTag>
+    Fixed<Tag> from_double(double value) const noexcept {
+        return Fixed<Tag>(static_cast<std::int64_t>(std::llround(value * detail::kPow10[decimals_])));
+    }
+
+    template <typename Tag>
+    double to_double(Fixed<Tag> value) const noexcept { return static_cast<double>(value.raw) / detail::kPow10[decimals_]; }
+
+    template <typename Tag>
+    Fixed<Tag> floor_to_tick(Fixed<Tag> value) const noexcept {
+        auto remainder = value.raw % tick_units_;
+        if (remainder < 0) remainder += tick_units_;
+        return Fixed<Tag>(value.raw - remainder);
+    }
+
+    template <typename Tag>
+    Fixed<Tag> ceil_to_tick(Fixed<Tag> value) const noexcept {
+        const auto floored = floor_to_tick(value);
+        return floored == value ? value : Fixed<Tag>(floored.raw + tick_units_);
+    }
+
+private:
+    int decimals_ = 8;
+    std::int64_t tick_units_ = 1;
+};
+
+struct SymbolScales {
+    FixedScale price;
+    FixedScale quantity;
+};
+
+struct FixedKline {
+    std::int64_t timestamp = 0;
+    Price open, high, low, close;
+    Qty volume;
+};
+
+// Candle with prices stored as 32-bit offsets from a per-series anchor: 32 bytes instead
+// of the 48 of a double Kline, and 16 instead of 32 bytes of price data per candle.
+struct PackedKline {
+    std::int64_t timestamp = 0;
+    std::int32_t open = 0, high = 0, low = 0, close = 0;
+    std::int64_t volume = 0;
+};
+static_assert(sizeof(PackedKline) == 32, "PackedKline must stay half a cache line");
+
+inline bool pack_kline(const FixedKline& kline, std::int64_t anchor, PackedKline& out) noexcept {
+    const auto fits = [anchor](Price value, std::int32_t& delta) {
+        const auto offset = value.raw - anchor;
+        if (offset < std::numeric_limits<std::int32_t>::min() || offset > std::numeric_limits<std::int32_t>::max()) return false;
+        delta = static_cast<std::int32_t>(offset);
+        return true;
+    };
+    out.timestamp = kline.timestamp;
+    out.volume = kline.volume.raw;
+    return fits(kline.open, out.open) && fits(kline.high, out.high) && fits(kline.low, out.low) && fits(kline.close, out.close);
+}
+
+inline FixedKline unpack_kline(const PackedKline& packed, std::int64_t anchor) noexcept {
+    FixedKline kline;
+    kline.timestamp = packed.timestamp;
+    kline.open = Price(anchor + packed.open);
+    kline.high = Price(anchor + packed.high);
+    kline.low = Price(anchor + packed.low);
+    kline.close = Price(anchor + packed.close);
+    kline.volume = Qty(packed.volume);
+    return kline;
+}
+
+} // namespace sentum::market
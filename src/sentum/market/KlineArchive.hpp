@@ -0,0 +1,751 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <sentum/api/model/Kline.hpp>
+#include <sentum/market/RuntimePerformanceMetrics.hpp>
+#include <sentum/market/StoreSnapshot.hpp>
+
+namespace sentum::market {
+
+// Append-only columnar archive of closed klines, an alternative to the SQLite klines
+// table. The archive is a directory of one partition per UTC day:
+//
+//   klines-YYYYMMDD.ska      file header, then blocks
+//   klines-YYYYMMDD.ska.idx  index magic, then one KlineArchiveIndexEntry per block
+//
+// A block holds up to `block_rows` consecutive klines of one symbol as six compressed
+// columns: timestamps as Gorilla delta-of-deltas, prices and volume as Gorilla XORs
+// against a prediction. Close and volume are predicted by their previous value, open
+// by the previous close, and high and low by the larger and smaller of the row's open
+// and close. A quiet second of 1s klines costs one bit per column. Blocks are written before their index
+// entry, so the index never points past the data; blocks after the last index entry
+// (a crash between the two writes) are found by walking the block headers. Values are
+// stored in native byte order, like the frame journal and store snapshots.
+struct KlineArchiveFormat {
+    static constexpr char data_magic[8] = {'S', 'N', 'T', 'M', 'K', 'L', 'A', '1'};
+    static constexpr char index_magic[8] = {'S', 'N', 'T', 'M', 'K', 'L', 'I', '1'};
+    static constexpr std::uint32_t version = 1;
+    static constexpr std::int64_t day_ms = 86400000;
+    static constexpr std::size_t columns = 6; // timestamp, open, high, low, close, volume
+};
+
+struct KlineArchiveFileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t reserved;
+    std::int64_t day; // days since the Unix epoch
+};
+
+struct KlineArchiveBlockHeader {
+    static constexpr std::uint32_t expected_magic = 0x424B4C53; // "SLKB"
+    std::uint32_t magic;
+    std::uint32_t rows;
+    char symbol[24]; // NUL-padded
+    std::int64_t first_timestamp;
+    std::int64_t last_timestamp;
+    std::uint32_t column_bytes[KlineArchiveFormat::columns];
+    // StoreSnapshotChecksum over the columns in order.
+    std::uint64_t checksum;
+
+    std::uint64_t bytes() const noexcept {
+        std::uint64_t total = sizeof(KlineArchiveBlockHeader);
+        for (auto column : column_bytes) total += column;
+        return total;
+    }
+};
+
+struct KlineArchiveIndexEntry {
+    char symbol[24];
+    std::int64_t first_timestamp;
+    std::int64_t last_timestamp;
+    std::uint64_t offset; // of the block header
+    std::uint32_t rows;
+    std::uint32_t bytes;  // header and columns
+};
+
+static_assert(sizeof(KlineArchiveFileHeader) == 24, "archive file header layout");
+static_assert(sizeof(KlineArchiveBlockHeader) == 80, "archive block header layout");
+static_assert(sizeof(KlineArchiveIndexEntry) == 56, "archive index entry layout");
+
+inline std::int64_t kline_archive_day(std::int64_t timestamp_ms) noexcept {
+    return timestamp_ms >= 0 ? timestamp_ms / KlineArchiveFormat::day_ms : (timestamp_ms + 1) / KlineArchiveFormat::day_ms - 1;
+}
+
+// "klines-YYYYMMDD.ska" for a day since the epoch (proleptic Gregorian, as in
+// Howard Hinnant's civil_from_days).
+inline std::string kline_archive_partition_name(std::int64_t day) {
+    const std::int64_t z = day + 719468;
+    const std::int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const auto doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    const unsigned d = doy - (153 * mp + 2) / 5 + 1;
+    const unsigned m = mp < 10 ? mp + 3 : mp - 9;
+    const long long y = static_cast<long long>(yoe) + era * 400 + (m <= 2 ? 1 : 0);
+    char name[40];
+    std::snprintf(name, sizeof(name), "klines-%04lld%02u%02u.ska", y, m, d);
+    return name;
+}
+
+namespace gorilla {
+
+// Bits are packed LSB first into little-endian 64-bit words, so the reader extracts
+// up to 57 bits with one unaligned load and a shift.
+class BitWriter {
+public:
+    void write(std::uint64_t value, unsigned bits) {
+        if (bits < 64) value &= (std::uint64_t{1} << bits) - 1;
+        acc_ |= value << filled_;
+        if (filled_ + bits < 64) { filled_ += bits; return; }
+        const auto size = bytes_.size();
+        bytes_.resize(size + 8);
+        std::memcpy(bytes_.data() + size, &acc_, 8);
+        const unsigned used = 64 - filled_;
+        acc_ = used < 64 ? value >> used : 0;
+        filled_ = filled_ + bits - 64;
+    }
+    void write_bit(bool bit) { write(bit ? 1 : 0, 1); }
+
+    // Bytes written so far, including the partial last word.
+    std::size_t size() const noexcept { return bytes_.size() + (filled_ + 7) / 8; }
+    // Appends the stream to `out` and resets the writer.
+    void finish(std::vector<char>& out) {
+        const auto tail = (filled_ + 7) / 8;
+        out.insert(out.end(), bytes_.begin(), bytes_.end());
+        const auto size = out.size();
+        out.resize(size + tail);
+        std::memcpy(out.data() + size, &acc_, tail);
+        bytes_.clear();
+        acc_ = 0;
+        filled_ = 0;
+    }
+
+private:
+    std::vector<char> bytes_;
+    std::uint64_t acc_ = 0;
+    unsigned filled_ = 0;
+};
+
+class BitReader {
+public:
+    BitReader(const char* data, std::size_t size) noexcept : data_(data), size_(size) {}
+
+    std::uint64_t read(unsigned bits) noexcept {
+        if (bits > 57) {
+            const auto low = read(32);
+            return low | (read(bits - 32) << 32);
+        }
+        const auto byte = position_ >> 3;
+        const auto shift = static_cast<unsigned>(position_ & 7);
+        std::uint64_t word = 0;
+        if (byte + 8 <= size_) std::memcpy(&word, data_ + byte, 8);
+        else if (byte < size_) std::memcpy(&word, data_ + byte, size_ - byte);
+        position_ += bits;
+        return (word >> shift) & ((std::uint64_t{1} << bits) - 1);
+    }
+    bool read_bit() noexcept { return read(1) != 0; }
+    // True once a read went past the end: the column is truncated or corrupt.
+    bool overrun() const noexcept { return position_ > size_ * 8; }
+
+private:
+    const char* data_;
+    std::size_t size_;
+    std::size_t position_ = 0;
+};
+
+// Delta-of-delta: '0' for a repeated interval, then 7, 9 and 12-bit buckets behind
+// '10', '110' and '1110', and the raw 64 bits behind '1111'. The first timestamp is
+// stored raw and the first delta is coded against zero.
+class TimestampEncoder {
+public:
+    void append(BitWriter& out, std::int64_t timestamp) {
+        if (count_++ == 0) {
+            out.write(static_cast<std::uint64_t>(timestamp), 64);
+        } else {
+            const auto delta = static_cast<std::uint64_t>(timestamp) - static_cast<std::uint64_t>(previous_);
+            const auto dod = static_cast<std::int64_t>(delta - static_cast<std::uint64_t>(previous_delta_));
+            previous_delta_ = static_cast<std::int64_t>(delta);
+            if (dod == 0) {
+                out.write_bit(false);
+            } else if (dod >= -63 && dod <= 64) {
+                out.write(0b01, 2);
+                out.write(static_cast<std::uint64_t>(dod + 63), 7);
+            } else if (dod >= -255 && dod <= 256) {
+                out.write(0b011, 3);
+                out.write(static_cast<std::uint64_t>(dod + 255), 9);
+            } else if (dod >= -2047 && dod <= 2048) {
+                out.write(0b0111, 4);
+                out.write(static_cast<std::uint64_t>(dod + 2047), 12);
+            } else {
+                out.write(0b1111, 4);
+                out.write(static_cast<std::uint64_t>(dod), 64);
+            }
+        }
+        previous_ = timestamp;
+    }
+
+private:
+    std::uint64_t count_ = 0;
+    std::int64_t previous_ = 0;
+    std::int64_t previous_delta_ = 0;
+};
+
+class TimestampDecoder {
+public:
+    std::int64_t next(BitReader& in) noexcept {
+        if (count_++ == 0) {
+            previous_ = static_cast<std::int64_t>(in.read(64));
+            return previous_;
+        }
+        unsigned ones = 0;
+        while (ones < 4 && in.read_bit()) ++ones;
+        std::int64_t dod = 0;
+        switch (ones) {
+        case 0: break;
+        case 1: dod = static_cast<std::int64_t>(in.read(7)) - 63; break;
+        case 2: dod = static_cast<std::int64_t>(in.read(9)) - 255; break;
+        case 3: dod = static_cast<std::int64_t>(in.read(12)) - 2047; break;
+        default: dod = static_cast<std::int64_t>(in.read(64)); break;
+        }
+        previous_delta_ = static_cast<std::int64_t>(static_cast<std::uint64_t>(previous_delta_) + static_cast<std::uint64_t>(dod));
+        previous_ = static_cast<std::int64_t>(static_cast<std::uint64_t>(previous_) + static_cast<std::uint64_t>(previous_delta_));
+        return previous_;
+    }
+
+private:
+    std::uint64_t count_ = 0;
+    std::int64_t previous_ = 0;
+    std::int64_t previous_delta_ = 0;
+};
+
+// XOR against a prediction, by default the column's previous value: '0' when it is
+// exact; '10' and the meaningful bits when they fit the previous leading/trailing-zero
+// window; otherwise '11', 5 bits of leading zeros, 6 bits of length - 1 and the
+// meaningful bits. The first value is stored raw.
+class XorEncoder {
+public:
+    void append(BitWriter& out, double value) { append(out, value, previous_); }
+    // `predicted` must be computable by the decoder from values it has already decoded.
+    void append(BitWriter& out, double value, double predicted) {
+        std::uint64_t bits, reference;
+        std::memcpy(&bits, &value, sizeof(bits));
+        std::memcpy(&reference, &predicted, sizeof(reference));
+        previous_ = value;
+        if (first_) {
+            out.write(bits, 64);
+            first_ = false;
+            return;
+        }
+        const auto x = bits ^ reference;
+        if (x == 0) { out.write_bit(false); return; }
+        const auto leading = std::min(static_cast<unsigned>(__builtin_clzll(x)), 31u);
+        const auto trailing = static_cast<unsigned>(__builtin_ctzll(x));
+        if (window_ && leading >= leading_ && trailing >= trailing_) {
+            out.write(0b01, 2);
+            out.write(x >> trailing_, 64 - leading_ - trailing_);
+            return;
+        }
+        const unsigned meaningful = 64 - leading - trailing;
+        out.write(0b11, 2);
+        out.write(leading, 5);
+        out.write(meaningful - 1, 6);
+        out.write(x >> trailing, meaningful);
+        leading_ = leading;
+        trailing_ = trailing;
+        window_ = true;
+    }
+
+private:
+    double previous_ = 0.0;
+    unsigned leading_ = 0;
+    unsigned trailing_ = 0;
+    bool first_ = true;
+    bool window_ = false;
+};
+
+class XorDecoder {
+public:
+    double next(BitReader& in) noexcept { return next(in, previous_); }
+    double next(BitReader& in, double predicted) noexcept {
+        std::uint64_t bits;
+        std::memcpy(&bits, &predicted, sizeof(bits));
+        if (first_) {
+            bits = in.read(64);
+            first_ = false;
+        } else if (in.read_bit()) {
+            if (in.read_bit()) {
+                leading_ = static_cast<unsigned>(in.read(5));
+                const auto meaningful = static_cast<unsigned>(in.read(6)) + 1;
+                // 5 bits of leading zeros cap it at 31, so the window always fits.
+                trailing_ = leading_ + meaningful > 64 ? 0 : 64 - leading_ - meaningful;
+            }
+            bits ^= in.read(64 - leading_ - trailing_) << trailing_;
+        }
+        std::memcpy(&previous_, &bits, sizeof(previous_));
+        return previous_;
+    }
+
+private:
+    double previous_ = 0.0;
+    unsigned leading_ = 0;
+    unsigned trailing_ = 0;
+    bool first_ = true;
+};
+
+} // namespace gorilla
+
+struct KlineArchivePartitionScan {
+    bool valid = false;          // the file header is intact
+    std::int64_t day = 0;
+    std::uint64_t valid_end = 0; // end of the last complete block
+    std::vector<KlineArchiveIndexEntry> blocks;
+};
+
+// Reads the `.idx` entries of a partition; an absent or foreign index reads as empty.
+inline std::vector<KlineArchiveIndexEntry> read_kline_archive_index(const std::string& path) {
+    std::vector<KlineArchiveIndexEntry> entries;
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(KlineArchiveFormat::index_magic)] = {};
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, KlineArchiveFormat::index_magic, sizeof(magic)) != 0) return entries;
+    KlineArchiveIndexEntry entry{};
+    while (in.read(reinterpret_cast<char*>(&entry), sizeof(entry))) entries.push_back(entry);
+    return entries;
+}
+
+// Validates a mapped partition against its index. Index entries are trusted while they
+// tile the file with matching block headers; past the last one, blocks are accepted
+// only with an intact checksum. Anything after `valid_end` is a torn write.
+inline KlineArchivePartitionScan scan_kline_archive_partition(const std::byte* data, std::size_t size,
+                                                              const std::vector<KlineArchiveIndexEntry>& index) {
+    KlineArchivePartitionScan scan;
+    KlineArchiveFileHeader file{};
+    if (size < sizeof(file)) return scan;
+    std::memcpy(&file, data, sizeof(file));
+    if (std::memcmp(file.magic, KlineArchiveFormat::data_magic, sizeof(file.magic)) != 0 || file.version != KlineArchiveFormat::version) return scan;
+    scan.valid = true;
+    scan.day = file.day;
+    std::uint64_t position = sizeof(file);
+    KlineArchiveBlockHeader header{};
+    for (const auto& entry : index) {
+        if (entry.offset != position || entry.bytes < sizeof(header) || entry.bytes > size - position) break;
+        std::memcpy(&header, data + position, sizeof(header));
+        if (header.magic != KlineArchiveBlockHeader::expected_magic || header.rows != entry.rows || header.bytes() != entry.bytes ||
+            header.first_timestamp != entry.first_timestamp || std::memcmp(header.symbol, entry.symbol, sizeof(header.symbol)) != 0) break;
+        scan.blocks.push_back(entry);
+        position += entry.bytes;
+    }
+    while (size - position >= sizeof(header)) {
+        std::memcpy(&header, data + position, sizeof(header));
+        if (header.magic != KlineArchiveBlockHeader::expected_magic || header.rows == 0 || header.bytes() > size - position) break;
+        StoreSnapshotChecksum checksum;
+        checksum.update(data + position + sizeof(header), header.bytes() - sizeof(header));
+        if (checksum.value() != header.checksum) break;
+        KlineArchiveIndexEntry entry{};
+        std::memcpy(entry.symbol, header.symbol, sizeof(entry.symbol));
+        entry.first_timestamp = header.first_timestamp;
+        entry.last_timestamp = header.last_timestamp;
+        entry.offset = position;
+        entry.rows = header.rows;
+        entry.bytes = static_cast<std::uint32_t>(header.bytes());
+        scan.blocks.push_back(entry);
+        position += entry.bytes;
+    }
+    scan.valid_end = position;
+    return scan;
+}
+
+// Single-threaded writer, owned by the collector's writer thread. Each symbol has one
+// open block that is compressed as rows arrive; it is written out when it holds
+// `block_rows` rows, when a row of the next UTC day arrives, and on seal(). Rows of open
+// blocks are lost if the process dies without seal().
+class KlineArchiveWriter {
+public:
+    static constexpr std::size_t default_block_rows = 1024;
+
+    explicit KlineArchiveWriter(std::string directory, std::size_t block_rows = default_block_rows)
+        : directory_(std::move(directory)), block_rows_(std::max<std::size_t>(2, block_rows)) {
+        std::filesystem::create_directories(directory_);
+        // Resume the newest partition: trim a torn tail and learn where each symbol ended,
+        // so rows already archived are not appended again.
+        std::string newest;
+        for (const auto& entry : std::filesystem::directory_iterator(directory_)) {
+            const auto name = entry.path().filename().string();
+            if (is_partition_name(name) && name > newest) newest = name;
+        }
+        if (newest.empty()) return;
+        KlineArchiveFileHeader file{};
+        std::ifstream in((std::filesystem::path(directory_) / newest).string(), std::ios::binary);
+        if (!in.read(reinterpret_cast<char*>(&file), sizeof(file))) return;
+        in.close();
+        if (auto* part = partition(file.day)) {
+            for (const auto& [symbol, last] : part->last_timestamps) blocks_[symbol].last_sealed = last;
+            part->last_timestamps.clear();
+        }
+    }
+
+    ~KlineArchiveWriter() {
+        try { seal(); } catch (...) {}
+    }
+
+    KlineArchiveWriter(const KlineArchiveWriter&) = delete;
+    KlineArchiveWriter& operator=(const KlineArchiveWriter&) = delete;
+
+    // Rows must arrive in timestamp order per symbol. A row with the timestamp of the
+    // symbol's newest row replaces it while that row is still unwritten; older rows are
+    // dropped. Returns false for dropped rows and failed block writes.
+    bool append(const std::string& symbol, const Kline& kline) {
+        auto it = blocks_.find(symbol);
+        if (it == blocks_.end()) {
+            if (symbol.empty() || symbol.size() >= sizeof(KlineArchiveBlockHeader::symbol)) return drop();
+            it = blocks_.emplace(symbol, OpenBlock{}).first;
+        }
+        auto& block = it->second;
+        if (block.pending_valid && kline.timestamp == block.pending.timestamp) { block.pending = kline; return true; }
+        if (kline.timestamp <= (block.pending_valid ? block.pending.timestamp : block.last_sealed)) return drop();
+        bool ok = true;
+        if (block.pending_valid) {
+            block.encode(block.pending);
+            if (block.rows >= block_rows_ || kline_archive_day(kline.timestamp) != block.day) ok = write_block(it->first, block);
+        }
+        if (block.rows == 0) block.day = kline_archive_day(kline.timestamp);
+        block.pending = kline;
+        block.pending_valid = true;
+        return ok;
+    }
+
+    // Writes every open block.
+    bool seal() {
+        bool ok = true;
+        for (auto& [symbol, block] : blocks_) {
+            if (!block.pending_valid) continue;
+            block.encode(block.pending);
+            block.pending_valid = false;
+            ok = write_block(symbol, block) && ok;
+        }
+        for (auto& [day, part] : partitions_) {
+            part->data.flush();
+            part->index.flush();
+        }
+        return ok;
+    }
+
+    const std::string& directory() const noexcept { return directory_; }
+    std::size_t block_rows() const noexcept { return block_rows_; }
+
+    static bool is_partition_name(const std::string& name) {
+        return name.size() == 19 && name.compare(0, 7, "klines-") == 0 && name.compare(15, 4, ".ska") == 0;
+    }
+
+private:
+    struct OpenBlock {
+        gorilla::BitWriter columns[KlineArchiveFormat::columns];
+        gorilla::TimestampEncoder timestamps;
+        gorilla::XorEncoder values[KlineArchiveFormat::columns - 1];
+        std::uint32_t rows = 0;
+        std::int64_t day = 0;
+        std::int64_t first_timestamp = 0;
+        std::int64_t last_timestamp = 0;
+        std::int64_t last_sealed = std::numeric_limits<std::int64_t>::min();
+        double previous_close = 0.0;
+        Kline pending{};
+        bool pending_valid = false;
+
+        void encode(const Kline& kline) {
+            if (rows++ == 0) first_timestamp = kline.timestamp;
+            last_timestamp = kline.timestamp;
+            timestamps.append(columns[0], kline.timestamp);
+            values[0].append(columns[1], kline.open, previous_close);
+            values[1].append(columns[2], kline.high, std::max(kline.open, kline.close));
+            values[2].append(columns[3], kline.low, std::min(kline.open, kline.close));
+            values[3].append(columns[4], kline.close);
+            values[4].append(columns[5], kline.volume);
+            previous_close = kline.close;
+        }
+    };
+
+    struct Partition {
+        std::ofstream data;
+        std::ofstream index;
+        std::uint64_t size = 0;
+        std::map<std::string, std::int64_t> last_timestamps; // only filled when resuming
+    };
+
+    static constexpr std::size_t max_open_partitions = 2;
+
+    bool drop() {
+        RuntimePerformanceMetrics::global().kline_archive.dropped_rows.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    Partition* partition(std::int64_t day) {
+        if (auto it = partitions_.find(day); it != partitions_.end()) return it->second.get();
+        const auto path = (std::filesystem::path(directory_) / kline_archive_partition_name(day)).string();
+        const auto index_path = path + ".idx";
+        auto part = std::make_unique<Partition>();
+        std::error_code ec;
+        if (std::filesystem::exists(path, ec)) {
+            StoreSnapshotFile mapped;
+            KlineArchivePartitionScan scan;
+            const auto index = read_kline_archive_index(index_path);
+            if (mapped.open(path)) scan = scan_kline_archive_partition(mapped.data(), mapped.size(), index);
+            const auto file_size = mapped.size();
+            mapped.close();
+            if (!scan.valid || scan.day != day) return nullptr; // not ours; leave it alone
+            if (scan.valid_end != file_size) std::filesystem::resize_file(path, scan.valid_end, ec);
+            if (ec) return nullptr;
+            if (index.size() != scan.blocks.size()) {
+                std::ofstream rewrite(index_path, std::ios::binary | std::ios::trunc);
+                rewrite.write(KlineArchiveFormat::index_magic, sizeof(KlineArchiveFormat::index_magic));
+                rewrite.write(reinterpret_cast<const char*>(scan.blocks.data()), static_cast<std::streamsize>(scan.blocks.size() * sizeof(KlineArchiveIndexEntry)));
+                if (!rewrite) return nullptr;
+            }
+            for (const auto& block : scan.blocks) {
+                auto& last = part->last_timestamps[std::string(block.symbol, strnlen(block.symbol, sizeof(block.symbol)))];
+                last = std::max(last, block.last_timestamp);
+            }
+            part->size = scan.valid_end;
+            part->data.open(path, std::ios::binary | std::ios::app);
+            part->index.open(index_path, std::ios::binary | std::ios::app);
+        } else {
+            part->data.open(path, std::ios::binary | std::ios::trunc);
+            part->index.open(index_path, std::ios::binary | std::ios::trunc);
+            KlineArchiveFileHeader file{};
+            std::memcpy(file.magic, KlineArchiveFormat::data_magic, sizeof(file.magic));
+            file.version = KlineArchiveFormat::version;
+            file.day = day;
+            part->data.write(reinterpret_cast<const char*>(&file), sizeof(file));
+            part->index.write(KlineArchiveFormat::index_magic, sizeof(KlineArchiveFormat::index_magic));
+            part->size = sizeof(file);
+        }
+        if (!part->data || !part->index) return nullptr;
+        auto* raw = part.get();
+        partitions_.emplace(day, std::move(part));
+        // Late rows for a closed day reopen its partition.
+        while (partitions_.size() > max_open_partitions) partitions_.erase(partitions_.begin()->first == day ? std::next(partitions_.begin()) : partitions_.begin());
+        return raw;
+    }
+
+    bool write_block(const std::string& symbol, OpenBlock& block) {
+        const auto rows = block.rows;
+        staging_.clear();
+        KlineArchiveBlockHeader header{};
+        header.magic = KlineArchiveBlockHeader::expected_magic;
+        header.rows = rows;
+        symbol.copy(header.symbol, sizeof(header.symbol) - 1);
+        header.first_timestamp = block.first_timestamp;
+        header.last_timestamp = block.last_timestamp;
+        for (std::size_t column = 0; column < KlineArchiveFormat::columns; ++column) {
+            const auto before = staging_.size();
+            block.columns[column].finish(staging_);
+            header.column_bytes[column] = static_cast<std::uint32_t>(staging_.size() - before);
+        }
+        StoreSnapshotChecksum checksum;
+        checksum.update(staging_.data(), staging_.size());
+        header.checksum = checksum.value();
+        block.last_sealed = block.last_timestamp;
+        block.timestamps = {};
+        for (auto& encoder : block.values) encoder = {};
+        block.rows = 0;
+
+        auto* part = partition(block.day);
+        if (!part) return false;
+        KlineArchiveIndexEntry entry{};
+        std::memcpy(entry.symbol, header.symbol, sizeof(entry.symbol));
+        entry.first_timestamp = header.first_timestamp;
+        entry.last_timestamp = header.last_timestamp;
+        entry.offset = part->size;
+        entry.rows = rows;
+        entry.bytes = static_cast<std::uint32_t>(header.bytes());
+        part->data.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        part->data.write(staging_.data(), static_cast<std::streamsize>(staging_.size()));
+        // The block reaches the file before the index entry that points at it.
+        part->data.flush();
+        if (!part->data) return false;
+        part->index.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+        part->size += entry.bytes;
+        auto& metrics = RuntimePerformanceMetrics::global().kline_archive;
+        metrics.blocks.fetch_add(1, std::memory_order_relaxed);
+        metrics.rows.fetch_add(rows, std::memory_order_relaxed);
+        metrics.stored_bytes.fetch_add(entry.bytes, std::memory_order_relaxed);
+        return static_cast<bool>(part->index);
+    }
+
+    std::string directory_;
+    std::size_t block_rows_;
+    std::unordered_map<std::string, OpenBlock> blocks_;
+    std::map<std::int64_t, std::unique_ptr<Partition>> partitions_;
+    std::vector<char> staging_;
+};
+
+// Read-only view of an archive directory as of construction. Every partition is mapped
+// read-only; the block index is held in memory per symbol, so a range scan touches only
+// the blocks it decodes. Const member functions may be called from several threads.
+class KlineArchiveReader {
+public:
+    explicit KlineArchiveReader(const std::string& directory) {
+        std::error_code ec;
+        std::vector<std::string> names;
+        for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+            const auto name = entry.path().filename().string();
+            if (KlineArchiveWriter::is_partition_name(name)) names.push_back(entry.path().string());
+        }
+        std::sort(names.begin(), names.end());
+        for (const auto& path : names) {
+            auto file = std::make_unique<StoreSnapshotFile>();
+            if (!file->open(path)) continue;
+            const auto scan = scan_kline_archive_partition(file->data(), file->size(), read_kline_archive_index(path + ".idx"));
+            if (!scan.valid || scan.blocks.empty()) continue;
+            const auto partition = static_cast<std::uint32_t>(files_.size());
+            for (const auto& entry : scan.blocks) {
+                auto& blocks = blocks_[std::string(entry.symbol, strnlen(entry.symbol, sizeof(entry.symbol)))];
+                blocks.push_back({partition, entry.rows, entry.offset, entry.first_timestamp, entry.last_timestamp});
+                rows_ += entry.rows;
+                bytes_ += entry.bytes;
+            }
+            files_.push_back(std::move(file));
+        }
+        for (auto& [symbol, blocks] : blocks_)
+            std::stable_sort(blocks.begin(), blocks.end(), [](const BlockRef& a, const BlockRef& b) { return a.first < b.first; });
+    }
+
+    bool empty() const noexcept { return blocks_.empty(); }
+    std::size_t partition_count() const noexcept { return files_.size(); }
+    std::uint64_t row_count() const noexcept { return rows_; }
+    std::uint64_t stored_bytes() const noexcept { return bytes_; }
+    std::size_t block_count() const noexcept {
+        std::size_t count = 0;
+        for (const auto& [symbol, blocks] : blocks_) count += blocks.size();
+        return count;
+    }
+    std::vector<std::string> symbols() const {
+        std::vector<std::string> out;
+        out.reserve(blocks_.size());
+        for (const auto& [symbol, blocks] : blocks_) out.push_back(symbol);
+        std::sort(out.begin(), out.end());
+        return out;
+    }
+
+    // Calls visit(const Kline* rows, std::size_t count) for each run of `symbol`'s klines
+    // opened in [from_ms, to_ms], oldest first, one call per decoded block. Rows already
+    // visited (overlapping blocks after a restart) are skipped. Returns false if a block
+    // failed its checksum; the other blocks are still visited.
+    template <typename Visit>
+    bool scan(const std::string& symbol, std::int64_t from_ms, std::int64_t to_ms, Visit&& visit) const {
+        const auto it = blocks_.find(symbol);
+        if (it == blocks_.end()) return true;
+        bool ok = true;
+        std::vector<Kline> rows;
+        auto last = std::numeric_limits<std::int64_t>::min();
+        for (const auto& block : it->second) {
+            if (block.last < from_ms || block.first > to_ms) continue;
+            rows.clear();
+            if (!decode(block, rows)) { ok = false; continue; }
+            const auto lower = std::max(from_ms, last == std::numeric_limits<std::int64_t>::min() ? last : last + 1);
+            const auto begin = std::lower_bound(rows.begin(), rows.end(), lower, [](const Kline& k, std::int64_t t) { return k.timestamp < t; });
+            const auto end = std::upper_bound(begin, rows.end(), to_ms, [](std::int64_t t, const Kline& k) { return t < k.timestamp; });
+            if (begin == end) continue;
+            last = std::prev(end)->timestamp;
+            visit(&*begin, static_cast<std::size_t>(end - begin));
+        }
+        return ok;
+    }
+
+    bool load_range(const std::string& symbol, std::int64_t from_ms, std::int64_t to_ms, std::vector<Kline>& out) const {
+        out.clear();
+        return scan(symbol, from_ms, to_ms, [&out](const Kline* rows, std::size_t count) { out.insert(out.end(), rows, rows + count); });
+    }
+
+    // Replaces `out` with the newest `limit` klines of `symbol` opened at or after
+    // `since_ms`, oldest first, decoding blocks from the newest backwards.
+    bool load_latest(const std::string& symbol, std::int64_t since_ms, std::size_t limit, std::vector<Kline>& out) const {
+        out.clear();
+        const auto it = blocks_.find(symbol);
+        if (it == blocks_.end() || limit == 0) return true;
+        bool ok = true;
+        std::vector<Kline> rows;
+        auto next = std::numeric_limits<std::int64_t>::max();
+        for (auto block = it->second.rbegin(); block != it->second.rend() && out.size() < limit; ++block) {
+            if (block->last < since_ms) continue;
+            rows.clear();
+            if (!decode(*block, rows)) { ok = false; continue; }
+            for (auto row = rows.rbegin(); row != rows.rend() && out.size() < limit; ++row) {
+                if (row->timestamp < since_ms) break;
+                if (row->timestamp >= next) continue;
+                out.push_back(*row);
+                next = row->timestamp;
+            }
+        }
+        std::reverse(out.begin(), out.end());
+        return ok;
+    }
+
+private:
+    struct BlockRef {
+        std::uint32_t partition;
+        std::uint32_t rows;
+        std::uint64_t offset;
+        std::int64_t first;
+        std::int64_t last;
+    };
+
+    bool decode(const BlockRef& block, std::vector<Kline>& out) const {
+        const auto& file = *files_[block.partition];
+        KlineArchiveBlockHeader header{};
+        std::memcpy(&header, file.data() + block.offset, sizeof(header));
+        const auto* columns = reinterpret_cast<const char*>(file.data() + block.offset + sizeof(header));
+        const auto payload = header.bytes() - sizeof(header);
+        StoreSnapshotChecksum checksum;
+        checksum.update(columns, payload);
+        if (checksum.value() != header.checksum) return false;
+        const auto base = out.size();
+        out.resize(base + header.rows);
+        Kline* rows = out.data() + base;
+        const char* column[KlineArchiveFormat::columns];
+        column[0] = columns;
+        for (std::size_t i = 1; i < KlineArchiveFormat::columns; ++i) column[i] = column[i - 1] + header.column_bytes[i - 1];
+        // Close first: open is predicted by the previous close, high and low by the
+        // row's open and close.
+        gorilla::BitReader timestamp_in(column[0], header.column_bytes[0]), open_in(column[1], header.column_bytes[1]),
+            high_in(column[2], header.column_bytes[2]), low_in(column[3], header.column_bytes[3]),
+            close_in(column[4], header.column_bytes[4]), volume_in(column[5], header.column_bytes[5]);
+        gorilla::TimestampDecoder timestamps;
+        gorilla::XorDecoder open, high, low, close, volume;
+        double previous_close = 0.0;
+        for (std::uint32_t i = 0; i < header.rows; ++i) {
+            auto& row = rows[i];
+            row.timestamp = timestamps.next(timestamp_in);
+            row.close = close.next(close_in);
+            row.open = open.next(open_in, previous_close);
+            row.high = high.next(high_in, std::max(row.open, row.close));
+            row.low = low.next(low_in, std::min(row.open, row.close));
+            row.volume = volume.next(volume_in);
+            previous_close = row.close;
+        }
+        const bool ok = !timestamp_in.overrun() && !open_in.overrun() && !high_in.overrun() && !low_in.overrun() &&
+                        !close_in.overrun() && !volume_in.overrun();
+        if (!ok) out.resize(base);
+        return ok;
+    }
+
+    std::vector<std::unique_ptr<StoreSnapshotFile>> files_;
+    std::unordered_map<std::string, std::vector<BlockRef>> blocks_;
+    std::uint64_t rows_ = 0;
+    std::uint64_t bytes_ = 0;
+};
+
+} // namespace sentum::market
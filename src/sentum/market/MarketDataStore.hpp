@@ -1,135 +1,1034 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <shared_mutex>
 #include <string>
+#include <thread>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <sentum/api/model/Kline.hpp>
+#include <sentum/market/FixedPoint.hpp>
+#include <sentum/market/SlabArena.hpp>
+#include <sentum/market/StoreSnapshot.hpp>
 #include <sentum/market/SymbolId.hpp>
+#include <sentum/market/SymbolInterner.hpp>
 
+// Column-oriented candle store. One slab arena holds a separate array per field
+// (timestamp, open, high, low, close, volume); symbol `id` owns the slots
+// [id * capacity, (id + 1) * capacity) of every column, so a series is found by
+// arithmetic on its SymbolId with no map or shared_ptr on the way. Fixed-point symbols
+// use parallel 32-bit offset columns. Cross-sectional reads such as cumulative_returns
+// walk the close column for every symbol in one loop.
+//
+// Each series has one writer at a time (its collector shard) and any number of readers.
+// Writers serialize on the series mutex and bump a sequence counter around every change;
+// readers never take the mutex. They copy what they need, re-check the sequence and
+// retry if a write overlapped, falling back to the mutex only after repeated collisions.
+// with_window() hands a callback two contiguous spans per column without copying.
+//
+// Every upsert also folds the candle into 1m, 5m, 15m and 1h rollups, so coarser bars are
+// read in place instead of being re-aggregated by each consumer. The bar still forming
+// lives next to the series cursor, where updating it touches no extra cache lines; when
+// its bucket ends it is appended to a ring of closed bars kept in the same arena.
+//
+// With the collector's book ticker and aggTrade streams enabled, each series also keeps
+// its best bid/ask and a ring of recent trades (the tape). Those are versioned by a
+// second sequence counter, so a stream of quotes does not make candle readers retry.
+//
+// save_snapshot() writes the arena to a file in its in-memory layout, with the series
+// cursors alongside; load_snapshot() validates such a file and adopts it on restart.
 class MarketDataStore {
+    // Base pointers of one set of columns. Rollup columns have no packed_* arrays.
+    struct Columns {
+        std::int64_t* timestamp = nullptr;
+        double* open = nullptr;
+        double* high = nullptr;
+        double* low = nullptr;
+        double* close = nullptr;
+        double* volume = nullptr;
+        std::int32_t* packed_open = nullptr;
+        std::int32_t* packed_high = nullptr;
+        std::int32_t* packed_low = nullptr;
+        std::int32_t* packed_close = nullptr;
+        std::int64_t* packed_volume = nullptr;
+        std::size_t capacity = 0;
+    };
+
+    struct TapeColumns {
+        std::int64_t* timestamp = nullptr;
+        double* price = nullptr;
+        double* quantity = nullptr;
+        std::uint8_t* buyer_maker = nullptr;
+    };
+
 public:
-    explicit MarketDataStore(std::size_t capacity_per_symbol = 600)
-        : capacity_per_symbol_(capacity_per_symbol) {}
+    static constexpr std::size_t default_max_symbols = 16384;
+    static constexpr std::size_t default_rollup_capacity = 240;
+    static constexpr std::size_t default_tape_capacity = 256;
+
+    // Best bid/ask. `timestamp` is when the quote was received, in epoch milliseconds.
+    struct TopOfBook {
+        std::int64_t update_id = 0;
+        std::int64_t timestamp = 0;
+        double bid_price = 0.0;
+        double bid_quantity = 0.0;
+        double ask_price = 0.0;
+        double ask_quantity = 0.0;
+    };
+
+    struct TradeTick {
+        std::int64_t timestamp = 0;
+        double price = 0.0;
+        double quantity = 0.0;
+        // The aggressor sold.
+        bool buyer_maker = false;
+    };
+
+    enum class RollupInterval : std::uint8_t { OneMinute, FiveMinutes, FifteenMinutes, OneHour };
+    static constexpr std::size_t rollup_intervals = 4;
+
+    static constexpr std::int64_t rollup_seconds(RollupInterval interval) noexcept {
+        constexpr std::int64_t seconds[rollup_intervals] = {60, 300, 900, 3600};
+        return seconds[static_cast<std::size_t>(interval)];
+    }
+    // Maps a bar length to the rollup that maintains it, if any.
+    static bool rollup_for_seconds(std::int64_t seconds, RollupInterval& interval) noexcept {
+        for (std::size_t i = 0; i < rollup_intervals; ++i) {
+            if (rollup_seconds(static_cast<RollupInterval>(i)) == seconds) { interval = static_cast<RollupInterval>(i); return true; }
+        }
+        return false;
+    }
+
+    // One column of a window: the older part of the ring, then the newer part.
+    template <typename T>
+    struct ColumnSpan {
+        const T* first = nullptr;
+        std::size_t first_size = 0;
+        const T* second = nullptr;
+        std::size_t second_size = 0;
+
+        std::size_t size() const noexcept { return first_size + second_size; }
+        bool empty() const noexcept { return size() == 0; }
+        const T& operator[](std::size_t index) const noexcept { return index < first_size ? first[index] : second[index - first_size]; }
+        const T& front() const noexcept { return (*this)[0]; }
+        const T& back() const noexcept { return second_size ? second[second_size - 1] : first[first_size - 1]; }
+    };
+
+    // Read-only view of the newest `size()` candles of one series, oldest first. Double
+    // series expose open..volume; fixed-point series expose the packed_* offset columns,
+    // which add anchor() to give grid units of scales().price.
+    class Window {
+    public:
+        std::size_t size() const noexcept { return count_; }
+        bool packed() const noexcept { return packed_; }
+        std::int64_t anchor() const noexcept { return anchor_; }
+        const sentum::market::SymbolScales& scales() const noexcept { return scales_; }
+        ColumnSpan<std::int64_t> timestamp() const noexcept { return column(columns_->timestamp); }
+        ColumnSpan<double> open() const noexcept { return column(columns_->open); }
+        ColumnSpan<double> high() const noexcept { return column(columns_->high); }
+        ColumnSpan<double> low() const noexcept { return column(columns_->low); }
+        ColumnSpan<double> close() const noexcept { return column(columns_->close); }
+        ColumnSpan<double> volume() const noexcept { return column(columns_->volume); }
+        ColumnSpan<std::int32_t> packed_open() const noexcept { return column(columns_->packed_open); }
+        ColumnSpan<std::int32_t> packed_high() const noexcept { return column(columns_->packed_high); }
+        ColumnSpan<std::int32_t> packed_low() const noexcept { return column(columns_->packed_low); }
+        ColumnSpan<std::int32_t> packed_close() const noexcept { return column(columns_->packed_close); }
+        ColumnSpan<std::int64_t> packed_volume() const noexcept { return column(columns_->packed_volume); }
+
+    private:
+        friend class MarketDataStore;
+        template <typename T>
+        ColumnSpan<T> column(const T* data) const noexcept {
+            if (!data) return {};
+            const auto first_size = std::min(count_, columns_->capacity - start_);
+            return {data + base_ + start_, first_size, data + base_, count_ - first_size};
+        }
+        const Columns* columns_ = nullptr;
+        std::size_t base_ = 0, start_ = 0, count_ = 0;
+        std::int64_t anchor_ = 0;
+        sentum::market::SymbolScales scales_;
+        bool packed_ = false;
+    };
+
+    // `rollup_capacity` bars are kept per interval and `tape_capacity` trades per symbol;
+    // zero disables either.
+    explicit MarketDataStore(std::size_t capacity_per_symbol = 600, std::size_t max_symbols = default_max_symbols,
+                             bool huge_pages = false, std::size_t rollup_capacity = default_rollup_capacity,
+                             std::size_t tape_capacity = default_tape_capacity)
+        : capacity_per_symbol_(std::max<std::size_t>(1, capacity_per_symbol)), max_symbols_(max_symbols),
+          rollup_capacity_(rollup_capacity), tape_capacity_(tape_capacity), arena_(carve(nullptr), huge_pages),
+          series_(std::make_unique<Series[]>(max_symbols_ + 1)) {
+        carve(arena_.data());
+    }
+
+    MarketDataStore(const MarketDataStore&) = delete;
+    MarketDataStore& operator=(const MarketDataStore&) = delete;
 
     static MarketDataStore& global() {
         static MarketDataStore instance;
         return instance;
     }
 
-    void register_symbol(sentum::market::SymbolId id, const std::string& symbol) {
-        if (id == sentum::market::kInvalidSymbolId) return;
-        auto buffer = get_or_create(symbol);
-        std::unique_lock<std::shared_mutex> lock(map_mutex_);
-        if (id_buffers_.size() <= id) id_buffers_.resize(static_cast<std::size_t>(id) + 1);
-        id_buffers_[id] = std::move(buffer);
+    void register_symbol(sentum::market::SymbolId id, const std::string& symbol) { register_series(id, symbol, nullptr); }
+
+    // Opt-in fixed-point series: candles are kept on the symbol's tick grid as packed
+    // 32-bit price offsets. The double API keeps working and converts at the boundary.
+    void register_symbol(sentum::market::SymbolId id, const std::string& symbol, const sentum::market::SymbolScales& scales) {
+        register_series(id, symbol, &scales);
     }
 
-    void upsert(const std::string& symbol, const Kline& kline) { upsert_buffer(get_or_create(symbol), kline); }
+    void upsert(const std::string& symbol, const Kline& kline) { upsert(get_or_create(symbol), kline); }
     void upsert(sentum::market::SymbolId id, const Kline& kline) {
-        auto buffer = find(id);
-        if (buffer) upsert_buffer(std::move(buffer), kline);
+        if (!registered(id)) return;
+        auto& series = series_[id];
+        if (series.packed) { upsert(id, to_fixed(kline, series.scales)); return; }
+        WriteGuard guard(series);
+        const std::size_t base = slot_base(id);
+        if (series.cursor.size > 0) {
+            const auto last = base + last_index(series.cursor, capacity_per_symbol_);
+            if (columns_.timestamp[last] == kline.timestamp) {
+                const double replaced_volume = columns_.volume[last];
+                write(columns_, last, kline);
+                roll_up(id, series, kline, replaced_volume);
+                return;
+            }
+        }
+        write(columns_, base + series.cursor.head, kline);
+        advance(series.cursor, capacity_per_symbol_);
+        roll_up(id, series, kline, 0.0);
+    }
+    void upsert(sentum::market::SymbolId id, const sentum::market::FixedKline& kline) {
+        if (!registered(id)) return;
+        auto& series = series_[id];
+        if (!series.packed) { upsert(id, to_kline(kline, {})); return; }
+        WriteGuard guard(series);
+        auto& cursor = series.cursor;
+        if (cursor.size == 0) cursor.anchor = kline.close.raw;
+        sentum::market::PackedKline packed;
+        if (!sentum::market::pack_kline(kline, cursor.anchor, packed)) {
+            rebase(id, cursor, kline.close.raw);
+            if (!sentum::market::pack_kline(kline, cursor.anchor, packed)) return;
+        }
+        const std::size_t base = slot_base(id);
+        const auto rolled = to_kline(kline, series.scales);
+        if (cursor.size > 0) {
+            const auto last = base + last_index(cursor, capacity_per_symbol_);
+            if (columns_.timestamp[last] == kline.timestamp) {
+                const double replaced_volume = series.scales.quantity.to_double(sentum::market::Qty{columns_.packed_volume[last]});
+                write_packed(last, packed);
+                roll_up(id, series, rolled, replaced_volume);
+                return;
+            }
+        }
+        write_packed(base + cursor.head, packed);
+        advance(cursor, capacity_per_symbol_);
+        roll_up(id, series, rolled, 0.0);
+    }
+
+    // Keeps the newest quote per symbol; an update id at or below the stored one is stale.
+    void update_book(sentum::market::SymbolId id, const TopOfBook& book) {
+        if (!registered(id)) return;
+        auto& series = series_[id];
+        WriteGuard guard(series, series.feed_sequence);
+        if (book.update_id != 0 && book.update_id <= series.book.update_id) return;
+        series.book = book;
+    }
+
+    bool top_of_book(sentum::market::SymbolId id, TopOfBook& result) const {
+        if (!registered(id)) return false;
+        const auto& series = series_[id];
+        return read_consistent(series, series.feed_sequence, [&] {
+            result = series.book;
+            return result.bid_price > 0.0 && result.ask_price > 0.0;
+        });
+    }
+
+    void record_trade(sentum::market::SymbolId id, const TradeTick& trade) {
+        if (!registered(id) || tape_capacity_ == 0) return;
+        auto& series = series_[id];
+        WriteGuard guard(series, series.feed_sequence);
+        const auto slot = tape_base(id) + series.tape.head;
+        tape_.timestamp[slot] = trade.timestamp;
+        tape_.price[slot] = trade.price;
+        tape_.quantity[slot] = trade.quantity;
+        tape_.buyer_maker[slot] = trade.buyer_maker ? 1 : 0;
+        advance(series.tape, tape_capacity_);
+    }
+
+    // The newest `limit` trades of the tape, oldest first.
+    std::vector<TradeTick> latest_trades(sentum::market::SymbolId id, std::size_t limit) const {
+        std::vector<TradeTick> result;
+        if (!registered(id) || tape_capacity_ == 0) return result;
+        const auto& series = series_[id];
+        read_consistent(series, series.feed_sequence, [&] {
+            const auto cursor = snapshot(series.tape, tape_capacity_);
+            const std::size_t count = std::min(limit, cursor.size);
+            const std::size_t base = tape_base(id), start = first_index(cursor, count, tape_capacity_);
+            result.clear();
+            result.reserve(count);
+            for (std::size_t i = 0; i < count; ++i) {
+                const auto slot = base + wrap(start + i, tape_capacity_);
+                result.push_back({tape_.timestamp[slot], tape_.price[slot], tape_.quantity[slot], tape_.buyer_maker[slot] != 0});
+            }
+            return true;
+        });
+        return result;
     }
 
     std::vector<std::string> symbols() const {
-        std::shared_lock<std::shared_mutex> lock(map_mutex_);
+        std::shared_lock<std::shared_mutex> lock(names_mutex_);
         std::vector<std::string> result;
-        result.reserve(buffers_.size());
-        for (const auto& entry : buffers_) result.push_back(entry.first);
+        result.reserve(ids_by_name_.size());
+        for (const auto& entry : ids_by_name_) result.push_back(entry.first);
         return result;
     }
 
-    std::vector<Kline> latest(const std::string& symbol, std::size_t limit) const { return latest_buffer(find(symbol), limit); }
-    std::vector<Kline> latest(sentum::market::SymbolId id, std::size_t limit) const { return latest_buffer(find(id), limit); }
+    std::vector<Kline> latest(const std::string& symbol, std::size_t limit) const { return latest(find(symbol), limit); }
+    std::vector<Kline> latest(sentum::market::SymbolId id, std::size_t limit) const {
+        std::vector<Kline> result;
+        with_window(id, limit, [&](const Window& window) {
+            result.clear();
+            result.reserve(window.size());
+            for (std::size_t i = 0; i < window.size(); ++i) result.push_back(kline_at(window, i));
+        });
+        return result;
+    }
 
-    bool cumulative_return(const std::string& symbol, std::size_t lookback, double& result) const { return cumulative_return_buffer(find(symbol), lookback, result); }
-    bool cumulative_return(sentum::market::SymbolId id, std::size_t lookback, double& result) const { return cumulative_return_buffer(find(id), lookback, result); }
+    // Calls `visit(const Window&)` with the newest `limit` candles of `id`, read in place.
+    // Returns false for an unknown symbol. `visit` may run more than once if the writer
+    // overlaps, so it should only read the window and write to state it resets itself.
+    template <typename Visit>
+    bool with_window(sentum::market::SymbolId id, std::size_t limit, Visit&& visit) const {
+        if (!registered(id)) return false;
+        const auto& series = series_[id];
+        read_consistent(series, [&] {
+            visit(window(columns_, slot_base(id), snapshot(series.cursor, capacity_per_symbol_), series, limit));
+            return true;
+        });
+        return true;
+    }
+
+    // Same as with_window over the closed bars of the `interval` rollup. Rollup windows
+    // are always double columns.
+    template <typename Visit>
+    bool with_rollup_window(sentum::market::SymbolId id, RollupInterval interval, std::size_t limit, Visit&& visit) const {
+        if (!registered(id) || rollup_capacity_ == 0) return false;
+        const auto& series = series_[id];
+        const auto index = static_cast<std::size_t>(interval);
+        read_consistent(series, [&] {
+            auto view = window(rollups_[index], rollup_base(id), snapshot(series.rollups[index].cursor, rollup_capacity_), series, limit);
+            view.packed_ = false;
+            visit(view);
+            return true;
+        });
+        return true;
+    }
+
+    // The `interval` bar that has not closed yet. False before the first candle.
+    bool forming_rollup(sentum::market::SymbolId id, RollupInterval interval, Kline& result) const {
+        if (!registered(id) || rollup_capacity_ == 0) return false;
+        const auto& rollup = series_[id].rollups[static_cast<std::size_t>(interval)];
+        return read_consistent(series_[id], [&] {
+            result = rollup.forming;
+            return rollup.open;
+        });
+    }
+
+    // The newest `limit` bars of the `interval` rollup, oldest first; the last one is
+    // still forming.
+    std::vector<Kline> latest_rollup(sentum::market::SymbolId id, RollupInterval interval, std::size_t limit) const {
+        std::vector<Kline> result;
+        Kline forming{};
+        if (limit == 0 || !forming_rollup(id, interval, forming)) return result;
+        with_rollup_window(id, interval, limit - 1, [&](const Window& window) {
+            result.clear();
+            result.reserve(window.size() + 1);
+            for (std::size_t i = 0; i < window.size(); ++i) result.push_back(kline_at(window, i));
+        });
+        // Re-read so a bar that closed in between is not returned twice.
+        if (!forming_rollup(id, interval, forming) || (!result.empty() && result.back().timestamp >= forming.timestamp))
+            return latest_rollup(id, interval, limit);
+        result.push_back(forming);
+        return result;
+    }
+
+    // Return over the newest `lookback` rollup bars, the forming bar included.
+    bool rollup_return(sentum::market::SymbolId id, RollupInterval interval, std::size_t lookback, double& result) const {
+        if (!registered(id) || rollup_capacity_ == 0 || lookback < 2) return false;
+        const auto& series = series_[id];
+        return read_consistent(series, [&] { return rollup_series_return(id, series, interval, lookback, result); });
+    }
+
+    // Cross-sectional rollup_return, laid out like cumulative_returns.
+    void rollup_returns(RollupInterval interval, std::size_t lookback, std::vector<double>& returns) const {
+        const std::size_t count = std::min(registered_limit_.load(std::memory_order_acquire), max_symbols_ + 1);
+        returns.assign(count, std::numeric_limits<double>::quiet_NaN());
+        if (lookback < 2 || rollup_capacity_ == 0) return;
+        for (std::size_t id = 1; id < count; ++id) {
+            const auto& series = series_[id];
+            if (!series.registered.load(std::memory_order_acquire)) continue;
+            double value;
+            if (read_consistent(series, [&] { return rollup_series_return(static_cast<sentum::market::SymbolId>(id), series, interval, lookback, value); }))
+                returns[id] = value;
+        }
+    }
+
+    bool cumulative_return(const std::string& symbol, std::size_t lookback, double& result) const { return cumulative_return(find(symbol), lookback, result); }
+    bool cumulative_return(sentum::market::SymbolId id, std::size_t lookback, double& result) const {
+        if (!registered(id) || lookback < 2) return false;
+        const auto& series = series_[id];
+        return read_consistent(series, [&] { return series_return(id, series, lookback, result); });
+    }
+
+    // Cross-sectional scan: `returns[id]` receives the `lookback`-bar return of every
+    // registered symbol, or NaN where there is not enough history. Reads two close slots
+    // per symbol; nothing is copied out of the slab and no lock is taken.
+    void cumulative_returns(std::size_t lookback, std::vector<double>& returns) const {
+        const std::size_t count = std::min(registered_limit_.load(std::memory_order_acquire), max_symbols_ + 1);
+        returns.assign(count, std::numeric_limits<double>::quiet_NaN());
+        if (lookback < 2) return;
+        for (std::size_t id = 1; id < count; ++id) {
+            const auto& series = series_[id];
+            if (!series.registered.load(std::memory_order_acquire)) continue;
+            double value;
+            if (read_consistent(series, [&] { return series_return(static_cast<sentum::market::SymbolId>(id), series, lookback, value); }))
+                returns[id] = value;
+        }
+    }
+
+    std::size_t size(const std::string& symbol) const { return size(find(symbol)); }
+    std::size_t size(sentum::market::SymbolId id) const {
+        if (!registered(id)) return 0;
+        const auto& series = series_[id];
+        return read_consistent(series, [&] { return snapshot(series.cursor, capacity_per_symbol_).size; });
+    }
+    bool fixed_point(sentum::market::SymbolId id) const { return registered(id) && series_[id].packed; }
+
+    std::size_t capacity_per_symbol() const noexcept { return capacity_per_symbol_; }
+    std::size_t max_symbols() const noexcept { return max_symbols_; }
+    std::size_t rollup_capacity() const noexcept { return rollup_capacity_; }
+    std::size_t tape_capacity() const noexcept { return tape_capacity_; }
+    bool huge_pages() const noexcept { return arena_.huge_pages(); }
+
+    struct SnapshotReport {
+        bool ok = false;
+        // The arena maps the snapshot copy-on-write instead of holding a copy of it.
+        bool mapped = false;
+        std::size_t symbols = 0; // series written or restored
+        std::size_t skipped = 0; // snapshot series with no compatible registered series
+        std::int64_t written_ms = 0;
+        std::chrono::milliseconds elapsed{0};
+        std::string error;
+    };
+
+    // Writes every registered series (candle ring, rollups, quote and tape) to `path`. The
+    // file is written as `path`.tmp and renamed over `path`, so a loader never sees a
+    // partial file and a store that mapped the previous snapshot keeps its pages. Each
+    // series is copied under its writer mutex; other series keep updating. The file is
+    // not fsynced: a file torn by a power loss fails its checksum on load.
+    SnapshotReport save_snapshot(const std::string& path) const {
+        const auto begin = std::chrono::steady_clock::now();
+        SnapshotReport report;
+        std::vector<std::pair<sentum::market::SymbolId, std::string>> names;
+        {
+            std::shared_lock<std::shared_mutex> lock(names_mutex_);
+            names.reserve(ids_by_name_.size());
+            for (const auto& entry : ids_by_name_) names.emplace_back(entry.second, entry.first);
+        }
+        std::sort(names.begin(), names.end());
+        const std::size_t limit = std::min(registered_limit_.load(std::memory_order_acquire), max_symbols_ + 1);
+        const std::size_t data_offset = sentum::market::SlabArena::round_up(
+            sizeof(sentum::market::StoreSnapshotHeader) + names.size() * sizeof(SeriesRecord), sentum::market::SlabArena::huge_page_size);
+
+        const std::string temporary = path + ".tmp";
+        sentum::market::StoreSnapshotFile file;
+        if (!file.create(temporary, data_offset + arena_.size())) return failed(report, "cannot create " + temporary);
+        std::vector<SeriesRecord> records;
+        records.reserve(names.size());
+        sentum::market::StoreSnapshotChecksum checksum;
+        bool written = true;
+        for (std::size_t i = 0; i < names.size() && written; ++i) {
+            const auto id = names[i].first;
+            const auto& name = names[i].second;
+            // A series may be registered under several spellings; keep the first.
+            if ((i > 0 && names[i - 1].first == id) || id >= limit || !registered(id) || name.size() > sentum::market::SymbolInterner::max_symbol_length) continue;
+            const auto& series = series_[id];
+            std::lock_guard<std::mutex> lock(series.mutex);
+            records.push_back(to_record(id, name, series));
+            checksum.update(&records.back(), sizeof(SeriesRecord));
+            for (const auto& extent : extents_) {
+                const auto* slots = arena_.data() + extent.offset + id * extent.stride;
+                checksum.update(slots, extent.stride);
+                written = written && file.write(data_offset + extent.offset + id * extent.stride, slots, extent.stride);
+            }
+        }
+
+        sentum::market::StoreSnapshotHeader header{};
+        std::memcpy(header.magic, sentum::market::StoreSnapshotHeader::expected_magic, sizeof(header.magic));
+        header.version = sentum::market::StoreSnapshotHeader::current_version;
+        header.record_bytes = sizeof(SeriesRecord);
+        header.capacity_per_symbol = capacity_per_symbol_;
+        header.max_symbols = max_symbols_;
+        header.rollup_capacity = rollup_capacity_;
+        header.tape_capacity = tape_capacity_;
+        header.arena_bytes = arena_.size();
+        header.slot_limit = limit;
+        header.series_count = records.size();
+        header.data_offset = data_offset;
+        header.written_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        header.checksum = checksum.value();
+        written = written && file.write(sizeof(header), records.data(), records.size() * sizeof(SeriesRecord)) && file.write(0, &header, sizeof(header));
+        file.close();
+        if (!written || std::rename(temporary.c_str(), path.c_str()) != 0) {
+            std::remove(temporary.c_str());
+            return failed(report, (written ? "cannot rename " : "cannot write ") + temporary);
+        }
+        report.ok = true;
+        report.symbols = records.size();
+        report.written_ms = header.written_ms;
+        report.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin);
+        return report;
+    }
+
+    // Restores series from a snapshot written at most `max_age` ago. Call it after the
+    // universe is registered and before anything reads or writes the store. A snapshot
+    // series is restored into the registered series of the same name when both use the
+    // same representation and, for fixed-point series, the same scales; store capacities
+    // must match exactly. When every snapshot series keeps its id and the arena is on
+    // regular pages, the arena maps the file copy-on-write and nothing is copied.
+    SnapshotReport load_snapshot(const std::string& path, std::chrono::seconds max_age) {
+        const auto begin = std::chrono::steady_clock::now();
+        SnapshotReport report;
+        sentum::market::StoreSnapshotFile file;
+        if (!file.open(path)) return failed(report, "cannot open " + path);
+        sentum::market::StoreSnapshotHeader header{};
+        if (file.size() < sizeof(header)) return failed(report, "truncated snapshot");
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.magic, sentum::market::StoreSnapshotHeader::expected_magic, sizeof(header.magic)) != 0 ||
+            header.version != sentum::market::StoreSnapshotHeader::current_version || header.record_bytes != sizeof(SeriesRecord))
+            return failed(report, "unsupported snapshot format");
+        if (header.capacity_per_symbol != capacity_per_symbol_ || header.max_symbols != max_symbols_ || header.rollup_capacity != rollup_capacity_ ||
+            header.tape_capacity != tape_capacity_ || header.arena_bytes != arena_.size())
+            return failed(report, "snapshot store layout differs");
+        if (header.data_offset % sentum::market::SlabArena::huge_page_size != 0 || header.slot_limit > max_symbols_ + 1 ||
+            header.series_count > max_symbols_ || header.data_offset < sizeof(header) + header.series_count * sizeof(SeriesRecord) ||
+            file.size() < header.data_offset + header.arena_bytes)
+            return failed(report, "truncated snapshot");
+        report.written_ms = header.written_ms;
+        const auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        if (now_ms - header.written_ms > std::chrono::duration_cast<std::chrono::milliseconds>(max_age).count())
+            return failed(report, "snapshot is stale");
+
+        const auto* records = reinterpret_cast<const SeriesRecord*>(file.data() + sizeof(header));
+        const std::byte* const image = file.data() + header.data_offset;
+        sentum::market::StoreSnapshotChecksum checksum;
+        for (std::size_t i = 0; i < header.series_count; ++i) {
+            if (records[i].id >= header.slot_limit) return failed(report, "snapshot checksum mismatch");
+            checksum.update(&records[i], sizeof(SeriesRecord));
+            for (const auto& extent : extents_) checksum.update(image + extent.offset + records[i].id * extent.stride, extent.stride);
+        }
+        if (checksum.value() != header.checksum) return failed(report, "snapshot checksum mismatch");
+
+        std::vector<std::pair<const SeriesRecord*, sentum::market::SymbolId>> matches;
+        matches.reserve(header.series_count);
+        bool same_ids = true;
+        for (std::size_t i = 0; i < header.series_count; ++i) {
+            const auto& record = records[i];
+            if (record.symbol_length > sizeof(record.symbol) || !valid(record)) {
+                ++report.skipped;
+                continue;
+            }
+            const auto id = find(std::string(record.symbol, record.symbol_length));
+            if (!restorable(record, id)) { ++report.skipped; continue; }
+            same_ids = same_ids && id == record.id;
+            matches.emplace_back(&record, id);
+        }
 
-    std::size_t size(const std::string& symbol) const { return buffer_size(find(symbol)); }
-    std::size_t size(sentum::market::SymbolId id) const { return buffer_size(find(id)); }
+        report.mapped = same_ids && report.skipped == 0 && arena_.adopt(file.fd(), header.data_offset);
+        for (const auto& [record, id] : matches) {
+            auto& series = series_[id];
+            WriteGuard guard(series);
+            if (!report.mapped) {
+                for (const auto& extent : extents_)
+                    std::memcpy(arena_.data() + extent.offset + id * extent.stride, image + extent.offset + record->id * extent.stride, extent.stride);
+            }
+            from_record(*record, series);
+            ++report.symbols;
+        }
+        report.ok = true;
+        report.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin);
+        return report;
+    }
 
 private:
-    struct RingBuffer {
-        explicit RingBuffer(std::size_t c) : data(c), capacity(c) {}
-        std::vector<Kline> data;
-        const std::size_t capacity;
+
+    struct Cursor {
         std::size_t head = 0;
         std::size_t size = 0;
+        std::int64_t anchor = 0;
+    };
+
+    struct Rollup {
+        Kline forming{};
+        bool open = false;
+        // Ring of closed bars.
+        Cursor cursor;
+    };
+
+    struct alignas(64) Series {
+        // Serializes writers; readers only use it after repeated sequence collisions.
         mutable std::mutex mutex;
+        // Odd while a write is in progress.
+        std::atomic<std::uint64_t> sequence{0};
+        Cursor cursor;
+        std::array<Rollup, rollup_intervals> rollups{};
+        sentum::market::SymbolScales scales;
+        // Versions book and tape, which the collector may update far more often than candles.
+        std::atomic<std::uint64_t> feed_sequence{0};
+        TopOfBook book;
+        Cursor tape;
+        bool packed = false;
+        std::atomic<bool> registered{false};
     };
 
-    static void upsert_buffer(const std::shared_ptr<RingBuffer>& buffer, const Kline& kline) {
-        if (!buffer) return;
-        std::lock_guard<std::mutex> lock(buffer->mutex);
-        if (buffer->size > 0) {
-            const auto last_index = (buffer->head + buffer->capacity - 1) % buffer->capacity;
-            if (buffer->data[last_index].timestamp == kline.timestamp) { buffer->data[last_index] = kline; return; }
-        }
-        buffer->data[buffer->head] = kline;
-        buffer->head = (buffer->head + 1) % buffer->capacity;
-        if (buffer->size < buffer->capacity) ++buffer->size;
-    }
-
-    static std::vector<Kline> latest_buffer(const std::shared_ptr<RingBuffer>& buffer, std::size_t limit) {
-        if (!buffer || limit == 0) return {};
-        std::lock_guard<std::mutex> lock(buffer->mutex);
-        const std::size_t count = std::min(limit, buffer->size);
-        std::vector<Kline> result; result.reserve(count);
-        const std::size_t start = (buffer->head + buffer->capacity - count) % buffer->capacity;
-        for (std::size_t i = 0; i < count; ++i) result.push_back(buffer->data[(start + i) % buffer->capacity]);
-        return result;
+    class WriteGuard {
+    public:
+        explicit WriteGuard(Series& series) : WriteGuard(series, series.sequence) {}
+        WriteGuard(Series& series, std::atomic<std::uint64_t>& sequence) : sequence_(sequence), lock_(series.mutex) {
+            sequence_.store(sequence_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+        ~WriteGuard() { sequence_.store(sequence_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+        WriteGuard(const WriteGuard&) = delete;
+        WriteGuard& operator=(const WriteGuard&) = delete;
+
+    private:
+        std::atomic<std::uint64_t>& sequence_;
+        std::lock_guard<std::mutex> lock_;
+    };
+
+#if defined(__SANITIZE_THREAD__)
+    static constexpr bool optimistic_reads = false;
+#elif defined(__has_feature)
+#if __has_feature(thread_sanitizer)
+    static constexpr bool optimistic_reads = false;
+#else
+    static constexpr bool optimistic_reads = true;
+#endif
+#else
+    static constexpr bool optimistic_reads = true;
+#endif
+    static constexpr int optimistic_attempts = 64;
+
+    // Runs `read` until it completes without an overlapping write. The columns are plain
+    // memory, so ThreadSanitizer builds read under the writer mutex instead.
+    template <typename Read>
+    std::invoke_result_t<Read&> read_consistent(const Series& series, Read&& read) const {
+        return read_consistent(series, series.sequence, read);
+    }
+    template <typename Read>
+    std::invoke_result_t<Read&> read_consistent(const Series& series, const std::atomic<std::uint64_t>& sequence, Read&& read) const {
+        if constexpr (optimistic_reads) {
+            for (int attempt = 0; attempt < optimistic_attempts; ++attempt) {
+                const auto before = sequence.load(std::memory_order_acquire);
+                if (before & 1U) { std::this_thread::yield(); continue; }
+                auto result = read();
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (sequence.load(std::memory_order_relaxed) == before) return result;
+            }
+        }
+        std::lock_guard<std::mutex> lock(series.mutex);
+        return read();
     }
 
-    static bool cumulative_return_buffer(const std::shared_ptr<RingBuffer>& buffer, std::size_t lookback, double& result) {
-        if (!buffer || lookback < 2) return false;
-        std::lock_guard<std::mutex> lock(buffer->mutex);
-        const std::size_t count = std::min(lookback, buffer->size);
+    // Cursor as seen by a reader. A torn copy is discarded by the sequence check, but it
+    // is clamped first so that no read leaves the series' own slots.
+    static Cursor snapshot(Cursor cursor, std::size_t capacity) noexcept {
+        if (cursor.head >= capacity) cursor.head = 0;
+        cursor.size = std::min(cursor.size, capacity);
+        return cursor;
+    }
+
+    static Window window(const Columns& columns, std::size_t base, const Cursor& cursor, const Series& series, std::size_t limit) noexcept {
+        Window view;
+        view.columns_ = &columns;
+        view.base_ = base;
+        view.count_ = std::min(limit, cursor.size);
+        view.start_ = first_index(cursor, view.count_, columns.capacity);
+        view.anchor_ = cursor.anchor;
+        view.scales_ = series.scales;
+        view.packed_ = series.packed;
+        return view;
+    }
+
+    static Kline kline_at(const Window& window, std::size_t index) {
+        const auto slot = window.base_ + wrap(window.start_ + index, window.columns_->capacity);
+        if (window.packed_) return to_kline(sentum::market::unpack_kline(read_packed(*window.columns_, slot), window.anchor_), window.scales_);
+        return read(*window.columns_, slot);
+    }
+
+    static sentum::market::PackedKline packed_at(const Window& window, std::size_t index) noexcept {
+        return read_packed(*window.columns_, window.base_ + wrap(window.start_ + index, window.columns_->capacity));
+    }
+
+    // Points every column into the arena at `base` and returns the bytes needed; a null
+    // `base` only measures. Each column starts on a huge-page boundary.
+    std::size_t carve(std::byte* base) {
+        const std::size_t slots = max_symbols_ + 1;
+        std::size_t offset = 0;
+        const auto column = [&](auto*& pointer, std::size_t capacity) {
+            using T = std::remove_reference_t<decltype(*pointer)>;
+            if (base) {
+                pointer = reinterpret_cast<T*>(base + offset);
+                extents_.push_back({offset, capacity * sizeof(T)});
+            }
+            offset += sentum::market::SlabArena::round_up(capacity * slots * sizeof(T), sentum::market::SlabArena::huge_page_size);
+        };
+        Columns columns;
+        columns.capacity = capacity_per_symbol_;
+        column(columns.timestamp, capacity_per_symbol_);
+        column(columns.open, capacity_per_symbol_);
+        column(columns.high, capacity_per_symbol_);
+        column(columns.low, capacity_per_symbol_);
+        column(columns.close, capacity_per_symbol_);
+        column(columns.volume, capacity_per_symbol_);
+        column(columns.packed_open, capacity_per_symbol_);
+        column(columns.packed_high, capacity_per_symbol_);
+        column(columns.packed_low, capacity_per_symbol_);
+        column(columns.packed_close, capacity_per_symbol_);
+        column(columns.packed_volume, capacity_per_symbol_);
+        std::array<Columns, rollup_intervals> rollups{};
+        if (rollup_capacity_ > 0) {
+            for (auto& rollup : rollups) {
+                rollup.capacity = rollup_capacity_;
+                column(rollup.timestamp, rollup_capacity_);
+                column(rollup.open, rollup_capacity_);
+                column(rollup.high, rollup_capacity_);
+                column(rollup.low, rollup_capacity_);
+                column(rollup.close, rollup_capacity_);
+                column(rollup.volume, rollup_capacity_);
+            }
+        }
+        TapeColumns tape;
+        if (tape_capacity_ > 0) {
+            column(tape.timestamp, tape_capacity_);
+            column(tape.price, tape_capacity_);
+            column(tape.quantity, tape_capacity_);
+            column(tape.buyer_maker, tape_capacity_);
+        }
+        if (base) {
+            columns_ = columns;
+            rollups_ = rollups;
+            tape_ = tape;
+        }
+        return offset;
+    }
+
+    bool registered(sentum::market::SymbolId id) const noexcept {
+        return id != sentum::market::kInvalidSymbolId && id <= max_symbols_ && series_[id].registered.load(std::memory_order_acquire);
+    }
+
+    std::size_t slot_base(sentum::market::SymbolId id) const noexcept { return static_cast<std::size_t>(id) * capacity_per_symbol_; }
+    std::size_t rollup_base(sentum::market::SymbolId id) const noexcept { return static_cast<std::size_t>(id) * rollup_capacity_; }
+    std::size_t tape_base(sentum::market::SymbolId id) const noexcept { return static_cast<std::size_t>(id) * tape_capacity_; }
+    static std::size_t wrap(std::size_t index, std::size_t capacity) noexcept { return index >= capacity ? index - capacity : index; }
+    static std::size_t last_index(const Cursor& cursor, std::size_t capacity) noexcept { return cursor.head == 0 ? capacity - 1 : cursor.head - 1; }
+    static std::size_t first_index(const Cursor& cursor, std::size_t count, std::size_t capacity) noexcept { return wrap(cursor.head + capacity - count, capacity); }
+    static void advance(Cursor& cursor, std::size_t capacity) noexcept {
+        cursor.head = wrap(cursor.head + 1, capacity);
+        if (cursor.size < capacity) ++cursor.size;
+    }
+
+    static void write(const Columns& columns, std::size_t slot, const Kline& kline) noexcept {
+        columns.timestamp[slot] = kline.timestamp;
+        columns.open[slot] = kline.open; columns.high[slot] = kline.high; columns.low[slot] = kline.low;
+        columns.close[slot] = kline.close; columns.volume[slot] = kline.volume;
+    }
+    static Kline read(const Columns& columns, std::size_t slot) noexcept {
+        return {columns.timestamp[slot], columns.open[slot], columns.high[slot], columns.low[slot], columns.close[slot], columns.volume[slot]};
+    }
+    void write_packed(std::size_t slot, const sentum::market::PackedKline& packed) noexcept {
+        columns_.timestamp[slot] = packed.timestamp;
+        columns_.packed_open[slot] = packed.open; columns_.packed_high[slot] = packed.high; columns_.packed_low[slot] = packed.low;
+        columns_.packed_close[slot] = packed.close; columns_.packed_volume[slot] = packed.volume;
+    }
+    static sentum::market::PackedKline read_packed(const Columns& columns, std::size_t slot) noexcept {
+        sentum::market::PackedKline packed;
+        packed.timestamp = columns.timestamp[slot];
+        packed.open = columns.packed_open[slot]; packed.high = columns.packed_high[slot]; packed.low = columns.packed_low[slot];
+        packed.close = columns.packed_close[slot]; packed.volume = columns.packed_volume[slot];
+        return packed;
+    }
+
+    // Folds one candle into every rollup in O(1). `replaced_volume` is the volume of the
+    // base candle this upsert overwrote (zero for a new candle), so repeated updates of a
+    // forming candle add only their increment. Candles older than a rollup's forming bar
+    // are ignored by that rollup.
+    void roll_up(sentum::market::SymbolId id, Series& series, const Kline& kline, double replaced_volume) noexcept {
+        if (rollup_capacity_ == 0) return;
+        roll_up(rollup_base(id), series, kline, replaced_volume, std::make_index_sequence<rollup_intervals>{});
+    }
+    template <std::size_t... Index>
+    void roll_up(std::size_t base, Series& series, const Kline& kline, double replaced_volume, std::index_sequence<Index...>) noexcept {
+        (roll_up_interval<Index>(base, series.rollups[Index], kline, replaced_volume), ...);
+    }
+    // One instantiation per interval, so the bucket division is by a constant.
+    template <std::size_t Index>
+    void roll_up_interval(std::size_t base, Rollup& rollup, const Kline& kline, double replaced_volume) noexcept {
+        constexpr auto span = rollup_seconds(static_cast<RollupInterval>(Index)) * 1000;
+        const auto bucket = kline.timestamp - kline.timestamp % span;
+        auto& bar = rollup.forming;
+        if (rollup.open) {
+            if (bucket < bar.timestamp) return;
+            if (bucket == bar.timestamp) {
+                bar.high = std::max(bar.high, kline.high);
+                bar.low = std::min(bar.low, kline.low);
+                bar.close = kline.close;
+                bar.volume += kline.volume - replaced_volume;
+                return;
+            }
+            write(rollups_[Index], base + rollup.cursor.head, bar);
+            advance(rollup.cursor, rollup_capacity_);
+        }
+        bar = {bucket, kline.open, kline.high, kline.low, kline.close, kline.volume};
+        rollup.open = true;
+    }
+
+    bool rollup_series_return(sentum::market::SymbolId id, const Series& series, RollupInterval interval, std::size_t lookback, double& result) const noexcept {
+        const auto index = static_cast<std::size_t>(interval);
+        const auto& rollup = series.rollups[index];
+        const auto cursor = snapshot(rollup.cursor, rollup_capacity_);
+        if (!rollup.open) return false;
+        const std::size_t count = std::min(lookback - 1, cursor.size);
+        if (count == 0) return false;
+        const double first_price = rollups_[index].close[rollup_base(id) + first_index(cursor, count, rollup_capacity_)];
+        if (first_price <= 0.0) return false;
+        result = (rollup.forming.close - first_price) / first_price;
+        return true;
+    }
+
+    bool series_return(sentum::market::SymbolId id, const Series& series, std::size_t lookback, double& result) const noexcept {
+        const auto cursor = snapshot(series.cursor, capacity_per_symbol_);
+        const std::size_t count = std::min(lookback, cursor.size);
         if (count < 2) return false;
-        const std::size_t first_index = (buffer->head + buffer->capacity - count) % buffer->capacity;
-        const std::size_t last_index = (buffer->head + buffer->capacity - 1) % buffer->capacity;
-        const double first = buffer->data[first_index].close;
-        if (first <= 0.0) return false;
-        result = (buffer->data[last_index].close - first) / first;
+        const std::size_t base = slot_base(id);
+        const std::size_t first = base + first_index(cursor, count, capacity_per_symbol_), last = base + last_index(cursor, capacity_per_symbol_);
+        if (series.packed) {
+            // Offsets share the anchor, so the price difference is an exact integer.
+            const auto first_price = cursor.anchor + columns_.packed_close[first];
+            if (first_price <= 0) return false;
+            result = static_cast<double>(columns_.packed_close[last] - columns_.packed_close[first]) / static_cast<double>(first_price);
+            return true;
+        }
+        const double first_price = columns_.close[first];
+        if (first_price <= 0.0) return false;
+        result = (columns_.close[last] - first_price) / first_price;
         return true;
     }
 
-    static std::size_t buffer_size(const std::shared_ptr<RingBuffer>& buffer) {
-        if (!buffer) return 0;
-        std::lock_guard<std::mutex> lock(buffer->mutex);
-        return buffer->size;
+    static sentum::market::FixedKline to_fixed(const Kline& kline, const sentum::market::SymbolScales& scales) {
+        sentum::market::FixedKline fixed;
+        fixed.timestamp = kline.timestamp;
+        fixed.open = scales.price.from_double(kline.open);
+        fixed.high = scales.price.from_double(kline.high);
+        fixed.low = scales.price.from_double(kline.low);
+        fixed.close = scales.price.from_double(kline.close);
+        fixed.volume = scales.quantity.from_double<sentum::market::QtyTag>(kline.volume);
+        return fixed;
     }
 
-    std::shared_ptr<RingBuffer> get_or_create(const std::string& symbol) {
+    static Kline to_kline(const sentum::market::FixedKline& fixed, const sentum::market::SymbolScales& scales) {
+        return {fixed.timestamp, scales.price.to_double(fixed.open), scales.price.to_double(fixed.high),
+                scales.price.to_double(fixed.low), scales.price.to_double(fixed.close), scales.quantity.to_double(fixed.volume)};
+    }
+
+    // Re-encodes the retained window around a new anchor. A move beyond the 32-bit offset
+    // range (2^31 grid units) cannot be represented, so the window restarts instead.
+    void rebase(sentum::market::SymbolId id, Cursor& cursor, std::int64_t anchor) {
+        const std::size_t base = slot_base(id), start = first_index(cursor, cursor.size, capacity_per_symbol_);
+        for (std::size_t i = 0; i < cursor.size; ++i) {
+            const auto slot = base + wrap(start + i, capacity_per_symbol_);
+            sentum::market::PackedKline packed;
+            if (!sentum::market::pack_kline(sentum::market::unpack_kline(read_packed(columns_, slot), cursor.anchor), anchor, packed)) {
+                cursor.head = 0;
+                cursor.size = 0;
+                break;
+            }
+            write_packed(slot, packed);
+        }
+        cursor.anchor = anchor;
+    }
+
+    // Registering again keeps the retained window unless the representation changes.
+    void register_series(sentum::market::SymbolId id, const std::string& symbol, const sentum::market::SymbolScales* scales) {
+        if (id == sentum::market::kInvalidSymbolId || id > max_symbols_) return;
+        auto& series = series_[id];
         {
-            std::shared_lock<std::shared_mutex> lock(map_mutex_);
-            auto it = buffers_.find(symbol);
-            if (it != buffers_.end()) return it->second;
+            WriteGuard guard(series);
+            const bool packed = scales != nullptr;
+            if (!series.registered.load(std::memory_order_relaxed) || series.packed != packed) {
+                series.cursor = {};
+                series.rollups = {};
+            }
+            series.packed = packed;
+            series.scales = scales ? *scales : sentum::market::SymbolScales{};
+            series.registered.store(true, std::memory_order_release);
+        }
+        auto limit = registered_limit_.load(std::memory_order_relaxed);
+        while (limit <= id && !registered_limit_.compare_exchange_weak(limit, static_cast<std::size_t>(id) + 1, std::memory_order_acq_rel)) {}
+        std::unique_lock<std::shared_mutex> lock(names_mutex_);
+        ids_by_name_[symbol] = id;
+    }
+
+    // Byte range of one column in the arena; symbol `id` owns [offset + id * stride, +stride).
+    struct ColumnExtent {
+        std::size_t offset = 0;
+        std::size_t stride = 0;
+    };
+
+    struct SnapshotCursor {
+        std::uint64_t head;
+        std::uint64_t size;
+        std::int64_t anchor;
+    };
+
+    struct SnapshotBar {
+        std::int64_t timestamp;
+        double open, high, low, close, volume;
+    };
+
+    // Per-series part of a snapshot: everything Series holds besides its locks.
+    struct SeriesRecord {
+        char symbol[sentum::market::SymbolInterner::max_symbol_length];
+        std::uint32_t id;
+        std::uint32_t symbol_length;
+        std::uint32_t packed;
+        std::uint32_t rollup_open; // bit i: rollup i has a forming bar
+        std::int64_t price_decimals, price_tick_units, quantity_decimals, quantity_tick_units;
+        SnapshotCursor cursor;
+        SnapshotCursor rollup_cursors[rollup_intervals];
+        SnapshotBar rollup_forming[rollup_intervals];
+        std::int64_t book_update_id, book_timestamp;
+        double bid_price, bid_quantity, ask_price, ask_quantity;
+        SnapshotCursor tape;
+    };
+    static_assert(std::is_trivially_copyable_v<SeriesRecord> && sizeof(SeriesRecord) % 8 == 0, "snapshot records are copied as bytes");
+
+    static SnapshotReport failed(SnapshotReport& report, std::string error) {
+        report.ok = false;
+        report.error = std::move(error);
+        return report;
+    }
+
+    static SnapshotCursor to_record(const Cursor& cursor) noexcept {
+        return {cursor.head, cursor.size, cursor.anchor};
+    }
+    static Cursor from_record(const SnapshotCursor& cursor) noexcept {
+        return {static_cast<std::size_t>(cursor.head), static_cast<std::size_t>(cursor.size), cursor.anchor};
+    }
+
+    static SeriesRecord to_record(sentum::market::SymbolId id, const std::string& name, const Series& series) noexcept {
+        SeriesRecord record{};
+        std::memcpy(record.symbol, name.data(), name.size());
+        record.id = id;
+        record.symbol_length = static_cast<std::uint32_t>(name.size());
+        record.packed = series.packed ? 1 : 0;
+        record.price_decimals = series.scales.price.decimals();
+        record.price_tick_units = series.scales.price.tick_units();
+        record.quantity_decimals = series.scales.quantity.decimals();
+        record.quantity_tick_units = series.scales.quantity.tick_units();
+        record.cursor = to_record(series.cursor);
+        for (std::size_t i = 0; i < rollup_intervals; ++i) {
+            const auto& rollup = series.rollups[i];
+            if (rollup.open) record.rollup_open |= 1U << i;
+            record.rollup_cursors[i] = to_record(rollup.cursor);
+            const auto& bar = rollup.forming;
+            record.rollup_forming[i] = {bar.timestamp, bar.open, bar.high, bar.low, bar.close, bar.volume};
         }
-        std::unique_lock<std::shared_mutex> lock(map_mutex_);
-        auto [it, inserted] = buffers_.emplace(symbol, nullptr);
-        if (inserted) it->second = std::make_shared<RingBuffer>(capacity_per_symbol_);
-        return it->second;
+        record.book_update_id = series.book.update_id;
+        record.book_timestamp = series.book.timestamp;
+        record.bid_price = series.book.bid_price;
+        record.bid_quantity = series.book.bid_quantity;
+        record.ask_price = series.book.ask_price;
+        record.ask_quantity = series.book.ask_quantity;
+        record.tape = to_record(series.tape);
+        return record;
     }
 
-    std::shared_ptr<RingBuffer> find(const std::string& symbol) const {
-        std::shared_lock<std::shared_mutex> lock(map_mutex_);
-        auto it = buffers_.find(symbol);
-        return it == buffers_.end() ? nullptr : it->second;
+    static void from_record(const SeriesRecord& record, Series& series) noexcept {
+        series.cursor = from_record(record.cursor);
+        for (std::size_t i = 0; i < rollup_intervals; ++i) {
+            auto& rollup = series.rollups[i];
+            const auto& bar = record.rollup_forming[i];
+            rollup.forming = {bar.timestamp, bar.open, bar.high, bar.low, bar.close, bar.volume};
+            rollup.open = (record.rollup_open >> i) & 1U;
+            rollup.cursor = from_record(record.rollup_cursors[i]);
+        }
+        series.book = {record.book_update_id, record.book_timestamp, record.bid_price, record.bid_quantity, record.ask_price, record.ask_quantity};
+        series.tape = from_record(record.tape);
+    }
+
+    // Writers index the rings with these cursors directly, so they are checked even
+    // though the checksum already passed.
+    bool valid(const SeriesRecord& record) const noexcept {
+        const auto fits = [](const SnapshotCursor& cursor, std::size_t capacity) {
+            return capacity == 0 ? cursor.head == 0 && cursor.size == 0 : cursor.head < capacity && cursor.size <= capacity;
+        };
+        if (!fits(record.cursor, capacity_per_symbol_) || !fits(record.tape, tape_capacity_)) return false;
+        for (const auto& cursor : record.rollup_cursors) {
+            if (!fits(cursor, rollup_capacity_)) return false;
+        }
+        return true;
+    }
+
+    bool restorable(const SeriesRecord& record, sentum::market::SymbolId id) const noexcept {
+        if (!registered(id)) return false;
+        const auto& series = series_[id];
+        if (series.packed != (record.packed != 0)) return false;
+        return !series.packed ||
+               (series.scales.price.decimals() == record.price_decimals && series.scales.price.tick_units() == record.price_tick_units &&
+                series.scales.quantity.decimals() == record.quantity_decimals && series.scales.quantity.tick_units() == record.quantity_tick_units);
+    }
+
+
+    // String entry points resolve through the shared interner.
+    sentum::market::SymbolId get_or_create(const std::string& symbol) {
+        if (const auto id = find(symbol); id != sentum::market::kInvalidSymbolId) return id;
+        const auto id = sentum::market::SymbolInterner::global().intern(symbol);
+        register_series(id, symbol, nullptr);
+        return id;
     }
 
-    std::shared_ptr<RingBuffer> find(sentum::market::SymbolId id) const {
-        std::shared_lock<std::shared_mutex> lock(map_mutex_);
-        const auto index = static_cast<std::size_t>(id);
-        return index < id_buffers_.size() ? id_buffers_[index] : nullptr;
+    sentum::market::SymbolId find(const std::string& symbol) const {
+        std::shared_lock<std::shared_mutex> lock(names_mutex_);
+        const auto it = ids_by_name_.find(symbol);
+        return it == ids_by_name_.end() ? sentum::market::kInvalidSymbolId : it->second;
     }
 
     std::size_t capacity_per_symbol_;
-    mutable std::shared_mutex map_mutex_;
-    std::unordered_map<std::string, std::shared_ptr<RingBuffer>> buffers_;
-    std::vector<std::shared_ptr<RingBuffer>> id_buffers_;
+    std::size_t max_symbols_;
+    std::size_t rollup_capacity_;
+    std::size_t tape_capacity_;
+    sentum::market::SlabArena arena_;
+    std::unique_ptr<Series[]> series_;
+    std::atomic<std::size_t> registered_limit_{0};
+    Columns columns_;
+    std::array<Columns, rollup_intervals> rollups_{};
+    TapeColumns tape_;
+    std::vector<ColumnExtent> extents_;
+    mutable std::shared_mutex names_mutex_;
+    std::unordered_map<std::string, sentum::market::SymbolId> ids_by_name_;
 };
@@ -1,15 +1,22 @@
 #pragma once
 
 #include <chrono>
-#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
 
 #include <sentum/market/SymbolId.hpp>
+#include <sentum/market/SymbolInterner.hpp>
 
-struct MarketEvent {
-    enum class Type { Trade, Candle };
-    Type type = Type::Trade;
-    sentum::market::SymbolId symbol_id = sentum::market::kInvalidSymbolId;
-    std::string symbol;
+// One cache line, trivially copyable and keyed only by SymbolId. Names are resolved
+// through the SymbolInterner at UI, logging and persistence boundaries.
+//
+// Quote events (best bid/ask from @bookTicker) reuse the bar fields: low/high carry the
+// bid/ask prices, open/close their quantities, and price is the mid. Use the accessors
+// below rather than the raw fields. Trade and AggTrade events carry the quantity in volume.
+struct alignas(64) MarketEvent {
+    enum class Type : std::uint8_t { Trade, Candle, Quote, AggTrade };
     std::chrono::system_clock::time_point timestamp{};
     double price = 0.0;
     double open = 0.0;
@@ -17,5 +24,47 @@ struct MarketEvent {
     double low = 0.0;
     double close = 0.0;
     double volume = 0.0;
+    sentum::market::SymbolId symbol_id = sentum::market::kInvalidSymbolId;
+    Type type = Type::Trade;
     bool closed = true;
+    // AggTrade: the buyer was the resting order, i.e. the aggressor sold.
+    bool buyer_maker = false;
+
+    std::string_view symbol() const noexcept { return sentum::market::SymbolInterner::global().name(symbol_id); }
+
+    double bid() const noexcept { return low; }
+    double ask() const noexcept { return high; }
+    double bid_quantity() const noexcept { return open; }
+    double ask_quantity() const noexcept { return close; }
+
+    static MarketEvent quote(sentum::market::SymbolId id, std::chrono::system_clock::time_point at,
+                             double bid, double bid_quantity, double ask, double ask_quantity) noexcept {
+        MarketEvent event;
+        event.type = Type::Quote;
+        event.symbol_id = id;
+        event.timestamp = at;
+        event.price = (bid + ask) * 0.5;
+        event.low = bid; event.high = ask;
+        event.open = bid_quantity; event.close = ask_quantity;
+        event.closed = false;
+        return event;
+    }
+
+    static constexpr std::uint8_t type_mask(Type type) noexcept { return static_cast<std::uint8_t>(1U << static_cast<unsigned>(type)); }
+    static constexpr std::uint8_t all_types = 0xFF;
+};
+
+static_assert(sizeof(MarketEvent) == 64, "MarketEvent must stay one cache line");
+static_assert(std::is_trivially_copyable_v<MarketEvent>, "MarketEvent must stay trivially copyable");
+
+// A contiguous run of events handed to subscribers in one publish call. The span is only
+// valid for the duration of the call.
+struct MarketEventBatch {
+    const MarketEvent* events = nullptr;
+    std::size_t count = 0;
+
+    const MarketEvent* begin() const noexcept { return events; }
+    const MarketEvent* end() const noexcept { return events + count; }
+    std::size_t size() const noexcept { return count; }
+    bool empty() const noexcept { return count == 0; }
 };
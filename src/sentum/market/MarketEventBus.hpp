@@ -1,47 +1,334 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <mutex>
-#include <shared_mutex>
-#include <unordered_map>
+#include <thread>
 #include <utility>
+#include <vector>
 
+#include <sentum/market/DispatchLane.hpp>
 #include <sentum/market/MarketEvent.hpp>
 
 namespace sentum::market {
 
+// Fan-out of market events to in-process subscribers.
+//
+// The subscriber table is an immutable, contiguous array published through an atomic
+// pointer (read-copy-update). subscribe/unsubscribe copy the table, swap the pointer and
+// retire the old copy; publish loads the pointer and walks the array without locks or
+// read-modify-write atomics. Each publishing thread owns a cache-line sized reader slot
+// in which it records the epoch it entered at; a retired table is freed only once every
+// slot has moved past its retirement epoch. Slots go back to the bus when their thread
+// exits and are reused by later threads.
+//
+// Handlers run inline on the publishing thread unless subscribed with LaneOptions, in
+// which case the bus gives them their own DispatchLane and worker thread.
+//
+// unsubscribe waits for in-flight publishes that could still see the handler, and for a
+// lane's worker to stop, so the subscriber may be destroyed right after it returns. It
+// must not be called from inside a handler of the same bus.
 class MarketEventBus {
 public:
     using Handler = std::function<void(const MarketEvent&)>;
+    using Callback = void (*)(void* context, const MarketEvent& event);
+    // Optional per-batch entry point; subscribers without one get the events one by one.
+    using BatchCallback = void (*)(void* context, const MarketEventBatch& batch);
     using SubscriptionId = std::uint64_t;
 
+    static constexpr std::size_t max_reader_threads = 128;
+
     static MarketEventBus& global() {
         static MarketEventBus instance;
         return instance;
     }
 
+    MarketEventBus() : table_(new Table()) {}
+    MarketEventBus(const MarketEventBus&) = delete;
+    MarketEventBus& operator=(const MarketEventBus&) = delete;
+
+    ~MarketEventBus() {
+        readers_->bus_alive.store(false, std::memory_order_relaxed);
+        lanes_.clear();
+        delete table_.load(std::memory_order_acquire);
+        for (auto& retired : retired_) delete retired.table;
+    }
+
+    // Typed subscription without type erasure: `context` is passed back to `callback`.
+    SubscriptionId subscribe(Callback callback, void* context) {
+        return add({callback, context}, nullptr);
+    }
+
+    // As above, plus a callback that receives publish(MarketEventBatch) spans whole.
+    SubscriptionId subscribe(Callback callback, BatchCallback batch, void* context) {
+        return add({callback, context, batch}, nullptr);
+    }
+
+    // Binds a member function, e.g. `bus.subscribe<&Scanner::on_event>(*this)`.
+    template <auto Method, typename T>
+    SubscriptionId subscribe(T& target) {
+        return subscribe([](void* context, const MarketEvent& event) { (static_cast<T*>(context)->*Method)(event); },
+                         static_cast<void*>(&target));
+    }
+
     SubscriptionId subscribe(Handler handler) {
-        const auto id = next_id_.fetch_add(1, std::memory_order_relaxed);
-        std::unique_lock<std::shared_mutex> lock(mutex_);
-        handlers_.emplace(id, std::move(handler));
+        auto owned = std::make_shared<Handler>(std::move(handler));
+        Handler* target = owned.get();
+        return add({[](void* context, const MarketEvent& event) { (*static_cast<Handler*>(context))(event); }, target},
+                   std::move(owned));
+    }
+
+    // Asynchronous variants: the handler runs on a dedicated lane worker.
+    SubscriptionId subscribe(Callback callback, void* context, LaneOptions options) {
+        auto lane = std::make_unique<DispatchLane>(std::move(options), callback, context);
+        DispatchLane* target = lane.get();
+        const auto id = add({&DispatchLane::push_thunk, target, &DispatchLane::push_batch_thunk}, nullptr);
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        lanes_.emplace_back(id, std::move(lane));
         return id;
     }
 
+    template <auto Method, typename T>
+    SubscriptionId subscribe(T& target, LaneOptions options) {
+        return subscribe([](void* context, const MarketEvent& event) { (static_cast<T*>(context)->*Method)(event); },
+                         static_cast<void*>(&target), std::move(options));
+    }
+
     void unsubscribe(SubscriptionId id) {
-        std::unique_lock<std::shared_mutex> lock(mutex_);
-        handlers_.erase(id);
+        std::uint64_t retired_at = 0;
+        {
+            std::lock_guard<std::mutex> lock(write_mutex_);
+            const Table* current = table_.load(std::memory_order_relaxed);
+            auto it = std::find(current->ids.begin(), current->ids.end(), id);
+            if (it == current->ids.end()) return;
+            const auto index = static_cast<std::size_t>(it - current->ids.begin());
+            auto next = std::make_unique<Table>(*current);
+            next->entries.erase(next->entries.begin() + static_cast<std::ptrdiff_t>(index));
+            next->ids.erase(next->ids.begin() + static_cast<std::ptrdiff_t>(index));
+            next->owners.erase(next->owners.begin() + static_cast<std::ptrdiff_t>(index));
+            retired_at = swap(std::move(next));
+        }
+        // Grace period: no publish that started on the old table may still be running.
+        while (!quiescent_since(retired_at)) std::this_thread::yield();
+        std::unique_ptr<DispatchLane> lane;
+        {
+            std::lock_guard<std::mutex> lock(write_mutex_);
+            reclaim_locked();
+            auto it = std::find_if(lanes_.begin(), lanes_.end(), [id](const auto& entry) { return entry.first == id; });
+            if (it != lanes_.end()) {
+                lane = std::move(it->second);
+                lanes_.erase(it);
+            }
+        }
+        // Joins the worker outside the lock.
+        lane.reset();
     }
 
     void publish(const MarketEvent& event) const {
-        std::shared_lock<std::shared_mutex> lock(mutex_);
-        for (const auto& [_, handler] : handlers_) handler(event);
+        ReadGuard guard(*this);
+        const Table* table = table_.load(std::memory_order_seq_cst);
+        for (const auto& entry : table->entries) entry.callback(entry.context, event);
+    }
+
+    // Delivers a batch with one table walk: lanes enqueue it under one lock and wake-up,
+    // batch-aware subscribers get the span, and the rest are called per event.
+    void publish(const MarketEventBatch& batch) const {
+        if (batch.empty()) return;
+        ReadGuard guard(*this);
+        const Table* table = table_.load(std::memory_order_seq_cst);
+        for (const auto& entry : table->entries) {
+            if (entry.batch) { entry.batch(entry.context, batch); continue; }
+            for (const auto& event : batch) entry.callback(entry.context, event);
+        }
+    }
+
+    std::size_t subscriber_count() const noexcept {
+        ReadGuard guard(*this);
+        return table_.load(std::memory_order_seq_cst)->entries.size();
+    }
+
+    // Frees retired tables that no publisher can still be reading.
+    void reclaim() {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        reclaim_locked();
     }
 
 private:
-    mutable std::shared_mutex mutex_;
-    std::unordered_map<SubscriptionId, Handler> handlers_;
+    struct Entry {
+        Callback callback = nullptr;
+        void* context = nullptr;
+        BatchCallback batch = nullptr;
+    };
+
+    // `entries` is the only array publish touches; ids and owned handlers sit alongside it.
+    struct Table {
+        std::vector<Entry> entries;
+        std::vector<SubscriptionId> ids;
+        std::vector<std::shared_ptr<Handler>> owners;
+    };
+
+    struct Retired {
+        const Table* table = nullptr;
+        std::uint64_t epoch = 0;
+    };
+
+    // Epoch a publishing thread entered at, or zero while it is outside publish. A slot
+    // belongs to one thread at a time.
+    struct alignas(64) ReaderSlot {
+        std::atomic<std::uint64_t> epoch{0};
+        std::atomic<bool> owned{false};
+    };
+
+    // Shared with the threads' slot caches, so a thread that outlives the bus can still
+    // hand its slot back.
+    struct ReaderSlots {
+        std::array<ReaderSlot, max_reader_threads> slots{};
+        // One past the highest slot ever claimed; quiescent_since scans up to here.
+        std::atomic<std::size_t> high_water{0};
+        std::atomic<std::size_t> in_use{0};
+        std::atomic<bool> bus_alive{true};
+
+        ReaderSlot* claim() noexcept {
+            if (in_use.load(std::memory_order_relaxed) >= max_reader_threads) return nullptr;
+            for (std::size_t i = 0; i < max_reader_threads; ++i) {
+                bool expected = false;
+                if (slots[i].owned.load(std::memory_order_relaxed) ||
+                    !slots[i].owned.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) continue;
+                in_use.fetch_add(1, std::memory_order_relaxed);
+                auto seen = high_water.load(std::memory_order_seq_cst);
+                while (seen <= i && !high_water.compare_exchange_weak(seen, i + 1, std::memory_order_seq_cst)) {}
+                return &slots[i];
+            }
+            return nullptr;
+        }
+
+        // The owner's epoch is already zero: it is outside publish.
+        void release(ReaderSlot* slot) noexcept {
+            slot->owned.store(false, std::memory_order_release);
+            in_use.fetch_sub(1, std::memory_order_relaxed);
+        }
+    };
+
+    // A thread's slots on up to eight buses, returned when the thread exits.
+    struct SlotCache {
+        struct Cached {
+            std::uint64_t bus = 0;
+            ReaderSlot* slot = nullptr;
+            std::shared_ptr<ReaderSlots> owner;
+        };
+        std::array<Cached, 8> entries{};
+
+        ~SlotCache() {
+            for (auto& cached : entries) {
+                if (cached.slot) cached.owner->release(cached.slot);
+            }
+        }
+    };
+
+    class ReadGuard {
+    public:
+        explicit ReadGuard(const MarketEventBus& bus) : bus_(bus), slot_(bus.reader_slot()) {
+            if (!slot_) {
+                bus_.overflow_readers_.fetch_add(1, std::memory_order_seq_cst);
+                return;
+            }
+            // A nested publish keeps the outer (older) epoch.
+            previous_ = slot_->epoch.load(std::memory_order_relaxed);
+            if (previous_ == 0) slot_->epoch.store(bus_.epoch_.load(std::memory_order_acquire), std::memory_order_seq_cst);
+        }
+        ~ReadGuard() {
+            if (!slot_) {
+                bus_.overflow_readers_.fetch_sub(1, std::memory_order_release);
+                return;
+            }
+            if (previous_ == 0) slot_->epoch.store(0, std::memory_order_release);
+        }
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+    private:
+        const MarketEventBus& bus_;
+        ReaderSlot* slot_;
+        std::uint64_t previous_ = 0;
+    };
+
+    SubscriptionId add(Entry entry, std::shared_ptr<Handler> owner) {
+        const auto id = next_id_.fetch_add(1, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        auto next = std::make_unique<Table>(*table_.load(std::memory_order_relaxed));
+        next->entries.push_back(entry);
+        next->ids.push_back(id);
+        next->owners.push_back(std::move(owner));
+        swap(std::move(next));
+        reclaim_locked();
+        return id;
+    }
+
+    // Publishes `next` and retires the previous table. Returns the retirement epoch.
+    std::uint64_t swap(std::unique_ptr<Table> next) {
+        const Table* previous = table_.exchange(next.release(), std::memory_order_seq_cst);
+        const auto epoch = epoch_.fetch_add(1, std::memory_order_seq_cst) + 1;
+        retired_.push_back({previous, epoch});
+        return epoch;
+    }
+
+    void reclaim_locked() {
+        auto keep = retired_.begin();
+        for (auto it = retired_.begin(); it != retired_.end(); ++it) {
+            if (quiescent_since(it->epoch)) delete it->table;
+            else *keep++ = *it;
+        }
+        retired_.erase(keep, retired_.end());
+    }
+
+    // True when no reader can still hold a table retired at `epoch`.
+    bool quiescent_since(std::uint64_t epoch) const noexcept {
+        if (overflow_readers_.load(std::memory_order_seq_cst) != 0) return false;
+        const auto claimed = std::min(readers_->high_water.load(std::memory_order_seq_cst), max_reader_threads);
+        for (std::size_t i = 0; i < claimed; ++i) {
+            const auto seen = readers_->slots[i].epoch.load(std::memory_order_seq_cst);
+            if (seen != 0 && seen < epoch) return false;
+        }
+        return true;
+    }
+
+    // Each thread claims a free slot per bus on its first publish and caches it, for up
+    // to eight live buses at a time. Without a cache entry or a free slot (more than
+    // max_reader_threads publishing threads alive) a publish uses the shared counter
+    // instead; a slot is claimed again once either frees up.
+    ReaderSlot* reader_slot() const noexcept {
+        thread_local SlotCache cache;
+        SlotCache::Cached* free = nullptr;
+        for (auto& cached : cache.entries) {
+            if (cached.bus == instance_) return cached.slot;
+            if (!free && (cached.bus == 0 || !cached.owner->bus_alive.load(std::memory_order_relaxed))) free = &cached;
+        }
+        if (!free) return nullptr;
+        ReaderSlot* slot = readers_->claim();
+        if (!slot) return nullptr;
+        if (free->slot) free->owner->release(free->slot);
+        *free = {instance_, slot, readers_};
+        return slot;
+    }
+
+    static std::uint64_t next_instance() noexcept {
+        static std::atomic<std::uint64_t> counter{1};
+        return counter.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::atomic<const Table*> table_;
+    std::atomic<std::uint64_t> epoch_{1};
+    const std::shared_ptr<ReaderSlots> readers_ = std::make_shared<ReaderSlots>();
+    mutable std::atomic<std::uint64_t> overflow_readers_{0};
+    const std::uint64_t instance_ = next_instance();
+    std::mutex write_mutex_;
+    std::vector<Retired> retired_;
+    std::vector<std::pair<SubscriptionId, std::unique_ptr<DispatchLane>>> lanes_;
     std::atomic<SubscriptionId> next_id_{1};
 };
 
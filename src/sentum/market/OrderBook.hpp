@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <sentum/market/FixedPoint.hpp>
+
+namespace sentum::market {
+
+enum class BookSide : std::uint8_t { Bid, Ask };
+
+struct BookLevel {
+    Price price;
+    Qty quantity;
+};
+
+// Outcome of walking one side of the book for a base quantity.
+struct FillEstimate {
+    double filled_quantity = 0.0;
+    double average_price = 0.0; // volume-weighted over the filled part
+    double worst_price = 0.0;   // price of the last level touched
+    std::size_t levels = 0;
+    bool complete = false;      // the side held the whole quantity
+};
+
+// Price-level (L2) book of one symbol on its tick grid. Each side is one flat, sorted
+// vector with the best level at the back: bids ascend and asks descend. The touch and
+// the n-th level are index lookups, and a diff landing near the touch only moves the
+// few levels behind it. A side keeps at most `max_levels` levels; when full, a new
+// level further out than all of them is dropped and a better one evicts the worst.
+class OrderBook {
+public:
+    static constexpr std::size_t default_max_levels = 5000;
+
+    explicit OrderBook(SymbolScales scales = {}, std::size_t max_levels = default_max_levels)
+        : scales_(scales), max_levels_(std::max<std::size_t>(1, max_levels)) {
+        bids_.reserve(max_levels_);
+        asks_.reserve(max_levels_);
+    }
+
+    void clear() noexcept {
+        bids_.clear();
+        asks_.clear();
+    }
+
+    // Sets the aggregate quantity resting at `price`; zero removes the level. Returns
+    // false when a full side dropped the level.
+    bool set_level(BookSide side, Price price, Qty quantity) {
+        return side == BookSide::Bid ? set<BookSide::Bid>(bids_, price, quantity)
+                                     : set<BookSide::Ask>(asks_, price, quantity);
+    }
+
+    std::size_t depth(BookSide side) const noexcept { return levels(side).size(); }
+    bool empty() const noexcept { return bids_.empty() && asks_.empty(); }
+    std::size_t max_levels() const noexcept { return max_levels_; }
+    const SymbolScales& scales() const noexcept { return scales_; }
+
+    // The n-th best level, 0 being the touch. Requires n < depth(side).
+    const BookLevel& level(BookSide side, std::size_t n) const noexcept {
+        const auto& side_levels = levels(side);
+        return side_levels[side_levels.size() - 1 - n];
+    }
+
+    bool best(BookSide side, BookLevel& out) const noexcept {
+        const auto& side_levels = levels(side);
+        if (side_levels.empty()) return false;
+        out = side_levels.back();
+        return true;
+    }
+
+    bool crossed() const noexcept {
+        return !bids_.empty() && !asks_.empty() && bids_.back().price.raw >= asks_.back().price.raw;
+    }
+
+    double price(const BookLevel& level) const noexcept { return scales_.price.to_double(level.price); }
+    double quantity(const BookLevel& level) const noexcept { return scales_.quantity.to_double(level.quantity); }
+
+    // Base quantity resting in the best `count` levels of `side`.
+    double cumulative_quantity(BookSide side, std::size_t count) const noexcept {
+        const auto& side_levels = levels(side);
+        count = std::min(count, side_levels.size());
+        std::int64_t total = 0;
+        for (std::size_t i = side_levels.size() - count; i < side_levels.size(); ++i) total += side_levels[i].quantity.raw;
+        return scales_.quantity.to_double(Qty{total});
+    }
+
+    // Takes `quantity` from `side` level by level, best first: asks for a buy, bids for a sell.
+    FillEstimate walk(BookSide side, double quantity) const noexcept {
+        FillEstimate estimate;
+        if (!(quantity > 0.0)) return estimate;
+        const auto& side_levels = levels(side);
+        double remaining = quantity;
+        double notional = 0.0;
+        for (auto it = side_levels.rbegin(); it != side_levels.rend() && remaining > 0.0; ++it) {
+            const double level_price = price(*it);
+            const double taken = std::min(this->quantity(*it), remaining);
+            notional += taken * level_price;
+            remaining -= taken;
+            estimate.worst_price = level_price;
+            ++estimate.levels;
+        }
+        estimate.filled_quantity = quantity - remaining;
+        estimate.complete = remaining <= 0.0;
+        if (estimate.filled_quantity > 0.0) estimate.average_price = notional / estimate.filled_quantity;
+        return estimate;
+    }
+
+    // Average price of filling `quantity` against `side`; false when the side is too thin.
+    bool vwap_to_fill(BookSide side, double quantity, double& vwap) const noexcept {
+        const auto estimate = walk(side, quantity);
+        if (!estimate.complete) return false;
+        vwap = estimate.average_price;
+        return true;
+    }
+
+private:
+    static constexpr std::size_t near_touch = 64;
+
+    const std::vector<BookLevel>& levels(BookSide side) const noexcept { return side == BookSide::Bid ? bids_ : asks_; }
+
+    // True when `a` sits further from the touch than `b` on side S.
+    template <BookSide S>
+    static bool worse(Price a, Price b) noexcept { return S == BookSide::Bid ? a.raw < b.raw : a.raw > b.raw; }
+
+    template <BookSide S>
+    bool set(std::vector<BookLevel>& side_levels, Price price, Qty quantity) {
+        // Most updates land near the touch: search the levels behind it first.
+        const auto by_price = [](const BookLevel& level, Price value) { return worse<S>(level.price, value); };
+        auto first = side_levels.begin();
+        if (side_levels.size() > near_touch && worse<S>(side_levels[side_levels.size() - near_touch].price, price))
+            first = side_levels.end() - near_touch;
+        auto it = std::lower_bound(first, side_levels.end(), price, by_price);
+        if (it != side_levels.end() && it->price.raw == price.raw) {
+            if (quantity.raw > 0) it->quantity = quantity;
+            else side_levels.erase(it);
+            return true;
+        }
+        if (quantity.raw <= 0) return true;
+        if (side_levels.size() >= max_levels_) {
+            if (it == side_levels.begin()) return false;
+            const auto index = it - side_levels.begin();
+            side_levels.erase(side_levels.begin());
+            it = side_levels.begin() + (index - 1);
+        }
+        side_levels.insert(it, {price, quantity});
+        return true;
+    }
+
+    SymbolScales scales_;
+    std::size_t max_levels_;
+    std::vector<BookLevel> bids_;
+    std::vector<BookLevel> asks_;
+};
+
+} // namespace sentum::market
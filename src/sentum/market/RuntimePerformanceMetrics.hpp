@@ -1,9 +1,11 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <chrono>
 #include <cstdint>
+#include <string>
 
 #include <nlohmann/json.hpp>
 
@@ -19,6 +21,21 @@ public:
         buckets_[bucket_for(microseconds)].fetch_add(1, std::memory_order_relaxed);
     }
 
+    // Records `count` samples of the same value, e.g. the per-item average of a batch.
+    void observe(std::uint64_t microseconds, std::uint64_t count) noexcept {
+        if (!count) return;
+        count_.fetch_add(count, std::memory_order_relaxed);
+        total_.fetch_add(microseconds * count, std::memory_order_relaxed);
+        auto current = max_.load(std::memory_order_relaxed);
+        while (microseconds > current && !max_.compare_exchange_weak(current, microseconds, std::memory_order_relaxed)) {}
+        buckets_[bucket_for(microseconds)].fetch_add(count, std::memory_order_relaxed);
+    }
+
+    void reset() noexcept {
+        for (auto& bucket : buckets_) bucket.store(0, std::memory_order_relaxed);
+        count_.store(0, std::memory_order_relaxed); total_.store(0, std::memory_order_relaxed); max_.store(0, std::memory_order_relaxed);
+    }
+
     nlohmann::json snapshot() const {
         const auto count = count_.load(std::memory_order_relaxed);
         return {{"count",count},{"avg_us",count ? static_cast<double>(total_.load(std::memory_order_relaxed))/count : 0.0},
@@ -43,36 +60,309 @@ private:
     std::atomic<std::uint64_t> count_{0}, total_{0}, max_{0};
 };
 
+struct CollectorShardMetrics {
+    std::atomic<std::uint64_t> symbols{0};
+    std::atomic<std::uint64_t> events{0};
+    std::atomic<std::uint64_t> reconnects{0};
+    std::atomic<bool> connected{false};
+    LatencyHistogram parse_latency;
+
+    nlohmann::json snapshot() const {
+        return {{"symbols",symbols.load(std::memory_order_relaxed)},{"events_total",events.load(std::memory_order_relaxed)},
+                {"reconnects",reconnects.load(std::memory_order_relaxed)},{"connected",connected.load(std::memory_order_relaxed)},
+                {"parse_latency",parse_latency.snapshot()}};
+    }
+};
+
+struct DispatchLaneMetrics {
+    std::atomic<bool> active{false};
+    std::array<char,32> name{};
+    std::atomic<std::uint8_t> policy{0};
+    std::atomic<std::uint64_t> published{0};
+    std::atomic<std::uint64_t> delivered{0};
+    std::atomic<std::uint64_t> dropped{0};
+    std::atomic<std::uint64_t> conflated{0};
+    std::atomic<std::uint64_t> handler_errors{0};
+    std::atomic<std::uint64_t> depth{0};
+    std::atomic<std::uint64_t> depth_high_water{0};
+    std::atomic<std::uint64_t> last_lag_us{0};
+    LatencyHistogram lag;
+
+    void observe_depth(std::uint64_t value) noexcept {
+        depth.store(value,std::memory_order_relaxed);
+        auto current=depth_high_water.load(std::memory_order_relaxed);
+        while(value>current && !depth_high_water.compare_exchange_weak(current,value,std::memory_order_relaxed)){}
+    }
+    nlohmann::json snapshot() const {
+        static constexpr const char* policies[]={"block","drop_oldest","conflate"};
+        const auto p=policy.load(std::memory_order_relaxed);
+        return {{"name",std::string(name.data())},{"policy",p<3?policies[p]:"unknown"},
+                {"published_total",published.load(std::memory_order_relaxed)},{"delivered_total",delivered.load(std::memory_order_relaxed)},
+                {"dropped_total",dropped.load(std::memory_order_relaxed)},{"conflated_total",conflated.load(std::memory_order_relaxed)},
+                {"handler_errors",handler_errors.load(std::memory_order_relaxed)},{"depth",depth.load(std::memory_order_relaxed)},
+                {"depth_high_water",depth_high_water.load(std::memory_order_relaxed)},{"lag_us",last_lag_us.load(std::memory_order_relaxed)},
+                {"lag",lag.snapshot()}};
+    }
+};
+
+// The shared trade-stream connection (sentum::collector::MarketFeedManager).
+struct MarketFeedMetrics {
+    std::atomic<bool> connected{false};
+    std::atomic<std::uint64_t> streams{0};
+    std::atomic<std::uint64_t> connects{0};
+    std::atomic<std::uint64_t> requests{0}; // SUBSCRIBE/UNSUBSCRIBE frames sent
+    std::atomic<std::uint64_t> trades{0};
+    // From subscribe_trades() to the symbol's first trade, i.e. the cost of a symbol
+    // switch. Milliseconds, beyond the latency histograms' range.
+    std::atomic<std::uint64_t> first_trades{0};
+    std::atomic<std::uint64_t> first_trade_ms_total{0};
+    std::atomic<std::uint64_t> last_first_trade_ms{0};
+
+    void observe_first_trade(std::uint64_t ms) noexcept {
+        first_trades.fetch_add(1,std::memory_order_relaxed);first_trade_ms_total.fetch_add(ms,std::memory_order_relaxed);
+        last_first_trade_ms.store(ms,std::memory_order_relaxed);
+    }
+    nlohmann::json snapshot() const {
+        const auto first=first_trades.load(std::memory_order_relaxed);
+        return {{"connected",connected.load(std::memory_order_relaxed)},{"streams",streams.load(std::memory_order_relaxed)},
+                {"connects",connects.load(std::memory_order_relaxed)},{"requests",requests.load(std::memory_order_relaxed)},
+                {"trades_total",trades.load(std::memory_order_relaxed)},
+                {"first_trade_avg_ms",first?static_cast<double>(first_trade_ms_total.load(std::memory_order_relaxed))/first:0.0},
+                {"first_trade_last_ms",last_first_trade_ms.load(std::memory_order_relaxed)}};
+    }
+};
+
+// Columnar kline archive (KlineArchiveWriter): rows and bytes of the blocks written.
+struct KlineArchiveMetrics {
+    std::atomic<std::uint64_t> rows{0};
+    std::atomic<std::uint64_t> blocks{0};
+    std::atomic<std::uint64_t> stored_bytes{0};
+    std::atomic<std::uint64_t> dropped_rows{0}; // out of order, or symbols too long for a block header
+
+    nlohmann::json snapshot() const {
+        const auto written=rows.load(std::memory_order_relaxed);const auto bytes=stored_bytes.load(std::memory_order_relaxed);
+        return {{"rows",written},{"blocks",blocks.load(std::memory_order_relaxed)},{"stored_bytes",bytes},
+                {"bytes_per_row",written?static_cast<double>(bytes)/written:0.0},{"dropped_rows",dropped_rows.load(std::memory_order_relaxed)}};
+    }
+};
+
+// Collector's SQLite writer and its WAL checkpoint thread. `batch_limit` is the current
+// adaptive batch cap; the wal_* gauges come from the latest checkpoint.
+struct SqliteWriterMetrics {
+    std::atomic<std::uint64_t> batch_limit{0};
+    std::atomic<std::uint64_t> batches{0};
+    std::atomic<std::uint64_t> rows{0};
+    std::atomic<std::uint64_t> failed_batches{0};
+    std::atomic<std::uint64_t> checkpoints{0};
+    std::atomic<std::uint64_t> restarts{0};
+    std::atomic<std::uint64_t> busy_checkpoints{0}; // RESTART gave up on a busy database
+    std::atomic<std::uint64_t> wal_frames{0};
+    std::atomic<std::uint64_t> wal_checkpointed_frames{0};
+    std::atomic<std::uint64_t> wal_bytes{0};
+    std::atomic<std::uint64_t> wal_high_water_bytes{0};
+    LatencyHistogram checkpoint_latency;
+
+    void observe_wal_bytes(std::uint64_t bytes) noexcept {
+        wal_bytes.store(bytes,std::memory_order_relaxed);
+        auto current=wal_high_water_bytes.load(std::memory_order_relaxed);
+        while(bytes>current && !wal_high_water_bytes.compare_exchange_weak(current,bytes,std::memory_order_relaxed)){}
+    }
+    nlohmann::json snapshot() const {
+        return {{"batch_limit",batch_limit.load(std::memory_order_relaxed)},{"batches",batches.load(std::memory_order_relaxed)},
+                {"rows",rows.load(std::memory_order_relaxed)},{"failed_batches",failed_batches.load(std::memory_order_relaxed)},
+                {"checkpoints",checkpoints.load(std::memory_order_relaxed)},{"restarts",restarts.load(std::memory_order_relaxed)},
+                {"busy_checkpoints",busy_checkpoints.load(std::memory_order_relaxed)},{"wal_frames",wal_frames.load(std::memory_order_relaxed)},
+                {"wal_checkpointed_frames",wal_checkpointed_frames.load(std::memory_order_relaxed)},
+                {"wal_bytes",wal_bytes.load(std::memory_order_relaxed)},{"wal_high_water_bytes",wal_high_water_bytes.load(std::memory_order_relaxed)},
+                {"checkpoint_latency",checkpoint_latency.snapshot()}};
+    }
+};
+
+// Collector's overflow file (sentum::collector::KlineSpill). `depth` rows wait on disk for
+// the writer; the oldest of them was spilled at `oldest_spilled_ms` (wall clock, 0 when
+// empty). `rejected` rows found the file full and were dropped.
+struct KlineSpillMetrics {
+    std::atomic<std::uint64_t> spilled{0};
+    std::atomic<std::uint64_t> drained{0};
+    std::atomic<std::uint64_t> recovered{0};
+    std::atomic<std::uint64_t> rejected{0};
+    std::atomic<std::uint64_t> depth{0};
+    std::atomic<std::uint64_t> depth_high_water{0};
+    std::atomic<std::int64_t> oldest_spilled_ms{0};
+    std::atomic<std::uint64_t> file_bytes{0};
+    std::atomic<std::uint64_t> syncs{0};
+    std::atomic<std::uint64_t> write_errors{0};
+    LatencyHistogram sync_latency;
+
+    nlohmann::json snapshot() const {
+        const auto oldest=oldest_spilled_ms.load(std::memory_order_relaxed);
+        const auto now=std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        return {{"spilled",spilled.load(std::memory_order_relaxed)},{"drained",drained.load(std::memory_order_relaxed)},
+                {"recovered",recovered.load(std::memory_order_relaxed)},{"rejected",rejected.load(std::memory_order_relaxed)},
+                {"depth",depth.load(std::memory_order_relaxed)},{"depth_high_water",depth_high_water.load(std::memory_order_relaxed)},
+                {"backlog_age_ms",oldest>0?std::max<std::int64_t>(0,now-oldest):0},{"file_bytes",file_bytes.load(std::memory_order_relaxed)},
+                {"syncs",syncs.load(std::memory_order_relaxed)},{"write_errors",write_errors.load(std::memory_order_relaxed)},
+                {"sync_latency",sync_latency.snapshot()}};
+    }
+};
+
+// Placement of a thread tuned by sentum::runtime::apply_thread_tuning. Cores are kept as
+// a mask of the first 64 CPUs; `pinned` and `realtime` report what the kernel granted.
+struct ThreadPlacementMetrics {
+    std::atomic<bool> active{false};
+    std::array<char,16> name{};
+    std::atomic<std::uint64_t> core_mask{0};
+    std::atomic<bool> pinned{false};
+    std::atomic<bool> realtime{false};
+    std::atomic<bool> busy_poll{false};
+
+    nlohmann::json snapshot() const {
+        nlohmann::json cores=nlohmann::json::array();
+        const auto mask=core_mask.load(std::memory_order_relaxed);
+        for(int core=0;core<64;++core) if(mask>>core&1u) cores.push_back(core);
+        return {{"name",std::string(name.data())},{"cores",cores},{"pinned",pinned.load(std::memory_order_relaxed)},
+                {"realtime",realtime.load(std::memory_order_relaxed)},{"busy_poll",busy_poll.load(std::memory_order_relaxed)}};
+    }
+};
+
+// Startup cost: the SQLite warm start and the time from engine start until the scanner
+// first has a ranking (-1 until then).
+struct StartupMetrics {
+    std::atomic<std::int64_t> started_ns{0};
+    std::atomic<std::int64_t> time_to_valid_signal_ms{-1};
+    std::atomic<std::uint64_t> warm_start_ms{0};
+    std::atomic<std::uint64_t> warm_start_symbols{0};
+    std::atomic<std::uint64_t> warm_start_klines{0};
+    std::atomic<std::uint64_t> snapshot_load_ms{0};
+    std::atomic<std::uint64_t> snapshot_symbols{0};
+
+    void mark_started() noexcept {
+        time_to_valid_signal_ms.store(-1,std::memory_order_relaxed);
+        started_ns.store(steady_ns(),std::memory_order_release);
+    }
+    void observe_valid_signal() noexcept {
+        if(time_to_valid_signal_ms.load(std::memory_order_relaxed)>=0)return;
+        const auto started=started_ns.load(std::memory_order_acquire);
+        if(started==0)return;
+        std::int64_t expected=-1;
+        time_to_valid_signal_ms.compare_exchange_strong(expected,(steady_ns()-started)/1000000,std::memory_order_relaxed);
+    }
+    nlohmann::json snapshot() const {
+        return {{"time_to_valid_signal_ms",time_to_valid_signal_ms.load(std::memory_order_relaxed)},
+                {"warm_start_ms",warm_start_ms.load(std::memory_order_relaxed)},
+                {"warm_start_symbols",warm_start_symbols.load(std::memory_order_relaxed)},
+                {"warm_start_klines",warm_start_klines.load(std::memory_order_relaxed)},
+                {"snapshot_load_ms",snapshot_load_ms.load(std::memory_order_relaxed)},
+                {"snapshot_symbols",snapshot_symbols.load(std::memory_order_relaxed)}};
+    }
+
+private:
+    static std::int64_t steady_ns() noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+};
+
 class RuntimePerformanceMetrics {
 public:
+    static constexpr std::size_t max_collector_shards = 32;
     static RuntimePerformanceMetrics& global(){static RuntimePerformanceMetrics instance;return instance;}
     LatencyHistogram parse_latency;
     LatencyHistogram event_dispatch_latency;
     LatencyHistogram strategy_decision_latency;
     LatencyHistogram sqlite_batch_latency;
+    LatencyHistogram archive_batch_latency;
+    // Exchange event time (E) to collector receive time of aggTrade frames. Both are
+    // whole milliseconds, so values are multiples of 1000 us and include clock skew.
+    LatencyHistogram feed_lag;
+    // Trade stream frame handed to the decision thread until it dequeues it: the wake-up
+    // cost that busy-polling removes.
+    LatencyHistogram decision_queue_latency;
     std::atomic<std::uint64_t> market_events{0};
     std::atomic<std::uint64_t> queue_high_water{0};
+    std::array<CollectorShardMetrics,max_collector_shards> collector_shards;
+    std::atomic<std::size_t> collector_shard_count{0};
+    static constexpr std::size_t max_dispatch_lanes = 16;
+    std::array<DispatchLaneMetrics,max_dispatch_lanes> dispatch_lanes;
+    StartupMetrics startup;
+    MarketFeedMetrics market_feed;
+    KlineArchiveMetrics kline_archive;
+    SqliteWriterMetrics sqlite_writer;
+    KlineSpillMetrics kline_spill;
+    static constexpr std::size_t max_thread_placements = 48;
+    std::array<ThreadPlacementMetrics,max_thread_placements> thread_placements;
+
+    // Claims a metrics slot for a dispatch lane; null once every slot is in use.
+    DispatchLaneMetrics* acquire_dispatch_lane(const std::string& name,std::uint8_t policy) noexcept {
+        for(auto& lane:dispatch_lanes){
+            bool expected=false;
+            if(!lane.active.compare_exchange_strong(expected,true,std::memory_order_acq_rel))continue;
+            lane.name.fill('\0');name.copy(lane.name.data(),lane.name.size()-1);
+            lane.policy.store(policy,std::memory_order_relaxed);
+            lane.published.store(0,std::memory_order_relaxed);lane.delivered.store(0,std::memory_order_relaxed);
+            lane.dropped.store(0,std::memory_order_relaxed);lane.conflated.store(0,std::memory_order_relaxed);
+            lane.handler_errors.store(0,std::memory_order_relaxed);lane.depth.store(0,std::memory_order_relaxed);
+            lane.depth_high_water.store(0,std::memory_order_relaxed);lane.last_lag_us.store(0,std::memory_order_relaxed);
+            lane.lag.reset();
+            return &lane;
+        }
+        return nullptr;
+    }
+    // Slot of the named thread, claimed on first use; null once every slot is in use.
+    ThreadPlacementMetrics* thread_placement(const std::string& name) noexcept {
+        for(auto& slot:thread_placements) if(slot.active.load(std::memory_order_acquire) && name.compare(slot.name.data())==0) return &slot;
+        for(auto& slot:thread_placements){
+            bool expected=false;
+            if(!slot.active.compare_exchange_strong(expected,true,std::memory_order_acq_rel))continue;
+            slot.name.fill('\0');name.copy(slot.name.data(),slot.name.size()-1);
+            return &slot;
+        }
+        return nullptr;
+    }
+    void release_dispatch_lane(DispatchLaneMetrics* lane) noexcept { if(lane) lane->active.store(false,std::memory_order_release); }
 
     void observe_queue_depth(std::uint64_t depth) noexcept {
         auto current=queue_high_water.load(std::memory_order_relaxed);
         while(depth>current && !queue_high_water.compare_exchange_weak(current,depth,std::memory_order_relaxed)){}
     }
     nlohmann::json snapshot() const {
+        nlohmann::json shards=nlohmann::json::array();
+        const auto shard_count=std::min(collector_shard_count.load(std::memory_order_relaxed),collector_shards.size());
+        for(std::size_t i=0;i<shard_count;++i){auto shard=collector_shards[i].snapshot();shard["shard"]=i;shards.push_back(std::move(shard));}
+        nlohmann::json lanes=nlohmann::json::array();
+        for(const auto& lane:dispatch_lanes) if(lane.active.load(std::memory_order_acquire)) lanes.push_back(lane.snapshot());
+        nlohmann::json threads=nlohmann::json::array();
+        for(const auto& slot:thread_placements) if(slot.active.load(std::memory_order_acquire)) threads.push_back(slot.snapshot());
         return {{"market_events_total",market_events.load(std::memory_order_relaxed)},
                 {"queue_high_water",queue_high_water.load(std::memory_order_relaxed)},
                 {"parse_latency",parse_latency.snapshot()},
                 {"event_dispatch_latency",event_dispatch_latency.snapshot()},
                 {"strategy_decision_latency",strategy_decision_latency.snapshot()},
-                {"sqlite_batch_latency",sqlite_batch_latency.snapshot()}};
+                {"sqlite_batch_latency",sqlite_batch_latency.snapshot()},
+                {"archive_batch_latency",archive_batch_latency.snapshot()},
+                {"feed_lag",feed_lag.snapshot()},
+                {"decision_queue_latency",decision_queue_latency.snapshot()},
+                {"collector_shards",shards},
+                {"dispatch_lanes",lanes},
+                {"threads",threads},
+                {"market_feed",market_feed.snapshot()},
+                {"kline_archive",kline_archive.snapshot()},
+                {"sqlite_writer",sqlite_writer.snapshot()},
+                {"kline_spill",kline_spill.snapshot()},
+                {"startup",startup.snapshot()}};
     }
 };
 
 class ScopedLatency {
 public:
-    explicit ScopedLatency(LatencyHistogram& histogram):histogram_(histogram),start_(std::chrono::steady_clock::now()){}
-    ~ScopedLatency(){const auto us=std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now()-start_).count();histogram_.observe(static_cast<std::uint64_t>(us<0?0:us));}
+    explicit ScopedLatency(LatencyHistogram& histogram,LatencyHistogram* secondary=nullptr):histogram_(histogram),secondary_(secondary),start_(std::chrono::steady_clock::now()){}
+    ~ScopedLatency(){
+        const auto us=std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now()-start_).count();
+        const auto value=static_cast<std::uint64_t>(us<0?0:us);
+        histogram_.observe(value);
+        if(secondary_) secondary_->observe(value);
+    }
 private:
-    LatencyHistogram& histogram_; std::chrono::steady_clock::time_point start_;
+    LatencyHistogram& histogram_; LatencyHistogram* secondary_; std::chrono::steady_clock::time_point start_;
 };
 
 } // namespace sentum::market
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#endif
+
+namespace sentum::market {
+
+// One contiguous, zero-filled reservation for column data. On POSIX the range is mapped
+// lazily, so untouched symbols cost address space but no memory. With huge pages
+// requested it first tries explicit 2 MiB pages (MAP_HUGETLB, reserved up front from the
+// kernel pool) and otherwise asks for transparent huge pages on the regular mapping.
+class SlabArena {
+public:
+    static constexpr std::size_t huge_page_size = std::size_t{2} << 20;
+
+    SlabArena(std::size_t bytes, bool huge_pages) : size_(round_up(bytes == 0 ? 1 : bytes, huge_page_size)) {
+#if !defined(_WIN32)
+#if defined(MAP_HUGETLB)
+        if (huge_pages) {
+            void* mapped = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (mapped != MAP_FAILED) { data_ = static_cast<std::byte*>(mapped); huge_pages_ = true; mapped_ = true; return; }
+        }
+#endif
+        void* mapped = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (mapped == MAP_FAILED) throw std::bad_alloc();
+        data_ = static_cast<std::byte*>(mapped);
+        mapped_ = true;
+#if defined(MADV_HUGEPAGE)
+        if (huge_pages) huge_pages_ = ::madvise(mapped, size_, MADV_HUGEPAGE) == 0;
+#endif
+#else
+        (void)huge_pages;
+        data_ = static_cast<std::byte*>(std::calloc(size_, 1));
+        if (!data_) throw std::bad_alloc();
+#endif
+    }
+
+    ~SlabArena() {
+#if !defined(_WIN32)
+        if (mapped_) ::munmap(data_, size_);
+#else
+        std::free(data_);
+#endif
+    }
+
+    SlabArena(const SlabArena&) = delete;
+    SlabArena& operator=(const SlabArena&) = delete;
+
+    std::byte* data() const noexcept { return data_; }
+    std::size_t size() const noexcept { return size_; }
+    // True when huge pages were granted (explicitly or via the THP advice).
+    bool huge_pages() const noexcept { return huge_pages_; }
+
+    // Replaces the whole range with a private, copy-on-write mapping of `fd` from `offset`
+    // (page aligned); pages are then read from the file on first touch. Refused for huge
+    // pages, which a file mapping would give up. On failure the range is zero-filled
+    // again, so only call it before the arena holds data.
+    bool adopt(int fd, std::size_t offset) noexcept {
+#if !defined(_WIN32)
+        if (!mapped_ || huge_pages_) return false;
+        if (::mmap(data_, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, static_cast<off_t>(offset)) != MAP_FAILED) return true;
+        ::mmap(data_, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0);
+#else
+        (void)fd; (void)offset;
+#endif
+        return false;
+    }
+
+    static std::size_t round_up(std::size_t value, std::size_t alignment) noexcept {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+private:
+    std::size_t size_;
+    std::byte* data_ = nullptr;
+    bool huge_pages_ = false;
+    bool mapped_ = false;
+};
+
+} // namespace sentum::market
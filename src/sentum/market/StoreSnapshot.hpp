@@ -0,0 +1,178 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace sentum::market {
+
+// First bytes of a MarketDataStore snapshot (see MarketDataStore::save_snapshot). The
+// header is followed by one record per series, and the slab arena follows byte for byte
+// from `data_offset`, a huge-page boundary. Only the slots of the saved series are
+// written; the rest of the image is a hole in a sparse file. Values are stored in native
+// byte order, so a snapshot is only read on the kind of machine that wrote it.
+struct StoreSnapshotHeader {
+    static constexpr char expected_magic[8] = {'S', 'N', 'T', 'M', 'S', 'N', 'A', 'P'};
+    static constexpr std::uint32_t current_version = 1;
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t record_bytes;
+    std::uint64_t capacity_per_symbol;
+    std::uint64_t max_symbols;
+    std::uint64_t rollup_capacity;
+    std::uint64_t tape_capacity;
+    std::uint64_t arena_bytes;
+    std::uint64_t slot_limit;
+    std::uint64_t series_count;
+    std::uint64_t data_offset;
+    std::int64_t written_ms;
+    // StoreSnapshotChecksum over each record followed by its series' slots in every column.
+    std::uint64_t checksum;
+};
+
+// Four-lane multiply-rotate checksum (the xxHash64 round), fast enough to verify the
+// written columns on every load. It catches torn and truncated files, not tampering.
+// Blocks are mixed in the order they are passed, so writer and reader must split the
+// data identically.
+class StoreSnapshotChecksum {
+public:
+    void update(const void* data, std::size_t bytes) noexcept {
+        const auto* p = static_cast<const unsigned char*>(data);
+        total_ += bytes;
+        for (; bytes >= 32; p += 32, bytes -= 32) {
+            for (int lane = 0; lane < 4; ++lane) lanes_[lane] = round(lanes_[lane], load(p + lane * 8));
+        }
+        for (; bytes >= 8; p += 8, bytes -= 8) lanes_[0] = round(lanes_[0], load(p));
+        if (bytes > 0) {
+            std::uint64_t tail = 0;
+            std::memcpy(&tail, p, bytes);
+            lanes_[1] = round(lanes_[1], tail);
+        }
+    }
+
+    std::uint64_t value() const noexcept {
+        std::uint64_t hash = rotl(lanes_[0], 1) + rotl(lanes_[1], 7) + rotl(lanes_[2], 12) + rotl(lanes_[3], 18) + total_;
+        hash ^= hash >> 33;
+        hash *= prime2;
+        hash ^= hash >> 29;
+        hash *= prime3;
+        return hash ^ (hash >> 32);
+    }
+
+private:
+    static constexpr std::uint64_t prime1 = 0x9E3779B185EBCA87ULL;
+    static constexpr std::uint64_t prime2 = 0xC2B2AE3D27D4EB4FULL;
+    static constexpr std::uint64_t prime3 = 0x165667B19E3779F9ULL;
+
+    static std::uint64_t rotl(std::uint64_t value, int bits) noexcept { return (value << bits) | (value >> (64 - bits)); }
+    static std::uint64_t round(std::uint64_t lane, std::uint64_t input) noexcept { return rotl(lane + input * prime2, 31) * prime1; }
+    static std::uint64_t load(const unsigned char* p) noexcept {
+        std::uint64_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    std::uint64_t lanes_[4] = {prime1 + prime2, prime2, 0, 0 - prime1};
+    std::uint64_t total_ = 0;
+};
+
+// A snapshot file. It is written with positional writes, not through a shared mapping: a
+// write fault dirties a whole (possibly huge) page-cache folio and would fill the holes
+// of the sparse image. For loading it is mapped whole, read-only and private, and the
+// descriptor stays open so the arena image can be mapped a second time. Unmapped and
+// closed on destruction.
+class StoreSnapshotFile {
+public:
+    StoreSnapshotFile() = default;
+    ~StoreSnapshotFile() { close(); }
+    StoreSnapshotFile(const StoreSnapshotFile&) = delete;
+    StoreSnapshotFile& operator=(const StoreSnapshotFile&) = delete;
+
+    // Creates (or truncates) `path` as a sparse file of `bytes`.
+    bool create(const std::string& path, std::size_t bytes) {
+#if !defined(_WIN32)
+        close();
+        fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd_ < 0) return false;
+        if (::ftruncate(fd_, static_cast<off_t>(bytes)) != 0) { close(); return false; }
+        size_ = bytes;
+        return true;
+#else
+        (void)path; (void)bytes;
+        return false;
+#endif
+    }
+
+    bool write(std::size_t offset, const void* data, std::size_t bytes) noexcept {
+#if !defined(_WIN32)
+        const auto* p = static_cast<const char*>(data);
+        while (bytes > 0) {
+            const auto written = ::pwrite(fd_, p, bytes, static_cast<off_t>(offset));
+            if (written < 0 && errno == EINTR) continue;
+            if (written <= 0) return false;
+            p += written;
+            offset += static_cast<std::size_t>(written);
+            bytes -= static_cast<std::size_t>(written);
+        }
+        return true;
+#else
+        (void)offset; (void)data; (void)bytes;
+        return false;
+#endif
+    }
+
+    bool open(const std::string& path) {
+#if !defined(_WIN32)
+        close();
+        fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd_ < 0) return false;
+        struct stat status {};
+        if (::fstat(fd_, &status) != 0 || status.st_size <= 0) { close(); return false; }
+        return map(static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE);
+#else
+        (void)path;
+        return false;
+#endif
+    }
+
+    void close() noexcept {
+#if !defined(_WIN32)
+        if (data_) ::munmap(data_, size_);
+        if (fd_ >= 0) ::close(fd_);
+#endif
+        data_ = nullptr;
+        size_ = 0;
+        fd_ = -1;
+    }
+
+    std::byte* data() const noexcept { return data_; }
+    std::size_t size() const noexcept { return size_; }
+    int fd() const noexcept { return fd_; }
+
+private:
+#if !defined(_WIN32)
+    bool map(std::size_t bytes, int protection, int flags) {
+        void* mapped = ::mmap(nullptr, bytes, protection, flags, fd_, 0);
+        if (mapped == MAP_FAILED) { close(); return false; }
+        data_ = static_cast<std::byte*>(mapped);
+        size_ = bytes;
+        return true;
+    }
+#endif
+
+    std::byte* data_ = nullptr;
+    std::size_t size_ = 0;
+    int fd_ = -1;
+};
+
+} // namespace sentum::market
@@ -0,0 +1,288 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <sentum/market/SymbolId.hpp>
+
+namespace sentum::market {
+
+// Resolves exchange symbols to dense SymbolId values through a minimal perfect hash
+// (hash-and-displace, in the CHD/PTHash family) built over the current universe.
+//
+// Lookups are lock free. Symbols interned after a build go to an append-only side set
+// in the published table, probed only when the perfect hash misses; once the side set
+// holds half as many symbols as the hash, the table is rebuilt over all of them and
+// published atomically. Rebuilds therefore happen each time the universe grows by half,
+// and the superseded tables, kept alive for the interner's lifetime so readers never
+// need a lock, add up to a small multiple of the current one. Ids are assigned in
+// insertion order, start at 1 and never change, so they can index flat per-symbol arrays.
+class SymbolInterner {
+public:
+    static constexpr std::size_t max_symbol_length = 32;
+
+    static SymbolInterner& global() {
+        static SymbolInterner instance;
+        return instance;
+    }
+
+    SymbolInterner() { publish(Table::build(names_)); }
+
+    // Resolves a symbol that is already upper case, as Binance sends it: one hash, one
+    // displacement lookup and one memcmp, plus a side-set probe for symbols interned
+    // since the last rebuild.
+    SymbolId find(std::string_view symbol) const noexcept {
+        return table_.load(std::memory_order_acquire)->find(symbol);
+    }
+
+    // Resolves a symbol in any case, e.g. a lowercase stream name.
+    SymbolId find_folded(std::string_view symbol) const noexcept {
+        char upper[max_symbol_length];
+        if (!fold(symbol, upper)) return kInvalidSymbolId;
+        return find(std::string_view(upper, symbol.size()));
+    }
+
+    SymbolId intern(std::string_view symbol) {
+        if (const auto id = find_folded(symbol); id != kInvalidSymbolId) return id;
+        std::vector<std::string> single{std::string(symbol)};
+        return intern_all(single).front();
+    }
+
+    // Adds every missing symbol, rebuilding the table at most once. Returns the ids in
+    // input order.
+    std::vector<SymbolId> intern_all(const std::vector<std::string>& symbols) {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        std::vector<SymbolId> ids;
+        ids.reserve(symbols.size());
+        const auto first_added = names_.size();
+        for (const auto& symbol : symbols) {
+            char upper[max_symbol_length];
+            if (symbol.empty() || !fold(symbol, upper)) throw std::invalid_argument("Invalid symbol: " + symbol);
+            std::string name(upper, symbol.size());
+            auto [it, inserted] = ids_by_name_.emplace(name, static_cast<SymbolId>(names_.size() + 1));
+            if (inserted) names_.push_back(std::move(name));
+            ids.push_back(it->second);
+        }
+        const auto added = names_.size() - first_added;
+        if (added == 0) return ids;
+        auto& table = *tables_.back();
+        if (table.late_count.load(std::memory_order_relaxed) + added > table.late_limit()) {
+            publish(Table::build(names_));
+        } else {
+            for (auto i = first_added; i < names_.size(); ++i)
+                table.add_late(late_.emplace_back(Late{names_[i], static_cast<SymbolId>(i + 1)}));
+            version_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return ids;
+    }
+
+    // Upper-case name of an interned id, or an empty view.
+    std::string_view name(SymbolId id) const noexcept { return table_.load(std::memory_order_acquire)->name(id); }
+    std::size_t size() const noexcept { return table_.load(std::memory_order_acquire)->size(); }
+    // Bumped whenever symbols are added.
+    std::uint64_t version() const noexcept { return version_.load(std::memory_order_relaxed); }
+
+    // Hash shared by the table build and lookups: eight bytes per step, then a finalizer.
+    static std::uint64_t hash(std::string_view value, std::uint64_t seed) noexcept {
+        std::uint64_t h = seed ^ (static_cast<std::uint64_t>(value.size()) * 0x9E3779B97F4A7C15ULL);
+        const char* p = value.data();
+        std::size_t n = value.size();
+        while (n >= 8) {
+            std::uint64_t word;
+            std::memcpy(&word, p, sizeof(word));
+            h = (h ^ word) * 0xBF58476D1CE4E5B9ULL;
+            h ^= h >> 29;
+            p += 8; n -= 8;
+        }
+        if (n) {
+            std::uint64_t word = 0;
+            std::memcpy(&word, p, n);
+            h = (h ^ word) * 0xBF58476D1CE4E5B9ULL;
+        }
+        return mix(h);
+    }
+
+private:
+    struct Slot {
+        std::uint32_t offset = 0;
+        std::uint32_t length = 0;
+        SymbolId id = kInvalidSymbolId;
+    };
+
+    // A symbol interned after the current table was built. Lives in `late_`, a deque, so
+    // it never moves; `name` views the equally stable entry in `names_`.
+    struct Late {
+        std::string_view name;
+        SymbolId id = kInvalidSymbolId;
+    };
+
+    struct Table {
+        static constexpr std::uint64_t late_seed = 0x13198A2E03707344ULL;
+
+        std::uint64_t seed = 0x243F6A8885A308D3ULL;
+        std::vector<std::uint32_t> displacements;
+        std::vector<Slot> slots;
+        std::vector<Slot> by_id;
+        std::string pool;
+        // Side set: linear probing over a power-of-two array, written under the interner's
+        // write mutex and never more than half full. late_by_id holds late_limit() entries
+        // for the ids that follow by_id.
+        std::size_t late_capacity = 0;
+        std::unique_ptr<std::atomic<const Late*>[]> late_slots;
+        std::unique_ptr<std::atomic<const Late*>[]> late_by_id;
+        std::atomic<std::size_t> late_count{0};
+
+        SymbolId find(std::string_view symbol) const noexcept {
+            if (!slots.empty()) {
+                const auto h = hash(symbol, seed);
+                const auto& slot = slots[position(h, displacements[reduce(h >> 32, displacements.size())], slots.size())];
+                if (slot.length == symbol.size() && std::memcmp(pool.data() + slot.offset, symbol.data(), symbol.size()) == 0) return slot.id;
+            }
+            if (late_count.load(std::memory_order_acquire) == 0) return kInvalidSymbolId;
+            for (auto i = hash(symbol, late_seed) & (late_capacity - 1);; i = (i + 1) & (late_capacity - 1)) {
+                const auto* late = late_slots[i].load(std::memory_order_acquire);
+                if (!late) return kInvalidSymbolId;
+                if (late->name == symbol) return late->id;
+            }
+        }
+
+        std::string_view name(SymbolId id) const noexcept {
+            if (id == kInvalidSymbolId) return {};
+            if (id < by_id.size()) return std::string_view(pool.data() + by_id[id].offset, by_id[id].length);
+            const auto index = static_cast<std::size_t>(id - by_id.size());
+            if (index >= late_limit()) return {};
+            const auto* late = late_by_id[index].load(std::memory_order_acquire);
+            return late ? late->name : std::string_view{};
+        }
+
+        std::size_t size() const noexcept { return slots.size() + late_count.load(std::memory_order_acquire); }
+        std::size_t late_limit() const noexcept { return late_capacity / 2; }
+
+        // Writer only. `late.id` is the id after every symbol already in the table.
+        void add_late(const Late& late) noexcept {
+            auto i = hash(late.name, late_seed) & (late_capacity - 1);
+            while (late_slots[i].load(std::memory_order_relaxed)) i = (i + 1) & (late_capacity - 1);
+            late_slots[i].store(&late, std::memory_order_release);
+            late_by_id[late.id - by_id.size()].store(&late, std::memory_order_release);
+            late_count.fetch_add(1, std::memory_order_release);
+        }
+
+        static std::unique_ptr<Table> build(const std::deque<std::string>& names) {
+            auto table = std::make_unique<Table>();
+            table->by_id.resize(names.size() + 1);
+            for (std::size_t i = 0; i < names.size(); ++i) {
+                table->by_id[i + 1] = {static_cast<std::uint32_t>(table->pool.size()), static_cast<std::uint32_t>(names[i].size()),
+                                       static_cast<SymbolId>(i + 1)};
+                table->pool += names[i];
+            }
+            // Room for half as many late symbols as the table holds, and at least 32.
+            table->late_capacity = 64;
+            while (table->late_capacity < names.size()) table->late_capacity *= 2;
+            table->late_slots = std::make_unique<std::atomic<const Late*>[]>(table->late_capacity);
+            table->late_by_id = std::make_unique<std::atomic<const Late*>[]>(table->late_limit());
+            for (std::size_t i = 0; i < table->late_capacity; ++i) table->late_slots[i].store(nullptr, std::memory_order_relaxed);
+            for (std::size_t i = 0; i < table->late_limit(); ++i) table->late_by_id[i].store(nullptr, std::memory_order_relaxed);
+            // Average bucket size of four keeps displacement search short while the
+            // displacement array stays at one 32-bit word per four symbols.
+            const std::size_t bucket_count = std::max<std::size_t>(1, (names.size() + 3) / 4);
+            for (std::uint64_t attempt = 0;; ++attempt) {
+                table->seed = mix(0x243F6A8885A308D3ULL + attempt);
+                if (table->place(names, bucket_count)) return table;
+                if (attempt == 64) throw std::runtime_error("SymbolInterner could not build a perfect hash");
+            }
+        }
+
+        bool place(const std::deque<std::string>& names, std::size_t bucket_count) {
+            const std::size_t n = names.size();
+            std::vector<std::vector<std::uint32_t>> buckets(bucket_count);
+            std::vector<std::uint64_t> hashes(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                hashes[i] = hash(names[i], seed);
+                buckets[reduce(hashes[i] >> 32, bucket_count)].push_back(static_cast<std::uint32_t>(i));
+            }
+            std::vector<std::uint32_t> order(bucket_count);
+            for (std::uint32_t b = 0; b < bucket_count; ++b) order[b] = b;
+            std::stable_sort(order.begin(), order.end(), [&](std::uint32_t a, std::uint32_t b) { return buckets[a].size() > buckets[b].size(); });
+
+            displacements.assign(bucket_count, 0);
+            slots.assign(n, Slot{});
+            std::vector<bool> taken(n, false);
+            std::vector<std::size_t> positions;
+            constexpr std::uint32_t max_displacement = 1u << 22;
+            for (const auto b : order) {
+                const auto& keys = buckets[b];
+                if (keys.empty()) break;
+                bool placed = false;
+                for (std::uint32_t d = 0; d < max_displacement && !placed; ++d) {
+                    positions.clear();
+                    placed = true;
+                    for (const auto key : keys) {
+                        const auto pos = position(hashes[key], d, n);
+                        if (taken[pos] || std::find(positions.begin(), positions.end(), pos) != positions.end()) { placed = false; break; }
+                        positions.push_back(pos);
+                    }
+                    if (!placed) continue;
+                    displacements[b] = d;
+                    for (std::size_t k = 0; k < keys.size(); ++k) {
+                        taken[positions[k]] = true;
+                        slots[positions[k]] = by_id[keys[k] + 1];
+                    }
+                }
+                if (!placed) return false;
+            }
+            return true;
+        }
+    };
+
+    static std::uint64_t mix(std::uint64_t x) noexcept {
+        x ^= x >> 30; x *= 0xBF58476D1CE4E5B9ULL;
+        x ^= x >> 27; x *= 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+    // Maps a 32-bit value onto [0, n) with a multiply instead of a division.
+    static std::size_t reduce(std::uint64_t value, std::size_t n) noexcept {
+        return static_cast<std::size_t>(((value & 0xFFFFFFFFULL) * static_cast<std::uint64_t>(n)) >> 32);
+    }
+
+    static std::size_t position(std::uint64_t h, std::uint32_t displacement, std::size_t n) noexcept {
+        return reduce(mix(h ^ (static_cast<std::uint64_t>(displacement) * 0x9E3779B97F4A7C15ULL)), n);
+    }
+
+    static bool fold(std::string_view symbol, char* out) noexcept {
+        if (symbol.size() > max_symbol_length) return false;
+        for (std::size_t i = 0; i < symbol.size(); ++i) {
+            char c = symbol[i];
+            if (c >= 'a' && c <= 'z') c = static_cast<char>(c - 'a' + 'A');
+            out[i] = c;
+        }
+        return true;
+    }
+
+    void publish(std::unique_ptr<Table> table) {
+        table_.store(table.get(), std::memory_order_release);
+        tables_.push_back(std::move(table));
+        version_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::atomic<const Table*> table_{nullptr};
+    std::atomic<std::uint64_t> version_{0};
+    std::mutex write_mutex_;
+    std::vector<std::unique_ptr<Table>> tables_;
+    std::deque<std::string> names_;
+    std::deque<Late> late_;
+    std::unordered_map<std::string, SymbolId> ids_by_name_;
+};
+
+} // namespace sentum::market
@@ -10,13 +10,15 @@
 #include <mutex>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <nlohmann/json.hpp>
 #include <sqlite3.h>
 
-#include <sentum/api/BinanceWebsocketClient.hpp>
 #include <sentum/backtest/Backtest.hpp>
+#include <sentum/collector/MarketFeedManager.hpp>
+#include <sentum/market/MarketEventBus.hpp>
 #include <sentum/research/ExperimentManager.hpp>
 #include <sentum/time/Clock.hpp>
 #include <sentum/trader/TradeEngine.hpp>
@@ -201,18 +203,19 @@ public:
         : definition_(std::move(definition)), risk_(std::move(risk)), registry_path_(std::move(registry_path)),
           clock_(std::make_shared<SystemClock>()),
           engine_(definition_.symbol,risk_,clock_,sentum::strategy::StrategyFactory::create(definition_.strategy),shadow_db_path()),
-          stream_(definition_.symbol) {}
+          symbol_id_(sentum::market::SymbolInterner::global().intern(definition_.symbol)) {}
 
     void start() {
         if(running_.exchange(true)) return;
         started_at_ms_=sentum::research::unix_ms_now();
-        stream_.set_on_price([this](double price){if(!running_.load())return; MarketEvent e;e.type=MarketEvent::Type::Trade;e.symbol=definition_.symbol;e.price=price;e.close=price;e.timestamp=clock_->now();std::lock_guard<std::mutex> lock(mutex_);engine_.process_event(e);});
-        stream_.start();
+        subscription_=sentum::market::MarketEventBus::global().subscribe<&ShadowTradingSession::on_market_event>(*this);
+        feed_=sentum::collector::MarketFeedManager::global().subscribe_trades(definition_.symbol);
     }
 
     StageEvidence stop() {
         if(!running_.exchange(false)) return last_;
-        stream_.stop();
+        feed_.reset();
+        sentum::market::MarketEventBus::global().unsubscribe(std::exchange(subscription_,0));
         std::lock_guard<std::mutex> lock(mutex_);
         const auto metrics=MetricsCalculator::calculate(engine_.completed_trades());
         last_=evidence_from_metrics("shadow",metrics,started_at_ms_,sentum::research::unix_ms_now(),shadow_db_path());
@@ -222,9 +225,10 @@ public:
     }
     ~ShadowTradingSession(){try{stop();}catch(...){}}
 private:
+    void on_market_event(const MarketEvent&e){if(e.type!=MarketEvent::Type::Trade||e.symbol_id!=symbol_id_||!running_.load())return;std::lock_guard<std::mutex> lock(mutex_);engine_.process_event(e);}
     std::string shadow_db_path() const {std::filesystem::create_directories("log/shadow");return "log/shadow/"+definition_.model_id+".sqlite3";}
     void write_report(const StageEvidence&e)const{nlohmann::json j{{"model_id",definition_.model_id},{"stage",e.stage},{"started_at_ms",e.started_at_ms},{"finished_at_ms",e.finished_at_ms},{"trades",e.trades},{"net_profit",e.net_profit},{"max_drawdown",e.max_drawdown},{"profit_factor",e.profit_factor},{"win_rate",e.win_rate},{"expectancy",e.expectancy},{"sharpe",e.sharpe},{"sortino",e.sortino},{"artifact",e.artifact}};std::ofstream("log/shadow/"+definition_.model_id+"-latest.json")<<j.dump(2)<<'\n';}
-    ModelDefinition definition_;RiskConfig risk_;std::string registry_path_;std::shared_ptr<SystemClock> clock_;TradeEngine engine_;BinanceWebsocketClient stream_;std::atomic<bool> running_{false};std::mutex mutex_;std::int64_t started_at_ms_=0;StageEvidence last_;
+    ModelDefinition definition_;RiskConfig risk_;std::string registry_path_;std::shared_ptr<SystemClock> clock_;TradeEngine engine_;sentum::market::SymbolId symbol_id_;sentum::market::MarketEventBus::SubscriptionId subscription_=0;sentum::collector::TradeSubscription feed_;std::atomic<bool> running_{false};std::mutex mutex_;std::int64_t started_at_ms_=0;StageEvidence last_;
 };
 
 } // namespace sentum::promotion
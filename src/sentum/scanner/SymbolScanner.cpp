@@ -1,17 +1,33 @@
 #include <algorithm>
 #include <cmath>
+#include <limits>
 
+#include <sentum/market/RuntimePerformanceMetrics.hpp>
 #include <sentum/scanner/SymbolScanner.hpp>
+#include <sentum/utils/helper.hpp>
 
 constexpr double ROUND_FACTOR = 1e8;
 
+namespace {
+// The interner keeps Binance's upper-case names; the trader, order ids and trade history
+// use the collector's lower-case form.
+std::string canonical_name(sentum::market::SymbolId id) {
+    return helper::to_lowercase(std::string(sentum::market::SymbolInterner::global().name(id)));
+}
+}
+
 SymbolScanner::SymbolScanner(Database&, double threshold)
     : SymbolScanner(MarketDataStore::global(), threshold) {}
 
 SymbolScanner::SymbolScanner(MarketDataStore& store_, double threshold)
     : store(store_), min_return_threshold(threshold) {
-    subscription_id_ = sentum::market::MarketEventBus::global().subscribe(
-        [this](const MarketEvent& event) { on_market_event(event); });
+    // Ranking only needs the latest candle per symbol, so a slow scan conflates instead of
+    // stalling the collector.
+    sentum::market::LaneOptions lane;
+    lane.name = "scanner";
+    lane.policy = sentum::market::OverflowPolicy::Conflate;
+    lane.event_types = MarketEvent::type_mask(MarketEvent::Type::Candle);
+    subscription_id_ = sentum::market::MarketEventBus::global().subscribe<&SymbolScanner::on_market_event>(*this, std::move(lane));
 }
 
 SymbolScanner::~SymbolScanner() {
@@ -23,36 +39,63 @@ void SymbolScanner::set_top_changed_handler(TopChangedHandler handler) {
     top_changed_handler_ = std::move(handler);
 }
 
-void SymbolScanner::update_cache(const MarketEvent& event, std::size_t lookback,
-                                 std::unordered_map<std::string, double>& cache) {
-    double value = 0.0;
-    const bool available = event.symbol_id != sentum::market::kInvalidSymbolId
-        ? store.cumulative_return(event.symbol_id, lookback, value)
-        : store.cumulative_return(event.symbol, lookback, value);
-    if (!available) return;
-    cache[event.symbol] = std::round(value * ROUND_FACTOR) / ROUND_FACTOR;
+bool SymbolScanner::load_return(sentum::market::SymbolId id, std::size_t lookback, double& value) const {
+    if (!store.cumulative_return(id, lookback, value)) return false;
+    value = std::round(value * ROUND_FACTOR) / ROUND_FACTOR;
+    return true;
 }
 
-void SymbolScanner::on_market_event(const MarketEvent& event) {
-    if (event.symbol.empty() || !event.closed) return;
+bool SymbolScanner::update_top(SymbolPerformance& top, TopChangedHandler& handler) {
+    for (const auto& cached : returns_) {
+        if (!cached.has_30 || cached.return_30 <= min_return_threshold) continue;
+        if (top.symbol.empty() || cached.return_30 > top.cum_return) top = {cached.symbol, cached.return_30};
+    }
+    if (top.symbol.empty()) return false;
+    sentum::market::RuntimePerformanceMetrics::global().startup.observe_valid_signal();
+    if (top.symbol == last_top_symbol_) return false;
+    last_top_symbol_ = top.symbol;
+    handler = top_changed_handler_;
+    return true;
+}
 
+void SymbolScanner::seed() {
     TopChangedHandler handler;
     SymbolPerformance top;
     bool changed = false;
     {
         std::lock_guard<std::mutex> lock(cache_mutex_);
-        update_cache(event, 30, returns_30_);
-        update_cache(event, 60, returns_60_);
-
-        for (const auto& [symbol, value] : returns_30_) {
-            if (value <= min_return_threshold) continue;
-            if (top.symbol.empty() || value > top.cum_return) top = {symbol, value};
-        }
-        if (!top.symbol.empty() && top.symbol != last_top_symbol_) {
-            last_top_symbol_ = top.symbol;
-            handler = top_changed_handler_;
-            changed = true;
+        store.cumulative_returns(30, seed_30_);
+        store.cumulative_returns(60, seed_60_);
+        if (returns_.size() < seed_30_.size()) returns_.resize(seed_30_.size());
+        for (std::size_t id = 1; id < seed_30_.size(); ++id) {
+            auto& entry = returns_[id];
+            const double return_30 = seed_30_[id];
+            const double return_60 = id < seed_60_.size() ? seed_60_[id] : std::numeric_limits<double>::quiet_NaN();
+            if (std::isnan(return_30) && std::isnan(return_60)) continue;
+            if (entry.symbol.empty()) entry.symbol = canonical_name(static_cast<sentum::market::SymbolId>(id));
+            if (!std::isnan(return_30)) { entry.return_30 = std::round(return_30 * ROUND_FACTOR) / ROUND_FACTOR; entry.has_30 = true; }
+            if (!std::isnan(return_60)) { entry.return_60 = std::round(return_60 * ROUND_FACTOR) / ROUND_FACTOR; entry.has_60 = true; }
         }
+        changed = update_top(top, handler);
+    }
+    if (changed && handler) handler(top);
+}
+
+void SymbolScanner::on_market_event(const MarketEvent& event) {
+    const auto id = event.symbol_id;
+    if (id == sentum::market::kInvalidSymbolId || !event.closed) return;
+
+    TopChangedHandler handler;
+    SymbolPerformance top;
+    bool changed = false;
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        if (returns_.size() <= id) returns_.resize(static_cast<std::size_t>(id) + 1);
+        auto& entry = returns_[id];
+        if (entry.symbol.empty()) entry.symbol = canonical_name(id);
+        if (load_return(id, 30, entry.return_30)) entry.has_30 = true;
+        if (load_return(id, 60, entry.return_60)) entry.has_60 = true;
+        changed = update_top(top, handler);
     }
     if (changed && handler) handler(top);
 }
@@ -61,12 +104,36 @@ std::vector<SymbolPerformance> SymbolScanner::fetch_top_performers(int lookback,
     std::vector<SymbolPerformance> result;
     {
         std::lock_guard<std::mutex> lock(cache_mutex_);
-        const auto& cache = lookback <= 30 ? returns_30_ : returns_60_;
-        result.reserve(cache.size());
-        for (const auto& [symbol, cum_return] : cache) {
-            if (cum_return > min_return_threshold) result.push_back({symbol, cum_return});
+        const bool short_window = lookback <= 30;
+        result.reserve(returns_.size());
+        for (const auto& cached : returns_) {
+            if (!(short_window ? cached.has_30 : cached.has_60)) continue;
+            const double cum_return = short_window ? cached.return_30 : cached.return_60;
+            if (cum_return > min_return_threshold) result.push_back({cached.symbol, cum_return});
         }
     }
+    rank(result, max_symbols);
+    return result;
+}
+
+std::vector<SymbolPerformance> SymbolScanner::fetch_top_performers(MarketDataStore::RollupInterval interval, std::size_t lookback, int max_symbols) {
+    std::vector<SymbolPerformance> result;
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        store.rollup_returns(interval, lookback, rollup_returns_);
+        for (std::size_t id = 1; id < rollup_returns_.size(); ++id) {
+            const double value = rollup_returns_[id];
+            if (std::isnan(value)) continue;
+            const double cum_return = std::round(value * ROUND_FACTOR) / ROUND_FACTOR;
+            if (cum_return <= min_return_threshold) continue;
+            result.push_back({std::string(sentum::market::SymbolInterner::global().name(static_cast<sentum::market::SymbolId>(id))), cum_return});
+        }
+    }
+    rank(result, max_symbols);
+    return result;
+}
+
+void SymbolScanner::rank(std::vector<SymbolPerformance>& result, int max_symbols) {
     const std::size_t wanted = max_symbols > 0 ? static_cast<std::size_t>(max_symbols) : result.size();
     if (wanted < result.size()) {
         std::partial_sort(result.begin(), result.begin() + static_cast<std::ptrdiff_t>(wanted), result.end(),
@@ -77,5 +144,4 @@ std::vector<SymbolPerformance> SymbolScanner::fetch_top_performers(int lookback,
             return a.cum_return > b.cum_return;
         });
     }
-    return result;
 }
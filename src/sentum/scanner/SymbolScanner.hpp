@@ -3,7 +3,6 @@
 #include <functional>
 #include <mutex>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 #include <sentum/market/MarketDataStore.hpp>
@@ -24,18 +23,36 @@ public:
     ~SymbolScanner();
 
     void set_top_changed_handler(TopChangedHandler handler);
+    // Fills the return cache from whatever history the store already holds (e.g. after a
+    // warm start), so a top symbol is available before the first live candle closes.
+    void seed();
     std::vector<SymbolPerformance> fetch_top_performers(int lookback = 60, int max_symbols = 5);
+    // Ranks every symbol by its return over the newest `lookback` bars of a store rollup.
+    std::vector<SymbolPerformance> fetch_top_performers(MarketDataStore::RollupInterval interval, std::size_t lookback, int max_symbols = 5);
 
 private:
     void on_market_event(const MarketEvent& event);
-    void update_cache(const MarketEvent& event, std::size_t lookback,
-                      std::unordered_map<std::string, double>& cache);
+    struct CachedReturn {
+        std::string symbol;
+        double return_30 = 0.0;
+        double return_60 = 0.0;
+        bool has_30 = false;
+        bool has_60 = false;
+    };
+
+    bool load_return(sentum::market::SymbolId id, std::size_t lookback, double& value) const;
+    // Picks the top symbol from the cache; on a change, returns true with the handler to
+    // call once the lock is released. Requires cache_mutex_.
+    bool update_top(SymbolPerformance& top, TopChangedHandler& handler);
+    static void rank(std::vector<SymbolPerformance>& result, int max_symbols);
 
     MarketDataStore& store;
     double min_return_threshold;
     mutable std::mutex cache_mutex_;
-    std::unordered_map<std::string, double> returns_30_;
-    std::unordered_map<std::string, double> returns_60_;
+    std::vector<double> rollup_returns_;
+    std::vector<double> seed_30_, seed_60_;
+    // Indexed by interned SymbolId.
+    std::vector<CachedReturn> returns_;
     TopChangedHandler top_changed_handler_;
     std::string last_top_symbol_;
     sentum::market::MarketEventBus::SubscriptionId subscription_id_ = 0;
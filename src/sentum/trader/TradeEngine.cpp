@@ -1,8 +1,11 @@
 #include <chrono>
 #include <stdexcept>
+#include <utility>
 
+#include <sentum/collector/DepthBook.hpp>
 #include <sentum/core/RuntimeControl.hpp>
 #include <sentum/dashboard/DashboardState.hpp>
+#include <sentum/market/MarketDataStore.hpp>
 #include <sentum/market/RuntimePerformanceMetrics.hpp>
 #include <sentum/trader/TradeEngine.hpp>
 #include <sentum/trader/strategy/MomentumStrategy.hpp>
@@ -38,68 +41,98 @@ void TradeEngine::initialize_components() {
     execution_venue->start([](const sentum::order::Snapshot&) {});
 }
 
-void TradeEngine::enqueue_price(double price) {
-    latest_price.store(price, std::memory_order_relaxed);
-    MarketEvent event;
-    event.type = MarketEvent::Type::Trade;
-    event.symbol = symbol;
-    event.timestamp = clock->now();
-    event.price = price;
-    event.close = price;
+void TradeEngine::on_market_event(const MarketEvent& event) {
+    if (event.type != MarketEvent::Type::Trade || event.symbol_id != symbol_id || !running.load(std::memory_order_relaxed)) return;
+    latest_price.store(event.price, std::memory_order_relaxed);
     {
         std::lock_guard<std::mutex> lock(queue_mutex);
         if (price_queue.size() >= max_queue_size) price_queue.pop_front();
-        price_queue.push_back(std::move(event));
+        price_queue.push_back({event, std::chrono::steady_clock::now()});
+        queued_events.store(price_queue.size(), std::memory_order_release);
     }
-    queue_cv.notify_one();
+    // A busy-polling decision thread is not waiting on the condition variable.
+    if (!decision_tuning.busy_poll) queue_cv.notify_one();
+}
+
+bool TradeEngine::next_event(MarketEvent& event) {
+    if (decision_tuning.busy_poll) {
+        sentum::runtime::SpinBackoff backoff;
+        while (running.load(std::memory_order_relaxed) && queued_events.load(std::memory_order_acquire) == 0) backoff.idle();
+    }
+    QueuedEvent queued;
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        if (!decision_tuning.busy_poll) queue_cv.wait(lock, [this] { return !running.load() || !price_queue.empty(); });
+        if (!running.load() && price_queue.empty()) return false;
+        queued = std::move(price_queue.front());
+        price_queue.pop_front();
+        queued_events.store(price_queue.size(), std::memory_order_relaxed);
+    }
+    const auto waited = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - queued.queued).count();
+    sentum::market::RuntimePerformanceMetrics::global().decision_queue_latency.observe(static_cast<std::uint64_t>(waited < 0 ? 0 : waited));
+    event = queued.event;
+    return true;
 }
 
 void TradeEngine::stop() {
     if (!running.exchange(false)) return;
-    if (price_stream) price_stream->stop();
     if (execution_venue) execution_venue->stop();
     queue_cv.notify_all();
 }
 
+void TradeEngine::release_feed() {
+    trade_feed.reset();
+    if (bus_subscription) sentum::market::MarketEventBus::global().unsubscribe(std::exchange(bus_subscription, 0));
+}
+
 void TradeEngine::run() {
     if (!isPaperTrading) throw std::runtime_error("Live trading is disabled until order execution is production-ready");
     if (!api) throw std::runtime_error("Network run requires BinanceRestClient");
     if (running.exchange(true)) return;
     engine_logger.start();
+    if (decision_tuning.active() && !sentum::runtime::apply_thread_tuning("sentum-decision", decision_tuning))
+        engine_logger.log("[WARN] Decision thread: CPU affinity or SCHED_FIFO was refused");
     try {
         if (!runtime_configured_) risk = load_risk_config("config/risk.json");
         initialize_components();
         sentum::dashboard::DashboardState::global().merge({
             {"strategy_name", strategy->name()}, {"entries_paused", sentum::runtime::RuntimeControl::global().entries_paused()}
         });
-        price_stream = std::make_unique<BinanceWebsocketClient>(symbol);
-        price_stream->set_on_price([this](double price) { enqueue_price(price); });
-        price_stream->start();
+        bus_subscription = sentum::market::MarketEventBus::global().subscribe<&TradeEngine::on_market_event>(*this);
+        trade_feed = sentum::collector::MarketFeedManager::global().subscribe_trades(symbol);
         while (running.load()) {
             MarketEvent event;
-            {
-                std::unique_lock<std::mutex> lock(queue_mutex);
-                queue_cv.wait(lock, [this] { return !running.load() || !price_queue.empty(); });
-                if (!running.load() && price_queue.empty()) break;
-                event = std::move(price_queue.front());
-                price_queue.pop_front();
-            }
+            if (!next_event(event)) break;
             process_event(event);
         }
     } catch (...) {
         stop();
+        release_feed();
         engine_logger.stop();
         throw;
     }
-    if (price_stream) price_stream->stop();
+    release_feed();
     if (execution_venue) execution_venue->stop();
     engine_logger.stop();
 }
 
+void TradeEngine::attach_market_data(const MarketDataStore& store) {
+    std::lock_guard<std::mutex> lock(state_mutex);
+    market_store = &store;
+    if (strategy) strategy->attach_market_data(store, symbol_id);
+}
+
 sentum::order::Snapshot TradeEngine::execute(sentum::order::Side side, double quantity, double price,
                                               std::chrono::system_clock::time_point now, const char* purpose) {
     if (!execution_venue) throw std::logic_error("Execution venue is not initialized");
     execution_venue->set_market(price, now);
+    MarketDataStore::TopOfBook book;
+    if (market_store && market_store->top_of_book(symbol_id, book) &&
+        now - std::chrono::system_clock::time_point(std::chrono::milliseconds(book.timestamp)) <= std::chrono::milliseconds(risk.max_data_age_ms))
+        execution_venue->set_quote(book.bid_price, book.ask_price);
+    else execution_venue->clear_quote();
+    // Depth books only exist for the live feed, which is what attaches a market store.
+    execution_venue->set_depth(market_store ? sentum::collector::DepthBooks::global().find(symbol_id) : nullptr);
     sentum::order::Request request;
     request.symbol = symbol;
     request.side = side;
@@ -112,7 +145,7 @@ sentum::order::Snapshot TradeEngine::execute(sentum::order::Side side, double qu
 TradeAction TradeEngine::process_event(const MarketEvent& event) {
     sentum::market::ScopedLatency decision_latency(
         sentum::market::RuntimePerformanceMetrics::global().strategy_decision_latency);
-    if (event.symbol != symbol || event.price <= 0.0) return TradeAction::NONE;
+    if (event.symbol_id != symbol_id || event.price <= 0.0) return TradeAction::NONE;
     const auto age = clock->now() - event.timestamp;
     if (age > std::chrono::milliseconds(risk.max_data_age_ms)) {
         engine_logger.log("[RISK] stale market event rejected");
@@ -174,6 +207,16 @@ TradeAction TradeEngine::evaluate_at(double price, std::chrono::system_clock::ti
         position.lowest_price = fill.average_fill_price;
         position.stop_loss_price = fill.average_fill_price * (1.0 - risk.stop_loss_percent);
         position.take_profit_price = fill.average_fill_price * (1.0 + risk.take_profit_percent);
+        if (exit_price_scale) {
+            position.fixed_point_levels = true;
+            position.price_scale = *exit_price_scale;
+            position.highest_level = position.price_scale.from_double(fill.average_fill_price);
+            const auto levels = risk_manager->exit_levels(position.highest_level, position.price_scale);
+            position.stop_loss_level = levels.stop_loss;
+            position.take_profit_level = levels.take_profit;
+            position.stop_loss_price = position.price_scale.to_double(levels.stop_loss);
+            position.take_profit_price = position.price_scale.to_double(levels.take_profit);
+        }
         position.risk_per_trade = risk.risk_per_trade;
         position.capital_at_risk = risk.max_total_capital * risk.risk_per_trade;
         position.stop_loss_percent = risk.stop_loss_percent;
@@ -186,13 +229,27 @@ TradeAction TradeEngine::evaluate_at(double price, std::chrono::system_clock::ti
         logger.log(position, TradeAction::BUY);
         return TradeAction::BUY;
     }
-    if (price > position.highest_price) {
-        position.highest_price = price;
-        if (position.trailing_sl_enabled) position.stop_loss_price = price * (1.0 - position.trailing_sl_percent);
-    }
     if (price < position.lowest_price) position.lowest_price = price;
-    if (price <= position.stop_loss_price) return close_position(price, "stop_loss", now);
-    if (price >= position.take_profit_price) return close_position(price, "take_profit", now);
+    if (position.fixed_point_levels) {
+        const auto level = position.price_scale.from_double(price);
+        if (level > position.highest_level) {
+            position.highest_level = level;
+            position.highest_price = price;
+            if (position.trailing_sl_enabled) {
+                position.stop_loss_level = RiskManager::trailing_stop(level, position.price_scale, position.trailing_sl_percent);
+                position.stop_loss_price = position.price_scale.to_double(position.stop_loss_level);
+            }
+        }
+        if (level <= position.stop_loss_level) return close_position(price, "stop_loss", now);
+        if (level >= position.take_profit_level) return close_position(price, "take_profit", now);
+    } else {
+        if (price > position.highest_price) {
+            position.highest_price = price;
+            if (position.trailing_sl_enabled) position.stop_loss_price = price * (1.0 - position.trailing_sl_percent);
+        }
+        if (price <= position.stop_loss_price) return close_position(price, "stop_loss", now);
+        if (price >= position.take_profit_price) return close_position(price, "take_profit", now);
+    }
     if (now - position.entry_time >= std::chrono::seconds(risk.max_holding_seconds)) return close_position(price, "maximum_holding_time", now);
     return TradeAction::NONE;
 }
@@ -1,16 +1,21 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <deque>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <vector>
 
 #include <sentum/api/BinanceRestClient.hpp>
-#include <sentum/api/BinanceWebsocketClient.hpp>
+#include <sentum/collector/MarketFeedManager.hpp>
+#include <sentum/core/ThreadTuning.hpp>
 #include <sentum/market/MarketEvent.hpp>
+#include <sentum/market/MarketEventBus.hpp>
+#include <sentum/market/SymbolInterner.hpp>
 #include <sentum/time/Clock.hpp>
 #include <sentum/trader/execution/IExecutionVenue.hpp>
 #include <sentum/trader/execution/SimulatedExecutionVenue.hpp>
@@ -24,6 +29,8 @@
 #include <sentum/trader/utils/TradeLogger.hpp>
 #include <sentum/utils/AsyncLogger.hpp>
 
+class MarketDataStore;
+
 class TradeEngine {
 public:
     explicit TradeEngine(const std::string& symbol, BinanceRestClient& binance, bool paper_trading);
@@ -36,6 +43,15 @@ public:
     void run();
     void stop();
     TradeAction process_event(const MarketEvent& event);
+    // Paper fills use the store's best bid/ask for the symbol while it is fresh, and the
+    // strategy gets read access to the store. The store must outlive the engine.
+    void attach_market_data(const MarketDataStore& store);
+    // Placement of the thread that calls run(); with busy_poll it spins on the event queue
+    // instead of sleeping. Call before run(). Trades come from MarketFeedManager::global().
+    void set_thread_tuning(sentum::runtime::ThreadTuning decision) { decision_tuning = std::move(decision); }
+    // Keeps stop-loss, take-profit and trailing-stop levels on `scale` (the symbol's
+    // PRICE_FILTER tick) and compares them as integers. Call before run().
+    void set_exit_price_scale(const sentum::market::FixedScale& scale) { exit_price_scale = scale; }
     TradeAction evaluate(double price);
     const std::vector<TradePosition>& completed_trades() const { return completed_; }
     TradePosition get_current_position() const;
@@ -50,7 +66,15 @@ public:
 
 private:
     void initialize_components();
-    void enqueue_price(double price);
+    struct QueuedEvent {
+        MarketEvent event;
+        std::chrono::steady_clock::time_point queued;
+    };
+
+    // Bus handler, on the feed's io thread: queues this symbol's trades for run().
+    void on_market_event(const MarketEvent& event);
+    bool next_event(MarketEvent& event);
+    void release_feed();
     TradeAction evaluate_at(double price, std::chrono::system_clock::time_point now, const std::string& source,
                             const MarketEvent* event = nullptr);
     TradeAction close_position(double market_price, const std::string& reason, std::chrono::system_clock::time_point now);
@@ -58,6 +82,7 @@ private:
                                     std::chrono::system_clock::time_point now, const char* purpose);
 
     std::string symbol;
+    sentum::market::SymbolId symbol_id = sentum::market::SymbolInterner::global().intern(symbol);
     BinanceRestClient* api = nullptr;
     std::atomic<bool> running{false};
     bool isPaperTrading = true;
@@ -74,14 +99,21 @@ private:
     std::unique_ptr<RiskManager> risk_manager;
     std::unique_ptr<TradeHistoryRepository> history;
     std::unique_ptr<sentum::execution::SimulatedExecutionVenue> execution_venue;
+    // Set by set_exit_price_scale; exit levels stay doubles without it.
+    std::optional<sentum::market::FixedScale> exit_price_scale;
+    const MarketDataStore* market_store = nullptr;
     std::shared_ptr<IClock> clock;
     std::string history_path = "log/klines.sqlite3";
     std::vector<TradePosition> completed_;
     std::chrono::system_clock::time_point last_exit{};
-    std::unique_ptr<BinanceWebsocketClient> price_stream;
+    sentum::market::MarketEventBus::SubscriptionId bus_subscription = 0;
+    sentum::collector::TradeSubscription trade_feed;
     std::atomic<double> latest_price{0.0};
     std::mutex queue_mutex;
     std::condition_variable queue_cv;
-    std::deque<MarketEvent> price_queue;
+    std::deque<QueuedEvent> price_queue;
+    // Mirrors price_queue.size() so a busy-polling run() can spin without the mutex.
+    std::atomic<std::size_t> queued_events{0};
+    sentum::runtime::ThreadTuning decision_tuning;
     static constexpr std::size_t max_queue_size = 4096;
 };
@@ -3,9 +3,10 @@
 #include <chrono>
 #include <mutex>
 #include <string>
-#include <unordered_map>
+#include <vector>
 
 #include <sentum/api/BinanceSpotExecutionClient.hpp>
+#include <sentum/market/SymbolInterner.hpp>
 #include <sentum/trader/execution/ExchangeRules.hpp>
 
 namespace sentum::execution {
@@ -16,24 +17,16 @@ public:
                                    std::chrono::minutes ttl = std::chrono::minutes(60))
         : client_(client), ttl_(ttl) {}
 
-    ExchangeRules rules(const std::string& symbol) const {
-        const auto now = std::chrono::steady_clock::now();
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            auto it = rules_.find(symbol);
-            if (it != rules_.end() && now - it->second.loaded_at < ttl_) return it->second.rules;
-        }
-        auto loaded = ExchangeRules::from_exchange_info(client_.exchange_info(symbol), symbol);
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            rules_.insert_or_assign(symbol, Entry{loaded, now});
-        }
-        return loaded;
+    ExchangeRules rules(const std::string& symbol) const { return rules(sentum::market::SymbolInterner::global().intern(symbol), symbol); }
+
+    ExchangeRules rules(sentum::market::SymbolId id) const {
+        return rules(id, std::string(sentum::market::SymbolInterner::global().name(id)));
     }
 
     void invalidate(const std::string& symbol) {
+        const auto id = sentum::market::SymbolInterner::global().find_folded(symbol);
         std::lock_guard<std::mutex> lock(mutex_);
-        rules_.erase(symbol);
+        if (id < rules_.size()) rules_[id].loaded = false;
     }
 
     void clear() {
@@ -42,11 +35,28 @@ public:
     }
 
 private:
-    struct Entry { ExchangeRules rules; std::chrono::steady_clock::time_point loaded_at; };
+    struct Entry { ExchangeRules rules; std::chrono::steady_clock::time_point loaded_at; bool loaded = false; };
+
+    ExchangeRules rules(sentum::market::SymbolId id, const std::string& symbol) const {
+        const auto now = std::chrono::steady_clock::now();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (id < rules_.size() && rules_[id].loaded && now - rules_[id].loaded_at < ttl_) return rules_[id].rules;
+        }
+        auto loaded = ExchangeRules::from_exchange_info(client_.exchange_info(symbol), symbol);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (rules_.size() <= id) rules_.resize(static_cast<std::size_t>(id) + 1);
+            rules_[id] = Entry{loaded, now, true};
+        }
+        return loaded;
+    }
+
     const BinanceSpotExecutionClient& client_;
     std::chrono::minutes ttl_;
     mutable std::mutex mutex_;
-    mutable std::unordered_map<std::string, Entry> rules_;
+    // Indexed by interned SymbolId.
+    mutable std::vector<Entry> rules_;
 };
 
 } // namespace sentum::execution
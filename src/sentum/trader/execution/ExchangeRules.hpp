@@ -5,6 +5,7 @@
 #include <string>
 
 #include <nlohmann/json.hpp>
+#include <sentum/market/FixedPoint.hpp>
 
 namespace sentum::execution {
 
@@ -12,9 +13,11 @@ struct ExchangeRules {
     double min_quantity = 0.0;
     double max_quantity = 0.0;
     double step_size = 0.0;
+    double tick_size = 0.0;
     double min_notional = 0.0;
     int base_precision = 8;
     int quote_precision = 8;
+    sentum::market::FixedScale price_scale;
 
     double normalize_quantity(double value) const {
         if (step_size <= 0.0) throw std::logic_error("Invalid exchange step size");
@@ -43,6 +46,10 @@ struct ExchangeRules {
                     if (rules.min_quantity == 0.0 || type == "MARKET_LOT_SIZE") rules.min_quantity = parse("minQty");
                     if (rules.max_quantity == 0.0 || type == "MARKET_LOT_SIZE") rules.max_quantity = parse("maxQty");
                     if (rules.step_size == 0.0 || type == "MARKET_LOT_SIZE") rules.step_size = parse("stepSize");
+                } else if (type == "PRICE_FILTER") {
+                    const auto tick = filter.value("tickSize", std::string{"0"});
+                    rules.tick_size = std::stod(tick);
+                    if (rules.tick_size > 0.0) rules.price_scale = sentum::market::FixedScale::from_increment(tick);
                 } else if (type == "MIN_NOTIONAL" || type == "NOTIONAL") {
                     rules.min_notional = std::stod(filter.value("minNotional", std::string{"0"}));
                 }
@@ -8,6 +8,7 @@
 #include <stdexcept>
 #include <string>
 
+#include <sentum/collector/DepthBook.hpp>
 #include <sentum/trader/execution/IExecutionVenue.hpp>
 
 namespace sentum::execution {
@@ -30,10 +31,23 @@ public:
 
         const double half_spread = spread_percent_ * 0.5;
         const bool buy = request.side == order::Side::Buy;
-        const double touch = buy ? market_price_ * (1.0 + half_spread)
-                                 : market_price_ * (1.0 - half_spread);
-        const double fill = buy ? touch * (1.0 + slippage_percent_)
-                                : touch * (1.0 - slippage_percent_);
+        // A live quote is the real touch; otherwise the spread is modelled around the last price.
+        const bool quoted = bid_ > 0.0 && ask_ >= bid_;
+        const double touch = quoted ? (buy ? ask_ : bid_)
+                                    : buy ? market_price_ * (1.0 + half_spread)
+                                          : market_price_ * (1.0 - half_spread);
+        double fill = buy ? touch * (1.0 + slippage_percent_)
+                          : touch * (1.0 - slippage_percent_);
+        // With a synchronized depth book the order walks the levels it would consume; what
+        // the book cannot absorb is priced beyond its last level with the slippage model.
+        sentum::market::FillEstimate walked;
+        if (depth_ && depth_->estimate_fill(buy ? sentum::market::BookSide::Ask : sentum::market::BookSide::Bid, request.quantity, walked) &&
+            walked.filled_quantity > 0.0) {
+            const double remaining = request.quantity - walked.filled_quantity;
+            const double beyond = buy ? walked.worst_price * (1.0 + slippage_percent_)
+                                      : walked.worst_price * (1.0 - slippage_percent_);
+            fill = (walked.average_price * walked.filled_quantity + beyond * remaining) / request.quantity;
+        }
 
         order::Snapshot s;
         s.symbol = request.symbol;
@@ -68,6 +82,16 @@ public:
         market_time_ = timestamp;
     }
 
+    // Best bid/ask to fill against until cleared. The caller decides whether it is fresh.
+    void set_quote(double bid, double ask) noexcept {
+        bid_ = bid;
+        ask_ = ask;
+    }
+    void clear_quote() noexcept { bid_ = ask_ = 0.0; }
+
+    // Local L2 book to walk for market-impact fills, or null for touch/spread fills only.
+    void set_depth(const sentum::collector::DepthBook* book) noexcept { depth_ = book; }
+
     void set_fill_model(double spread_percent, double slippage_percent) noexcept {
         spread_percent_ = std::max(0.0, spread_percent);
         slippage_percent_ = std::max(0.0, slippage_percent);
@@ -80,6 +104,9 @@ private:
     std::atomic<bool> killed_{false};
     std::atomic<std::int64_t> next_id_{0};
     double market_price_ = 0.0;
+    double bid_ = 0.0;
+    double ask_ = 0.0;
+    const sentum::collector::DepthBook* depth_ = nullptr;
     double spread_percent_ = 0.0;
     double slippage_percent_ = 0.0;
     std::chrono::system_clock::time_point market_time_{};
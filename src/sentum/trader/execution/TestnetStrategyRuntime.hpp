@@ -11,8 +11,10 @@
 #include <string>
 #include <utility>
 
-#include <sentum/api/BinanceWebsocketClient.hpp>
+#include <sentum/collector/MarketFeedManager.hpp>
 #include <sentum/dashboard/DashboardState.hpp>
+#include <sentum/market/MarketEventBus.hpp>
+#include <sentum/market/SymbolInterner.hpp>
 #include <sentum/observability/StatusReporter.hpp>
 #include <sentum/trader/execution/IExecutionVenue.hpp>
 #include <sentum/trader/order/OrderEventRepository.hpp>
@@ -39,9 +41,8 @@ public:
         set_status("reconciliation_complete", false);
         venue_->start([this](const order::Snapshot& update) { on_order_update(update); });
         set_status("reconciliation_complete", venue_->ready());
-        price_stream_ = std::make_unique<BinanceWebsocketClient>(symbol_);
-        price_stream_->set_on_price([this](double price) { on_price(price); });
-        price_stream_->start();
+        bus_subscription_ = sentum::market::MarketEventBus::global().subscribe<&TestnetStrategyRuntime::on_market_event>(*this);
+        trade_feed_ = sentum::collector::MarketFeedManager::global().subscribe_trades(symbol_);
         set_status("market_data_connected", true);
         set_status("user_stream_connected", true);
         sentum::dashboard::DashboardState::global().set("health", "healthy");
@@ -49,7 +50,8 @@ public:
 
     void stop() noexcept {
         if (!running_.exchange(false)) return;
-        if (price_stream_) price_stream_->stop();
+        trade_feed_.reset();
+        if (bus_subscription_) sentum::market::MarketEventBus::global().unsubscribe(std::exchange(bus_subscription_, 0));
         if (venue_) venue_->stop();
         set_status("market_data_connected", false);
         set_status("user_stream_connected", false);
@@ -78,6 +80,10 @@ private:
         return "sentum-" + symbol + "-" + side + "-" + std::to_string(now);
     }
 
+    void on_market_event(const MarketEvent& event) {
+        if (event.type == MarketEvent::Type::Trade && event.symbol_id == symbol_id_) on_price(event.price);
+    }
+
     void on_price(double price) {
         if (!running_.load() || !venue_->ready() || price <= 0.0) return;
         const auto now = std::chrono::system_clock::now();
@@ -154,7 +160,9 @@ private:
     RiskManager risk_manager_;
     order::OrderEventRepository events_;
     observability::StatusReporter status_;
-    std::unique_ptr<BinanceWebsocketClient> price_stream_;
+    sentum::market::SymbolId symbol_id_ = sentum::market::SymbolInterner::global().intern(symbol_);
+    sentum::market::MarketEventBus::SubscriptionId bus_subscription_ = 0;
+    sentum::collector::TradeSubscription trade_feed_;
     std::atomic<bool> running_{false};
     std::mutex mutex_;
     std::string active_order_;
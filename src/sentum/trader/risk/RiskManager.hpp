@@ -5,6 +5,7 @@
 #include <cmath>
 #include <string>
 
+#include <sentum/market/FixedPoint.hpp>
 #include <sentum/trader/strategy/IStrategy.hpp>
 #include <sentum/trader/types/RiskConfig.hpp>
 
@@ -15,6 +16,11 @@ struct RiskDecision {
     double notional = 0.0;
 };
 
+struct ExitLevels {
+    sentum::market::Price stop_loss;
+    sentum::market::Price take_profit;
+};
+
 class RiskManager {
 public:
     explicit RiskManager(const RiskConfig& config) : config_(config) {}
@@ -42,6 +48,18 @@ public:
         return {true, "approved", quantity, notional};
     }
 
+    // Levels are rounded up onto the tick grid: the stop triggers no later than the configured
+    // distance and the target is never below it.
+    ExitLevels exit_levels(sentum::market::Price entry, const sentum::market::FixedScale& scale) const {
+        const double price = scale.to_double(entry);
+        return {scale.ceil_to_tick(scale.from_double(price * (1.0 - config_.stop_loss_percent))),
+                scale.ceil_to_tick(scale.from_double(price * (1.0 + config_.take_profit_percent)))};
+    }
+
+    static sentum::market::Price trailing_stop(sentum::market::Price high, const sentum::market::FixedScale& scale, double percent) {
+        return scale.ceil_to_tick(scale.from_double(scale.to_double(high) * (1.0 - percent)));
+    }
+
 private:
     RiskConfig config_;
 };
@@ -5,8 +5,11 @@
 #include <string>
 
 #include <sentum/market/MarketEvent.hpp>
+#include <sentum/market/SymbolId.hpp>
 #include <sentum/trader/types/TradeAction.hpp>
 
+class MarketDataStore;
+
 struct StrategySignal {
     TradeAction action = TradeAction::NONE;
     std::string strategy;
@@ -25,4 +28,8 @@ public:
     }
     virtual void reset() = 0;
     virtual std::string name() const { return "strategy"; }
+    // Gives the strategy read access to the shared candle store for the symbol it trades,
+    // e.g. to use its rollups instead of aggregating events itself. The store must outlive
+    // the strategy.
+    virtual void attach_market_data(const MarketDataStore& store, sentum::market::SymbolId symbol) { (void)store; (void)symbol; }
 };
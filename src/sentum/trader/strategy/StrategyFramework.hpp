@@ -14,6 +14,7 @@
 
 #include <nlohmann/json.hpp>
 #include <sentum/market/IncrementalIndicators.hpp>
+#include <sentum/market/MarketDataStore.hpp>
 #include <sentum/trader/strategy/IStrategy.hpp>
 #include <sentum/trader/strategy/MomentumStrategy.hpp>
 
@@ -146,12 +147,15 @@ private:
     std::deque<double> window_;
 };
 
+// Timeframes the attached store keeps as rollups (1m, 5m, 15m, 1h) are read from it, and
+// their EMAs are warmed from the closed bars already in the ring. Other timeframes, or
+// a strategy without a store, aggregate events locally.
 class MultiTimeframeTrendStrategy final : public IStrategy {
 public:
     MultiTimeframeTrendStrategy(std::int64_t fast_tf_seconds = 60, std::int64_t slow_tf_seconds = 300,
                                 std::size_t ema_period = 8, double threshold = 0.001)
-        : fast_tf_seconds_(fast_tf_seconds), slow_tf_seconds_(slow_tf_seconds), ema_period_(ema_period), threshold_(threshold),
-          fast_frame_(fast_tf_seconds), slow_frame_(slow_tf_seconds), fast_ema_(ema_period), slow_ema_(ema_period) {
+        : ema_period_(ema_period), threshold_(threshold),
+          fast_(fast_tf_seconds, ema_period), slow_(slow_tf_seconds, ema_period) {
         if (slow_tf_seconds <= fast_tf_seconds) throw std::invalid_argument("slow timeframe must exceed fast timeframe");
     }
 
@@ -161,31 +165,83 @@ public:
     }
 
     StrategySignal on_event(const MarketEvent& event) override {
-        if (fast_frame_.push(event)) { fast_value_ = fast_ema_.push(fast_frame_.latest_closed().close); ++fast_samples_; }
-        if (slow_frame_.push(event)) { slow_value_ = slow_ema_.push(slow_frame_.latest_closed().close); ++slow_samples_; }
+        update(fast_, event);
+        update(slow_, event);
         const double price = event.price > 0.0 ? event.price : event.close;
-        if (fast_samples_ < ema_period_ || slow_samples_ < ema_period_ || !(slow_value_ > 0.0)) return {};
-        const double spread = (fast_value_ - slow_value_) / slow_value_;
+        if (fast_.samples < ema_period_ || slow_.samples < ema_period_ || !(slow_.value > 0.0)) return {};
+        const double spread = (fast_.value - slow_.value) / slow_.value;
         if (spread < threshold_) return {};
         return {TradeAction::BUY, name(), "fast timeframe trend confirmed by slow timeframe", price, event.timestamp,
                 std::clamp(spread / std::max(threshold_, 1e-9), 0.0, 2.0) / 2.0};
     }
 
+    void attach_market_data(const MarketDataStore& store, sentum::market::SymbolId symbol) override {
+        store_ = store.rollup_capacity() > 0 ? &store : nullptr;
+        symbol_ = symbol;
+        reset();
+    }
+
     void reset() override {
-        fast_frame_.reset(); slow_frame_.reset();
-        fast_ema_ = sentum::market::Ema(ema_period_); slow_ema_ = sentum::market::Ema(ema_period_);
-        fast_samples_ = slow_samples_ = 0; fast_value_ = slow_value_ = 0.0;
+        fast_.reset(ema_period_);
+        slow_.reset(ema_period_);
     }
     std::string name() const override { return "multi_timeframe_trend"; }
 
 private:
-    std::int64_t fast_tf_seconds_, slow_tf_seconds_;
+    struct Frame {
+        Frame(std::int64_t seconds, std::size_t ema_period)
+            : rollup(MarketDataStore::rollup_for_seconds(seconds, interval)), aggregator(seconds), ema(ema_period) {}
+        void reset(std::size_t ema_period) {
+            aggregator.reset();
+            ema = sentum::market::Ema(ema_period);
+            samples = 0; value = 0.0; last_closed = -1;
+        }
+        MarketDataStore::RollupInterval interval = MarketDataStore::RollupInterval::OneMinute;
+        bool rollup;
+        TimeframeAggregator aggregator;
+        sentum::market::Ema ema;
+        std::size_t samples = 0;
+        double value = 0.0;
+        // Start time (ms) of the newest rollup bar fed to the EMA.
+        std::int64_t last_closed = -1;
+    };
+
+    void update(Frame& frame, const MarketEvent& event) {
+        if (!store_ || !frame.rollup || !read_closed(frame)) {
+            if (frame.aggregator.push(event)) push(frame, frame.aggregator.latest_closed().close);
+            return;
+        }
+        for (const auto& [timestamp, close] : closes_) {
+            push(frame, close);
+            frame.last_closed = timestamp;
+        }
+    }
+
+    // Collects the closed rollup bars not fed yet, oldest first. False when the store does
+    // not hold the symbol.
+    bool read_closed(const Frame& frame) {
+        closes_.clear();
+        return store_->with_rollup_window(symbol_, frame.interval, ema_period_, [&](const MarketDataStore::Window& window) {
+            closes_.clear();
+            const auto timestamp = window.timestamp();
+            const auto close = window.close();
+            for (std::size_t i = 0; i < window.size(); ++i) {
+                if (timestamp[i] > frame.last_closed) closes_.emplace_back(timestamp[i], close[i]);
+            }
+        });
+    }
+
+    static void push(Frame& frame, double close) {
+        frame.value = frame.ema.push(close);
+        ++frame.samples;
+    }
+
     std::size_t ema_period_;
     double threshold_;
-    TimeframeAggregator fast_frame_, slow_frame_;
-    sentum::market::Ema fast_ema_, slow_ema_;
-    std::size_t fast_samples_ = 0, slow_samples_ = 0;
-    double fast_value_ = 0.0, slow_value_ = 0.0;
+    Frame fast_, slow_;
+    const MarketDataStore* store_ = nullptr;
+    sentum::market::SymbolId symbol_ = sentum::market::kInvalidSymbolId;
+    std::vector<std::pair<std::int64_t, double>> closes_;
 };
 
 class EnsembleStrategy final : public IStrategy {
@@ -222,6 +278,9 @@ public:
     }
 
     void reset() override { for (auto& member : members_) member.strategy->reset(); }
+    void attach_market_data(const MarketDataStore& store, sentum::market::SymbolId symbol) override {
+        for (auto& member : members_) member.strategy->attach_market_data(store, symbol);
+    }
     std::string name() const override { return "ensemble"; }
 
 private:
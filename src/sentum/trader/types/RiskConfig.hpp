@@ -20,6 +20,9 @@ struct RiskConfig {
     double max_quantity = 0.0;
     double step_size = 0.000001;
     double min_notional = 5.0;
+    // Keep stop-loss/take-profit levels on the symbol's PRICE_FILTER tick grid and compare
+    // them as integers; off keeps double comparisons.
+    bool tick_grid_exits = false;
     std::int64_t cooldown_seconds = 30;
     std::int64_t max_holding_seconds = 900;
     std::int64_t max_data_age_ms = 2000;
@@ -4,6 +4,8 @@
 #include <cstdint>
 #include <string>
 
+#include <sentum/market/FixedPoint.hpp>
+
 struct TradePosition {
     bool open = false;
     bool simulated = false;
@@ -50,6 +52,12 @@ struct TradePosition {
     std::string close_reason;
     bool stop_loss_triggered = false;
     bool take_profit_triggered = false;
+    // Tick-grid exit levels; authoritative for exits when fixed_point_levels is set.
+    bool fixed_point_levels = false;
+    sentum::market::FixedScale price_scale;
+    sentum::market::Price highest_level;
+    sentum::market::Price stop_loss_level;
+    sentum::market::Price take_profit_level;
 
     double holding_seconds() const {
         const auto end = open ? std::chrono::system_clock::now() : exit_time;
@@ -43,6 +43,7 @@ RiskConfig load_risk_config(const std::string& path) {
     c.trailing_sl_percent = j.value("trailing_sl_percent", 0.0);
     c.trailing_tp_enabled = j.value("trailing_tp_enabled", false);
     c.trailing_tp_percent = j.value("trailing_tp_percent", 0.0);
+    c.tick_grid_exits = j.value("tick_grid_exits", false);
 
     if (c.max_total_capital <= 0.0 || c.risk_per_trade <= 0.0 || c.risk_per_trade > 1.0) throw std::runtime_error("Invalid capital or risk_per_trade");
     if (c.stop_loss_percent <= 0.0 || c.take_profit_percent <= 0.0) throw std::runtime_error("Stop loss and take profit must be positive");
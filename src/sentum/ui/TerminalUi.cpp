@@ -578,8 +578,53 @@ void TerminalUi::draw(bool force_full) {
         const auto perf = snapshot.value("performance", nlohmann::json::object());
         latency_row(out, perf, "parse_latency", "Parser");
         latency_row(out, perf, "event_dispatch_latency", "Event dispatch");
+        latency_row(out, perf, "decision_queue_latency", "Decision queue");
         latency_row(out, perf, "strategy_decision_latency", "Decision");
         latency_row(out, perf, "sqlite_batch_latency", "SQLite batch");
+        latency_row(out, perf, "archive_batch_latency", "Archive batch");
+        const auto writer = perf.value("sqlite_writer", nlohmann::json::object());
+        latency_row(out, writer, "checkpoint_latency", "WAL checkpoint");
+        const auto shards = perf.value("collector_shards", nlohmann::json::array());
+        if (shards.size() > 1) {
+            out << "\n  " << std::left << std::setw(8) << "Shard" << std::right << std::setw(9) << "Symbols" << std::setw(12) << "Events/s"
+                << std::setw(12) << "Parse p99" << std::setw(12) << "Reconnects" << "  Link\n";
+            for (const auto& shard : shards) {
+                out << "  " << std::left << std::setw(8) << number<std::size_t>(shard,"shard")
+                    << std::right << std::setw(9) << number<std::size_t>(shard,"symbols")
+                    << std::setw(12) << format_number(number<double>(shard,"events_per_second"),1)
+                    << std::setw(12) << format_number(number<double>(shard.value("parse_latency", nlohmann::json::object()),"p99_us"),1)
+                    << std::setw(12) << number<std::uint64_t>(shard,"reconnects")
+                    << "  " << on_off(number<bool>(shard,"connected")) << '\n';
+            }
+        }
+        const auto feed = perf.value("market_feed", nlohmann::json::object());
+        if (number<std::uint64_t>(feed,"connects") > 0)
+            out << "\n  Trade feed " << on_off(number<bool>(feed,"connected")) << "   Streams " << number<std::uint64_t>(feed,"streams")
+                << "   Requests " << number<std::uint64_t>(feed,"requests")
+                << "   First trade " << format_number(number<double>(feed,"first_trade_last_ms"),0) << " ms\n";
+        if (number<std::uint64_t>(writer,"batches") > 0)
+            out << "\n  SQLite writer   Batch cap " << number<std::uint64_t>(writer,"batch_limit")
+                << "   WAL " << format_number(number<double>(writer,"wal_bytes") / 1024.0 / 1024.0,2) << " MiB"
+                << "   Checkpoints " << number<std::uint64_t>(writer,"checkpoints")
+                << "   Busy " << number<std::uint64_t>(writer,"busy_checkpoints") << '\n';
+        const auto spill = perf.value("kline_spill", nlohmann::json::object());
+        if (number<std::uint64_t>(spill,"spilled") + number<std::uint64_t>(spill,"recovered") > 0)
+            out << "\n  Kline spill   Depth " << number<std::uint64_t>(spill,"depth")
+                << "   Age " << format_number(number<double>(spill,"backlog_age_ms") / 1000.0,1) << " s"
+                << "   Spilled " << number<std::uint64_t>(spill,"spilled")
+                << "   Recovered " << number<std::uint64_t>(spill,"recovered")
+                << "   Rejected " << number<std::uint64_t>(spill,"rejected") << '\n';
+        const auto threads = perf.value("threads", nlohmann::json::array());
+        if (!threads.empty()) {
+            out << "\n  Pinned threads:";
+            for (const auto& thread : threads) {
+                std::string cores;
+                for (const auto& core : thread.value("cores", nlohmann::json::array())) cores += (cores.empty() ? "" : ",") + std::to_string(core.get<int>());
+                out << "  " << text(thread,"name") << '@' << (cores.empty() ? "-" : cores)
+                    << (number<bool>(thread,"realtime") ? " fifo" : "") << (number<bool>(thread,"busy_poll") ? " spin" : "");
+            }
+            out << '\n';
+        }
         out << "\n  Dashboard bind: " << text(snapshot,"dashboard_host","-") << ':' << number<int>(snapshot,"dashboard_port") << '\n';
     }
 
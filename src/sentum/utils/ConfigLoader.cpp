@@ -32,6 +32,70 @@ Config load_config(const std::string& path) {
         config.paperModelDefinition = paper.value("modelDefinition", config.paperModelDefinition);
     }
 
+    if (json.contains("collector") && json.at("collector").is_object()) {
+        const auto& collector = json.at("collector");
+        const int shards = collector.value("shards", static_cast<int>(config.collectorShards));
+        if (shards < 1 || shards > 32) throw std::runtime_error("collector.shards must be between 1 and 32");
+        config.collectorShards = static_cast<std::size_t>(shards);
+        config.collectorStreamUrl = collector.value("streamUrl", config.collectorStreamUrl);
+        if (config.collectorStreamUrl.rfind("ws://", 0) != 0 && config.collectorStreamUrl.rfind("wss://", 0) != 0)
+            throw std::runtime_error("collector.streamUrl must start with ws:// or wss://");
+        config.collectorBatchFrames = collector.value("batchFrames", config.collectorBatchFrames);
+        config.collectorFixedPoint = collector.value("fixedPoint", config.collectorFixedPoint);
+        config.collectorHugePages = collector.value("hugePages", config.collectorHugePages);
+        config.collectorBookTicker = collector.value("bookTicker", config.collectorBookTicker);
+        config.collectorAggTrades = collector.value("aggTrades", config.collectorAggTrades);
+        config.collectorDepthSymbols = collector.value("depthSymbols", config.collectorDepthSymbols);
+        config.collectorDepthSnapshotLimit = collector.value("depthSnapshotLimit", config.collectorDepthSnapshotLimit);
+        if (config.collectorDepthSnapshotLimit < 1 || config.collectorDepthSnapshotLimit > 5000)
+            throw std::runtime_error("collector.depthSnapshotLimit must be between 1 and 5000");
+        config.collectorDepthRecordPath = collector.value("depthRecordPath", config.collectorDepthRecordPath);
+        config.collectorFrameJournalPath = collector.value("frameJournalPath", config.collectorFrameJournalPath);
+        config.collectorKlineSink = collector.value("klineSink", config.collectorKlineSink);
+        if (config.collectorKlineSink != "sqlite" && config.collectorKlineSink != "archive" && config.collectorKlineSink != "both")
+            throw std::runtime_error("collector.klineSink must be sqlite, archive or both");
+        config.collectorArchivePath = collector.value("archivePath", config.collectorArchivePath);
+        if (config.collectorKlineSink != "sqlite" && config.collectorArchivePath.empty()) throw std::runtime_error("collector.archivePath must not be empty");
+        const int block_rows = collector.value("archiveBlockRows", static_cast<int>(config.collectorArchiveBlockRows));
+        if (block_rows < 16 || block_rows > 65536) throw std::runtime_error("collector.archiveBlockRows must be between 16 and 65536");
+        config.collectorArchiveBlockRows = static_cast<std::size_t>(block_rows);
+        config.collectorWalCheckpointIntervalMs = collector.value("walCheckpointIntervalMs", config.collectorWalCheckpointIntervalMs);
+        if (config.collectorWalCheckpointIntervalMs < 0 || config.collectorWalCheckpointIntervalMs > 60000)
+            throw std::runtime_error("collector.walCheckpointIntervalMs must be between 0 and 60000");
+        config.collectorWalRestartMb = collector.value("walRestartMb", config.collectorWalRestartMb);
+        if (config.collectorWalRestartMb < 1 || config.collectorWalRestartMb > 4096) throw std::runtime_error("collector.walRestartMb must be between 1 and 4096");
+        config.collectorSpillPath = collector.value("spillPath", config.collectorSpillPath);
+        config.collectorSpillMaxMb = collector.value("spillMaxMb", config.collectorSpillMaxMb);
+        if (config.collectorSpillMaxMb < 1 || config.collectorSpillMaxMb > 65536) throw std::runtime_error("collector.spillMaxMb must be between 1 and 65536");
+        const int warm_bars = collector.value("warmStartBars", static_cast<int>(config.collectorWarmStartBars));
+        if (warm_bars < 0) throw std::runtime_error("collector.warmStartBars must be >= 0");
+        config.collectorWarmStartBars = static_cast<std::size_t>(warm_bars);
+        const int warm_threads = collector.value("warmStartThreads", static_cast<int>(config.collectorWarmStartThreads));
+        if (warm_threads < 0 || warm_threads > 64) throw std::runtime_error("collector.warmStartThreads must be between 0 and 64");
+        config.collectorWarmStartThreads = static_cast<std::size_t>(warm_threads);
+        config.collectorWarmStartMaxAgeSeconds = collector.value("warmStartMaxAgeSeconds", config.collectorWarmStartMaxAgeSeconds);
+        if (config.collectorWarmStartMaxAgeSeconds < 1) throw std::runtime_error("collector.warmStartMaxAgeSeconds must be >= 1");
+        config.collectorSnapshotPath = collector.value("snapshotPath", config.collectorSnapshotPath);
+        config.collectorSnapshotIntervalSeconds = collector.value("snapshotIntervalSeconds", config.collectorSnapshotIntervalSeconds);
+        if (config.collectorSnapshotIntervalSeconds < 0) throw std::runtime_error("collector.snapshotIntervalSeconds must be >= 0");
+    }
+
+    if (json.contains("lowLatency") && json.at("lowLatency").is_object()) {
+        const auto& low_latency = json.at("lowLatency");
+        config.lowLatencyEnabled = low_latency.value("enabled", config.lowLatencyEnabled);
+        config.lowLatencyIoCores = low_latency.value("ioCores", config.lowLatencyIoCores);
+        config.lowLatencyDecisionCores = low_latency.value("decisionCores", config.lowLatencyDecisionCores);
+        config.lowLatencyPersistenceCores = low_latency.value("persistenceCores", config.lowLatencyPersistenceCores);
+        config.lowLatencyFifoPriority = low_latency.value("fifoPriority", config.lowLatencyFifoPriority);
+        for (const auto* cores : {&config.lowLatencyIoCores, &config.lowLatencyDecisionCores, &config.lowLatencyPersistenceCores})
+            for (int core : *cores) if (core < 0 || core > 1023) throw std::runtime_error("lowLatency cores must be between 0 and 1023");
+        if (config.lowLatencyFifoPriority < 0 || config.lowLatencyFifoPriority > 99)
+            throw std::runtime_error("lowLatency.fifoPriority must be between 0 and 99");
+        // A SCHED_FIFO spinner on a shared core starves everything else on it.
+        if (config.lowLatencyFifoPriority > 0 && (config.lowLatencyIoCores.empty() || config.lowLatencyDecisionCores.empty()))
+            throw std::runtime_error("lowLatency.fifoPriority requires ioCores and decisionCores");
+    }
+
     config.dashboardHost = json.value("dashboardHost", config.dashboardHost);
     const int dashboard_port = json.value("dashboardPort", static_cast<int>(config.dashboardPort));
     if (dashboard_port < 1 || dashboard_port > 65535) throw std::runtime_error("dashboardPort must be between 1 and 65535");
@@ -4,8 +4,10 @@
  */
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include <nlohmann/json.hpp>
 
@@ -28,6 +30,37 @@ struct Config {
     std::string paperRiskConfigPath = "config/risk.json";
     std::string paperModelId;
 
+    std::size_t collectorShards = 1;
+    std::string collectorStreamUrl = "wss://stream.binance.com:443"; // also used by the shared trade feed
+    bool collectorBatchFrames = true;
+    bool collectorFixedPoint = false;
+    bool collectorHugePages = false;
+    bool collectorBookTicker = false;
+    bool collectorAggTrades = false;
+    std::vector<std::string> collectorDepthSymbols;
+    int collectorDepthSnapshotLimit = 1000;
+    std::string collectorDepthRecordPath;
+    std::string collectorFrameJournalPath;
+    std::string collectorKlineSink = "sqlite"; // sqlite, archive or both
+    std::string collectorArchivePath = "log/archive";
+    std::size_t collectorArchiveBlockRows = 1024;
+    int collectorWalCheckpointIntervalMs = 1000; // 0 leaves checkpoints to SQLite's autocheckpoint
+    int collectorWalRestartMb = 64;
+    std::string collectorSpillPath = "log/kline_spill.bin"; // empty drops rows when a queue is full
+    int collectorSpillMaxMb = 1024;
+    std::size_t collectorWarmStartBars = 600; // 0 disables the warm start
+    std::size_t collectorWarmStartThreads = 0; // 0 picks min(hardware threads, 8)
+    int collectorWarmStartMaxAgeSeconds = 900;
+    std::string collectorSnapshotPath = "log/market_store.snapshot"; // empty disables snapshots
+    int collectorSnapshotIntervalSeconds = 300; // 0 saves on shutdown only
+
+    // Low-latency mode: pinned, busy-polling collector io and trade-decision threads.
+    bool lowLatencyEnabled = false;
+    std::vector<int> lowLatencyIoCores;
+    std::vector<int> lowLatencyDecisionCores;
+    std::vector<int> lowLatencyPersistenceCores; // empty: every core not listed above
+    int lowLatencyFifoPriority = 0; // 0 keeps SCHED_OTHER
+
     std::string dashboardHost = "127.0.0.1";
     std::uint16_t dashboardPort = 8080;
 };
@@ -1,17 +1,181 @@
 #include <algorithm>
+#include <cctype>
+#include <filesystem>
 #include <iostream>
+#include <limits>
 #include <stdexcept>
+#include <utility>
 
+#include <sentum/market/SymbolInterner.hpp>
 #include <sentum/utils/Database.hpp>
 
-Database::Database(const std::string& db_path) {
-    if (sqlite3_open_v2(db_path.c_str(), &db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX, nullptr) != SQLITE_OK) {
+namespace {
+
+void exec(sqlite3* db, const char* sql) {
+    char* error = nullptr;
+    if (sqlite3_exec(db, sql, nullptr, nullptr, &error) != SQLITE_OK) {
+        const std::string message = error ? error : sqlite3_errmsg(db);
+        sqlite3_free(error);
+        throw std::runtime_error(message);
+    }
+}
+
+std::int64_t query_int(sqlite3* db, const char* sql) {
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) throw std::runtime_error(sqlite3_errmsg(db));
+    const std::int64_t value = sqlite3_step(stmt) == SQLITE_ROW ? sqlite3_column_int64(stmt, 0) : 0;
+    sqlite3_finalize(stmt);
+    return value;
+}
+
+sqlite3_stmt* prepare(sqlite3* db, const char* sql) {
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) throw std::runtime_error(sqlite3_errmsg(db));
+    return stmt;
+}
+
+// Finalizes the migration's statements on every exit path.
+struct Statements {
+    std::vector<sqlite3_stmt*> all;
+    sqlite3_stmt* add(sqlite3_stmt* stmt) { all.push_back(stmt); return stmt; }
+    ~Statements() { for (auto* stmt : all) sqlite3_finalize(stmt); }
+};
+
+int detect_schema(sqlite3* db) {
+    const auto user_version = static_cast<int>(query_int(db, "PRAGMA user_version;"));
+    if (user_version >= 2) return user_version;
+    return query_int(db, "SELECT COUNT(*) FROM pragma_table_info('klines') WHERE name='symbol';") > 0 ? 1 : 0;
+}
+
+void create_schema(sqlite3* db, const char* klines) {
+    exec(db, "CREATE TABLE IF NOT EXISTS symbols(id INTEGER PRIMARY KEY,name TEXT NOT NULL UNIQUE);");
+    const std::string sql = std::string("CREATE TABLE IF NOT EXISTS ") + klines +
+                            "(symbol_id INTEGER NOT NULL,ts INTEGER NOT NULL,open REAL,high REAL,low REAL,close REAL,volume REAL,"
+                            "PRIMARY KEY(symbol_id,ts)) WITHOUT ROWID;";
+    exec(db, sql.c_str());
+}
+
+// Mirrors every insert and upsert on the schema 1 table into klines_v2, in the writer's own
+// transaction. The triggers are stored in the schema, so they fire for other connections
+// too, and DROP TABLE klines removes them.
+void create_mirror_triggers(sqlite3* db) {
+    for (const char* event : {"INSERT", "UPDATE"}) {
+        const std::string sql = std::string("CREATE TRIGGER IF NOT EXISTS klines_v2_mirror_") + event + " AFTER " + event +
+                                " ON klines BEGIN "
+                                "INSERT OR IGNORE INTO symbols(name) VALUES(NEW.symbol);"
+                                "INSERT OR REPLACE INTO klines_v2(symbol_id,ts,open,high,low,close,volume) "
+                                "SELECT id,NEW.timestamp,NEW.open,NEW.high,NEW.low,NEW.close,NEW.volume FROM symbols WHERE name=NEW.symbol;"
+                                "END;";
+        exec(db, sql.c_str());
+    }
+}
+
+// Copies klines into klines_v2 in primary-key chunks, each in its own transaction. Rows
+// that other connections insert or update meanwhile, including upserts of rows already
+// copied, are mirrored by triggers created before the first chunk. The final transaction
+// swaps the tables.
+KlineSchemaMigration migrate_connection(sqlite3* db, std::size_t chunk_rows,
+                                        const std::function<void(const KlineSchemaMigration&)>& progress) {
+    KlineSchemaMigration result;
+    result.from_version = 1;
+    chunk_rows = std::max<std::size_t>(chunk_rows, 1);
+
+    exec(db, "BEGIN IMMEDIATE;");
+    try {
+        create_schema(db, "klines_v2");
+        exec(db, "INSERT OR IGNORE INTO symbols(name) SELECT DISTINCT symbol FROM klines ORDER BY symbol;");
+        create_mirror_triggers(db);
+        exec(db, "COMMIT;");
+    } catch (...) {
+        sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        throw;
+    }
+
+    Statements statements;
+    auto* next_key = statements.add(prepare(db,
+        "SELECT symbol,timestamp FROM klines WHERE (symbol,timestamp)>(?1,?2) ORDER BY symbol,timestamp LIMIT 1 OFFSET ?3;"));
+    auto* copy_range = statements.add(prepare(db,
+        "INSERT OR REPLACE INTO klines_v2(symbol_id,ts,open,high,low,close,volume) "
+        "SELECT s.id,k.timestamp,k.open,k.high,k.low,k.close,k.volume FROM klines k CROSS JOIN symbols s ON s.name=k.symbol "
+        "WHERE (k.symbol,k.timestamp)>(?1,?2) AND (k.symbol,k.timestamp)<=(?3,?4);"));
+    auto* copy_tail = statements.add(prepare(db,
+        "INSERT OR REPLACE INTO klines_v2(symbol_id,ts,open,high,low,close,volume) "
+        "SELECT s.id,k.timestamp,k.open,k.high,k.low,k.close,k.volume FROM klines k CROSS JOIN symbols s ON s.name=k.symbol "
+        "WHERE (k.symbol,k.timestamp)>(?1,?2);"));
+
+    // Every stored symbol sorts after ('', min).
+    std::string cursor_symbol;
+    std::int64_t cursor_ts = std::numeric_limits<std::int64_t>::min();
+    for (bool done = false; !done;) {
+        exec(db, "BEGIN IMMEDIATE;");
+        try {
+            sqlite3_reset(next_key);
+            sqlite3_bind_text(next_key, 1, cursor_symbol.c_str(), static_cast<int>(cursor_symbol.size()), SQLITE_TRANSIENT);
+            sqlite3_bind_int64(next_key, 2, cursor_ts);
+            sqlite3_bind_int64(next_key, 3, static_cast<sqlite3_int64>(chunk_rows - 1));
+            sqlite3_stmt* copy = copy_tail;
+            std::string end_symbol;
+            std::int64_t end_ts = 0;
+            if (sqlite3_step(next_key) == SQLITE_ROW) {
+                const auto* text = reinterpret_cast<const char*>(sqlite3_column_text(next_key, 0));
+                end_symbol.assign(text ? text : "", static_cast<std::size_t>(sqlite3_column_bytes(next_key, 0)));
+                end_ts = sqlite3_column_int64(next_key, 1);
+                copy = copy_range;
+            } else {
+                done = true;
+            }
+            sqlite3_reset(next_key);
+            sqlite3_reset(copy);
+            sqlite3_bind_text(copy, 1, cursor_symbol.c_str(), static_cast<int>(cursor_symbol.size()), SQLITE_TRANSIENT);
+            sqlite3_bind_int64(copy, 2, cursor_ts);
+            if (!done) {
+                sqlite3_bind_text(copy, 3, end_symbol.c_str(), static_cast<int>(end_symbol.size()), SQLITE_TRANSIENT);
+                sqlite3_bind_int64(copy, 4, end_ts);
+            }
+            if (sqlite3_step(copy) != SQLITE_DONE) throw std::runtime_error(sqlite3_errmsg(db));
+            result.rows += static_cast<std::uint64_t>(sqlite3_changes(db));
+            sqlite3_reset(copy);
+            exec(db, "COMMIT;");
+            cursor_symbol = std::move(end_symbol);
+            cursor_ts = end_ts;
+        } catch (...) {
+            sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+            throw;
+        }
+        ++result.chunks;
+        if (progress) progress(result);
+    }
+
+    exec(db, "BEGIN IMMEDIATE;");
+    try {
+        // DROP TABLE takes idx_klines_symbol_ts and the mirror triggers with it.
+        exec(db, "DROP TABLE klines;");
+        exec(db, "ALTER TABLE klines_v2 RENAME TO klines;");
+        exec(db, "PRAGMA user_version=2;");
+        result.symbols = static_cast<std::uint64_t>(query_int(db, "SELECT COUNT(*) FROM symbols;"));
+        exec(db, "COMMIT;");
+    } catch (...) {
+        sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        throw;
+    }
+    return result;
+}
+
+sqlite3* open_connection(const std::string& db_path, int flags, const char* what) {
+    sqlite3* db = nullptr;
+    if (sqlite3_open_v2(db_path.c_str(), &db, flags | SQLITE_OPEN_NOMUTEX, nullptr) != SQLITE_OK) {
         const std::string message = db ? sqlite3_errmsg(db) : "unknown SQLite error";
         if (db) sqlite3_close(db);
-        db = nullptr;
-        throw std::runtime_error("Failed to open database: " + message);
+        throw std::runtime_error(std::string(what) + message);
     }
     sqlite3_busy_timeout(db, 5000);
+    return db;
+}
+
+} // namespace
+
+Database::Database(const std::string& db_path) : path_(db_path) {
+    db = open_connection(db_path, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, "Failed to open database: ");
     exec_or_throw("PRAGMA journal_mode=WAL;");
     exec_or_throw("PRAGMA synchronous=NORMAL;");
     exec_or_throw("PRAGMA temp_store=MEMORY;");
@@ -19,32 +183,49 @@ Database::Database(const std::string& db_path) {
     if (!ensure_table()) throw std::runtime_error("Failed to initialize database schema");
 
     const char* sql =
-        "INSERT INTO klines(symbol,timestamp,open,high,low,close,volume) VALUES(?,?,?,?,?,?,?) "
-        "ON CONFLICT(symbol,timestamp) DO UPDATE SET open=excluded.open,high=excluded.high,"
+        "INSERT INTO klines(symbol_id,ts,open,high,low,close,volume) VALUES(?,?,?,?,?,?,?) "
+        "ON CONFLICT(symbol_id,ts) DO UPDATE SET open=excluded.open,high=excluded.high,"
         "low=excluded.low,close=excluded.close,volume=excluded.volume;";
-    if (sqlite3_prepare_v2(db, sql, -1, &upsert_stmt, nullptr) != SQLITE_OK) {
+    if (sqlite3_prepare_v2(db, sql, -1, &upsert_stmt, nullptr) != SQLITE_OK ||
+        sqlite3_prepare_v2(db, "INSERT OR IGNORE INTO symbols(name) VALUES(?);", -1, &symbol_insert_stmt, nullptr) != SQLITE_OK ||
+        sqlite3_prepare_v2(db, "SELECT id FROM symbols WHERE name=?;", -1, &symbol_select_stmt, nullptr) != SQLITE_OK) {
         throw std::runtime_error("Failed to prepare kline UPSERT: " + std::string(sqlite3_errmsg(db)));
     }
 }
 
 Database::~Database() {
-    if (upsert_stmt) sqlite3_finalize(upsert_stmt);
+    for (auto* stmt : {upsert_stmt, symbol_insert_stmt, symbol_select_stmt}) if (stmt) sqlite3_finalize(stmt);
     if (db) sqlite3_close(db);
 }
 
+void Database::set_wal_autocheckpoint(int pages) {
+    exec_or_throw(("PRAGMA wal_autocheckpoint=" + std::to_string(std::max(pages, 0)) + ";").c_str());
+}
+
 void Database::exec_or_throw(const char* sql) {
-    char* error = nullptr;
-    if (sqlite3_exec(db, sql, nullptr, nullptr, &error) != SQLITE_OK) {
-        const std::string message = error ? error : sqlite3_errmsg(db);
-        sqlite3_free(error);
-        throw std::runtime_error(message);
-    }
+    exec(db, sql);
 }
 
 bool Database::ensure_table() {
     try {
-        exec_or_throw("CREATE TABLE IF NOT EXISTS klines(symbol TEXT NOT NULL,timestamp INTEGER NOT NULL,open REAL,high REAL,low REAL,close REAL,volume REAL,PRIMARY KEY(symbol,timestamp));");
-        exec_or_throw("CREATE INDEX IF NOT EXISTS idx_klines_symbol_ts ON klines(symbol,timestamp DESC);");
+        const int version = detect_schema(db);
+        if (version == 1) {
+            std::cerr << "Migrating " << path_ << " to kline schema " << schema_version << "...\n";
+            const auto migration = migrate_connection(db, default_migration_chunk_rows, {});
+            std::cerr << "Migrated " << migration.rows << " klines of " << migration.symbols << " symbols\n";
+            return true;
+        }
+        if (version > schema_version) throw std::runtime_error("kline schema " + std::to_string(version) + " is newer than this build");
+        if (version == schema_version) return true;
+        exec_or_throw("BEGIN IMMEDIATE;");
+        try {
+            create_schema(db, "klines");
+            exec_or_throw("PRAGMA user_version=2;");
+            exec_or_throw("COMMIT;");
+        } catch (...) {
+            sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+            throw;
+        }
         return true;
     } catch (const std::exception& e) {
         std::cerr << "Database schema error: " << e.what() << '\n';
@@ -52,10 +233,43 @@ bool Database::ensure_table() {
     }
 }
 
-bool Database::bind_and_step(const std::string& symbol, const Kline& kline) {
+std::int64_t Database::symbol_row(const std::string& name) {
+    if (const auto it = rows_by_name_.find(name); it != rows_by_name_.end()) return it->second;
+    sqlite3_reset(symbol_insert_stmt);
+    sqlite3_bind_text(symbol_insert_stmt, 1, name.c_str(), static_cast<int>(name.size()), SQLITE_STATIC);
+    const bool inserted = sqlite3_step(symbol_insert_stmt) == SQLITE_DONE;
+    sqlite3_reset(symbol_insert_stmt);
+    if (!inserted) return 0;
+    sqlite3_reset(symbol_select_stmt);
+    sqlite3_bind_text(symbol_select_stmt, 1, name.c_str(), static_cast<int>(name.size()), SQLITE_STATIC);
+    const std::int64_t row = sqlite3_step(symbol_select_stmt) == SQLITE_ROW ? sqlite3_column_int64(symbol_select_stmt, 0) : 0;
+    sqlite3_reset(symbol_select_stmt);
+    if (row != 0) rows_by_name_.emplace(name, row);
+    return row;
+}
+
+std::int64_t Database::symbol_row(sentum::market::SymbolId id) {
+    if (id < symbol_rows_.size() && symbol_rows_[id] != 0) return symbol_rows_[id];
+    const auto upper = sentum::market::SymbolInterner::global().name(id);
+    if (upper.empty()) return 0;
+    std::string name(upper);
+    for (auto& c : name) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    if (!register_symbol(id, name)) return 0;
+    return symbol_rows_[id];
+}
+
+bool Database::register_symbol(sentum::market::SymbolId id, const std::string& name) {
+    if (id == sentum::market::kInvalidSymbolId) return false;
+    const auto row = symbol_row(name);
+    if (row == 0) return false;
+    if (symbol_rows_.size() <= id) symbol_rows_.resize(static_cast<std::size_t>(id) + 1, 0);
+    symbol_rows_[id] = row;
+    return true;
+}
+
+bool Database::bind_and_step(std::int64_t symbol_row, const Kline& kline) {
     sqlite3_reset(upsert_stmt);
-    sqlite3_clear_bindings(upsert_stmt);
-    sqlite3_bind_text(upsert_stmt, 1, symbol.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(upsert_stmt, 1, symbol_row);
     sqlite3_bind_int64(upsert_stmt, 2, kline.timestamp);
     sqlite3_bind_double(upsert_stmt, 3, kline.open);
     sqlite3_bind_double(upsert_stmt, 4, kline.high);
@@ -67,9 +281,17 @@ bool Database::bind_and_step(const std::string& symbol, const Kline& kline) {
 
 bool Database::save_kline_batch(const std::vector<std::pair<std::string, Kline>>& batch) {
     if (batch.empty()) return true;
-    if (sqlite3_exec(db, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) != SQLITE_OK) return false;
+    // New symbols are inserted before the batch's transaction, so a rollback cannot
+    // leave a cached id without its dictionary row.
+    batch_rows_.clear();
     for (const auto& item : batch) {
-        if (!bind_and_step(item.first, item.second)) {
+        const auto row = symbol_row(item.first);
+        if (row == 0) return false;
+        batch_rows_.push_back(row);
+    }
+    if (sqlite3_exec(db, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) != SQLITE_OK) return false;
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+        if (!bind_and_step(batch_rows_[i], batch[i].second)) {
             sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
             return false;
         }
@@ -79,9 +301,15 @@ bool Database::save_kline_batch(const std::vector<std::pair<std::string, Kline>>
 
 bool Database::save_kline_batch(const std::vector<KlineBatchItem>& batch) {
     if (batch.empty()) return true;
-    if (sqlite3_exec(db, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) != SQLITE_OK) return false;
+    batch_rows_.clear();
     for (const auto& item : batch) {
-        if (!item.symbol || !bind_and_step(*item.symbol, item.kline)) {
+        const auto row = symbol_row(item.symbol_id);
+        if (row == 0) return false;
+        batch_rows_.push_back(row);
+    }
+    if (sqlite3_exec(db, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) != SQLITE_OK) return false;
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+        if (!bind_and_step(batch_rows_[i], batch[i].kline)) {
             sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
             return false;
         }
@@ -90,16 +318,24 @@ bool Database::save_kline_batch(const std::vector<KlineBatchItem>& batch) {
 }
 
 bool Database::save_klines(const std::string& symbol, const std::vector<Kline>& klines) {
-    std::vector<std::pair<std::string, Kline>> batch;
-    batch.reserve(klines.size());
-    for (const auto& kline : klines) batch.emplace_back(symbol, kline);
-    return save_kline_batch(batch);
+    if (klines.empty()) return true;
+    const auto row = symbol_row(symbol);
+    if (row == 0) return false;
+    if (sqlite3_exec(db, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) != SQLITE_OK) return false;
+    for (const auto& kline : klines) {
+        if (!bind_and_step(row, kline)) {
+            sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+            return false;
+        }
+    }
+    return sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr) == SQLITE_OK;
 }
 
 std::vector<Kline> Database::load_klines(const std::string& symbol, int limit) {
     std::vector<Kline> result;
     sqlite3_stmt* stmt = nullptr;
-    const char* sql = "SELECT timestamp,open,high,low,close,volume FROM klines WHERE symbol=? ORDER BY timestamp DESC LIMIT ?;";
+    const char* sql = "SELECT ts,open,high,low,close,volume FROM klines WHERE symbol_id=(SELECT id FROM symbols WHERE name=?) "
+                      "ORDER BY ts DESC LIMIT ?;";
     if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) return result;
     sqlite3_bind_text(stmt, 1, symbol.c_str(), -1, SQLITE_TRANSIENT);
     sqlite3_bind_int(stmt, 2, limit);
@@ -117,3 +353,240 @@ std::vector<Kline> Database::load_klines(const std::string& symbol, int limit) {
     std::reverse(result.begin(), result.end());
     return result;
 }
+
+int Database::schema_version_of(const std::string& db_path) {
+    sqlite3* db = open_connection(db_path, SQLITE_OPEN_READONLY, "Failed to open database for reading: ");
+    try {
+        const int version = detect_schema(db);
+        sqlite3_close(db);
+        return version;
+    } catch (...) {
+        sqlite3_close(db);
+        throw;
+    }
+}
+
+KlineSchemaMigration Database::migrate(const std::string& db_path, std::size_t chunk_rows,
+                                       const std::function<void(const KlineSchemaMigration&)>& progress) {
+    sqlite3* db = open_connection(db_path, SQLITE_OPEN_READWRITE, "Failed to open database: ");
+    try {
+        exec(db, "PRAGMA journal_mode=WAL;");
+        KlineSchemaMigration result;
+        result.from_version = detect_schema(db);
+        if (result.from_version == 0) throw std::runtime_error(db_path + " has no klines table");
+        if (result.from_version == 1) result = migrate_connection(db, chunk_rows, progress);
+        sqlite3_close(db);
+        return result;
+    } catch (...) {
+        sqlite3_close(db);
+        throw;
+    }
+}
+
+KlineBulkImport::KlineBulkImport(Database& db, std::size_t merge_rows, std::function<void(const KlineBulkImportProgress&)> progress)
+    : db_(db), merge_rows_(std::max<std::size_t>(merge_rows, 1)), on_progress_(std::move(progress)), begin_(std::chrono::steady_clock::now()) {
+    saved_synchronous = query_int(db_.db, "PRAGMA synchronous;");
+    saved_cache_size = query_int(db_.db, "PRAGMA cache_size;");
+    saved_autocheckpoint = query_int(db_.db, "PRAGMA wal_autocheckpoint;");
+    db_.exec_or_throw("PRAGMA synchronous=OFF;");
+    db_.exec_or_throw("PRAGMA cache_size=-262144;");
+    db_.exec_or_throw("PRAGMA wal_autocheckpoint=16384;");
+    std::string sql = "INSERT INTO klines(symbol_id,ts,open,high,low,close,volume) VALUES";
+    for (std::size_t i = 0; i < rows_per_statement; ++i) sql += i == 0 ? "(?,?,?,?,?,?,?)" : ",(?,?,?,?,?,?,?)";
+    sql += " ON CONFLICT(symbol_id,ts) DO UPDATE SET open=excluded.open,high=excluded.high,"
+           "low=excluded.low,close=excluded.close,volume=excluded.volume;";
+    multi_stmt = prepare(db_.db, sql.c_str());
+    staged_.reserve(std::min<std::size_t>(merge_rows_, default_merge_rows));
+}
+
+KlineBulkImport::~KlineBulkImport() {
+    finish();
+}
+
+std::int64_t KlineBulkImport::symbol_row(const std::string& symbol) {
+    if (last_row != 0 && symbol == last_symbol) return last_row;
+    last_row = db_.symbol_row(symbol);
+    last_symbol = symbol;
+    return last_row;
+}
+
+bool KlineBulkImport::stage(std::int64_t symbol_row, const Kline& kline) {
+    staged_.push_back({symbol_row, kline});
+    ++progress_.staged;
+    return staged_.size() < merge_rows_ || merge();
+}
+
+bool KlineBulkImport::append(const std::string& symbol, const Kline& kline) {
+    if (finished) return false;
+    const auto row = symbol_row(symbol);
+    return row != 0 && stage(row, kline);
+}
+
+bool KlineBulkImport::append(const std::string& symbol, const std::vector<Kline>& klines) {
+    if (finished) return false;
+    const auto row = symbol_row(symbol);
+    if (row == 0) return false;
+    for (const auto& kline : klines) if (!stage(row, kline)) return false;
+    return true;
+}
+
+bool KlineBulkImport::merge() {
+    if (staged_.empty()) return true;
+    // Stable, so the last staged copy of a key is written last and wins.
+    std::stable_sort(staged_.begin(), staged_.end(), [](const Staged& a, const Staged& b) {
+        return a.symbol_row != b.symbol_row ? a.symbol_row < b.symbol_row : a.kline.timestamp < b.kline.timestamp;
+    });
+    auto* db = db_.db;
+    if (sqlite3_exec(db, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) != SQLITE_OK) return false;
+    // Full statements of rows_per_statement rows, then the remainder one at a time.
+    const std::size_t full = staged_.size() - staged_.size() % rows_per_statement;
+    for (std::size_t i = 0; i < full; i += rows_per_statement) {
+        sqlite3_reset(multi_stmt);
+        int column = 1;
+        for (std::size_t j = i; j < i + rows_per_statement; ++j) {
+            const auto& kline = staged_[j].kline;
+            sqlite3_bind_int64(multi_stmt, column++, staged_[j].symbol_row);
+            sqlite3_bind_int64(multi_stmt, column++, kline.timestamp);
+            sqlite3_bind_double(multi_stmt, column++, kline.open);
+            sqlite3_bind_double(multi_stmt, column++, kline.high);
+            sqlite3_bind_double(multi_stmt, column++, kline.low);
+            sqlite3_bind_double(multi_stmt, column++, kline.close);
+            sqlite3_bind_double(multi_stmt, column++, kline.volume);
+        }
+        if (sqlite3_step(multi_stmt) != SQLITE_DONE) {
+            sqlite3_reset(multi_stmt);
+            sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+            return false;
+        }
+    }
+    sqlite3_reset(multi_stmt);
+    for (std::size_t i = full; i < staged_.size(); ++i) {
+        if (!db_.bind_and_step(staged_[i].symbol_row, staged_[i].kline)) {
+            sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+            return false;
+        }
+    }
+    if (sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return false;
+    }
+    progress_.merged += staged_.size();
+    ++progress_.merges;
+    staged_.clear();
+    progress_.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin_).count();
+    if (on_progress_) on_progress_(progress_);
+    return true;
+}
+
+bool KlineBulkImport::finish() {
+    if (finished) return true;
+    finished = true;
+    const bool ok = merge();
+    staged_.clear();
+    staged_.shrink_to_fit();
+    sqlite3_finalize(multi_stmt);
+    multi_stmt = nullptr;
+    // Back to the connection's own settings; the checkpoint then syncs what synchronous=OFF
+    // did not. TRUNCATE waits out readers for the busy timeout; if they outlast it, the rest
+    // of the WAL is left to the next checkpoint.
+    const auto restore = "PRAGMA synchronous=" + std::to_string(saved_synchronous) + "; PRAGMA cache_size=" +
+                         std::to_string(saved_cache_size) + "; PRAGMA wal_autocheckpoint=" + std::to_string(saved_autocheckpoint) + ";";
+    sqlite3_exec(db_.db, restore.c_str(), nullptr, nullptr, nullptr);
+    sqlite3_wal_checkpoint_v2(db_.db, nullptr, SQLITE_CHECKPOINT_TRUNCATE, nullptr, nullptr);
+    return ok;
+}
+
+WalCheckpointer::WalCheckpointer(const std::string& db_path, std::uint64_t restart_bytes, std::chrono::milliseconds busy_timeout)
+    : wal_path(db_path + "-wal"), restart_bytes_(restart_bytes) {
+    db = open_connection(db_path, SQLITE_OPEN_READWRITE, "Failed to open database for checkpoints: ");
+    sqlite3_busy_timeout(db, static_cast<int>(busy_timeout.count()));
+    // A connection learns the journal mode on its first read; until then a checkpoint is a no-op.
+    try {
+        exec(db, "PRAGMA journal_mode=WAL;");
+    } catch (...) {
+        sqlite3_close(db);
+        throw;
+    }
+}
+
+WalCheckpointer::~WalCheckpointer() {
+    if (db) sqlite3_close(db);
+}
+
+WalCheckpointResult WalCheckpointer::checkpoint() {
+    WalCheckpointResult result;
+    std::error_code ec;
+    const auto size_before = std::filesystem::file_size(wal_path, ec);
+    result.restart = !ec && size_before > restart_bytes_;
+    const auto begin = std::chrono::steady_clock::now();
+    const int rc = sqlite3_wal_checkpoint_v2(db, nullptr, result.restart ? SQLITE_CHECKPOINT_RESTART : SQLITE_CHECKPOINT_PASSIVE,
+                                             &result.wal_frames, &result.checkpointed_frames);
+    result.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
+    result.ok = rc == SQLITE_OK;
+    const auto size = std::filesystem::file_size(wal_path, ec);
+    result.wal_bytes = ec ? 0 : static_cast<std::uint64_t>(size);
+    return result;
+}
+
+KlineReader::KlineReader(const std::string& db_path) {
+    db = open_connection(db_path, SQLITE_OPEN_READONLY, "Failed to open database for reading: ");
+    try {
+        version = detect_schema(db);
+    } catch (const std::exception& e) {
+        sqlite3_close(db);
+        db = nullptr;
+        throw std::runtime_error("Failed to read the kline schema version: " + std::string(e.what()));
+    }
+    const char* sql = version == 1
+        ? "SELECT timestamp,open,high,low,close,volume FROM klines INDEXED BY idx_klines_symbol_ts "
+          "WHERE symbol=? AND timestamp>=? ORDER BY timestamp DESC LIMIT ?;"
+        : "SELECT ts,open,high,low,close,volume FROM klines WHERE symbol_id=(SELECT id FROM symbols WHERE name=?) "
+          "AND ts>=? ORDER BY ts DESC LIMIT ?;";
+    if (sqlite3_prepare_v2(db, sql, -1, &latest_stmt, nullptr) != SQLITE_OK) {
+        const std::string message = sqlite3_errmsg(db);
+        sqlite3_close(db);
+        db = nullptr;
+        throw std::runtime_error("Failed to prepare kline warm-start query: " + message);
+    }
+}
+
+KlineReader::~KlineReader() {
+    if (latest_stmt) sqlite3_finalize(latest_stmt);
+    if (db) sqlite3_close(db);
+}
+
+bool KlineReader::load_latest(const std::string& symbol, std::int64_t since_ms, int limit, std::vector<Kline>& out) {
+    out.clear();
+    sqlite3_reset(latest_stmt);
+    sqlite3_bind_text(latest_stmt, 1, symbol.c_str(), static_cast<int>(symbol.size()), SQLITE_STATIC);
+    sqlite3_bind_int64(latest_stmt, 2, since_ms);
+    sqlite3_bind_int(latest_stmt, 3, limit);
+    int rc;
+    while ((rc = sqlite3_step(latest_stmt)) == SQLITE_ROW) {
+        out.push_back({sqlite3_column_int64(latest_stmt, 0), sqlite3_column_double(latest_stmt, 1), sqlite3_column_double(latest_stmt, 2),
+                       sqlite3_column_double(latest_stmt, 3), sqlite3_column_double(latest_stmt, 4), sqlite3_column_double(latest_stmt, 5)});
+    }
+    sqlite3_reset(latest_stmt);
+    std::reverse(out.begin(), out.end());
+    return rc == SQLITE_DONE;
+}
+
+bool KlineReader::for_each(const std::function<void(const std::string& symbol, const Kline& kline)>& visit) {
+    sqlite3_stmt* stmt = nullptr;
+    const char* sql = version == 1
+        ? "SELECT symbol,timestamp,open,high,low,close,volume FROM klines ORDER BY symbol,timestamp;"
+        : "SELECT s.name,k.ts,k.open,k.high,k.low,k.close,k.volume FROM klines k CROSS JOIN symbols s ON s.id=k.symbol_id "
+          "ORDER BY k.symbol_id,k.ts;";
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) return false;
+    std::string symbol;
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        const auto* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        const auto length = static_cast<std::size_t>(sqlite3_column_bytes(stmt, 0));
+        if (symbol.size() != length || symbol.compare(0, length, text ? text : "", length) != 0) symbol.assign(text ? text : "", length);
+        visit(symbol, {sqlite3_column_int64(stmt, 1), sqlite3_column_double(stmt, 2), sqlite3_column_double(stmt, 3),
+                       sqlite3_column_double(stmt, 4), sqlite3_column_double(stmt, 5), sqlite3_column_double(stmt, 6)});
+    }
+    sqlite3_finalize(stmt);
+    return rc == SQLITE_DONE;
+}
@@ -1,35 +1,215 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
+#include <functional>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 #include <sqlite3.h>
 
 #include <sentum/api/model/Kline.hpp>
+#include <sentum/market/SymbolId.hpp>
 
 struct KlineBatchItem {
-    const std::string* symbol = nullptr;
+    sentum::market::SymbolId symbol_id = sentum::market::kInvalidSymbolId;
     Kline kline;
 };
 
+// Outcome of converting a text-keyed klines table to the current schema.
+struct KlineSchemaMigration {
+    int from_version = 0;
+    std::uint64_t rows = 0;
+    std::uint64_t symbols = 0;
+    std::uint64_t chunks = 0;
+};
+
+// Schema versions live in PRAGMA user_version:
+//   1  klines(symbol TEXT, timestamp, ...) rowid table plus idx_klines_symbol_ts
+//   2  symbols(id, name) dictionary and klines(symbol_id, ts, ...) WITHOUT ROWID,
+//      clustered on its primary key, with no secondary index
+// Symbol names are stored as the collector writes them (lower case).
 class Database {
 public:
+    static constexpr int schema_version = 2;
+    static constexpr std::size_t default_migration_chunk_rows = 50000;
+
+    // Opens or creates the database; a version 1 database is migrated first.
     explicit Database(const std::string& db_path);
     ~Database();
 
     Database(const Database&) = delete;
     Database& operator=(const Database&) = delete;
 
+    // Maps an interned id to its stored name ahead of the first batch. Ids that were
+    // not registered resolve to the interner's name, lower-cased, on first use.
+    bool register_symbol(sentum::market::SymbolId id, const std::string& name);
     bool save_klines(const std::string& symbol, const std::vector<Kline>& klines);
     bool save_kline_batch(const std::vector<std::pair<std::string, Kline>>& batch);
     bool save_kline_batch(const std::vector<KlineBatchItem>& batch);
     std::vector<Kline> load_klines(const std::string& symbol, int limit = 100);
+    const std::string& path() const noexcept { return path_; }
+    // Pages of WAL after which a commit checkpoints inline (1000 by default); 0 leaves
+    // checkpoints to a WalCheckpointer.
+    void set_wal_autocheckpoint(int pages);
+
+    // 0 for a database without a klines table, otherwise its schema version. Read-only.
+    static int schema_version_of(const std::string& db_path);
+    // Converts a version 1 database in place. Rows are copied in primary-key order,
+    // `chunk_rows` per transaction, so other connections keep reading and writing in
+    // between; the switch to the new tables is one short transaction at the end. A
+    // writer still on the old schema fails from then on and must be restarted.
+    // `progress` runs after every chunk. Returns from_version 2 without changes when
+    // the database is already current.
+    static KlineSchemaMigration migrate(const std::string& db_path, std::size_t chunk_rows = default_migration_chunk_rows,
+                                        const std::function<void(const KlineSchemaMigration&)>& progress = {});
 
 private:
+    friend class KlineBulkImport;
+
     void exec_or_throw(const char* sql);
     bool ensure_table();
-    bool bind_and_step(const std::string& symbol, const Kline& kline);
+    std::int64_t symbol_row(const std::string& name);
+    std::int64_t symbol_row(sentum::market::SymbolId id);
+    bool bind_and_step(std::int64_t symbol_row, const Kline& kline);
 
+    std::string path_;
     sqlite3* db = nullptr;
     sqlite3_stmt* upsert_stmt = nullptr;
+    sqlite3_stmt* symbol_insert_stmt = nullptr;
+    sqlite3_stmt* symbol_select_stmt = nullptr;
+    // symbols.id by interned SymbolId (0 = not resolved yet) and by name.
+    std::vector<std::int64_t> symbol_rows_;
+    std::unordered_map<std::string, std::int64_t> rows_by_name_;
+    // Reused per batch so resolution happens outside the write transaction.
+    std::vector<std::int64_t> batch_rows_;
+};
+
+struct KlineBulkImportProgress {
+    std::uint64_t staged = 0;
+    std::uint64_t merged = 0;
+    std::uint64_t merges = 0;
+    double seconds = 0.0;
+
+    double rows_per_s() const noexcept { return seconds > 0.0 ? static_cast<double>(merged) / seconds : 0.0; }
+};
+
+// Backfill path for long histories, e.g. REST pages or exchange CSV dumps. Rows are
+// staged in memory, resolved to their symbols row once per run of a symbol, and every
+// `merge_rows` rows sorted by (symbol_id, ts) and merged into klines in one transaction,
+// so the clustered key is filled in order whatever order the source delivers. While the
+// import is open the connection runs with synchronous=OFF, a 256 MiB page cache and a
+// longer WAL checkpoint interval; a crash loses the merges since the last checkpoint but
+// cannot corrupt the database. finish() restores the connection's previous settings and
+// runs a TRUNCATE checkpoint. That checkpoint is best-effort: readers that hold the WAL
+// past the busy timeout leave the rest to the next checkpoint.
+// Give the import a Database of its own; the collector can keep writing through its
+// connection meanwhile.
+class KlineBulkImport {
+public:
+    static constexpr std::size_t default_merge_rows = 1000000;
+
+    explicit KlineBulkImport(Database& db, std::size_t merge_rows = default_merge_rows,
+                             std::function<void(const KlineBulkImportProgress&)> progress = {});
+    // Finishes an import that is still open; errors are dropped, so call finish().
+    ~KlineBulkImport();
+
+    KlineBulkImport(const KlineBulkImport&) = delete;
+    KlineBulkImport& operator=(const KlineBulkImport&) = delete;
+
+    bool append(const std::string& symbol, const Kline& kline);
+    bool append(const std::string& symbol, const std::vector<Kline>& klines);
+    // Merges what is still staged, restores the connection and checkpoints. Returns
+    // false if a merge failed; rows merged before it are kept.
+    bool finish();
+
+    const KlineBulkImportProgress& progress() const noexcept { return progress_; }
+
+private:
+    struct Staged {
+        std::int64_t symbol_row = 0;
+        Kline kline;
+    };
+
+    bool stage(std::int64_t symbol_row, const Kline& kline);
+    std::int64_t symbol_row(const std::string& symbol);
+    bool merge();
+
+    Database& db_;
+    std::size_t merge_rows_;
+    std::function<void(const KlineBulkImportProgress&)> on_progress_;
+    // Rows bound per INSERT; fewer statement steps per merged row.
+    static constexpr std::size_t rows_per_statement = 64;
+
+    std::vector<Staged> staged_;
+    sqlite3_stmt* multi_stmt = nullptr;
+    bool finished = false;
+    // Connection settings to put back in finish().
+    std::int64_t saved_synchronous = 1;
+    std::int64_t saved_cache_size = -2000;
+    std::int64_t saved_autocheckpoint = 1000;
+    std::int64_t last_row = 0;
+    std::string last_symbol;
+    std::chrono::steady_clock::time_point begin_;
+    KlineBulkImportProgress progress_;
+};
+
+struct WalCheckpointResult {
+    bool ok = false; // false when RESTART found the database busy, or on an error
+    bool restart = false;
+    int wal_frames = 0;
+    int checkpointed_frames = 0;
+    std::uint64_t wal_bytes = 0;
+    std::chrono::microseconds elapsed{0};
+};
+
+// Checkpoints the WAL from a connection of its own, so the copy never lands inside one
+// of the writer's commits the way wal_autocheckpoint does. PASSIVE copies what it can
+// without waiting for anyone. Once the WAL file has grown past `restart_bytes` (readers
+// kept the writer from wrapping it) the next call uses RESTART, which holds the writer
+// off while it finishes; `busy_timeout` bounds that wait and a busy result is retried by
+// the next call. One thread per instance.
+class WalCheckpointer {
+public:
+    static constexpr std::uint64_t default_restart_bytes = 64ull << 20;
+
+    explicit WalCheckpointer(const std::string& db_path, std::uint64_t restart_bytes = default_restart_bytes,
+                             std::chrono::milliseconds busy_timeout = std::chrono::milliseconds(50));
+    ~WalCheckpointer();
+
+    WalCheckpointer(const WalCheckpointer&) = delete;
+    WalCheckpointer& operator=(const WalCheckpointer&) = delete;
+
+    WalCheckpointResult checkpoint();
+
+private:
+    sqlite3* db = nullptr;
+    std::string wal_path;
+    std::uint64_t restart_bytes_;
+};
+
+// Read-only connection for bulk loads beside the writer. WAL lets any number of them read
+// while the writer commits; each belongs to one thread. Reads both schema versions.
+class KlineReader {
+public:
+    explicit KlineReader(const std::string& db_path);
+    ~KlineReader();
+
+    KlineReader(const KlineReader&) = delete;
+    KlineReader& operator=(const KlineReader&) = delete;
+
+    // Replaces `out` with the newest `limit` klines of `symbol` opened at or after
+    // `since_ms`, oldest first. Walks the clustered primary key backwards.
+    bool load_latest(const std::string& symbol, std::int64_t since_ms, int limit, std::vector<Kline>& out);
+    // Streams the whole table in primary-key order (symbol, then timestamp), e.g. to
+    // convert it to the columnar archive.
+    bool for_each(const std::function<void(const std::string& symbol, const Kline& kline)>& visit);
+
+    int schema_version() const noexcept { return version; }
+
+private:
+    sqlite3* db = nullptr;
+    sqlite3_stmt* latest_stmt = nullptr;
+    int version = 0;
 };
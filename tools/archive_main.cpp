@@ -0,0 +1,151 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sentum/market/KlineArchive.hpp>
+#include <sentum/utils/Database.hpp>
+
+namespace {
+
+using sentum::market::KlineArchiveReader;
+using sentum::market::KlineArchiveWriter;
+
+struct Options {
+    std::string symbol;
+    std::int64_t from_ms = std::numeric_limits<std::int64_t>::min();
+    std::int64_t to_ms = std::numeric_limits<std::int64_t>::max();
+    std::size_t block_rows = KlineArchiveWriter::default_block_rows;
+};
+
+Options parse_options(int argc, char** argv, int first) {
+    Options options;
+    for (int i = first; i < argc; ++i) {
+        const std::string flag = argv[i];
+        if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + flag);
+        const std::string value = argv[++i];
+        if (flag == "--symbol") options.symbol = value;
+        else if (flag == "--from") options.from_ms = std::stoll(value);
+        else if (flag == "--to") options.to_ms = std::stoll(value);
+        else if (flag == "--block-rows") options.block_rows = static_cast<std::size_t>(std::stoul(value));
+        else throw std::invalid_argument("Unknown option " + flag);
+    }
+    return options;
+}
+
+// The SQLite database with its WAL, as it sits on disk.
+std::uintmax_t sqlite_bytes(const std::string& path) {
+    std::uintmax_t total = 0;
+    for (const auto* suffix : {"", "-wal", "-shm"}) {
+        std::error_code ec;
+        const auto size = std::filesystem::file_size(path + suffix, ec);
+        if (!ec) total += size;
+    }
+    return total;
+}
+
+std::uintmax_t directory_bytes(const std::string& path) {
+    std::uintmax_t total = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(path))
+        if (entry.is_regular_file()) total += entry.file_size();
+    return total;
+}
+
+int import(const std::string& db_path, const std::string& directory, const Options& options) {
+    std::uint64_t rows = 0, rejected = 0;
+    const auto begin = std::chrono::steady_clock::now();
+    {
+        KlineReader reader(db_path);
+        KlineArchiveWriter writer(directory, options.block_rows);
+        const bool ok = reader.for_each([&](const std::string& symbol, const Kline& kline) {
+            ++rows;
+            if (!writer.append(symbol, kline)) ++rejected;
+        });
+        if (!ok) throw std::runtime_error("Reading klines from " + db_path + " failed");
+        if (!writer.seal()) throw std::runtime_error("Writing " + directory + " failed");
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    const auto before = sqlite_bytes(db_path);
+    const auto after = directory_bytes(directory);
+    std::cout << std::fixed << std::setprecision(2)
+              << "rows=" << rows << " rejected=" << rejected << " seconds=" << seconds << '\n'
+              << "sqlite_bytes=" << before << " archive_bytes=" << after
+              << " ratio=" << (after > 0 ? static_cast<double>(before) / static_cast<double>(after) : 0.0)
+              << " bytes_per_row=" << (rows > 0 ? static_cast<double>(after) / static_cast<double>(rows) : 0.0) << '\n';
+    return EXIT_SUCCESS;
+}
+
+int stats(const std::string& directory) {
+    const KlineArchiveReader reader(directory);
+    std::cout << std::fixed << std::setprecision(2)
+              << "partitions=" << reader.partition_count() << " symbols=" << reader.symbols().size()
+              << " blocks=" << reader.block_count() << " rows=" << reader.row_count() << " bytes=" << reader.stored_bytes()
+              << " bytes_per_row=" << (reader.row_count() > 0 ? static_cast<double>(reader.stored_bytes()) / static_cast<double>(reader.row_count()) : 0.0)
+              << '\n';
+    return EXIT_SUCCESS;
+}
+
+// Decodes every selected row and reports the decode rate; `sum_close` keeps the work
+// observable and doubles as a cheap equality check between two archives.
+int scan(const std::string& directory, const Options& options) {
+    const KlineArchiveReader reader(directory);
+    const auto symbols = options.symbol.empty() ? reader.symbols() : std::vector<std::string>{options.symbol};
+    std::uint64_t rows = 0;
+    double sum_close = 0.0;
+    bool ok = true;
+    const auto begin = std::chrono::steady_clock::now();
+    for (const auto& symbol : symbols) {
+        ok = reader.scan(symbol, options.from_ms, options.to_ms, [&](const Kline* klines, std::size_t count) {
+            for (std::size_t i = 0; i < count; ++i) sum_close += klines[i].close;
+            rows += count;
+        }) && ok;
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::cout << std::fixed << std::setprecision(2)
+              << "symbols=" << symbols.size() << " rows=" << rows << " seconds=" << std::setprecision(4) << seconds << std::setprecision(2)
+              << " rows_per_s=" << (seconds > 0.0 ? static_cast<double>(rows) / seconds : 0.0)
+              << " decoded_mb_per_s=" << (seconds > 0.0 ? static_cast<double>(rows * sizeof(Kline)) / seconds / 1e6 : 0.0) << '\n'
+              << std::setprecision(8) << "sum_close=" << sum_close << (ok ? "" : " corrupt_blocks=true") << '\n';
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int export_csv(const std::string& directory, const Options& options) {
+    if (options.symbol.empty()) throw std::invalid_argument("export requires --symbol");
+    const KlineArchiveReader reader(directory);
+    std::cout << "timestamp,open,high,low,close,volume\n" << std::setprecision(17);
+    const bool ok = reader.scan(options.symbol, options.from_ms, options.to_ms, [](const Kline* klines, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i)
+            std::cout << klines[i].timestamp << ',' << klines[i].open << ',' << klines[i].high << ',' << klines[i].low << ','
+                      << klines[i].close << ',' << klines[i].volume << '\n';
+    });
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const std::string command = argc > 1 ? argv[1] : "";
+        if (command == "import" && argc >= 4) return import(argv[2], argv[3], parse_options(argc, argv, 4));
+        if (command == "stats" && argc == 3) return stats(argv[2]);
+        if (command == "scan" && argc >= 3) return scan(argv[2], parse_options(argc, argv, 3));
+        if (command == "export" && argc >= 3) return export_csv(argv[2], parse_options(argc, argv, 3));
+        std::cerr << "Usage:\n"
+                  << "  sentum_archive import <klines.sqlite3> <archive-dir> [--block-rows <n>]\n"
+                  << "  sentum_archive stats <archive-dir>\n"
+                  << "  sentum_archive scan <archive-dir> [--symbol <s>] [--from <ms>] [--to <ms>]\n"
+                  << "  sentum_archive export <archive-dir> --symbol <s> [--from <ms>] [--to <ms>]\n"
+                  << "Symbols are stored as the collector writes them (lower case).\n";
+        return EXIT_FAILURE;
+    } catch (const std::exception& ex) {
+        std::cerr << "[FATAL] " << ex.what() << '\n';
+        return EXIT_FAILURE;
+    }
+}
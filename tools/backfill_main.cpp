@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sentum/api/BinanceRestClient.hpp>
+#include <sentum/utils/Database.hpp>
+
+namespace {
+
+struct Options {
+    std::vector<std::string> inputs;
+    std::string symbol;
+    std::vector<std::string> symbols;
+    std::string interval = "1s";
+    std::int64_t from_ms = 0;
+    std::int64_t to_ms = 0;
+    std::size_t merge_rows = KlineBulkImport::default_merge_rows;
+};
+
+std::string lowercase(std::string value) {
+    for (auto& c : value) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return value;
+}
+
+Options parse_options(int argc, char** argv, int first) {
+    Options options;
+    for (int i = first; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg.rfind("--", 0) != 0) { options.inputs.push_back(arg); continue; }
+        if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + arg);
+        const std::string value = argv[++i];
+        if (arg == "--symbol") options.symbol = lowercase(value);
+        else if (arg == "--symbols") {
+            std::stringstream list(value);
+            for (std::string symbol; std::getline(list, symbol, ',');) if (!symbol.empty()) options.symbols.push_back(lowercase(symbol));
+        }
+        else if (arg == "--interval") options.interval = value;
+        else if (arg == "--from") options.from_ms = std::stoll(value);
+        else if (arg == "--to") options.to_ms = std::stoll(value);
+        else if (arg == "--merge-rows") options.merge_rows = static_cast<std::size_t>(std::stoull(value));
+        else throw std::invalid_argument("Unknown option " + arg);
+    }
+    return options;
+}
+
+void print_progress(const KlineBulkImportProgress& progress) {
+    std::cout << std::fixed << std::setprecision(1) << "merged=" << progress.merged << " merges=" << progress.merges
+              << " seconds=" << progress.seconds << " rows_per_s=" << progress.rows_per_s() << std::endl;
+}
+
+// Parses "open_time,open,high,low,close,volume[,...]". Binance's monthly dumps carry
+// microsecond open times since 2025; they are scaled to milliseconds.
+bool parse_row(const std::string& line, Kline& kline) {
+    const char* p = line.c_str();
+    char* end = nullptr;
+    const long long timestamp = std::strtoll(p, &end, 10);
+    if (end == p || *end != ',') return false;
+    kline.timestamp = timestamp > 100000000000000LL ? timestamp / 1000 : timestamp;
+    double* fields[] = {&kline.open, &kline.high, &kline.low, &kline.close, &kline.volume};
+    for (auto* field : fields) {
+        p = end + 1;
+        *field = std::strtod(p, &end);
+        if (end == p || (*end != ',' && *end != '\0' && *end != '\r')) return false;
+    }
+    return true;
+}
+
+int import_csv(const std::string& db_path, const Options& options) {
+    if (options.inputs.empty()) throw std::invalid_argument("csv needs at least one file");
+    Database db(db_path);
+    KlineBulkImport import(db, options.merge_rows, print_progress);
+    std::uint64_t skipped = 0;
+    for (const auto& path : options.inputs) {
+        // BTCUSDT-1s-2025-01.csv -> btcusdt, unless --symbol names it.
+        const auto stem = std::filesystem::path(path).stem().string();
+        const auto symbol = options.symbol.empty() ? lowercase(stem.substr(0, stem.find('-'))) : options.symbol;
+        std::ifstream in(path);
+        if (!in) throw std::runtime_error("Cannot read " + path);
+        std::string line;
+        Kline kline;
+        while (std::getline(in, line)) {
+            if (line.empty()) continue;
+            // Header lines start with a column name.
+            if (!parse_row(line, kline)) { if (std::isdigit(static_cast<unsigned char>(line[0]))) ++skipped; continue; }
+            if (!import.append(symbol, kline)) throw std::runtime_error("Staging " + symbol + " failed");
+        }
+        std::cout << "file=" << path << " symbol=" << symbol << " staged=" << import.progress().staged << std::endl;
+    }
+    if (!import.finish()) throw std::runtime_error("Merging into " + db_path + " failed");
+    const auto& progress = import.progress();
+    std::cout << std::fixed << std::setprecision(1) << "rows=" << progress.merged << " skipped=" << skipped
+              << " seconds=" << progress.seconds << " rows_per_s=" << progress.rows_per_s() << '\n';
+    return EXIT_SUCCESS;
+}
+
+// Pages /api/v3/klines 1000 rows at a time. Twenty requests per second stay well inside
+// the request-weight limit.
+int import_rest(const std::string& db_path, const Options& options) {
+    if (options.symbols.empty() || options.from_ms <= 0 || options.to_ms <= options.from_ms)
+        throw std::invalid_argument("rest needs --symbols and --from < --to");
+    Database db(db_path);
+    KlineBulkImport import(db, options.merge_rows, print_progress);
+    std::uint64_t requests = 0;
+    for (const auto& symbol : options.symbols) {
+        std::string upper = symbol;
+        for (auto& c : upper) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        for (std::int64_t start = options.from_ms; start <= options.to_ms;) {
+            const auto page = BinanceRestClient::get_klines(upper, options.interval, start, options.to_ms);
+            ++requests;
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            if (page.empty()) break;
+            if (!import.append(symbol, page)) throw std::runtime_error("Staging " + symbol + " failed");
+            start = page.back().timestamp + 1;
+        }
+        std::cout << "symbol=" << symbol << " staged=" << import.progress().staged << " requests=" << requests << std::endl;
+    }
+    if (!import.finish()) throw std::runtime_error("Merging into " + db_path + " failed");
+    const auto& progress = import.progress();
+    std::cout << std::fixed << std::setprecision(1) << "rows=" << progress.merged << " requests=" << requests
+              << " seconds=" << progress.seconds << " rows_per_s=" << progress.rows_per_s() << '\n';
+    return EXIT_SUCCESS;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const std::string command = argc > 1 ? argv[1] : "";
+        if (command == "csv" && argc >= 4) return import_csv(argv[2], parse_options(argc, argv, 3));
+        if (command == "rest" && argc >= 3) return import_rest(argv[2], parse_options(argc, argv, 3));
+        std::cerr << "Usage:\n"
+                  << "  sentum_backfill csv <klines.sqlite3> <file.csv>... [--symbol <s>] [--merge-rows <n>]\n"
+                  << "  sentum_backfill rest <klines.sqlite3> --symbols <a,b,...> --from <ms> --to <ms> [--interval 1s] [--merge-rows <n>]\n"
+                  << "CSV rows are open_time,open,high,low,close,volume[,...] as in Binance's kline dumps and\n"
+                  << "`sentum_archive export`; the symbol defaults to the file name up to its first '-'.\n";
+        return EXIT_FAILURE;
+    } catch (const std::exception& ex) {
+        std::cerr << "[FATAL] " << ex.what() << '\n';
+        return EXIT_FAILURE;
+    }
+}
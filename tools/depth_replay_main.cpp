@@ -0,0 +1,67 @@
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <sentum/collector/DepthBook.hpp>
+#include <sentum/collector/DepthReplayFeed.hpp>
+#include <sentum/market/FixedPoint.hpp>
+#include <sentum/market/OrderBook.hpp>
+
+int main(int argc, char** argv) {
+    try {
+        if (argc < 2) {
+            std::cerr << "Usage:\n"
+                      << "  sentum_depth_replay <recording> [--tick <size>] [--step <size>] [--levels <n>] [--quantity <base>]\n";
+            return EXIT_FAILURE;
+        }
+        sentum::market::SymbolScales scales;
+        std::size_t levels = 10;
+        double quantity = 0.0;
+        for (int i = 2; i + 1 < argc; i += 2) {
+            const std::string flag = argv[i];
+            const std::string value = argv[i + 1];
+            if (flag == "--tick") scales.price = sentum::market::FixedScale::from_increment(value);
+            else if (flag == "--step") scales.quantity = sentum::market::FixedScale::from_increment(value);
+            else if (flag == "--levels") levels = static_cast<std::size_t>(std::stoul(value));
+            else if (flag == "--quantity") quantity = std::stod(value);
+            else throw std::invalid_argument("Unknown option " + flag);
+        }
+
+        sentum::collector::DepthBook book(scales);
+        sentum::collector::DepthReplayFeed feed(book);
+        if (!feed.replay_file(argv[1])) throw std::runtime_error(std::string("Cannot open ") + argv[1]);
+
+        const auto& stats = feed.stats();
+        std::cout << "diffs=" << stats.diffs << " applied=" << stats.applied << " buffered=" << stats.buffered
+                  << " stale=" << stats.stale << " invalid=" << stats.invalid << " resyncs=" << stats.resyncs
+                  << " snapshots_served=" << stats.snapshots_served << " snapshots_skipped=" << stats.snapshots_skipped << '\n'
+                  << "last_update_id=" << book.last_update_id() << " live=" << (book.live() ? "true" : "false") << '\n';
+
+        book.with_book([&](const sentum::market::OrderBook& ob) {
+            using sentum::market::BookSide;
+            std::cout << std::setprecision(10) << "bid_levels=" << ob.depth(BookSide::Bid) << " ask_levels=" << ob.depth(BookSide::Ask)
+                      << " crossed=" << (ob.crossed() ? "true" : "false") << '\n';
+            for (std::size_t n = 0; n < levels && (n < ob.depth(BookSide::Bid) || n < ob.depth(BookSide::Ask)); ++n) {
+                std::cout << n << '\t';
+                if (n < ob.depth(BookSide::Bid)) std::cout << ob.quantity(ob.level(BookSide::Bid, n)) << " @ " << ob.price(ob.level(BookSide::Bid, n));
+                std::cout << "\t|\t";
+                if (n < ob.depth(BookSide::Ask)) std::cout << ob.price(ob.level(BookSide::Ask, n)) << " x " << ob.quantity(ob.level(BookSide::Ask, n));
+                std::cout << '\n';
+            }
+            if (quantity > 0.0) {
+                for (const auto side : {BookSide::Ask, BookSide::Bid}) {
+                    const auto fill = ob.walk(side, quantity);
+                    std::cout << (side == BookSide::Ask ? "buy " : "sell ") << quantity << ": vwap=" << fill.average_price
+                              << " worst=" << fill.worst_price << " levels=" << fill.levels
+                              << " filled=" << fill.filled_quantity << (fill.complete ? "" : " (book too thin)") << '\n';
+                }
+            }
+        });
+        return stats.invalid == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    } catch (const std::exception& ex) {
+        std::cerr << "[FATAL] " << ex.what() << '\n';
+        return EXIT_FAILURE;
+    }
+}
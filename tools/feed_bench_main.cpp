@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sentum/collector/Collector.hpp>
+#include <sentum/collector/SyntheticFeed.hpp>
+#include <sentum/core/ThreadTuning.hpp>
+#include <sentum/market/MarketDataStore.hpp>
+#include <sentum/market/RuntimePerformanceMetrics.hpp>
+#include <sentum/utils/Database.hpp>
+
+namespace {
+
+// Prints "<name>_p50_us=... <name>_p99_us=..." from a histogram snapshot.
+void print_latency(const char* name, const nlohmann::json& histogram) {
+    std::cout << name << "_p50_us=" << histogram.value("p50_us", 0) << ' ' << name << "_p99_us=" << histogram.value("p99_us", 0)
+              << ' ' << name << "_max_us=" << histogram.value("max_us", 0) << '\n';
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        std::string url = "ws://127.0.0.1:9443";
+        std::size_t symbols = 200;
+        std::size_t shards = 1;
+        double seconds = 10.0;
+        CollectorOptions options;
+        bool metrics = false;
+        for (int i = 1; i < argc; ++i) {
+            const std::string flag = argv[i];
+            if (flag == "--help" || flag == "-h") {
+                std::cout << "Usage:\n"
+                          << "  sentum_feed_bench [--url <ws[s]://host:port>] [--symbols <n>] [--shards <n>] [--seconds <s>]\n"
+                          << "                    [--book-ticker] [--agg-trades] [--fixed-point] [--metrics]\n"
+                          << "                    [--low-latency [--io-cores <list>] [--persistence-cores <list>] [--fifo <prio>]]\n"
+                          << "Runs the collector against sentum_feed_server with a synthetic universe and reports\n"
+                          << "ingest throughput and latency.\n";
+                return EXIT_SUCCESS;
+            }
+            if (flag == "--book-ticker") { options.book_ticker = true; continue; }
+            if (flag == "--agg-trades") { options.agg_trades = true; continue; }
+            if (flag == "--fixed-point") { options.fixed_point = true; continue; }
+            if (flag == "--metrics") { metrics = true; continue; }
+            if (flag == "--low-latency") { options.low_latency.enabled = true; continue; }
+            if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + flag);
+            const std::string value = argv[++i];
+            if (flag == "--url") url = value;
+            else if (flag == "--symbols") symbols = static_cast<std::size_t>(std::stoul(value));
+            else if (flag == "--shards") shards = static_cast<std::size_t>(std::stoul(value));
+            else if (flag == "--seconds") seconds = std::stod(value);
+            else if (flag == "--io-cores") options.low_latency.io_cores = sentum::runtime::parse_core_list(value);
+            else if (flag == "--persistence-cores") options.low_latency.persistence_cores = sentum::runtime::parse_core_list(value);
+            else if (flag == "--fifo") options.low_latency.fifo_priority = std::stoi(value);
+            else throw std::invalid_argument("Unknown option " + flag);
+        }
+        if (symbols == 0 || seconds <= 0.0) throw std::invalid_argument("--symbols and --seconds must be positive");
+
+        std::vector<MarketInfo> markets;
+        for (const auto& symbol : sentum::collector::SyntheticFeed::universe(symbols)) {
+            MarketInfo market{};
+            market.symbol = symbol;
+            market.base_asset = symbol.substr(0, symbol.size() - 4);
+            market.quote_asset = "USDT";
+            // The server prints eight decimals.
+            market.tick_size = market.step_size = "0.00000001";
+            markets.push_back(std::move(market));
+        }
+        options.stream_url = url;
+        options.shards = shards;
+        Database db(":memory:");
+        MarketDataStore store(600);
+        Collector collector(db, store, markets, options);
+
+        auto& perf = sentum::market::RuntimePerformanceMetrics::global();
+        collector.start();
+        // Connections open asynchronously; measure from the first event.
+        const auto connect_deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (perf.market_events.load() == 0 && std::chrono::steady_clock::now() < connect_deadline)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        if (perf.market_events.load() == 0) { collector.stop(); throw std::runtime_error("No events from " + url); }
+        const auto events_before = perf.market_events.load();
+        const auto begin = std::chrono::steady_clock::now();
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+        const auto events = perf.market_events.load() - events_before;
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        collector.stop();
+
+        std::uint64_t reconnects = 0;
+        for (std::size_t i = 0; i < collector.shard_count(); ++i) reconnects += perf.collector_shards[i].reconnects.load();
+        std::cout << std::fixed << std::setprecision(1)
+                  << "url=" << url << " symbols=" << symbols << " shards=" << collector.shard_count()
+                  << " seconds=" << elapsed << " reconnects=" << reconnects
+                  << " low_latency=" << (options.low_latency.enabled ? "true" : "false") << '\n'
+                  << "events=" << events << " events_per_s=" << static_cast<double>(events) / elapsed
+                  << " candles_enqueued=" << collector.enqueued_count() << " dropped=" << collector.dropped_count() << '\n';
+        print_latency("parse", perf.parse_latency.snapshot());
+        print_latency("dispatch", perf.event_dispatch_latency.snapshot());
+        print_latency("sqlite_batch", perf.sqlite_batch_latency.snapshot());
+        if (options.agg_trades) print_latency("feed_lag", perf.feed_lag.snapshot());
+        if (metrics) std::cout << perf.snapshot().dump(2) << '\n';
+        return EXIT_SUCCESS;
+    } catch (const std::exception& ex) {
+        std::cerr << "[FATAL] " << ex.what() << '\n';
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,287 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <boost/asio/ssl/context.hpp>
+#include <nlohmann/json.hpp>
+#include <websocketpp/config/asio.hpp>
+#include <websocketpp/config/asio_no_tls.hpp>
+#include <websocketpp/server.hpp>
+
+#include <sentum/collector/SyntheticFeed.hpp>
+
+namespace {
+
+struct ServerOptions {
+    std::uint16_t port = 9443;
+    // Messages per second per connection; 0 sends as fast as the client drains them.
+    double rate = 1000.0;
+    std::size_t threads = 1;
+    std::string cert, key; // PEM files; both set serves wss://
+    std::uint64_t seed = 1;
+};
+
+struct ServerStats {
+    std::atomic<std::uint64_t> connections{0};
+    std::atomic<std::uint64_t> streams{0};
+    std::atomic<std::uint64_t> messages{0};
+    std::atomic<std::uint64_t> bytes{0};
+    // Ticks cut short because the client had not read the previous output yet.
+    std::atomic<std::uint64_t> backlogged{0};
+};
+
+std::atomic<bool> stop_requested{false};
+
+std::int64_t now_milliseconds() noexcept {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Serves the streams each client subscribes to, through the handshake URL or SUBSCRIBE
+// requests, from a per-connection SyntheticFeed. Every connection is paced by its own
+// 1 ms timer chain, so a session is only touched by one handler at a time.
+template <typename Config>
+class FeedServer {
+public:
+    using server_type = websocketpp::server<Config>;
+
+    FeedServer(ServerOptions options, ServerStats& stats) : options_(std::move(options)), stats_(stats) {
+        server_.init_asio();
+        server_.set_reuse_addr(true);
+        server_.clear_access_channels(websocketpp::log::alevel::all);
+        server_.clear_error_channels(websocketpp::log::elevel::all);
+        if constexpr (std::is_same_v<Config, websocketpp::config::asio_tls>) {
+            server_.set_tls_init_handler([this](websocketpp::connection_hdl) {
+                auto ctx = websocketpp::lib::make_shared<boost::asio::ssl::context>(boost::asio::ssl::context::tls_server);
+                ctx->set_options(boost::asio::ssl::context::default_workarounds | boost::asio::ssl::context::no_sslv2 | boost::asio::ssl::context::no_sslv3);
+                ctx->use_certificate_chain_file(options_.cert);
+                ctx->use_private_key_file(options_.key, boost::asio::ssl::context::pem);
+                return ctx;
+            });
+        }
+        // Small frames must leave immediately for the latency figures to mean anything.
+        server_.set_socket_init_handler([](websocketpp::connection_hdl, auto& socket) {
+            socket.lowest_layer().set_option(boost::asio::ip::tcp::no_delay(true));
+        });
+        server_.set_open_handler([this](websocketpp::connection_hdl hdl) { on_open(hdl); });
+        server_.set_close_handler([this](websocketpp::connection_hdl hdl) { on_close(hdl); });
+        server_.set_message_handler([this](websocketpp::connection_hdl hdl, typename server_type::message_ptr msg) { on_request(hdl, msg->get_payload()); });
+    }
+
+    void run() {
+        server_.listen(options_.port);
+        server_.start_accept();
+        std::vector<std::thread> pool;
+        for (std::size_t i = 1; i < options_.threads; ++i) pool.emplace_back([this] { server_.run(); });
+        std::thread watcher([this] {
+            while (!stop_requested.load()) std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            websocketpp::lib::error_code ec;
+            server_.stop_listening(ec);
+            server_.stop();
+        });
+        server_.run();
+        for (auto& thread : pool) thread.join();
+        watcher.join();
+    }
+
+private:
+    struct Session {
+        websocketpp::connection_hdl hdl;
+        sentum::collector::SyntheticFeed feed;
+        std::chrono::steady_clock::time_point last_tick;
+        double credit = 0.0;
+        std::atomic<bool> open{true};
+        std::mutex mutex; // guards feed against SUBSCRIBE requests
+        std::string frame;
+        explicit Session(std::uint64_t seed) : feed(seed) {}
+    };
+
+    static constexpr std::size_t max_buffered_bytes = std::size_t{4} << 20;
+    static constexpr std::size_t max_burst = 4096;
+
+    void on_open(websocketpp::connection_hdl hdl) {
+        websocketpp::lib::error_code ec;
+        auto con = server_.get_con_from_hdl(hdl, ec);
+        if (ec) return;
+        auto session = std::make_shared<Session>(options_.seed + stats_.connections.load());
+        session->hdl = hdl;
+        const auto added = session->feed.subscribe_resource(con->get_resource());
+        stats_.streams.fetch_add(added);
+        stats_.connections.fetch_add(1);
+        session->last_tick = std::chrono::steady_clock::now();
+        {
+            std::lock_guard<std::mutex> lock(sessions_mutex_);
+            sessions_[hdl] = session;
+        }
+        schedule(session);
+    }
+
+    void on_close(websocketpp::connection_hdl hdl) {
+        std::lock_guard<std::mutex> lock(sessions_mutex_);
+        const auto it = sessions_.find(hdl);
+        if (it == sessions_.end()) return;
+        it->second->open.store(false);
+        stats_.streams.fetch_sub(it->second->feed.stream_count());
+        stats_.connections.fetch_sub(1);
+        sessions_.erase(it);
+    }
+
+    // {"method":"SUBSCRIBE","params":["btcusdt@trade"],"id":1} and UNSUBSCRIBE, as on the
+    // live endpoint.
+    void on_request(websocketpp::connection_hdl hdl, const std::string& payload) {
+        std::shared_ptr<Session> session;
+        {
+            std::lock_guard<std::mutex> lock(sessions_mutex_);
+            const auto it = sessions_.find(hdl);
+            if (it == sessions_.end()) return;
+            session = it->second;
+        }
+        const auto request = nlohmann::json::parse(payload, nullptr, false);
+        if (request.is_discarded() || !request.is_object()) return;
+        nlohmann::json response = {{"result", nullptr}, {"id", request.value("id", nlohmann::json())}};
+        const auto method = request.value("method", "");
+        if ((method == "SUBSCRIBE" || method == "UNSUBSCRIBE") && request.contains("params") && request["params"].is_array()) {
+            std::size_t changed = 0;
+            {
+                std::lock_guard<std::mutex> lock(session->mutex);
+                for (const auto& name : request["params"]) {
+                    if (!name.is_string()) continue;
+                    if (method == "SUBSCRIBE" ? session->feed.subscribe(name.get<std::string>()) : session->feed.unsubscribe(name.get<std::string>())) ++changed;
+                }
+            }
+            if (method == "SUBSCRIBE") stats_.streams.fetch_add(changed);
+            else stats_.streams.fetch_sub(changed);
+        } else if (method != "SET_PROPERTY") {
+            response = {{"error", {{"code", 2}, {"msg", "Unsupported method"}}}, {"id", request.value("id", nlohmann::json())}};
+        }
+        websocketpp::lib::error_code ec;
+        server_.send(hdl, response.dump(), websocketpp::frame::opcode::text, ec);
+    }
+
+    void schedule(const std::shared_ptr<Session>& session) {
+        server_.set_timer(1, [this, session](const websocketpp::lib::error_code& ec) {
+            if (ec || !session->open.load()) return;
+            tick(*session);
+            schedule(session);
+        });
+    }
+
+    void tick(Session& session) {
+        websocketpp::lib::error_code ec;
+        auto con = server_.get_con_from_hdl(session.hdl, ec);
+        if (ec) return;
+        const auto now = std::chrono::steady_clock::now();
+        std::size_t budget = max_burst;
+        if (options_.rate > 0.0) {
+            // Unsent credit is capped at 100 ms so a stalled client is not flooded later.
+            session.credit = std::min(session.credit + options_.rate * std::chrono::duration<double>(now - session.last_tick).count(),
+                                      std::max(1.0, options_.rate / 10.0));
+            budget = static_cast<std::size_t>(session.credit);
+        }
+        session.last_tick = now;
+        const auto now_ms = now_milliseconds();
+        std::lock_guard<std::mutex> lock(session.mutex);
+        std::size_t sent = 0;
+        std::uint64_t bytes = 0;
+        for (; sent < budget; ++sent) {
+            if (con->get_buffered_amount() >= max_buffered_bytes) { stats_.backlogged.fetch_add(1, std::memory_order_relaxed); break; }
+            if (!session.feed.next(now_ms, session.frame)) break;
+            server_.send(session.hdl, session.frame, websocketpp::frame::opcode::text, ec);
+            if (ec) break;
+            bytes += session.frame.size();
+        }
+        if (options_.rate > 0.0) session.credit -= static_cast<double>(sent);
+        stats_.messages.fetch_add(sent, std::memory_order_relaxed);
+        stats_.bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    ServerOptions options_;
+    ServerStats& stats_;
+    server_type server_;
+    std::mutex sessions_mutex_;
+    std::map<websocketpp::connection_hdl, std::shared_ptr<Session>, std::owner_less<websocketpp::connection_hdl>> sessions_;
+};
+
+void report(const ServerStats& stats) {
+    std::uint64_t messages = 0, bytes = 0;
+    auto last = std::chrono::steady_clock::now();
+    while (!stop_requested.load()) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        const auto now = std::chrono::steady_clock::now();
+        const double seconds = std::chrono::duration<double>(now - last).count();
+        const auto total_messages = stats.messages.load(), total_bytes = stats.bytes.load();
+        std::cout << std::fixed << std::setprecision(2)
+                  << "connections=" << stats.connections.load() << " streams=" << stats.streams.load()
+                  << " msgs_per_s=" << static_cast<double>(total_messages - messages) / seconds
+                  << " mb_per_s=" << static_cast<double>(total_bytes - bytes) / seconds / 1e6
+                  << " backlogged=" << stats.backlogged.load() << std::endl;
+        messages = total_messages; bytes = total_bytes; last = now;
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        ServerOptions options;
+        for (int i = 1; i < argc; ++i) {
+            const std::string flag = argv[i];
+            if (flag == "--help" || flag == "-h") {
+                std::cout << "Usage:\n"
+                          << "  sentum_feed_server [--port <p>] [--rate <msgs/s per connection>|max] [--threads <n>]\n"
+                          << "                     [--cert <pem> --key <pem>] [--seed <n>]\n"
+                          << "Serves Binance-format kline, trade, aggTrade and bookTicker streams for whatever a client\n"
+                          << "subscribes to (/stream?streams=..., /ws/<stream> or SUBSCRIBE/UNSUBSCRIBE). --cert/--key serve wss://.\n";
+                return EXIT_SUCCESS;
+            }
+            if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + flag);
+            const std::string value = argv[++i];
+            if (flag == "--port") options.port = static_cast<std::uint16_t>(std::stoi(value));
+            else if (flag == "--rate") options.rate = value == "max" ? 0.0 : std::stod(value);
+            else if (flag == "--threads") options.threads = static_cast<std::size_t>(std::max(1, std::stoi(value)));
+            else if (flag == "--cert") options.cert = value;
+            else if (flag == "--key") options.key = value;
+            else if (flag == "--seed") options.seed = std::stoull(value);
+            else throw std::invalid_argument("Unknown option " + flag);
+        }
+        if (options.rate < 0.0) throw std::invalid_argument("--rate must be positive or max");
+        if (options.cert.empty() != options.key.empty()) throw std::invalid_argument("--cert and --key go together");
+
+        std::signal(SIGINT, [](int) { stop_requested.store(true); });
+        std::signal(SIGTERM, [](int) { stop_requested.store(true); });
+        const bool tls = !options.cert.empty();
+        std::cout << "Serving " << (tls ? "wss" : "ws") << "://127.0.0.1:" << options.port
+                  << " rate=" << (options.rate > 0.0 ? std::to_string(options.rate) : std::string("max"))
+                  << " threads=" << options.threads << std::endl;
+
+        ServerStats stats;
+        std::thread reporter(report, std::cref(stats));
+        try {
+            if (tls) FeedServer<websocketpp::config::asio_tls>(options, stats).run();
+            else FeedServer<websocketpp::config::asio>(options, stats).run();
+        } catch (...) {
+            stop_requested.store(true);
+            reporter.join();
+            throw;
+        }
+        stop_requested.store(true);
+        reporter.join();
+        return EXIT_SUCCESS;
+    } catch (const std::exception& ex) {
+        std::cerr << "[FATAL] " << ex.what() << '\n';
+        return EXIT_FAILURE;
+    }
+}
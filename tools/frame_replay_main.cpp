@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sentum/collector/Collector.hpp>
+#include <sentum/collector/FrameJournal.hpp>
+#include <sentum/market/MarketDataStore.hpp>
+#include <sentum/market/RuntimePerformanceMetrics.hpp>
+#include <sentum/scanner/SymbolScanner.hpp>
+#include <sentum/utils/Database.hpp>
+
+namespace {
+
+struct JournalUniverse {
+    std::vector<MarketInfo> markets;
+    std::size_t connections = 0;
+};
+
+// The journal carries no exchange metadata, so the universe is every symbol named in a
+// combined-stream envelope ("btcusdt@kline_1s" -> BTCUSDT). Tick sizes are unknown, so
+// replays run on double candles.
+JournalUniverse scan_universe(const std::string& path) {
+    sentum::collector::FrameJournalReader journal(path);
+    if (!journal) throw std::runtime_error("Cannot read frame journal " + path);
+    constexpr std::string_view envelope = "{\"stream\":\"";
+    std::set<std::string> symbols;
+    JournalUniverse universe;
+    sentum::collector::JournalFrame frame;
+    while (journal.next(frame)) {
+        universe.connections = std::max<std::size_t>(universe.connections, frame.connection + 1);
+        if (frame.payload.compare(0, envelope.size(), envelope) != 0) continue;
+        const auto at = frame.payload.find('@', envelope.size());
+        if (at == std::string_view::npos) continue;
+        std::string symbol(frame.payload.substr(envelope.size(), at - envelope.size()));
+        std::transform(symbol.begin(), symbol.end(), symbol.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+        symbols.insert(std::move(symbol));
+    }
+    for (const auto& symbol : symbols) {
+        MarketInfo market{};
+        market.symbol = symbol;
+        universe.markets.push_back(std::move(market));
+    }
+    return universe;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        if (argc < 2) {
+            std::cerr << "Usage:\n"
+                      << "  sentum_frame_replay <journal> [--speed <factor>|max] [--db <path>] [--top <n>] [--per-frame] [--metrics]\n"
+                      << "                      [--archive <dir> [--archive-only]] [--spill <path>]\n"
+                      << "  --speed 1 keeps the recorded pacing; max (the default) replays as fast as possible.\n"
+                      << "  --per-frame disables batched ingest, for comparison.\n"
+                      << "  --archive also writes closed klines to a columnar archive; --archive-only skips SQLite.\n"
+                      << "  --spill sends klines that find a full queue to this file instead of dropping them.\n";
+            return EXIT_FAILURE;
+        }
+        const std::string journal_path = argv[1];
+        double speed = 0.0;
+        std::string db_path = ":memory:";
+        int top = 5;
+        bool metrics = false;
+        bool batch_frames = true;
+        std::string archive_path;
+        std::string spill_path;
+        bool sqlite_sink = true;
+        for (int i = 2; i < argc; ++i) {
+            const std::string flag = argv[i];
+            if (flag == "--metrics") { metrics = true; continue; }
+            if (flag == "--per-frame") { batch_frames = false; continue; }
+            if (flag == "--archive-only") { sqlite_sink = false; continue; }
+            if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + flag);
+            const std::string value = argv[++i];
+            if (flag == "--speed") speed = value == "max" ? 0.0 : std::stod(value);
+            else if (flag == "--db") db_path = value;
+            else if (flag == "--top") top = std::stoi(value);
+            else if (flag == "--archive") archive_path = value;
+            else if (flag == "--spill") spill_path = value;
+            else throw std::invalid_argument("Unknown option " + flag);
+        }
+        if (speed < 0.0) throw std::invalid_argument("--speed must be positive or max");
+        if (!sqlite_sink && archive_path.empty()) throw std::invalid_argument("--archive-only requires --archive");
+
+        const auto universe = scan_universe(journal_path);
+        if (universe.markets.empty()) throw std::runtime_error("No symbols found in " + journal_path);
+        Database db(db_path);
+        MarketDataStore store(600);
+        CollectorOptions options;
+        options.shards = std::max<std::size_t>(1, universe.connections);
+        options.batch_frames = batch_frames;
+        options.sqlite_sink = sqlite_sink;
+        options.archive_path = archive_path;
+        options.spill_path = spill_path;
+        Collector collector(db, store, universe.markets, options);
+        SymbolScanner scanner(store, 0.0);
+
+        const auto report = collector.replay(journal_path, speed);
+        // Rank from the final store state, independent of how far the scanner's lane got.
+        scanner.seed();
+
+        const double seconds = std::chrono::duration<double>(report.elapsed).count();
+        const double recorded = std::chrono::duration<double>(report.recorded).count();
+        auto& perf = sentum::market::RuntimePerformanceMetrics::global();
+        const auto parse = perf.parse_latency.snapshot();
+        std::cout << std::fixed << std::setprecision(3)
+                  << "frames=" << report.frames << " bytes=" << report.bytes << " symbols=" << universe.markets.size()
+                  << " shards=" << collector.shard_count() << (report.truncated ? " truncated=true" : "") << '\n'
+                  << "recorded_s=" << recorded << " replay_s=" << seconds
+                  << " speedup=" << (seconds > 0.0 ? recorded / seconds : 0.0) << '\n'
+                  << "frames_per_s=" << (seconds > 0.0 ? static_cast<double>(report.frames) / seconds : 0.0)
+                  << " mb_per_s=" << (seconds > 0.0 ? static_cast<double>(report.bytes) / seconds / 1e6 : 0.0) << '\n'
+                  << "market_events=" << perf.market_events.load() << " candles_enqueued=" << collector.enqueued_count()
+                  << " dropped=" << collector.dropped_count() << " spilled=" << perf.kline_spill.spilled.load() << '\n'
+                  << "parse_p50_us=" << parse.value("p50_us", 0) << " parse_p99_us=" << parse.value("p99_us", 0) << '\n';
+        if (!archive_path.empty()) {
+            const auto archive = perf.kline_archive.snapshot();
+            std::cout << "archive_rows=" << archive.value("rows", 0) << " archive_bytes=" << archive.value("stored_bytes", 0)
+                      << " archive_bytes_per_row=" << archive.value("bytes_per_row", 0.0) << '\n';
+        }
+        std::cout << std::setprecision(8);
+        for (const auto& item : scanner.fetch_top_performers(60, top)) std::cout << "top\t" << item.symbol << '\t' << item.cum_return << '\n';
+        if (metrics) std::cout << perf.snapshot().dump(2) << '\n';
+        return EXIT_SUCCESS;
+    } catch (const std::exception& ex) {
+        std::cerr << "[FATAL] " << ex.what() << '\n';
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,93 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include <sentum/utils/Database.hpp>
+
+namespace {
+
+// The SQLite database with its WAL, as it sits on disk.
+std::uintmax_t sqlite_bytes(const std::string& path) {
+    std::uintmax_t total = 0;
+    for (const auto* suffix : {"", "-wal", "-shm"}) {
+        std::error_code ec;
+        const auto size = std::filesystem::file_size(path + suffix, ec);
+        if (!ec) total += size;
+    }
+    return total;
+}
+
+// Folds the WAL into the main file and, with `vacuum`, rebuilds it without the pages the
+// dropped table left on the freelist. VACUUM needs the database to itself.
+void compact(const std::string& path, bool vacuum) {
+    sqlite3* db = nullptr;
+    if (sqlite3_open_v2(path.c_str(), &db, SQLITE_OPEN_READWRITE, nullptr) != SQLITE_OK) {
+        const std::string message = db ? sqlite3_errmsg(db) : "unknown SQLite error";
+        if (db) sqlite3_close(db);
+        throw std::runtime_error("Failed to open " + path + ": " + message);
+    }
+    sqlite3_busy_timeout(db, 5000);
+    const char* sql = vacuum ? "VACUUM; PRAGMA wal_checkpoint(TRUNCATE);" : "PRAGMA wal_checkpoint(TRUNCATE);";
+    char* error = nullptr;
+    const int rc = sqlite3_exec(db, sql, nullptr, nullptr, &error);
+    const std::string message = error ? error : "";
+    sqlite3_free(error);
+    sqlite3_close(db);
+    if (rc != SQLITE_OK) throw std::runtime_error("Compacting " + path + " failed: " + message);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        std::string path;
+        std::size_t chunk_rows = Database::default_migration_chunk_rows;
+        bool vacuum = false;
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (arg == "--vacuum") { vacuum = true; continue; }
+            if (arg == "--chunk-rows" && i + 1 < argc) { chunk_rows = static_cast<std::size_t>(std::stoul(argv[++i])); continue; }
+            if (path.empty() && arg.rfind("--", 0) != 0) { path = arg; continue; }
+            path.clear();
+            break;
+        }
+        if (path.empty() || chunk_rows == 0) {
+            std::cerr << "Usage:\n"
+                      << "  sentum_migrate <klines.sqlite3> [--chunk-rows <n>] [--vacuum]\n"
+                      << "Converts a text-keyed klines table to kline schema " << Database::schema_version
+                      << " (symbols dictionary, WITHOUT ROWID klines)\n"
+                      << "while other connections keep using the database. Restart a running collector afterwards;\n"
+                      << "--vacuum then returns the freed pages to the file system and needs exclusive access.\n";
+            return EXIT_FAILURE;
+        }
+
+        const int version = Database::schema_version_of(path);
+        const auto before = sqlite_bytes(path);
+        std::cout << "path=" << path << " schema=" << version << " bytes=" << before << '\n';
+        if (version == Database::schema_version && !vacuum) return EXIT_SUCCESS;
+
+        const auto begin = std::chrono::steady_clock::now();
+        const auto result = Database::migrate(path, chunk_rows, [](const KlineSchemaMigration& progress) {
+            if (progress.chunks % 20 == 0) std::cout << "chunks=" << progress.chunks << " rows=" << progress.rows << '\n';
+        });
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        compact(path, vacuum);
+        const auto after = sqlite_bytes(path);
+        std::cout << std::fixed << std::setprecision(2)
+                  << "from_schema=" << result.from_version << " to_schema=" << Database::schema_version
+                  << " rows=" << result.rows << " symbols=" << result.symbols << " chunks=" << result.chunks
+                  << " seconds=" << seconds << " rows_per_s=" << (seconds > 0.0 ? static_cast<double>(result.rows) / seconds : 0.0) << '\n'
+                  << "bytes_before=" << before << " bytes_after=" << after << (vacuum ? "" : " (without --vacuum the file keeps its freed pages)")
+                  << '\n';
+        return EXIT_SUCCESS;
+    } catch (const std::exception& ex) {
+        std::cerr << "[FATAL] " << ex.what() << '\n';
+        return EXIT_FAILURE;
+    }
+}